@@ -0,0 +1,2283 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_CACHE2Q.c
+Purpose     : Logical driver that caches sectors using the 2Q replacement policy.
+              The sector cache modules of the file system evict the least
+              recently used or the oldest sector so that a large sequential
+              transfer replaces the management and directory sectors with
+              data that is read only once. This driver keeps sectors seen
+              for the first time in a small FIFO and promotes them to the
+              main LRU list only when they are accessed again shortly after
+              eviction. Sectors of a scan pass through the FIFO and do not
+              displace the frequently accessed sectors.
+              The type of a sector (management, directory or data) is
+              derived from the layout of the FAT volume so that the cache
+              space can be limited per type via quotas. In automatic mode
+              the quotas follow the misses on recently evicted sectors.
+              In write-back mode the modified sectors are written to the
+              storage device in ascending sector order, a few at a time,
+              as soon as the oldest one exceeds a configured age or their
+              number exceeds a configured limit.
+              An optional second cache level in a large, slower memory such
+              as memory-mapped PSRAM receives the sectors evicted from the
+              first level and returns them to it when they are read again.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_CACHE2Q.h"
+#include "FS_OS.h"
+#include "FS_HINT.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*      Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_CACHE2Q_IN_PERCENT
+#define FS_CACHE2Q_IN_PERCENT           (25U)   /* Share of the cache used for the sectors seen once (Kin). */
+#endif
+
+#ifndef FS_CACHE2Q_GHOST_PERCENT
+#define FS_CACHE2Q_GHOST_PERCENT        (50U)   /* Number of evicted sectors remembered, relative to the cache size (Kout). */
+#endif
+
+#ifndef FS_CACHE2Q_NUM_DIR_CLUSTERS
+#define FS_CACHE2Q_NUM_DIR_CLUSTERS     (16U)   /* Number of directory clusters remembered for the sector type detection. */
+#endif
+
+#ifndef FS_CACHE2Q_QUOTA_INTERVAL
+#define FS_CACHE2Q_QUOTA_INTERVAL       (4U)    /* Quotas are adjusted after this number of sector reads per cache entry. */
+#endif
+
+#ifndef FS_CACHE2Q_QUOTA_STEP_DIV
+#define FS_CACHE2Q_QUOTA_STEP_DIV       (16U)   /* A quota adjustment moves 1/FS_CACHE2Q_QUOTA_STEP_DIV of the cache. */
+#endif
+
+#ifndef FS_CACHE2Q_CLEAN_BURST
+#define FS_CACHE2Q_CLEAN_BURST          (8U)    /* Maximum number of modified sectors written per clean step. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define ENTRY_NONE                      (0xFFFFU)
+#define MAX_NUM_BLOCKS                  (0xFFFEU)
+#define SECTOR_INDEX_INVALID            (0xFFFFFFFFUL)
+
+/* Replacement lists. */
+#define LIST_FREE                       (0U)    /* Unused entries. */
+#define LIST_IN                         (1U)    /* Sectors accessed once, FIFO order (A1in). */
+#define LIST_MAIN                       (2U)    /* Sectors accessed repeatedly, LRU order (Am). */
+#define NUM_LISTS                       (3U)
+
+#define BUFFER_ALIGNMENT                (4U)
+
+#define SECTOR_TYPE_MASK                (0x03U)
+#define FLAG_DIRTY                      (0x80U) /* Sector modified in the cache only. */
+
+/* Fields of the FAT boot sector used for the sector type detection. */
+#define BPB_OFF_JUMP                    (0U)
+#define BPB_OFF_BYTES_PER_SECTOR        (11U)
+#define BPB_OFF_SECTORS_PER_CLUSTER     (13U)
+#define BPB_OFF_NUM_RESERVED_SECTORS    (14U)
+#define BPB_OFF_NUM_FATS                (16U)
+#define BPB_OFF_NUM_ROOT_DIR_ENTRIES    (17U)
+#define BPB_OFF_NUM_SECTORS_16          (19U)
+#define BPB_OFF_FAT_SIZE_16             (22U)
+#define BPB_OFF_NUM_SECTORS_32          (32U)
+#define BPB_OFF_FAT_SIZE_32             (36U)
+#define BPB_OFF_ROOT_CLUSTER            (44U)
+#define BPB_OFF_SIGNATURE               (510U)
+#define DIR_ENTRY_SIZE                  (32U)
+#define DIR_ENTRY_OFF_ATTR              (11U)
+#define FIRST_CLUSTER_ID                (2U)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+/* Layout of the FAT volume stored on the storage device. */
+typedef struct
+{
+    bool is_valid;
+    U32  first_sector_boot;
+    U32  first_sector_root;         /* Root directory of FAT12/16. Equal to first_sector_data on FAT32. */
+    U32  first_sector_data;
+    U32  num_sectors;
+    U32  root_cluster;              /* Root directory cluster of FAT32. 0 on FAT12/16. */
+    U8   ld_sectors_per_cluster;
+} cache2q_fat_info_t;
+
+typedef struct
+{
+    const FS_DEVICE_TYPE     * device_type;
+    U8                         device_unit;
+    U8                         mode;
+    bool                       is_inited;       /* Set when the cache layout has been calculated. */
+    U8                       * buffer;
+    U32                        buffer_size;
+    FS_CACHE2Q_BLOCK_INFO    * blocks;
+    U8                       * sector_data;
+    U16                        bytes_per_sector;
+    U16                        num_blocks;
+    U16                        max_in;          /* Maximum number of entries in LIST_IN before eviction from it. */
+    U16                        max_ghosts;
+    U16                        ghost_first;
+    U16                        num_ghosts;
+    U16                        list_head[NUM_LISTS];    /* Most recently inserted entry. */
+    U16                        list_tail[NUM_LISTS];    /* Next entry to be evicted. */
+    U16                        list_count[NUM_LISTS];
+    cache2q_fat_info_t         fat_info;
+    U32                        dir_clusters[FS_CACHE2Q_NUM_DIR_CLUSTERS];
+    U8                         dir_cluster_next;
+    bool                       is_quota_enabled;
+    bool                       is_quota_auto;
+    U32                        quota_config[FS_SECTOR_TYPE_COUNT];  /* Quotas requested by the application. */
+    U16                        quota[FS_SECTOR_TYPE_COUNT];         /* Quotas applied to the current layout. */
+    U16                        type_count[FS_SECTOR_TYPE_COUNT];    /* Number of cached sectors per type. */
+    U32                        interval_reads;
+    U32                        interval_ghost_hits[FS_SECTOR_TYPE_COUNT];
+    U16                        num_dirty;
+    U32                        max_dirty_age_ms;    /* 0 means no age limit. */
+    U32                        max_num_dirty;       /* 0 means no count limit. */
+    U32                        time_oldest_dirty;
+    U32                        clean_cursor;        /* Sector index where the next clean step starts. */
+    U8                       * l2_buffer;
+    U32                        l2_buffer_size;
+    FS_CACHE2Q_L2_BLOCK_INFO * l2_blocks;
+    U8                       * l2_sector_data;
+    U16                        l2_num_blocks;
+    U16                        l2_head;             /* Most recently demoted sector. */
+    U16                        l2_tail;             /* Next sector to be dropped. */
+    U16                        l2_free;             /* Unused entries linked via ListNext. */
+    FS_CACHE2Q_STAT_COUNTERS   stat;
+} cache2q_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static cache2q_inst_t cache2q_inst[FS_CACHE2Q_NUM_UNITS];
+static U8             cache2q_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static cache2q_inst_t * get_inst(U8 unit)
+{
+    cache2q_inst_t * inst = NULL;
+
+    if(unit < FS_CACHE2Q_NUM_UNITS)
+    {
+        inst = &cache2q_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       get_sector_data
+*/
+static U8 * get_sector_data(const cache2q_inst_t * inst, U16 entry)
+{
+    return inst->sector_data + ((U32)entry * inst->bytes_per_sector);
+}
+
+/*********************************************************************
+*
+*       load_u16 / load_u32
+*/
+static U16 load_u16(const U8 * data)
+{
+    return (U16)((U16)data[0] | ((U16)data[1] << 8));
+}
+
+static U32 load_u32(const U8 * data)
+{
+    return (U32)load_u16(data) | ((U32)load_u16(data + 2) << 16);
+}
+
+/*********************************************************************
+*
+*       parse_boot_sector
+*
+*  Function description
+*    Checks if a sector is the boot sector of a FAT volume and stores
+*    the layout of the volume.
+*/
+static void parse_boot_sector(cache2q_inst_t * inst, U32 sector_index, const U8 * data)
+{
+    cache2q_fat_info_t * fat_info = &inst->fat_info;
+    U8  sectors_per_cluster;
+    U8  num_fats;
+    U16 num_reserved_sectors;
+    U16 num_root_dir_entries;
+    U32 fat_size;
+    U32 num_sectors;
+    U32 num_root_dir_sectors;
+
+    if((inst->bytes_per_sector < 512U) || (load_u16(data + BPB_OFF_SIGNATURE) != 0xAA55U) ||
+       ((data[BPB_OFF_JUMP] != 0xEBU) && (data[BPB_OFF_JUMP] != 0xE9U)) ||
+       (load_u16(data + BPB_OFF_BYTES_PER_SECTOR) != inst->bytes_per_sector))
+    {
+        return;
+    }
+
+    sectors_per_cluster  = data[BPB_OFF_SECTORS_PER_CLUSTER];
+    num_fats             = data[BPB_OFF_NUM_FATS];
+    num_reserved_sectors = load_u16(data + BPB_OFF_NUM_RESERVED_SECTORS);
+    num_root_dir_entries = load_u16(data + BPB_OFF_NUM_ROOT_DIR_ENTRIES);
+    fat_size             = load_u16(data + BPB_OFF_FAT_SIZE_16);
+    num_sectors          = load_u16(data + BPB_OFF_NUM_SECTORS_16);
+    if(fat_size == 0U)
+    {
+        fat_size = load_u32(data + BPB_OFF_FAT_SIZE_32);
+    }
+    if(num_sectors == 0U)
+    {
+        num_sectors = load_u32(data + BPB_OFF_NUM_SECTORS_32);
+    }
+
+    if((sectors_per_cluster == 0U) || ((sectors_per_cluster & (sectors_per_cluster - 1U)) != 0U) ||
+       (num_fats == 0U) || (num_fats > 2U) || (num_reserved_sectors == 0U) || (fat_size == 0U))
+    {
+        return;
+    }
+
+    num_root_dir_sectors = (((U32)num_root_dir_entries * DIR_ENTRY_SIZE) + inst->bytes_per_sector - 1U) / inst->bytes_per_sector;
+    fat_info->first_sector_boot = sector_index;
+    fat_info->first_sector_root = sector_index + num_reserved_sectors + ((U32)num_fats * fat_size);
+    fat_info->first_sector_data = fat_info->first_sector_root + num_root_dir_sectors;
+    fat_info->num_sectors       = num_sectors;
+    fat_info->root_cluster      = (num_root_dir_entries == 0U) ? load_u32(data + BPB_OFF_ROOT_CLUSTER) : 0U;
+    fat_info->ld_sectors_per_cluster = 0U;
+    while((1U << fat_info->ld_sectors_per_cluster) < sectors_per_cluster)
+    {
+        fat_info->ld_sectors_per_cluster++;
+    }
+    fat_info->is_valid = true;
+
+    FS_MEMSET(inst->dir_clusters, 0, sizeof(inst->dir_clusters));
+    inst->dir_clusters[0] = fat_info->root_cluster;
+    inst->dir_cluster_next = 1U;
+}
+
+/*********************************************************************
+*
+*       get_sector_type
+*
+*  Function description
+*    Determines the type of a sector from its position on the volume.
+*
+*  Additional information
+*    The sectors before the data area are management sectors except for
+*    the root directory of FAT12/16. In the data area only the clusters
+*    detected as directory clusters are directory sectors. A directory
+*    cluster is detected by the "." entry stored at its beginning so that
+*    the following clusters of a large directory are treated as data.
+*    The data read or written is evaluated to detect the directory
+*    clusters and the boot sector.
+*/
+static U8 get_sector_type(cache2q_inst_t * inst, U32 sector_index, const U8 * data)
+{
+    cache2q_fat_info_t * fat_info = &inst->fat_info;
+    U8 sector_type = FS_SECTOR_TYPE_DATA;
+
+    if((!fat_info->is_valid) || (sector_index == fat_info->first_sector_boot))
+    {
+        parse_boot_sector(inst, sector_index, data);
+    }
+
+    if(!fat_info->is_valid)
+    {
+        /* Volume not recognized. Partition table or no FAT volume. */
+        sector_type = (sector_index == 0U) ? FS_SECTOR_TYPE_MAN : FS_SECTOR_TYPE_DATA;
+    }
+    else if(sector_index < fat_info->first_sector_root)
+    {
+        sector_type = FS_SECTOR_TYPE_MAN;
+    }
+    else if(sector_index < fat_info->first_sector_data)
+    {
+        sector_type = FS_SECTOR_TYPE_DIR;
+    }
+    else if((sector_index - fat_info->first_sector_boot) < fat_info->num_sectors)
+    {
+        U32 sector_offset = sector_index - fat_info->first_sector_data;
+        U32 cluster_id = (sector_offset >> fat_info->ld_sectors_per_cluster) + FIRST_CLUSTER_ID;
+
+        for(U32 i = 0U; i < FS_CACHE2Q_NUM_DIR_CLUSTERS; i++)
+        {
+            if(inst->dir_clusters[i] == cluster_id)
+            {
+                sector_type = FS_SECTOR_TYPE_DIR;
+                break;
+            }
+        }
+
+        if((sector_type == FS_SECTOR_TYPE_DATA) &&
+           ((sector_offset & ((1UL << fat_info->ld_sectors_per_cluster) - 1UL)) == 0U) &&
+           (data[0] == (U8)'.') && (data[1] == (U8)' ') && ((data[DIR_ENTRY_OFF_ATTR] & FS_ATTR_DIRECTORY) != 0U))
+        {
+            inst->dir_clusters[inst->dir_cluster_next] = cluster_id;
+            inst->dir_cluster_next = (U8)((inst->dir_cluster_next + 1U) % FS_CACHE2Q_NUM_DIR_CLUSTERS);
+            if(inst->dir_cluster_next == 0U)
+            {
+                inst->dir_cluster_next = 1U;        /* Entry 0 is reserved for the FAT32 root directory. */
+            }
+            sector_type = FS_SECTOR_TYPE_DIR;
+        }
+    }
+    else
+    {
+        /* Outside of the volume. */
+    }
+
+    return sector_type;
+}
+
+/*********************************************************************
+*
+*       list_remove
+*/
+static void list_remove(cache2q_inst_t * inst, U16 entry)
+{
+    FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+    U8 list = block->List;
+
+    if(block->ListPrev != ENTRY_NONE)
+    {
+        inst->blocks[block->ListPrev].ListNext = block->ListNext;
+    }
+    else
+    {
+        inst->list_head[list] = block->ListNext;
+    }
+
+    if(block->ListNext != ENTRY_NONE)
+    {
+        inst->blocks[block->ListNext].ListPrev = block->ListPrev;
+    }
+    else
+    {
+        inst->list_tail[list] = block->ListPrev;
+    }
+
+    block->ListPrev = ENTRY_NONE;
+    block->ListNext = ENTRY_NONE;
+    inst->list_count[list]--;
+}
+
+/*********************************************************************
+*
+*       list_add
+*
+*  Function description
+*    Links an entry at the head (most recently used end) of a list.
+*/
+static void list_add(cache2q_inst_t * inst, U16 entry, U8 list)
+{
+    FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+    U16 head = inst->list_head[list];
+
+    block->List     = list;
+    block->ListPrev = ENTRY_NONE;
+    block->ListNext = head;
+    if(head != ENTRY_NONE)
+    {
+        inst->blocks[head].ListPrev = entry;
+    }
+    else
+    {
+        inst->list_tail[list] = entry;
+    }
+    inst->list_head[list] = entry;
+    inst->list_count[list]++;
+}
+
+/*********************************************************************
+*
+*       hash_get_bucket
+*/
+static U16 * hash_get_bucket(cache2q_inst_t * inst, U32 sector_index)
+{
+    return &inst->blocks[sector_index % inst->num_blocks].HashHead;
+}
+
+/*********************************************************************
+*
+*       hash_find
+*
+*  Function description
+*    Returns the entry storing a sector or ENTRY_NONE if the sector
+*    is not cached.
+*/
+static U16 hash_find(cache2q_inst_t * inst, U32 sector_index)
+{
+    U16 entry = *hash_get_bucket(inst, sector_index);
+
+    while(entry != ENTRY_NONE)
+    {
+        if(inst->blocks[entry].SectorIndex == sector_index)
+        {
+            break;
+        }
+        entry = inst->blocks[entry].HashNext;
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       hash_remove
+*/
+static void hash_remove(cache2q_inst_t * inst, U16 entry)
+{
+    U16 * link = hash_get_bucket(inst, inst->blocks[entry].SectorIndex);
+
+    while(*link != ENTRY_NONE)
+    {
+        if(*link == entry)
+        {
+            *link = inst->blocks[entry].HashNext;
+            break;
+        }
+        link = &inst->blocks[*link].HashNext;
+    }
+    inst->blocks[entry].HashNext = ENTRY_NONE;
+}
+
+/*********************************************************************
+*
+*       ghost_find_remove
+*
+*  Function description
+*    Checks if a sector has been evicted recently from LIST_IN and
+*    removes it from the history.
+*
+*  Additional information
+*    The history is searched linearly. It is consulted only on a cache
+*    miss, where the time required to access the storage device dominates.
+*/
+static bool ghost_find_remove(cache2q_inst_t * inst, U32 sector_index)
+{
+    bool is_found = false;
+
+    for(U16 i = 0U; i < inst->num_ghosts; i++)
+    {
+        U16 slot = (U16)((inst->ghost_first + i) % inst->max_ghosts);
+
+        if(inst->blocks[slot].GhostSectorIndex == sector_index)
+        {
+            /* Invalidate in place. The slot is reused when the ring wraps around. */
+            inst->blocks[slot].GhostSectorIndex = SECTOR_INDEX_INVALID;
+            is_found = true;
+            break;
+        }
+    }
+
+    return is_found;
+}
+
+/*********************************************************************
+*
+*       ghost_add
+*/
+static void ghost_add(cache2q_inst_t * inst, U32 sector_index)
+{
+    if(inst->max_ghosts != 0U)
+    {
+        U16 slot;
+
+        if(inst->num_ghosts == inst->max_ghosts)
+        {
+            /* Forget the oldest sector. */
+            inst->ghost_first = (U16)((inst->ghost_first + 1U) % inst->max_ghosts);
+            inst->num_ghosts--;
+        }
+        slot = (U16)((inst->ghost_first + inst->num_ghosts) % inst->max_ghosts);
+        inst->blocks[slot].GhostSectorIndex = sector_index;
+        inst->num_ghosts++;
+    }
+}
+
+/*********************************************************************
+*
+*       l2_get_sector_data
+*/
+static U8 * l2_get_sector_data(const cache2q_inst_t * inst, U16 entry)
+{
+    return inst->l2_sector_data + ((U32)entry * inst->bytes_per_sector);
+}
+
+/*********************************************************************
+*
+*       l2_hash_get_bucket
+*/
+static U16 * l2_hash_get_bucket(cache2q_inst_t * inst, U32 sector_index)
+{
+    return &inst->l2_blocks[sector_index % inst->l2_num_blocks].HashHead;
+}
+
+/*********************************************************************
+*
+*       l2_find
+*
+*  Return value
+*    Index of the second level entry storing the sector or ENTRY_NONE.
+*/
+static U16 l2_find(cache2q_inst_t * inst, U32 sector_index)
+{
+    U16 entry = ENTRY_NONE;
+
+    if(inst->l2_num_blocks != 0U)
+    {
+        entry = *l2_hash_get_bucket(inst, sector_index);
+        while((entry != ENTRY_NONE) && (inst->l2_blocks[entry].SectorIndex != sector_index))
+        {
+            entry = inst->l2_blocks[entry].HashNext;
+        }
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       l2_remove
+*
+*  Function description
+*    Removes a sector from the second level and returns the entry to the free list.
+*/
+static void l2_remove(cache2q_inst_t * inst, U16 entry)
+{
+    FS_CACHE2Q_L2_BLOCK_INFO * block = &inst->l2_blocks[entry];
+    U16 * link = l2_hash_get_bucket(inst, block->SectorIndex);
+
+    while(*link != ENTRY_NONE)
+    {
+        if(*link == entry)
+        {
+            *link = block->HashNext;
+            break;
+        }
+        link = &inst->l2_blocks[*link].HashNext;
+    }
+
+    if(block->ListPrev != ENTRY_NONE)
+    {
+        inst->l2_blocks[block->ListPrev].ListNext = block->ListNext;
+    }
+    else
+    {
+        inst->l2_head = block->ListNext;
+    }
+    if(block->ListNext != ENTRY_NONE)
+    {
+        inst->l2_blocks[block->ListNext].ListPrev = block->ListPrev;
+    }
+    else
+    {
+        inst->l2_tail = block->ListPrev;
+    }
+
+    block->SectorIndex = SECTOR_INDEX_INVALID;
+    block->HashNext    = ENTRY_NONE;
+    block->ListPrev    = ENTRY_NONE;
+    block->ListNext    = inst->l2_free;
+    inst->l2_free      = entry;
+}
+
+/*********************************************************************
+*
+*       l2_store
+*
+*  Function description
+*    Copies a sector evicted from the first level to the second level,
+*    replacing the sector that was demoted longest ago if necessary.
+*/
+static void l2_store(cache2q_inst_t * inst, U32 sector_index, const U8 * data)
+{
+    FS_CACHE2Q_L2_BLOCK_INFO * block;
+    U16 * bucket;
+    U16 entry = l2_find(inst, sector_index);
+
+    if(entry != ENTRY_NONE)
+    {
+        l2_remove(inst, entry);
+    }
+    if(inst->l2_free == ENTRY_NONE)
+    {
+        l2_remove(inst, inst->l2_tail);
+    }
+
+    entry = inst->l2_free;
+    block = &inst->l2_blocks[entry];
+    inst->l2_free = block->ListNext;
+
+    block->SectorIndex = sector_index;
+    bucket = l2_hash_get_bucket(inst, sector_index);
+    block->HashNext = *bucket;
+    *bucket = entry;
+    block->ListPrev = ENTRY_NONE;
+    block->ListNext = inst->l2_head;
+    if(inst->l2_head != ENTRY_NONE)
+    {
+        inst->l2_blocks[inst->l2_head].ListPrev = entry;
+    }
+    else
+    {
+        inst->l2_tail = entry;
+    }
+    inst->l2_head = entry;
+    FS_MEMCPY(l2_get_sector_data(inst, entry), data, inst->bytes_per_sector);
+    inst->stat.DemoteSectorCnt++;
+}
+
+/*********************************************************************
+*
+*       l2_invalidate_range
+*/
+static void l2_invalidate_range(cache2q_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    if(inst->l2_head != ENTRY_NONE)
+    {
+        if(num_sectors <= inst->l2_num_blocks)
+        {
+            for(U32 i = 0U; i < num_sectors; i++)
+            {
+                U16 entry = l2_find(inst, first_sector + i);
+
+                if(entry != ENTRY_NONE)
+                {
+                    l2_remove(inst, entry);
+                }
+            }
+        }
+        else
+        {
+            for(U16 entry = 0U; entry < inst->l2_num_blocks; entry++)
+            {
+                U32 sector_index = inst->l2_blocks[entry].SectorIndex;
+
+                if((sector_index != SECTOR_INDEX_INVALID) && (sector_index >= first_sector) && ((sector_index - first_sector) < num_sectors))
+                {
+                    l2_remove(inst, entry);
+                }
+            }
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       l2_init
+*
+*  Function description
+*    Calculates the number of sectors that fit in the second level
+*    buffer and marks all of them as unused.
+*/
+static void l2_init(cache2q_inst_t * inst)
+{
+    U32 num_blocks = 0U;
+
+    if(inst->l2_buffer != NULL)
+    {
+        num_blocks = inst->l2_buffer_size / (U32)(sizeof(FS_CACHE2Q_L2_BLOCK_INFO) + inst->bytes_per_sector);
+        if(num_blocks > MAX_NUM_BLOCKS)
+        {
+            num_blocks = MAX_NUM_BLOCKS;
+        }
+    }
+
+    inst->l2_num_blocks  = (U16)num_blocks;
+    inst->l2_blocks      = (FS_CACHE2Q_L2_BLOCK_INFO *)(void *)inst->l2_buffer;
+    inst->l2_sector_data = inst->l2_buffer + (num_blocks * sizeof(FS_CACHE2Q_L2_BLOCK_INFO));
+    inst->l2_head        = ENTRY_NONE;
+    inst->l2_tail        = ENTRY_NONE;
+    inst->l2_free        = ENTRY_NONE;
+    for(U16 entry = 0U; entry < inst->l2_num_blocks; entry++)
+    {
+        FS_CACHE2Q_L2_BLOCK_INFO * block = &inst->l2_blocks[entry];
+
+        block->SectorIndex = SECTOR_INDEX_INVALID;
+        block->HashHead    = ENTRY_NONE;
+        block->HashNext    = ENTRY_NONE;
+        block->ListPrev    = ENTRY_NONE;
+        block->ListNext    = inst->l2_free;
+        inst->l2_free      = entry;
+    }
+}
+
+/*********************************************************************
+*
+*       clear_dirty
+*/
+static void clear_dirty(cache2q_inst_t * inst, U16 entry)
+{
+    FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+
+    if((block->Flags & FLAG_DIRTY) != 0U)
+    {
+        block->Flags &= (U8)~FLAG_DIRTY;
+        inst->num_dirty--;
+    }
+}
+
+/*********************************************************************
+*
+*       invalidate_entry
+*/
+static void invalidate_entry(cache2q_inst_t * inst, U16 entry)
+{
+    clear_dirty(inst, entry);   /* The modification is discarded. */
+    inst->type_count[inst->blocks[entry].Flags & SECTOR_TYPE_MASK]--;
+    hash_remove(inst, entry);
+    list_remove(inst, entry);
+    inst->blocks[entry].SectorIndex = SECTOR_INDEX_INVALID;
+    list_add(inst, entry, LIST_FREE);
+}
+
+/*********************************************************************
+*
+*       invalidate_all
+*/
+static void invalidate_all(cache2q_inst_t * inst)
+{
+    U16 entry;
+
+    for(U32 list = 0U; list < NUM_LISTS; list++)
+    {
+        inst->list_head[list]  = ENTRY_NONE;
+        inst->list_tail[list]  = ENTRY_NONE;
+        inst->list_count[list] = 0U;
+    }
+    inst->ghost_first = 0U;
+    inst->num_ghosts  = 0U;
+    inst->num_dirty   = 0U;
+    FS_MEMSET(inst->type_count, 0, sizeof(inst->type_count));
+
+    for(entry = 0U; entry < inst->num_blocks; entry++)
+    {
+        FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+
+        block->SectorIndex      = SECTOR_INDEX_INVALID;
+        block->GhostSectorIndex = SECTOR_INDEX_INVALID;
+        block->HashHead         = ENTRY_NONE;
+        block->HashNext         = ENTRY_NONE;
+        block->Flags            = 0U;
+        list_add(inst, entry, LIST_FREE);
+    }
+}
+
+/*********************************************************************
+*
+*       mark_dirty
+*
+*  Function description
+*    Marks a cached sector as modified. The age of a modified sector
+*    is counted from the first modification that was not written to
+*    the storage device.
+*/
+static void mark_dirty(cache2q_inst_t * inst, U16 entry)
+{
+    FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+
+    if((block->Flags & FLAG_DIRTY) == 0U)
+    {
+        block->TimeDirty = FS_X_OS_GetTime();
+        block->Flags    |= FLAG_DIRTY;
+        if(inst->num_dirty == 0U)
+        {
+            inst->time_oldest_dirty = block->TimeDirty;
+        }
+        inst->num_dirty++;
+    }
+}
+
+/*********************************************************************
+*
+*       clean_entry
+*
+*  Function description
+*    Writes a modified sector to the storage device.
+*
+*  Return value
+*    ==0    OK, sector written.
+*    !=0    An error occurred. The sector remains modified.
+*/
+static int clean_entry(cache2q_inst_t * inst, U16 entry)
+{
+    int r;
+
+    r = inst->device_type->pfWrite(inst->device_unit, inst->blocks[entry].SectorIndex, get_sector_data(inst, entry), 1U, 0U);
+    if(r == 0)
+    {
+        clear_dirty(inst, entry);
+        inst->stat.CleanSectorCnt++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_dirty
+*
+*  Function description
+*    Searches for the modified sector with the lowest index in the
+*    range first_sector..last_sector.
+*
+*  Additional information
+*    The sector that follows the last written one is checked first
+*    so that a run of consecutive modified sectors is found quickly.
+*/
+static U16 find_dirty(cache2q_inst_t * inst, U32 first_sector, U32 last_sector)
+{
+    U16 entry = hash_find(inst, first_sector);
+
+    if((entry == ENTRY_NONE) || ((inst->blocks[entry].Flags & FLAG_DIRTY) == 0U))
+    {
+        U32 sector_found = SECTOR_INDEX_INVALID;
+
+        entry = ENTRY_NONE;
+        for(U16 i = 0U; i < inst->num_blocks; i++)
+        {
+            const FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[i];
+
+            if(((block->Flags & FLAG_DIRTY) != 0U) && (block->SectorIndex >= first_sector) &&
+               (block->SectorIndex <= last_sector) && (block->SectorIndex < sector_found))
+            {
+                sector_found = block->SectorIndex;
+                entry = i;
+            }
+        }
+    }
+    else if(first_sector > last_sector)
+    {
+        entry = ENTRY_NONE;
+    }
+    else
+    {
+        /* Next sector of a run. */
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       update_oldest_dirty
+*/
+static void update_oldest_dirty(cache2q_inst_t * inst)
+{
+    if((inst->num_dirty != 0U) && (inst->max_dirty_age_ms != 0U))
+    {
+        U32 time_now = FS_X_OS_GetTime();
+        U32 age_max = 0U;
+
+        inst->time_oldest_dirty = time_now;
+        for(U16 entry = 0U; entry < inst->num_blocks; entry++)
+        {
+            const FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+
+            if(((block->Flags & FLAG_DIRTY) != 0U) && ((time_now - block->TimeDirty) > age_max))
+            {
+                age_max = time_now - block->TimeDirty;
+                inst->time_oldest_dirty = block->TimeDirty;
+            }
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       clean_range
+*
+*  Function description
+*    Writes all the modified sectors of a range to the storage device
+*    in ascending sector order.
+*
+*  Return value
+*    ==0    OK, all sectors written.
+*    !=0    An error occurred.
+*/
+static int clean_range(cache2q_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    U32 last_sector = first_sector + (num_sectors - 1U);
+    U32 sector_index = first_sector;
+    int r = 0;
+
+    if(last_sector < first_sector)
+    {
+        last_sector = SECTOR_INDEX_INVALID - 1U;
+    }
+    while((inst->num_dirty != 0U) && (num_sectors != 0U))
+    {
+        U16 entry = find_dirty(inst, sector_index, last_sector);
+
+        if(entry == ENTRY_NONE)
+        {
+            break;
+        }
+        r = clean_entry(inst, entry);
+        if(r != 0)
+        {
+            break;
+        }
+        sector_index = inst->blocks[entry].SectorIndex + 1U;
+    }
+    update_oldest_dirty(inst);
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       clean_step
+*
+*  Function description
+*    Writes up to FS_CACHE2Q_CLEAN_BURST modified sectors to the storage device.
+*
+*  Additional information
+*    The sectors are written in ascending order starting where the
+*    previous step stopped, like an elevator that sweeps the storage
+*    device. A modified sector is written at the latest when the sweep
+*    comes by again, so the age limit is kept as long as clean steps
+*    are performed often enough.
+*/
+static int clean_step(cache2q_inst_t * inst)
+{
+    U32 num_sectors = 0U;
+    int r = 0;
+
+    while((inst->num_dirty != 0U) && (num_sectors < FS_CACHE2Q_CLEAN_BURST))
+    {
+        U16 entry = find_dirty(inst, inst->clean_cursor, SECTOR_INDEX_INVALID - 1U);
+
+        if(entry == ENTRY_NONE)
+        {
+            inst->clean_cursor = 0U;        /* Start the next sweep. */
+        }
+        else
+        {
+            r = clean_entry(inst, entry);
+            if(r != 0)
+            {
+                break;
+            }
+            inst->clean_cursor = inst->blocks[entry].SectorIndex + 1U;
+            num_sectors++;
+        }
+    }
+    update_oldest_dirty(inst);
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       clean_if_required
+*
+*  Function description
+*    Performs a clean step if the modified sectors exceed one of the
+*    limits configured via FS_CACHE2Q_SetWriteBackLimits().
+*
+*  Additional information
+*    A sector that cannot be written remains modified and is retried
+*    with the next step. The error is reported by FS_CMD_SYNC.
+*/
+static void clean_if_required(cache2q_inst_t * inst)
+{
+    bool is_required = false;
+
+    if(inst->num_dirty != 0U)
+    {
+        if((inst->max_num_dirty != 0U) && (inst->num_dirty > inst->max_num_dirty))
+        {
+            is_required = true;
+        }
+        else if((inst->max_dirty_age_ms != 0U) && ((FS_X_OS_GetTime() - inst->time_oldest_dirty) >= inst->max_dirty_age_ms))
+        {
+            is_required = true;
+        }
+        else
+        {
+            /* Within the limits. */
+        }
+    }
+    if(is_required)
+    {
+        (void)clean_step(inst);
+    }
+}
+
+/*********************************************************************
+*
+*       apply_quotas
+*
+*  Function description
+*    Calculates the quotas for the number of entries in the cache.
+*
+*  Additional information
+*    The automatic mode starts with half of the cache assigned to
+*    data sectors and a quarter to each of the other types.
+*/
+static void apply_quotas(cache2q_inst_t * inst)
+{
+    if(inst->is_quota_auto)
+    {
+        inst->quota[FS_SECTOR_TYPE_MAN]  = (U16)(inst->num_blocks / 4U);
+        inst->quota[FS_SECTOR_TYPE_DIR]  = (U16)(inst->num_blocks / 4U);
+        inst->quota[FS_SECTOR_TYPE_DATA] = (U16)(inst->num_blocks - (2U * (inst->num_blocks / 4U)));
+    }
+    else
+    {
+        for(U32 type = 0U; type < FS_SECTOR_TYPE_COUNT; type++)
+        {
+            inst->quota[type] = (U16)((inst->quota_config[type] < inst->num_blocks) ? inst->quota_config[type] : inst->num_blocks);
+        }
+    }
+    inst->interval_reads = 0U;
+    FS_MEMSET(inst->interval_ghost_hits, 0, sizeof(inst->interval_ghost_hits));
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Function description
+*    Calculates the number of sectors that fit in the cache
+*    buffer using the sector size reported by the storage device.
+*
+*  Return value
+*    ==0    OK, cache ready.
+*    !=0    An error occurred.
+*/
+static int init_if_required(cache2q_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info;
+        U32 num_blocks;
+
+        if(inst->device_type == NULL)
+        {
+            r = 1;              /* Driver not configured. */
+        }
+        else
+        {
+            FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+            r = inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+            if((r == 0) && (dev_info.BytesPerSector != 0U))
+            {
+                num_blocks = inst->buffer_size / (U32)(sizeof(FS_CACHE2Q_BLOCK_INFO) + dev_info.BytesPerSector);
+                if(num_blocks > MAX_NUM_BLOCKS)
+                {
+                    num_blocks = MAX_NUM_BLOCKS;
+                }
+                if(num_blocks < 2U)
+                {
+                    r = 1;      /* Buffer too small. */
+                }
+                else
+                {
+                    inst->bytes_per_sector = dev_info.BytesPerSector;
+                    inst->num_blocks       = (U16)num_blocks;
+                    inst->blocks           = (FS_CACHE2Q_BLOCK_INFO *)(void *)inst->buffer;
+                    inst->sector_data      = inst->buffer + (num_blocks * sizeof(FS_CACHE2Q_BLOCK_INFO));
+                    inst->max_in           = (U16)((num_blocks * FS_CACHE2Q_IN_PERCENT) / 100U);
+                    if(inst->max_in == 0U)
+                    {
+                        inst->max_in = 1U;
+                    }
+                    inst->max_ghosts       = (U16)((num_blocks * FS_CACHE2Q_GHOST_PERCENT) / 100U);
+                    if(inst->max_ghosts > num_blocks)
+                    {
+                        inst->max_ghosts = (U16)num_blocks;   /* The history is stored in the block information. */
+                    }
+                    FS_MEMSET(&inst->fat_info, 0, sizeof(inst->fat_info));
+                    invalidate_all(inst);
+                    l2_init(inst);
+                    apply_quotas(inst);
+                    inst->is_inited = true;
+                }
+            }
+            else
+            {
+                r = 1;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_victim
+*
+*  Function description
+*    Searches a replacement list from the eviction end for a sector
+*    that can be evicted according to the quotas.
+*
+*  Parameters
+*    inst           Driver instance.
+*    list           List to be searched.
+*    sector_type    Type of the sector to be inserted.
+*    is_same_type   true   Search for a sector of the same type.
+*                   false  Search for a sector of a type exceeding its quota.
+*/
+static U16 find_victim(const cache2q_inst_t * inst, U8 list, U8 sector_type, bool is_same_type)
+{
+    U16 entry = inst->list_tail[list];
+
+    while(entry != ENTRY_NONE)
+    {
+        U8 type = inst->blocks[entry].Flags & SECTOR_TYPE_MASK;
+
+        if(is_same_type ? (type == sector_type) : (inst->type_count[type] > inst->quota[type]))
+        {
+            break;
+        }
+        entry = inst->blocks[entry].ListPrev;
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       alloc_entry
+*
+*  Function description
+*    Returns an unused entry, evicting a sector if necessary.
+*
+*  Return value
+*    Index of the entry or ENTRY_NONE if the quota of the sector type is 0
+*    or the evicted sector could not be written to the storage device.
+*
+*  Additional information
+*    Sectors are evicted from LIST_IN as long as it holds more than
+*    its share of the cache, otherwise from the tail of LIST_MAIN.
+*    Only the sectors evicted from LIST_IN are remembered in the history
+*    because only those were never accessed more than once. With
+*    automatic quotas the sectors evicted from LIST_MAIN are remembered
+*    as well so that the misses caused by a too small quota are visible.
+*
+*    With quotas enabled a sector type that reached its quota replaces
+*    one of its own sectors. Otherwise a sector of a type exceeding its
+*    quota is evicted in preference to the others.
+*
+*    A modified sector is written to the storage device before eviction.
+*
+*    The evicted sector is moved to the second level if one is configured.
+*    Data sectors are moved only if they were accessed more than once so
+*    that a scan does not replace the management and directory sectors
+*    in the second level either.
+*/
+static U16 alloc_entry(cache2q_inst_t * inst, U8 sector_type)
+{
+    U16 entry = ENTRY_NONE;
+    bool is_same_type = false;
+
+    if(inst->is_quota_enabled)
+    {
+        if(inst->quota[sector_type] == 0U)
+        {
+            return ENTRY_NONE;
+        }
+        is_same_type = (inst->type_count[sector_type] >= inst->quota[sector_type]);
+    }
+
+    if(!is_same_type)
+    {
+        entry = inst->list_tail[LIST_FREE];
+    }
+
+    if(entry == ENTRY_NONE)
+    {
+        if(inst->is_quota_enabled)
+        {
+            entry = find_victim(inst, LIST_IN, sector_type, is_same_type);
+            if(entry == ENTRY_NONE)
+            {
+                entry = find_victim(inst, LIST_MAIN, sector_type, is_same_type);
+            }
+        }
+
+        if(entry == ENTRY_NONE)
+        {
+            bool evict_in = (inst->list_count[LIST_IN] > inst->max_in) || (inst->list_count[LIST_MAIN] == 0U);
+
+            entry = evict_in ? inst->list_tail[LIST_IN] : inst->list_tail[LIST_MAIN];
+        }
+
+        if((inst->blocks[entry].Flags & FLAG_DIRTY) != 0U)
+        {
+            if(clean_entry(inst, entry) != 0)
+            {
+                return ENTRY_NONE;      /* The modified sector has to stay in the cache. */
+            }
+        }
+        if((inst->blocks[entry].List == LIST_IN) || inst->is_quota_auto)
+        {
+            ghost_add(inst, inst->blocks[entry].SectorIndex);
+        }
+        if((inst->l2_num_blocks != 0U) &&
+           (((inst->blocks[entry].Flags & SECTOR_TYPE_MASK) != FS_SECTOR_TYPE_DATA) || (inst->blocks[entry].List == LIST_MAIN)))
+        {
+            l2_store(inst, inst->blocks[entry].SectorIndex, get_sector_data(inst, entry));
+        }
+        invalidate_entry(inst, entry);
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       is_bypassed
+*
+*  Function description
+*    Checks if a sector has to bypass the cache because the file
+*    system operation in progress was declared as FS_ACCESS_HINT_NOREUSE.
+*    Only file data is bypassed; the management and directory sectors
+*    are accessed again when the next file is opened.
+*/
+static bool is_bypassed(bool is_noreuse, U8 sector_type)
+{
+    return is_noreuse && (sector_type == FS_SECTOR_TYPE_DATA);
+}
+
+/*********************************************************************
+*
+*       touch_entry
+*
+*  Function description
+*    Updates the replacement information on a cache hit.
+*/
+static void touch_entry(cache2q_inst_t * inst, U16 entry)
+{
+    if(inst->blocks[entry].List == LIST_MAIN)
+    {
+        list_remove(inst, entry);
+        list_add(inst, entry, LIST_MAIN);
+    }
+    /* A hit in LIST_IN does not change the order. Correlated accesses
+     * shortly after the first one must not promote a sector. */
+}
+
+/*********************************************************************
+*
+*       insert_sector
+*
+*  Function description
+*    Stores the data of a sector that is not cached yet.
+*
+*  Return value
+*    Index of the entry or ENTRY_NONE if the sector was not cached.
+*/
+static U16 insert_sector(cache2q_inst_t * inst, U32 sector_index, const U8 * data, U8 sector_type)
+{
+    U16 entry = alloc_entry(inst, sector_type);
+
+    if(entry != ENTRY_NONE)
+    {
+        FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+        U16 * bucket;
+        U8 list = LIST_IN;
+
+        if(ghost_find_remove(inst, sector_index))
+        {
+            list = LIST_MAIN;
+            inst->stat.GhostHitCnt++;
+            inst->interval_ghost_hits[sector_type]++;
+        }
+
+        list_remove(inst, entry);
+        block->SectorIndex = sector_index;
+        block->Flags       = sector_type;
+        bucket = hash_get_bucket(inst, sector_index);
+        block->HashNext = *bucket;
+        *bucket = entry;
+        list_add(inst, entry, list);
+        inst->type_count[sector_type]++;
+        FS_MEMCPY(get_sector_data(inst, entry), data, inst->bytes_per_sector);
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       update_sector_type
+*
+*  Function description
+*    Changes the type of a cached sector. Called when a sector is
+*    rewritten, for example when the volume is formatted.
+*/
+static void update_sector_type(cache2q_inst_t * inst, U16 entry, U8 sector_type)
+{
+    FS_CACHE2Q_BLOCK_INFO * block = &inst->blocks[entry];
+    U8 type = block->Flags & SECTOR_TYPE_MASK;
+
+    if(type != sector_type)
+    {
+        inst->type_count[type]--;
+        inst->type_count[sector_type]++;
+        block->Flags = (U8)((block->Flags & (U8)~SECTOR_TYPE_MASK) | sector_type);
+    }
+}
+
+/*********************************************************************
+*
+*       rebalance_quotas
+*
+*  Function description
+*    Moves cache space from the sector type that would have profited
+*    least from more space to the one that would have profited most.
+*
+*  Additional information
+*    The profit is measured by the number of misses on sectors that were
+*    evicted recently. A type that misses its own evicted sectors would
+*    have had hits with a larger quota. Each type keeps at least one step.
+*/
+static void rebalance_quotas(cache2q_inst_t * inst)
+{
+    U16 step = (U16)(inst->num_blocks / FS_CACHE2Q_QUOTA_STEP_DIV);
+    U8  type_max = 0U;
+    U8  type_min = 0U;
+    bool is_min_found = false;
+
+    if(step == 0U)
+    {
+        step = 1U;
+    }
+
+    for(U8 type = 1U; type < FS_SECTOR_TYPE_COUNT; type++)
+    {
+        if(inst->interval_ghost_hits[type] > inst->interval_ghost_hits[type_max])
+        {
+            type_max = type;
+        }
+    }
+
+    for(U8 type = 0U; type < FS_SECTOR_TYPE_COUNT; type++)
+    {
+        if((type != type_max) && (inst->quota[type] >= (2U * step)))
+        {
+            if((!is_min_found) || (inst->interval_ghost_hits[type] < inst->interval_ghost_hits[type_min]))
+            {
+                type_min = type;
+                is_min_found = true;
+            }
+        }
+    }
+
+    if(is_min_found && (inst->interval_ghost_hits[type_max] > inst->interval_ghost_hits[type_min]))
+    {
+        inst->quota[type_min] -= step;
+        inst->quota[type_max] += step;
+        inst->stat.QuotaChangeCnt++;
+    }
+
+    inst->interval_reads = 0U;
+    FS_MEMSET(inst->interval_ghost_hits, 0, sizeof(inst->interval_ghost_hits));
+}
+
+/*********************************************************************
+*
+*       invalidate_range
+*/
+static void invalidate_range(cache2q_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    l2_invalidate_range(inst, first_sector, num_sectors);
+    for(U16 entry = 0U; entry < inst->num_blocks; entry++)
+    {
+        U32 sector_index = inst->blocks[entry].SectorIndex;
+
+        if((sector_index != SECTOR_INDEX_INVALID) && (sector_index >= first_sector) && ((sector_index - first_sector) < num_sectors))
+        {
+            invalidate_entry(inst, entry);
+        }
+    }
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 15,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       cache2q_get_name
+*/
+static const char * cache2q_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "cache2q";
+}
+
+/*********************************************************************
+*
+*       cache2q_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int cache2q_add_device(void)
+{
+    int r = -1;
+
+    if(cache2q_num_units < FS_CACHE2Q_NUM_UNITS)
+    {
+        r = (int)cache2q_num_units;
+        cache2q_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_read
+*
+*  Function description
+*    Reads sectors from the cache and the missing ones from the storage device.
+*
+*  Additional information
+*    Consecutive sectors that are not cached are read with a single request.
+*    Requests larger than the FIFO share of the cache are not cached since
+*    their sectors would only replace each other. File data read with
+*    the FS_ACCESS_HINT_NOREUSE hint is neither cached nor promoted.
+*/
+static int cache2q_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+    U8 * data = (U8 *)pBuffer;
+    U32  i = 0U;
+    int  r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = init_if_required(inst);
+        if(r != 0)
+        {
+            r = inst->device_type->pfRead(inst->device_unit, SectorIndex, pBuffer, NumSectors);
+        }
+        else
+        {
+            bool do_insert  = (NumSectors <= inst->max_in);
+            bool is_noreuse = (FS_HINT_GetCurrent() == FS_ACCESS_HINT_NOREUSE);
+
+            inst->stat.ReadSectorCnt += NumSectors;
+            while(i < NumSectors)
+            {
+                U16 entry = hash_find(inst, SectorIndex + i);
+                U16 entry_l2 = (entry == ENTRY_NONE) ? l2_find(inst, SectorIndex + i) : ENTRY_NONE;
+
+                if(entry != ENTRY_NONE)
+                {
+                    U8 sector_type = inst->blocks[entry].Flags & SECTOR_TYPE_MASK;
+
+                    FS_MEMCPY(data + (i * inst->bytes_per_sector), get_sector_data(inst, entry), inst->bytes_per_sector);
+                    if(!is_bypassed(is_noreuse, sector_type))
+                    {
+                        touch_entry(inst, entry);
+                    }
+                    inst->stat.ReadSectorCachedCnt++;
+                    inst->stat.ReadSectorCntPerType[sector_type]++;
+                    inst->stat.ReadSectorCachedCntPerType[sector_type]++;
+                    i++;
+                }
+                else if(entry_l2 != ENTRY_NONE)
+                {
+                    U8 * sector_data = data + (i * inst->bytes_per_sector);
+                    U8   sector_type;
+
+                    FS_MEMCPY(sector_data, l2_get_sector_data(inst, entry_l2), inst->bytes_per_sector);
+                    sector_type = get_sector_type(inst, SectorIndex + i, sector_data);
+                    inst->stat.ReadSectorCachedCnt++;
+                    inst->stat.ReadSectorCachedL2Cnt++;
+                    inst->stat.ReadSectorCntPerType[sector_type]++;
+                    inst->stat.ReadSectorCachedCntPerType[sector_type]++;
+                    if(do_insert && !is_bypassed(is_noreuse, sector_type))
+                    {
+                        /* Promote to the first level. The sector is removed first
+                         * because the insertion can demote another sector. */
+                        l2_remove(inst, entry_l2);
+                        if(insert_sector(inst, SectorIndex + i, sector_data, sector_type) == ENTRY_NONE)
+                        {
+                            l2_store(inst, SectorIndex + i, sector_data);
+                        }
+                    }
+                    i++;
+                }
+                else
+                {
+                    U32 num_sectors_miss = 1U;
+
+                    while(((i + num_sectors_miss) < NumSectors) && (hash_find(inst, SectorIndex + i + num_sectors_miss) == ENTRY_NONE) &&
+                          (l2_find(inst, SectorIndex + i + num_sectors_miss) == ENTRY_NONE))
+                    {
+                        num_sectors_miss++;
+                    }
+                    r = inst->device_type->pfRead(inst->device_unit, SectorIndex + i, data + (i * inst->bytes_per_sector), num_sectors_miss);
+                    if(r != 0)
+                    {
+                        break;
+                    }
+                    for(U32 k = 0U; k < num_sectors_miss; k++)
+                    {
+                        U8 * sector_data = data + ((i + k) * inst->bytes_per_sector);
+                        U8   sector_type = get_sector_type(inst, SectorIndex + i + k, sector_data);
+
+                        inst->stat.ReadSectorCntPerType[sector_type]++;
+                        if(do_insert && !is_bypassed(is_noreuse, sector_type))
+                        {
+                            (void)insert_sector(inst, SectorIndex + i + k, sector_data, sector_type);
+                        }
+                    }
+                    i += num_sectors_miss;
+                }
+            }
+
+            if(inst->is_quota_auto)
+            {
+                inst->interval_reads += NumSectors;
+                if(inst->interval_reads >= ((U32)inst->num_blocks * FS_CACHE2Q_QUOTA_INTERVAL))
+                {
+                    rebalance_quotas(inst);
+                }
+            }
+            clean_if_required(inst);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_write
+*
+*  Function description
+*    Writes sectors to the storage device and updates the cache.
+*
+*  Additional information
+*    In write-back mode the sectors are only stored to the cache.
+*    Requests larger than the FIFO share of the cache and requests
+*    with the FS_ACCESS_HINT_NOREUSE hint are written through to the
+*    storage device.
+*/
+static int cache2q_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+    const U8 * data = (const U8 *)pBuffer;
+    bool is_noreuse = (FS_HINT_GetCurrent() == FS_ACCESS_HINT_NOREUSE);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        if(init_if_required(inst) != 0)
+        {
+            r = inst->device_type->pfWrite(inst->device_unit, SectorIndex, pBuffer, NumSectors, RepeatSame);
+        }
+        else if(((inst->mode & FS_CACHE_MODE_D) != 0U) && (NumSectors <= inst->max_in) && (!is_noreuse))
+        {
+            inst->stat.WriteSectorCnt += NumSectors;
+            l2_invalidate_range(inst, SectorIndex, NumSectors);
+            r = 0;
+            for(U32 i = 0U; i < NumSectors; i++)
+            {
+                U16 entry = hash_find(inst, SectorIndex + i);
+                const U8 * sector_data = (RepeatSame != 0U) ? data : (data + (i * inst->bytes_per_sector));
+                U8 sector_type = get_sector_type(inst, SectorIndex + i, sector_data);
+
+                if(entry != ENTRY_NONE)
+                {
+                    FS_MEMCPY(get_sector_data(inst, entry), sector_data, inst->bytes_per_sector);
+                    update_sector_type(inst, entry, sector_type);
+                    touch_entry(inst, entry);
+                }
+                else
+                {
+                    entry = insert_sector(inst, SectorIndex + i, sector_data, sector_type);
+                }
+
+                if(entry != ENTRY_NONE)
+                {
+                    mark_dirty(inst, entry);
+                    inst->stat.WriteSectorCachedCnt++;
+                }
+                else
+                {
+                    r = inst->device_type->pfWrite(inst->device_unit, SectorIndex + i, sector_data, 1U, 0U);
+                    if(r != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+            clean_if_required(inst);
+        }
+        else
+        {
+            inst->stat.WriteSectorCnt += NumSectors;
+            l2_invalidate_range(inst, SectorIndex, NumSectors);
+            r = inst->device_type->pfWrite(inst->device_unit, SectorIndex, pBuffer, NumSectors, RepeatSame);
+            if(r != 0)
+            {
+                /* The contents of the sectors on the storage device is unknown. */
+                invalidate_range(inst, SectorIndex, NumSectors);
+            }
+            else
+            {
+                bool do_insert = ((inst->mode & FS_CACHE_MODE_W) != 0U) && (NumSectors <= inst->max_in);
+
+                for(U32 i = 0U; i < NumSectors; i++)
+                {
+                    U16 entry = hash_find(inst, SectorIndex + i);
+                    const U8 * sector_data = (RepeatSame != 0U) ? data : (data + (i * inst->bytes_per_sector));
+                    U8 sector_type = get_sector_type(inst, SectorIndex + i, sector_data);
+
+                    if(entry != ENTRY_NONE)
+                    {
+                        if((inst->mode & FS_CACHE_MODE_W) != 0U)
+                        {
+                            FS_MEMCPY(get_sector_data(inst, entry), sector_data, inst->bytes_per_sector);
+                            update_sector_type(inst, entry, sector_type);
+                            touch_entry(inst, entry);
+                            clear_dirty(inst, entry);   /* Up to date on the storage device. */
+                        }
+                        else
+                        {
+                            invalidate_entry(inst, entry);
+                        }
+                    }
+                    else if(do_insert && !is_bypassed(is_noreuse, sector_type))
+                    {
+                        (void)insert_sector(inst, SectorIndex + i, sector_data, sector_type);
+                    }
+                    else
+                    {
+                        /* Not cached. */
+                    }
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_ioctl
+*/
+static int cache2q_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_SYNC:
+        case FS_CMD_CLEAN:
+            r = 0;
+            if(inst->is_inited && (clean_range(inst, 0U, SECTOR_INDEX_INVALID) != 0))
+            {
+                r = -1;
+            }
+            if(inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer) != 0)
+            {
+                r = -1;
+            }
+            break;
+        case FS_CMD_SYNC_SECTORS:
+            r = 0;
+            if(inst->is_inited && (pBuffer != NULL) && (clean_range(inst, (U32)Aux, *(U32 *)pBuffer) != 0))
+            {
+                r = -1;
+            }
+            if(inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer) != 0)
+            {
+                r = -1;
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+            if(inst->is_inited && (inst->num_dirty != 0U))
+            {
+                r = (clean_step(inst) != 0) ? -1 : 0;
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = 1;    /* The storage device can have work to do as well. */
+                }
+            }
+            else
+            {
+                r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            }
+            break;
+        case FS_CMD_GET_CLEAN_CNT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            if(inst->is_inited && (pBuffer != NULL))
+            {
+                if(r != 0)
+                {
+                    *(int *)pBuffer = 0;    /* Not supported by the storage device. */
+                    r = 0;
+                }
+                *(int *)pBuffer += (int)(((U32)inst->num_dirty + FS_CACHE2Q_CLEAN_BURST - 1U) / FS_CACHE2Q_CLEAN_BURST);
+            }
+            break;
+        case FS_CMD_UNMOUNT:
+            r = 0;
+            if(inst->is_inited && (clean_range(inst, 0U, SECTOR_INDEX_INVALID) != 0))
+            {
+                r = -1;             /* The modified sectors are kept so that the unmount can be retried. */
+            }
+            if(r == 0)
+            {
+                /* The storage medium can be replaced while unmounted. */
+                inst->is_inited = false;
+                r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+                r = (r != 0) ? -1 : 0;
+            }
+            break;
+        case FS_CMD_UNMOUNT_FORCED:
+            /* Modified sectors are discarded. */
+            inst->is_inited = false;
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if(inst->is_inited && (pBuffer != NULL))
+            {
+                invalidate_range(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(cache2q_inst_t));
+            if(cache2q_num_units != 0U)
+            {
+                cache2q_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_init_medium
+*/
+static int cache2q_init_medium(U8 Unit)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = 0;
+        if(inst->device_type->pfInitMedium != NULL)
+        {
+            r = inst->device_type->pfInitMedium(inst->device_unit);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_get_status
+*/
+static int cache2q_get_status(U8 Unit)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfGetStatus(inst->device_unit);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       cache2q_get_num_units
+*/
+static int cache2q_get_num_units(void)
+{
+    return (int)cache2q_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_CACHE2Q_Driver =
+{
+    cache2q_get_name,
+    cache2q_add_device,
+    cache2q_read,
+    cache2q_write,
+    cache2q_ioctl,
+    cache2q_init_medium,
+    cache2q_get_status,
+    cache2q_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*   pBuffer       Memory for the cached sectors. Use FS_SIZEOF_CACHE_2Q()
+*                 to calculate the size required for a number of sectors.
+*   NumBytes      Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Configured successfully.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters.
+*
+*  The cache operates in FS_CACHE_MODE_WT mode by default.
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_Configure(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (pBuffer != NULL))
+    {
+        U32 num_bytes_skip = (BUFFER_ALIGNMENT - ((U32)(uintptr_t)pBuffer % BUFFER_ALIGNMENT)) % BUFFER_ALIGNMENT;
+
+        if(NumBytes > num_bytes_skip)
+        {
+            FS_MEMSET(inst, 0, sizeof(cache2q_inst_t));
+            inst->device_type = pDeviceType;
+            inst->device_unit = DeviceUnit;
+            inst->mode        = FS_CACHE_MODE_WT;
+            inst->buffer      = (U8 *)pBuffer + num_bytes_skip;
+            inst->buffer_size = NumBytes - num_bytes_skip;
+            result = FS_CACHE2Q_RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_ConfigureL2
+****************************************************************************//**
+*
+*  Assigns memory to the second cache level. Has to be called after
+*  FS_CACHE2Q_Configure() and before the storage device is accessed.
+*
+*  Parameters
+*   Unit        Index of the driver instance (0-based).
+*   pBuffer     Memory for the second level, typically a memory-mapped
+*               external PSRAM. Use FS_SIZEOF_CACHE_2Q_L2() to calculate
+*               the size required for a number of sectors. NULL disables
+*               the second level.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Configured successfully.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters or modified sectors
+*                                 are still cached.
+*
+*  The buffer passed to FS_CACHE2Q_Configure() forms the first level.
+*  Sectors evicted from the first level are copied to the second level
+*  and moved back to the first level when they are read again, so a
+*  sector is stored in only one of the levels. The second level holds
+*  unmodified sectors only and its management information is stored
+*  in pBuffer as well, leaving the internal RAM to the first level.
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_ConfigureL2(U8 Unit, void * pBuffer, U32 NumBytes)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (inst->device_type != NULL) && (inst->num_dirty == 0U))
+    {
+        U32 num_bytes_skip = (BUFFER_ALIGNMENT - ((U32)(uintptr_t)pBuffer % BUFFER_ALIGNMENT)) % BUFFER_ALIGNMENT;
+
+        if(pBuffer == NULL)
+        {
+            inst->l2_buffer      = NULL;
+            inst->l2_buffer_size = 0U;
+            result = FS_CACHE2Q_RESULT_OK;
+        }
+        else if(NumBytes > num_bytes_skip)
+        {
+            inst->l2_buffer      = (U8 *)pBuffer + num_bytes_skip;
+            inst->l2_buffer_size = NumBytes - num_bytes_skip;
+            result = FS_CACHE2Q_RESULT_OK;
+        }
+        else
+        {
+            /* Buffer too small. */
+        }
+        inst->is_inited = false;    /* Calculate the layout of both levels again. */
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_SetMode
+****************************************************************************//**
+*
+*  Selects how write operations are handled by the cache.
+*
+*  Parameters
+*   Unit    Index of the driver instance (0-based).
+*   Mode    FS_CACHE_MODE_R   Written sectors are removed from the cache.
+*           FS_CACHE_MODE_WT  Written sectors are stored to the cache
+*                             and to the storage device.
+*           FS_CACHE_MODE_WB  Written sectors are stored to the cache and
+*                             written to the storage device later.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Mode set.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters or modified sectors
+*                                 are still cached.
+*
+*  In FS_CACHE_MODE_WB mode the modified sectors are written to the storage
+*  device when they are evicted, on FS_STORAGE_Sync() or FS_Unmount() and
+*  when the limits set via FS_CACHE2Q_SetWriteBackLimits() are exceeded.
+*  If they cannot be written on FS_Unmount() they remain cached and the
+*  unmount reports an error. FS_UnmountForced() discards them.
+*  The mode can be changed from FS_CACHE_MODE_WB only after all modified
+*  sectors were written, for example via FS_STORAGE_Sync().
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetMode(U8 Unit, U8 Mode)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && ((Mode == FS_CACHE_MODE_R) || (Mode == FS_CACHE_MODE_WT) || (Mode == FS_CACHE_MODE_WB)) &&
+       ((inst->num_dirty == 0U) || (Mode == FS_CACHE_MODE_WB)))
+    {
+        inst->mode = Mode;
+        result = FS_CACHE2Q_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_SetQuota
+****************************************************************************//**
+*
+*  Limits the number of cached sectors of the specified types. Works like
+*  FS_CACHE_SetQuota() for the FS_CacheRWQuota_Init() cache module.
+*
+*  Parameters
+*   Unit        Index of the driver instance (0-based).
+*   TypeMask    Sector types the quota applies to (FS_SECTOR_TYPE_MASK_...).
+*   NumSectors  Maximum number of sectors of each type in TypeMask.
+*               0 disables the caching of these sector types.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Quota set.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters.
+*
+*  Calling this function disables the automatic quotas. The types without
+*  a configured quota are not cached once any quota is set.
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetQuota(U8 Unit, int TypeMask, U32 NumSectors)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (((unsigned)TypeMask & ~FS_SECTOR_TYPE_MASK_ALL) == 0U))
+    {
+        for(U32 type = 0U; type < FS_SECTOR_TYPE_COUNT; type++)
+        {
+            if(((unsigned)TypeMask & (1UL << type)) != 0U)
+            {
+                inst->quota_config[type] = NumSectors;
+            }
+        }
+        inst->is_quota_enabled = true;
+        inst->is_quota_auto    = false;
+        if(inst->is_inited)
+        {
+            apply_quotas(inst);
+        }
+        result = FS_CACHE2Q_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_SetAutoQuota
+****************************************************************************//**
+*
+*  Enables or disables the automatic adjustment of the quotas.
+*
+*  Parameters
+*   Unit    Index of the driver instance (0-based).
+*   OnOff   1   The quotas are adjusted to the workload.
+*           0   No quotas are applied.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Mode set.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters.
+*
+*  In automatic mode the whole cache is split between the sector types.
+*  After every FS_CACHE2Q_QUOTA_INTERVAL sector reads per cache entry a
+*  part of the cache is moved to the type that missed most of its recently
+*  evicted sectors from the type that missed least. The current split can
+*  be queried via FS_CACHE2Q_GetQuota().
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetAutoQuota(U8 Unit, U8 OnOff)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        inst->is_quota_auto    = (OnOff != 0U);
+        inst->is_quota_enabled = (OnOff != 0U);
+        if(inst->is_inited)
+        {
+            apply_quotas(inst);
+        }
+        result = FS_CACHE2Q_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_CACHE2Q_SetWriteBackLimits
+****************************************************************************//**
+*
+*  Limits the time and the number of sectors that are modified only in
+*  the cache in FS_CACHE_MODE_WB mode.
+*
+*  Parameters
+*   Unit            Index of the driver instance (0-based).
+*   MaxDirtyAgeMs   Maximum time in milliseconds a modified sector is
+*                   kept only in the cache. 0 disables the limit.
+*   MaxNumDirty     Maximum number of modified sectors in the cache.
+*                   0 disables the limit.
+*
+*  Return Value
+*   FS_CACHE2Q_RESULT_OK          Limits set.
+*   FS_CACHE2Q_RESULT_BADPARAM    Invalid parameters.
+*
+*  When a limit is exceeded each access to the driver writes up to
+*  FS_CACHE2Q_CLEAN_BURST modified sectors in ascending sector order.
+*  This spreads the writing over several accesses instead of one long
+*  flush. To clean the cache while the file system is idle, a low
+*  priority task can call FS_STORAGE_CleanOne() periodically; the age
+*  limit is kept as long as this happens more often than MaxDirtyAgeMs.
+*
+*  The age limit requires FS_X_OS_GetTime() to return the system time
+*  which is the case only with COMPONENT_RTOS_AWARE.
+*
+*******************************************************************************/
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetWriteBackLimits(U8 Unit, U32 MaxDirtyAgeMs, U32 MaxNumDirty)
+{
+    FS_CACHE2Q_Result_t result = FS_CACHE2Q_RESULT_BADPARAM;
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        inst->max_dirty_age_ms = MaxDirtyAgeMs;
+        inst->max_num_dirty    = MaxNumDirty;
+        if(inst->is_inited)
+        {
+            update_oldest_dirty(inst);
+        }
+        result = FS_CACHE2Q_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_CACHE2Q_GetQuota
+*
+*  Function description
+*    Returns the quotas currently applied.
+*
+*  Parameters
+*    Unit         Index of the driver instance (0-based).
+*    pNumSectors  [OUT] Maximum number of sectors per sector type.
+*                 Array of FS_SECTOR_TYPE_COUNT elements indexed by
+*                 FS_SECTOR_TYPE_DATA, FS_SECTOR_TYPE_DIR and FS_SECTOR_TYPE_MAN.
+*
+*  Additional information
+*    The quotas are calculated when the storage device is accessed
+*    for the first time. All values are 0 before that or if no quotas
+*    are enabled.
+*/
+void FS_CACHE2Q_GetQuota(U8 Unit, U32 * pNumSectors)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pNumSectors != NULL))
+    {
+        for(U32 type = 0U; type < FS_SECTOR_TYPE_COUNT; type++)
+        {
+            pNumSectors[type] = (inst->is_inited && inst->is_quota_enabled) ? inst->quota[type] : 0U;
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       FS_CACHE2Q_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_CACHE2Q_GetStatCounters(U8 Unit, FS_CACHE2Q_STAT_COUNTERS * pStat)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_CACHE2Q_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_CACHE2Q_ResetStatCounters(U8 Unit)
+{
+    cache2q_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,167 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_CACHE2Q.h
+Purpose     : Logical driver that caches sectors using the 2Q replacement policy.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_CACHE2Q_H     // Avoid recursive and multiple inclusion
+#define FS_CACHE2Q_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_CACHE2Q_NUM_UNITS
+#define FS_CACHE2Q_NUM_UNITS            (2U)    /* Maximum number of driver instances. */
+#endif
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+/* Management information of a cached sector. FS internal structure. */
+typedef struct
+{
+    U32 SectorIndex;        /* Index of the cached sector. */
+    U32 GhostSectorIndex;   /* Entry of the history of recently evicted sectors. */
+    U16 HashHead;           /* First entry of the hash bucket with the same index. */
+    U16 HashNext;           /* Next entry in the same hash bucket. */
+    U16 ListPrev;           /* Previous entry in the replacement list. */
+    U16 ListNext;           /* Next entry in the replacement list. */
+    U32 TimeDirty;          /* Time in milliseconds when the sector was modified in write-back mode. */
+    U8  List;               /* Replacement list the entry is linked in. */
+    U8  Flags;              /* Sector type and state of the cached sector. */
+} FS_CACHE2Q_BLOCK_INFO;
+
+/* Management information of a sector in the second cache level. FS internal structure. */
+typedef struct
+{
+    U32 SectorIndex;        /* Index of the cached sector. */
+    U16 HashHead;           /* First entry of the hash bucket with the same index. */
+    U16 HashNext;           /* Next entry in the same hash bucket. */
+    U16 ListPrev;           /* Previous entry in the replacement list. */
+    U16 ListNext;           /* Next entry in the replacement list. */
+} FS_CACHE2Q_L2_BLOCK_INFO;
+
+typedef struct
+{
+    U32 ReadSectorCnt;          /* Number of sectors requested by the file system. */
+    U32 ReadSectorCachedCnt;    /* Number of sectors served from the cache. */
+    U32 WriteSectorCnt;         /* Number of sectors written by the file system. */
+    U32 GhostHitCnt;            /* Number of misses on recently evicted sectors (promoted to the hot list). */
+    U32 ReadSectorCntPerType[FS_SECTOR_TYPE_COUNT];         /* ReadSectorCnt split by sector type (FS_SECTOR_TYPE_...). */
+    U32 ReadSectorCachedCntPerType[FS_SECTOR_TYPE_COUNT];   /* ReadSectorCachedCnt split by sector type (FS_SECTOR_TYPE_...). */
+    U32 QuotaChangeCnt;         /* Number of times the quotas were adjusted in automatic mode. */
+    U32 WriteSectorCachedCnt;   /* Number of written sectors stored only to the cache (write-back mode). */
+    U32 CleanSectorCnt;         /* Number of modified sectors written from the cache to the storage device. */
+    U32 ReadSectorCachedL2Cnt;  /* Number of sectors served from the second cache level (included in ReadSectorCachedCnt). */
+    U32 DemoteSectorCnt;        /* Number of sectors moved to the second cache level on eviction. */
+} FS_CACHE2Q_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_CACHE2Q_RESULT_OK = 0U,
+    FS_CACHE2Q_RESULT_BADPARAM,
+} FS_CACHE2Q_Result_t;
+
+/*********************************************************************
+*
+*       Cache size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_CACHE2Q_Configure()
+*    in order to cache NumSectors sectors of SectorSize bytes.
+*/
+#define FS_SIZEOF_CACHE_2Q_BLOCK_INFO               sizeof(FS_CACHE2Q_BLOCK_INFO)
+#define FS_SIZEOF_CACHE_2Q(NumSectors, SectorSize)  ((FS_SIZEOF_CACHE_2Q_BLOCK_INFO + (SectorSize)) * (NumSectors))
+
+/*********************************************************************
+*
+*       Second level cache size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_CACHE2Q_ConfigureL2()
+*    in order to cache NumSectors sectors of SectorSize bytes.
+*/
+#define FS_SIZEOF_CACHE_2Q_L2_BLOCK_INFO                sizeof(FS_CACHE2Q_L2_BLOCK_INFO)
+#define FS_SIZEOF_CACHE_2Q_L2(NumSectors, SectorSize)   ((FS_SIZEOF_CACHE_2Q_L2_BLOCK_INFO + (SectorSize)) * (NumSectors))
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_CACHE2Q_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_CACHE2Q_Result_t FS_CACHE2Q_Configure          (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes);
+FS_CACHE2Q_Result_t FS_CACHE2Q_ConfigureL2        (U8 Unit, void * pBuffer, U32 NumBytes);
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetMode            (U8 Unit, U8 Mode);
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetQuota           (U8 Unit, int TypeMask, U32 NumSectors);
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetAutoQuota       (U8 Unit, U8 OnOff);
+FS_CACHE2Q_Result_t FS_CACHE2Q_SetWriteBackLimits (U8 Unit, U32 MaxDirtyAgeMs, U32 MaxNumDirty);
+void                FS_CACHE2Q_GetQuota           (U8 Unit, U32 * pNumSectors);
+void                FS_CACHE2Q_GetStatCounters    (U8 Unit, FS_CACHE2Q_STAT_COUNTERS * pStat);
+void                FS_CACHE2Q_ResetStatCounters  (U8 Unit);
+
+#endif  // FS_CACHE2Q_H
+
+/*************************** End of file ****************************/
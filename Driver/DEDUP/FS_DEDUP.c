@@ -0,0 +1,1209 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_DEDUP.c
+Purpose     : Logical driver that stores identical sectors only once.
+              Firmware images and configuration snapshots contain many
+              identical sectors, for example padding. This driver maps
+              each sector of the volume to a sector on the storage
+              device via a map stored on the storage device. A written
+              sector that matches a sector already stored is mapped to
+              it instead of being programmed again, and sectors filled
+              with 0x00 or 0xFF are not stored at all. The stored sectors
+              are found via a hash index in RAM; a match of the hash
+              value is confirmed by comparing the stored data. The number
+              of references to each stored sector is calculated from the
+              map when the storage device is mounted, and a stored sector
+              no longer referenced is released to the storage device.
+              Copying a file is particularly efficient because the
+              sectors read are added to the index, so that writing them
+              again only updates the map.
+              The map is written at the end of each write request, after
+              the data, and a stored sector is reused only after the map
+              that referred to it has been written, so that the data
+              remains consistent after a power loss.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_DEDUP.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define HEADER_MAGIC                    (0x50554444UL)  /* "DDUP" */
+#define HEADER_OFF_MAGIC                (0U)
+#define HEADER_OFF_NUM_SECTORS          (4U)
+#define HEADER_OFF_NUM_STORED           (8U)
+#define HEADER_OFF_CHECK                (12U)
+#define ENTRY_FILL_00                   (0xFFFEU)       /* Sector filled with 0x00. */
+#define ENTRY_FILL_FF                   (0xFFFFU)       /* Sector filled with 0xFF or never written. */
+#define ENTRY_NONE                      (0xFFF0U)       /* No stored sector. */
+#define NEXT_END                        (0xFFFFU)       /* Last stored sector in a hash bucket. */
+#define NEXT_NOT_INDEXED                (0xFFFEU)       /* Stored sector not in the hash index. */
+#define REF_MAX                         (0xFFFFU)       /* A stored sector with as many references is not shared anymore. */
+#define MAP_SECTOR_NONE                 (0xFFFFFFFFUL)
+#define FNV_OFFSET                      (0x811C9DC5UL)
+#define FNV_PRIME                       (0x01000193UL)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    const FS_DEVICE_TYPE  * device_type;
+    U8                      device_unit;
+    bool                    is_inited;          /* Set when the map has been scanned. */
+    U8                    * buffer;
+    U32                     buffer_size;
+    U32                     num_sectors_config; /* Number of sectors of the volume. 0 for the number of stored sectors. */
+    U16                     bytes_per_sector;
+    U32                     num_sectors;        /* Number of sectors of the volume. */
+    U32                     num_stored;         /* Number of sectors available for the data on the storage device. */
+    U32                     num_sectors_map;
+    U32                     stored_start;       /* Index of the first data sector on the storage device. */
+    U32                     entries_per_sector;
+    U8                    * work_data;          /* Sector read to confirm a match. */
+    U8                    * map_data;           /* Cached sector of the map. */
+    U32                     map_sector;         /* Index of the cached sector of the map or MAP_SECTOR_NONE. */
+    bool                    is_map_dirty;
+    U16                   * released;           /* Stored sectors referred to by the cached map sector before it was changed. */
+    U32                     num_released;
+    U16                   * refs;               /* Number of references to each stored sector. */
+    U16                   * tags;               /* Upper half of the hash value of each stored sector. */
+    U16                   * next;               /* Next stored sector in the same hash bucket, NEXT_END or NEXT_NOT_INDEXED. */
+    U16                   * buckets;
+    U32                     bucket_mask;
+    U32                     alloc_cursor;       /* Stored sector at which the search for a free one starts. */
+    U32                     index_cursor;       /* Stored sector at which the search for one not indexed starts. */
+    U32                     num_not_indexed;    /* Number of referenced stored sectors not in the hash index. */
+    FS_DEDUP_STAT_COUNTERS  stat;
+} dedup_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static dedup_inst_t dedup_inst[FS_DEDUP_NUM_UNITS];
+static U8           dedup_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static dedup_inst_t * get_inst(U8 unit)
+{
+    dedup_inst_t * inst = NULL;
+
+    if(unit < FS_DEDUP_NUM_UNITS)
+    {
+        inst = &dedup_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       load_u16 / store_u16 / load_u32 / store_u32
+*/
+static U16 load_u16(const U8 * data)
+{
+    return (U16)((U32)data[0] | ((U32)data[1] << 8));
+}
+
+static void store_u16(U8 * data, U16 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+}
+
+static U32 load_u32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+static void store_u32(U8 * data, U32 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+    data[2] = (U8)(value >> 16);
+    data[3] = (U8)(value >> 24);
+}
+
+/*********************************************************************
+*
+*       calc_hash
+*
+*  Function description
+*    Calculates the FNV-1a hash value of a sector.
+*/
+static U32 calc_hash(const U8 * data, U32 num_bytes)
+{
+    U32 hash = FNV_OFFSET;
+
+    for(U32 i = 0U; i < num_bytes; i++)
+    {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/*********************************************************************
+*
+*       is_filled
+*
+*  Function description
+*    Checks if all the bytes of a sector have the same value.
+*/
+static bool is_filled(const U8 * data, U32 num_bytes, U8 value)
+{
+    U32 i = 0U;
+
+    while((i < num_bytes) && (data[i] == value))
+    {
+        i++;
+    }
+
+    return i == num_bytes;
+}
+
+/*********************************************************************
+*
+*       calc_header_check
+*/
+static U32 calc_header_check(const U8 * data)
+{
+    return ~(HEADER_MAGIC ^ load_u32(data + HEADER_OFF_NUM_SECTORS) ^ load_u32(data + HEADER_OFF_NUM_STORED));
+}
+
+/*********************************************************************
+*
+*       add_to_index / remove_from_index
+*
+*  Additional information
+*    The bucket is selected by the tag so that it is known when the
+*    stored sector has to be removed from the index.
+*/
+static void add_to_index(dedup_inst_t * inst, U16 stored, U32 hash)
+{
+    U16 tag = (U16)(hash >> 16);
+    U16 * head = &inst->buckets[tag & inst->bucket_mask];
+
+    inst->tags[stored] = tag;
+    inst->next[stored] = *head;
+    *head = stored;
+}
+
+static void remove_from_index(dedup_inst_t * inst, U16 stored)
+{
+    if(inst->next[stored] != NEXT_NOT_INDEXED)
+    {
+        U16 * link = &inst->buckets[inst->tags[stored] & inst->bucket_mask];
+
+        while(*link != stored)
+        {
+            link = &inst->next[*link];
+        }
+        *link = inst->next[stored];
+        inst->next[stored] = NEXT_NOT_INDEXED;
+    }
+}
+
+/*********************************************************************
+*
+*       index_sector
+*
+*  Function description
+*    Adds a referenced stored sector to the hash index.
+*/
+static void index_sector(dedup_inst_t * inst, U16 stored, const U8 * data)
+{
+    if((inst->next[stored] == NEXT_NOT_INDEXED) && (inst->refs[stored] != 0U))
+    {
+        inst->num_not_indexed--;
+        add_to_index(inst, stored, calc_hash(data, inst->bytes_per_sector));
+    }
+}
+
+/*********************************************************************
+*
+*       release_sector
+*
+*  Function description
+*    Removes a reference to a stored sector.
+*
+*  Additional information
+*    A stored sector no longer referenced is reported to the storage
+*    device as free so that it does not have to be copied when the
+*    storage device reorganizes its data.
+*/
+static void release_sector(dedup_inst_t * inst, U16 stored)
+{
+    inst->refs[stored]--;
+    if(inst->refs[stored] == 0U)
+    {
+        U32 num_sectors = 1U;
+
+        if(inst->next[stored] == NEXT_NOT_INDEXED)
+        {
+            inst->num_not_indexed--;
+        }
+        remove_from_index(inst, stored);
+        (void) inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_FREE_SECTORS,
+                                          (I32)(inst->stored_start + stored), &num_sectors);
+    }
+}
+
+/*********************************************************************
+*
+*       flush_map
+*
+*  Function description
+*    Writes the cached map sector if it was changed and releases the
+*    stored sectors it referred to before.
+*/
+static int flush_map(dedup_inst_t * inst)
+{
+    int r = 0;
+
+    if(inst->is_map_dirty)
+    {
+        r = inst->device_type->pfWrite(inst->device_unit, 1U + inst->map_sector, inst->map_data, 1U, 0U);
+        inst->stat.WriteMapCnt++;
+        if(r != 0)
+        {
+            inst->is_inited = false;    /* The references are counted again from the map stored on the storage device. */
+        }
+        else
+        {
+            inst->is_map_dirty = false;
+            for(U32 i = 0U; i < inst->num_released; i++)
+            {
+                release_sector(inst, inst->released[i]);
+            }
+            inst->num_released = 0U;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       load_map_sector
+*
+*  Function description
+*    Makes the map sector that contains the entry of a sector of the
+*    volume available in map_data.
+*/
+static int load_map_sector(dedup_inst_t * inst, U32 sector_index)
+{
+    U32 map_sector = sector_index / inst->entries_per_sector;
+    int r = 0;
+
+    if(map_sector != inst->map_sector)
+    {
+        r = flush_map(inst);
+        if(r == 0)
+        {
+            inst->map_sector = MAP_SECTOR_NONE;
+            r = inst->device_type->pfRead(inst->device_unit, 1U + map_sector, inst->map_data, 1U);
+            if(r == 0)
+            {
+                inst->map_sector = map_sector;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_entry / set_entry
+*/
+static U16 get_entry(const dedup_inst_t * inst, U32 sector_index)
+{
+    return load_u16(inst->map_data + ((sector_index % inst->entries_per_sector) * 2U));
+}
+
+static void set_entry(dedup_inst_t * inst, U32 sector_index, U16 entry)
+{
+    U16 entry_old = get_entry(inst, sector_index);
+
+    if(entry_old < ENTRY_NONE)
+    {
+        inst->released[inst->num_released] = entry_old;     /* Released after the map has been written. */
+        inst->num_released++;
+    }
+    store_u16(inst->map_data + ((sector_index % inst->entries_per_sector) * 2U), entry);
+    inst->is_map_dirty = true;
+}
+
+/*********************************************************************
+*
+*       format
+*
+*  Function description
+*    Initializes the map on a storage device that holds no valid header.
+*/
+static int format(dedup_inst_t * inst)
+{
+    int r;
+
+    FS_MEMSET(inst->work_data, 0xFF, inst->bytes_per_sector);
+    r = inst->device_type->pfWrite(inst->device_unit, 1U, inst->work_data, inst->num_sectors_map, 1U);
+    if(r == 0)
+    {
+        FS_MEMSET(inst->work_data, 0, inst->bytes_per_sector);
+        store_u32(inst->work_data + HEADER_OFF_MAGIC,       HEADER_MAGIC);
+        store_u32(inst->work_data + HEADER_OFF_NUM_SECTORS, inst->num_sectors);
+        store_u32(inst->work_data + HEADER_OFF_NUM_STORED,  inst->num_stored);
+        store_u32(inst->work_data + HEADER_OFF_CHECK,       calc_header_check(inst->work_data));
+        r = inst->device_type->pfWrite(inst->device_unit, 0U, inst->work_data, 1U, 0U);   /* Written last. */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       scan_map
+*
+*  Function description
+*    Counts the references to the stored sectors.
+*/
+static int scan_map(dedup_inst_t * inst)
+{
+    int r = 0;
+
+    FS_MEMSET(inst->refs, 0, inst->num_stored * sizeof(U16));
+    for(U32 stored = 0U; stored < inst->num_stored; stored++)
+    {
+        inst->next[stored] = NEXT_NOT_INDEXED;
+    }
+    FS_MEMSET(inst->buckets, 0xFF, (inst->bucket_mask + 1U) * sizeof(U16));
+    inst->num_not_indexed = 0U;
+    for(U32 sector_index = 0U; (r == 0) && (sector_index < inst->num_sectors); sector_index++)
+    {
+        r = load_map_sector(inst, sector_index);
+        if(r == 0)
+        {
+            U16 entry = get_entry(inst, sector_index);
+
+            if((entry >= inst->num_stored) && (entry < ENTRY_FILL_00))
+            {
+                r = 1;                  /* Invalid map. */
+            }
+            else if((entry < inst->num_stored) && (inst->refs[entry] < REF_MAX))
+            {
+                if(inst->refs[entry] == 0U)
+                {
+                    inst->num_not_indexed++;
+                }
+                inst->refs[entry]++;
+            }
+            else
+            {
+                /* Not stored. */
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, map scanned.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    Layout of the storage device: header sector, map with 2 bytes per
+*    sector of the volume, stored sectors. Buffer layout: work sector,
+*    map sector, released sectors, references, tags, hash links, hash
+*    buckets.
+*/
+static int init_if_required(dedup_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info;
+
+        r = 1;
+        FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+        if((inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info) == 0) &&
+           (dev_info.BytesPerSector >= 16U) && (dev_info.NumSectors > 2U))
+        {
+            U32 bytes_per_sector = dev_info.BytesPerSector;
+            U32 num_sectors = inst->num_sectors_config;
+            U32 num_sectors_map;
+            U32 num_stored;
+            U32 num_buckets = 1U;
+
+            if(num_sectors == 0U)
+            {
+                /* As many sectors as can be stored. */
+                num_sectors = ((dev_info.NumSectors - 1U) * bytes_per_sector) / (bytes_per_sector + 2U);
+            }
+            num_sectors_map = ((num_sectors * 2U) + bytes_per_sector - 1U) / bytes_per_sector;
+            num_stored = (dev_info.NumSectors > (num_sectors_map + 1U)) ? (dev_info.NumSectors - num_sectors_map - 1U) : 0U;
+            if(num_stored > FS_DEDUP_MAX_NUM_SECTORS)
+            {
+                num_stored = FS_DEDUP_MAX_NUM_SECTORS;
+            }
+            while((num_buckets * 4U) < num_stored)
+            {
+                num_buckets <<= 1;
+            }
+            if((num_stored != 0U) &&
+               (inst->buffer_size >= ((3U * bytes_per_sector) + (num_stored * 6U) + (num_buckets * 2U))))
+            {
+                U8 * p = inst->buffer;
+
+                inst->bytes_per_sector   = (U16)bytes_per_sector;
+                inst->num_sectors        = num_sectors;
+                inst->num_stored         = num_stored;
+                inst->num_sectors_map    = num_sectors_map;
+                inst->stored_start       = 1U + num_sectors_map;
+                inst->entries_per_sector = bytes_per_sector / 2U;
+                inst->bucket_mask        = num_buckets - 1U;
+                inst->work_data = p;
+                p += bytes_per_sector;
+                inst->map_data = p;
+                p += bytes_per_sector;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->released = (U16 *)p;
+                p += bytes_per_sector;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->refs = (U16 *)p;
+                p += num_stored * 2U;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->tags = (U16 *)p;
+                p += num_stored * 2U;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->next = (U16 *)p;
+                p += num_stored * 2U;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->buckets = (U16 *)p;
+                inst->map_sector   = MAP_SECTOR_NONE;
+                inst->is_map_dirty = false;
+                inst->num_released = 0U;
+                inst->alloc_cursor = 0U;
+                inst->index_cursor = 0U;
+                r = inst->device_type->pfRead(inst->device_unit, 0U, inst->work_data, 1U);
+                if(r == 0)
+                {
+                    if((load_u32(inst->work_data + HEADER_OFF_MAGIC) != HEADER_MAGIC) ||
+                       (load_u32(inst->work_data + HEADER_OFF_CHECK) != calc_header_check(inst->work_data)))
+                    {
+                        r = format(inst);
+                    }
+                    else if((load_u32(inst->work_data + HEADER_OFF_NUM_SECTORS) != num_sectors) ||
+                            (load_u32(inst->work_data + HEADER_OFF_NUM_STORED) != num_stored))
+                    {
+                        r = 1;          /* Formatted with a different configuration. */
+                    }
+                    else
+                    {
+                        /* Valid map. */
+                    }
+                }
+                if(r == 0)
+                {
+                    r = scan_map(inst);
+                }
+                inst->is_inited = (r == 0);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_match
+*
+*  Function description
+*    Searches the index for a stored sector with the same data.
+*
+*  Return value
+*    Index of the stored sector or ENTRY_NONE.
+*/
+static U16 find_match(dedup_inst_t * inst, const U8 * data, U32 hash)
+{
+    U16 tag = (U16)(hash >> 16);
+    U16 stored = inst->buckets[tag & inst->bucket_mask];
+
+    while(stored != NEXT_END)
+    {
+        if((inst->tags[stored] == tag) && (inst->refs[stored] < REF_MAX))
+        {
+            inst->stat.CompareCnt++;
+            if((inst->device_type->pfRead(inst->device_unit, inst->stored_start + stored, inst->work_data, 1U) == 0) &&
+               (FS_MEMCMP(inst->work_data, data, inst->bytes_per_sector) == 0))
+            {
+                break;
+            }
+        }
+        stored = inst->next[stored];
+    }
+
+    return (stored == NEXT_END) ? (U16)ENTRY_NONE : stored;
+}
+
+/*********************************************************************
+*
+*       alloc_sector
+*
+*  Return value
+*    Index of a stored sector without references or ENTRY_NONE.
+*/
+static U16 alloc_sector(dedup_inst_t * inst)
+{
+    U16 stored = ENTRY_NONE;
+
+    for(U32 i = 0U; i < inst->num_stored; i++)
+    {
+        U32 index = (inst->alloc_cursor + i) % inst->num_stored;
+
+        if(inst->refs[index] == 0U)
+        {
+            stored = (U16)index;
+            inst->alloc_cursor = (index + 1U) % inst->num_stored;
+            break;
+        }
+    }
+
+    return stored;
+}
+
+/*********************************************************************
+*
+*       write_sector
+*
+*  Function description
+*    Stores the data of one sector of the volume and updates its entry
+*    in the cached map sector.
+*/
+static int write_sector(dedup_inst_t * inst, U32 sector_index, const U8 * data)
+{
+    U32 bytes_per_sector = inst->bytes_per_sector;
+    U16 entry;
+    int r = 0;
+
+    if(is_filled(data, bytes_per_sector, 0xFFU))
+    {
+        entry = ENTRY_FILL_FF;
+        inst->stat.WriteSectorFillCnt++;
+    }
+    else if(is_filled(data, bytes_per_sector, 0x00U))
+    {
+        entry = ENTRY_FILL_00;
+        inst->stat.WriteSectorFillCnt++;
+    }
+    else
+    {
+        U32 hash = calc_hash(data, bytes_per_sector);
+
+        entry = find_match(inst, data, hash);
+        if(entry != ENTRY_NONE)
+        {
+            inst->stat.WriteSectorDupCnt++;
+        }
+        else
+        {
+            entry = alloc_sector(inst);
+            if(entry == ENTRY_NONE)
+            {
+                r = 1;                  /* Storage device full. */
+            }
+            else
+            {
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by the storage device driver');
+                r = inst->device_type->pfWrite(inst->device_unit, inst->stored_start + entry, (void *)data, 1U, 0U);
+                inst->stat.WriteSectorDeviceCnt++;
+                if(r == 0)
+                {
+                    add_to_index(inst, entry, hash);
+                }
+            }
+        }
+    }
+    if(r == 0)
+    {
+        r = load_map_sector(inst, sector_index);
+    }
+    if(r == 0)
+    {
+        if(get_entry(inst, sector_index) == entry)
+        {
+            /* Unchanged. */
+        }
+        else
+        {
+            if(entry < ENTRY_NONE)
+            {
+                inst->refs[entry]++;
+            }
+            set_entry(inst, sector_index, entry);
+        }
+    }
+    else if((entry < ENTRY_NONE) && (inst->refs[entry] == 0U))
+    {
+        remove_from_index(inst, entry); /* Stored sector allocated by this call. */
+    }
+    else
+    {
+        /* Nothing to undo. */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       read_sectors
+*
+*  Function description
+*    Reads sectors of the volume. Consecutive stored sectors are read
+*    with one request and added to the index.
+*/
+static int read_sectors(dedup_inst_t * inst, U32 sector_index, U8 * data, U32 num_sectors)
+{
+    U32 bytes_per_sector = inst->bytes_per_sector;
+    int r = 0;
+
+    while((r == 0) && (num_sectors != 0U))
+    {
+        U16 entry;
+
+        r = load_map_sector(inst, sector_index);
+        if(r == 0)
+        {
+            entry = get_entry(inst, sector_index);
+            if(entry >= ENTRY_NONE)
+            {
+                FS_MEMSET(data, (entry == ENTRY_FILL_00) ? 0x00 : 0xFF, bytes_per_sector);
+                sector_index++;
+                num_sectors--;
+                data += bytes_per_sector;
+            }
+            else
+            {
+                U32 num_sectors_run = 1U;
+
+                while((num_sectors_run < num_sectors) &&
+                      (((sector_index + num_sectors_run) % inst->entries_per_sector) != 0U) &&
+                      (get_entry(inst, sector_index + num_sectors_run) == (entry + num_sectors_run)))
+                {
+                    num_sectors_run++;
+                }
+                r = inst->device_type->pfRead(inst->device_unit, inst->stored_start + entry, data, num_sectors_run);
+                if(r == 0)
+                {
+                    for(U32 i = 0U; i < num_sectors_run; i++)
+                    {
+                        index_sector(inst, (U16)(entry + i), data);
+                        data += bytes_per_sector;
+                    }
+                    sector_index += num_sectors_run;
+                    num_sectors  -= num_sectors_run;
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       index_step
+*
+*  Function description
+*    Adds stored sectors that were referenced when the storage device
+*    was mounted to the index.
+*/
+static int index_step(dedup_inst_t * inst)
+{
+    U32 num_sectors = FS_DEDUP_INDEX_SECTORS;
+    int r = 0;
+
+    while((r == 0) && (num_sectors != 0U) && (inst->num_not_indexed != 0U))
+    {
+        U32 stored = inst->index_cursor;
+
+        if((inst->refs[stored] != 0U) && (inst->next[stored] == NEXT_NOT_INDEXED))
+        {
+            r = inst->device_type->pfRead(inst->device_unit, inst->stored_start + stored, inst->work_data, 1U);
+            if(r == 0)
+            {
+                index_sector(inst, (U16)stored, inst->work_data);
+            }
+            num_sectors--;
+        }
+        if(r == 0)
+        {
+            inst->index_cursor = (stored + 1U) % inst->num_stored;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       free_sectors
+*
+*  Function description
+*    Maps sectors no longer used by the file system to the 0xFF pattern
+*    so that the stored sectors can be released.
+*/
+static int free_sectors(dedup_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    int r = 0;
+
+    while((r == 0) && (num_sectors != 0U))
+    {
+        r = load_map_sector(inst, sector_index);
+        if((r == 0) && (get_entry(inst, sector_index) != ENTRY_FILL_FF))
+        {
+            set_entry(inst, sector_index, ENTRY_FILL_FF);
+        }
+        sector_index++;
+        num_sectors--;
+    }
+    if(r == 0)
+    {
+        r = flush_map(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       is_range_valid
+*/
+static bool is_range_valid(const dedup_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    return (sector_index < inst->num_sectors) && (num_sectors <= (inst->num_sectors - sector_index));
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 12,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       dedup_get_name
+*/
+static const char * dedup_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "dedup";
+}
+
+/*********************************************************************
+*
+*       dedup_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int dedup_add_device(void)
+{
+    int r = -1;
+
+    if(dedup_num_units < FS_DEDUP_NUM_UNITS)
+    {
+        r = (int)dedup_num_units;
+        dedup_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_read
+*/
+static int dedup_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL) && (init_if_required(inst) == 0) &&
+       is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        inst->stat.ReadSectorCnt += NumSectors;
+        r = read_sectors(inst, SectorIndex, (U8 *)pBuffer, NumSectors);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_write
+*
+*  Additional information
+*    The map is written once per map sector changed by the request.
+*/
+static int dedup_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL) && (init_if_required(inst) == 0) &&
+       is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        const U8 * data = (const U8 *)pBuffer;
+        int r_flush;
+
+        r = 0;
+        inst->stat.WriteSectorCnt += NumSectors;
+        for(U32 i = 0U; (r == 0) && (i < NumSectors); i++)
+        {
+            r = write_sector(inst, SectorIndex + i, data);
+            if(RepeatSame == 0U)
+            {
+                data += inst->bytes_per_sector;
+            }
+        }
+        r_flush = flush_map(inst);
+        if(r == 0)
+        {
+            r = r_flush;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_ioctl
+*/
+static int dedup_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_GET_DEVINFO:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+                if(r == 0)
+                {
+                    FS_DEV_INFO * dev_info = (FS_DEV_INFO *)pBuffer;
+
+                    dev_info->NumSectors = inst->num_sectors;
+                }
+            }
+            break;
+        case FS_CMD_UNMOUNT:
+        case FS_CMD_UNMOUNT_FORCED:
+            /* The storage medium can be replaced while unmounted. */
+            inst->is_inited = false;
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        case FS_CMD_FREE_SECTORS:
+            r = 0;
+            if((pBuffer != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, (U32)Aux, *(U32 *)pBuffer))
+            {
+                r = free_sectors(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+        case FS_CMD_GET_CLEAN_CNT:
+            {
+                int value = 0;
+                int value_index = 0;
+
+                r = 0;
+                if(init_if_required(inst) == 0)
+                {
+                    if((Cmd == FS_CMD_CLEAN_ONE) && (inst->num_not_indexed != 0U))
+                    {
+                        r = (index_step(inst) == 0) ? 0 : -1;
+                    }
+                    value_index = (int)((inst->num_not_indexed + FS_DEDUP_INDEX_SECTORS - 1U) / FS_DEDUP_INDEX_SECTORS);
+                }
+                if(inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, &value) != 0)
+                {
+                    r = -1;
+                }
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = (Cmd == FS_CMD_CLEAN_ONE) ? (value | ((value_index != 0) ? 1 : 0)) : (value + value_index);
+                }
+            }
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(dedup_inst_t));
+            if(dedup_num_units != 0U)
+            {
+                dedup_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_init_medium
+*/
+static int dedup_init_medium(U8 Unit)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = 0;
+        if(inst->device_type->pfInitMedium != NULL)
+        {
+            r = inst->device_type->pfInitMedium(inst->device_unit);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_get_status
+*/
+static int dedup_get_status(U8 Unit)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfGetStatus(inst->device_unit);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       dedup_get_num_units
+*/
+static int dedup_get_num_units(void)
+{
+    return (int)dedup_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_DEDUP_Driver =
+{
+    dedup_get_name,
+    dedup_add_device,
+    dedup_read,
+    dedup_write,
+    dedup_ioctl,
+    dedup_init_medium,
+    dedup_get_status,
+    dedup_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_DEDUP_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver, for example FS_NOR_BM_Driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*   NumSectors    Number of sectors of the volume. 0 to use the number of
+*                 sectors that can be stored. A larger value allows more
+*                 data to be written if it contains duplicates.
+*   pBuffer       Memory for the index and the references. Use
+*                 FS_SIZEOF_DEDUP() to calculate the size. Has to be
+*                 16-bit aligned.
+*   NumBytes      Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_DEDUP_RESULT_OK          Configured successfully.
+*   FS_DEDUP_RESULT_BADPARAM    Invalid parameters.
+*
+*  The map occupies 2 bytes per sector of the volume on the storage
+*  device, and the number of stored sectors is limited to
+*  FS_DEDUP_MAX_NUM_SECTORS. A write request fails when no stored sector
+*  is free. Each write request writes the map sectors it changed in
+*  addition to the new data, so the driver saves program and erase
+*  cycles when the data written contains duplicates or fill patterns.
+*  The storage device has to be formatted again after NumSectors is
+*  changed. The sectors stored before the storage device was mounted are
+*  added to the index when they are read or, in steps, by
+*  FS_STORAGE_CleanOne().
+*
+*******************************************************************************/
+FS_DEDUP_Result_t FS_DEDUP_Configure(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, U32 NumSectors, void * pBuffer, U32 NumBytes)
+{
+    FS_DEDUP_Result_t result = FS_DEDUP_RESULT_BADPARAM;
+    dedup_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (pBuffer != NULL) && (NumBytes != 0U))
+    {
+        FS_MEMSET(inst, 0, sizeof(dedup_inst_t));
+        inst->device_type        = pDeviceType;
+        inst->device_unit        = DeviceUnit;
+        inst->num_sectors_config = NumSectors;
+        inst->buffer             = (U8 *)pBuffer;
+        inst->buffer_size        = NumBytes;
+        result = FS_DEDUP_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_DEDUP_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_DEDUP_GetStatCounters(U8 Unit, FS_DEDUP_STAT_COUNTERS * pStat)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_DEDUP_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_DEDUP_ResetStatCounters(U8 Unit)
+{
+    dedup_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
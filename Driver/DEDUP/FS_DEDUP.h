@@ -0,0 +1,134 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_DEDUP.h
+Purpose     : Logical driver that stores identical sectors only once.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_DEDUP_H     // Avoid recursive and multiple inclusion
+#define FS_DEDUP_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_DEDUP_NUM_UNITS
+#define FS_DEDUP_NUM_UNITS              (1U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_DEDUP_INDEX_SECTORS
+#define FS_DEDUP_INDEX_SECTORS          (32U)   /* Maximum number of stored sectors added to the index per clean operation. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define FS_DEDUP_MAX_NUM_SECTORS        (0xFFF0U)   /* Maximum number of sectors stored on the storage device. */
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCnt;          /* Number of sectors read by the file system. */
+    U32 WriteSectorCnt;         /* Number of sectors written by the file system. */
+    U32 WriteSectorDupCnt;      /* Number of written sectors that matched a stored sector. */
+    U32 WriteSectorFillCnt;     /* Number of written sectors filled with 0x00 or 0xFF, which are not stored. */
+    U32 WriteSectorDeviceCnt;   /* Number of data sectors written to the storage device. */
+    U32 WriteMapCnt;            /* Number of sectors of the map written to the storage device. */
+    U32 CompareCnt;             /* Number of stored sectors read to confirm a match of the hash value. */
+} FS_DEDUP_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_DEDUP_RESULT_OK = 0U,
+    FS_DEDUP_RESULT_BADPARAM,
+} FS_DEDUP_Result_t;
+
+/*********************************************************************
+*
+*       Buffer size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_DEDUP_Configure()
+*    for a storage device of NumSectors sectors of SectorSize bytes.
+*/
+#define FS_SIZEOF_DEDUP(NumSectors, SectorSize)                                 \
+    (3U * (U32)(SectorSize) + 7U * (U32)(NumSectors) + 2U)
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_DEDUP_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_DEDUP_Result_t FS_DEDUP_Configure          (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, U32 NumSectors, void * pBuffer, U32 NumBytes);
+void              FS_DEDUP_GetStatCounters    (U8 Unit, FS_DEDUP_STAT_COUNTERS * pStat);
+void              FS_DEDUP_ResetStatCounters  (U8 Unit);
+
+#endif  // FS_DEDUP_H
+
+/*************************** End of file ****************************/
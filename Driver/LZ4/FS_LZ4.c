@@ -0,0 +1,1334 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_LZ4.c
+Purpose     : Logical driver that stores groups of sectors compressed.
+              Logged data is often highly redundant but is programmed
+              to the storage device byte by byte. This driver combines
+              a configurable number of consecutive sectors to a group
+              and stores the group compressed in the LZ4 block format
+              so that fewer sectors have to be transferred and programmed.
+              Each group is assigned two slots of one sector more than
+              the group size on the storage device. A group is always
+              written to the slot that does not hold its current version,
+              so that a power failure during the write leaves the previous
+              version intact. A header in front of the data identifies the
+              group, records the number of sectors used in the slot and
+              carries a sequence number and a check value of the data; the
+              slot with the newer sequence number whose data is complete
+              holds the current version. A map in RAM remembers the slot
+              and the number of sectors used so that a group is read with
+              a single request. The sectors of a slot not used by the
+              compressed data are released on the storage device via
+              FS_CMD_FREE_SECTORS, so that a storage device that maps its
+              sectors can use them for other data. Groups that do not
+              compress are stored uncompressed.
+              The most recently accessed group is kept decompressed in
+              RAM. A write to a part of a group reads the group, modifies
+              it and stores it again, so small writes should be collected
+              above this driver, for example via FS_WRCOAL.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_LZ4.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define GROUP_NONE                      (0xFFFFFFFFUL)
+#define HEADER_MAGIC                    (0x46345A4CUL)  /* "LZ4F" */
+#define FORMAT_RAW                      (0U)
+#define FORMAT_LZ4                      (1U)
+#define MAP_UNKNOWN                     (0U)            /* Size of the stored group not known yet. */
+#define MAP_EMPTY                       (0xFFU)         /* Group never written. Reads as 0. */
+#define NUM_SLOTS                       (2U)            /* Number of slots per group. */
+#define HEADER_OFF_CHECK                (FS_LZ4_HEADER_SIZE - 4U)
+#define MIN_MATCH                       (4U)            /* Minimum length of a match in the LZ4 format. */
+#define MF_LIMIT                        (12U)           /* No match may start in the last bytes of a block. */
+#define LAST_LITERALS                   (5U)            /* The last bytes of a block are always literals. */
+#define MAX_OFFSET                      (65535U)
+#define MIN_GROUP_SIZE                  (2U)
+#define MAX_GROUP_SIZE                  (64U)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 group_index;
+    U32 num_bytes;              /* Number of bytes of data following the header. */
+    U32 data_check;             /* Check value of the data following the header. */
+    U8  format;
+    U8  num_sectors;            /* Number of sectors used in the slot. */
+    U8  sequence;               /* Incremented with each write of the group. The slot is sequence & 1. */
+} lz4_header_t;
+
+typedef struct
+{
+    const FS_DEVICE_TYPE  * device_type;
+    U8                      device_unit;
+    U8                      group_size;         /* Number of sectors per group. */
+    bool                    is_inited;          /* Set when the buffer layout has been calculated. */
+    U8                    * buffer;
+    U32                     buffer_size;
+    U16                     bytes_per_sector;
+    U32                     group_bytes;        /* Number of bytes in a group. */
+    U32                     num_groups;
+    U16                   * hash_table;         /* Match candidates of the compressor. */
+    U8                    * group_data;         /* Decompressed data of the cached group. */
+    U8                    * stored_data;        /* Group as stored on the storage device. */
+    U16                   * map;                /* Per group: sequence number << 8 | number of sectors used, MAP_UNKNOWN or MAP_EMPTY. */
+    U32                     num_map_entries;
+    U32                     cached_group;       /* Index of the group in group_data or GROUP_NONE. */
+    U8                      cached_sequence;    /* Sequence number of the stored version of the cached group. */
+    FS_LZ4_STAT_COUNTERS    stat;
+} lz4_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static lz4_inst_t lz4_inst[FS_LZ4_NUM_UNITS];
+static U8         lz4_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static lz4_inst_t * get_inst(U8 unit)
+{
+    lz4_inst_t * inst = NULL;
+
+    if(unit < FS_LZ4_NUM_UNITS)
+    {
+        inst = &lz4_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       load_u32 / store_u32
+*/
+static U32 load_u32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+static void store_u32(U8 * data, U32 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+    data[2] = (U8)(value >> 16);
+    data[3] = (U8)(value >> 24);
+}
+
+/*********************************************************************
+*
+*       calc_check
+*
+*  Function description
+*    Calculates the check value of a range of bytes (FNV-1a).
+*/
+static U32 calc_check(const U8 * data, U32 num_bytes)
+{
+    U32 check = 0x811C9DC5UL;
+
+    for(U32 i = 0U; i < num_bytes; i++)
+    {
+        check = (check ^ data[i]) * 0x01000193UL;
+    }
+
+    return check;
+}
+
+/*********************************************************************
+*
+*       store_header
+*
+*  Function description
+*    Encodes the header of a stored group.
+*    Layout (little endian): magic, group index, number of data bytes (16 bit),
+*    format (8 bit), number of sectors (8 bit), sequence number (8 bit),
+*    3 reserved bytes, check value of the data, check value of the header.
+*/
+static void store_header(U8 * data, const lz4_header_t * header)
+{
+    store_u32(data,      HEADER_MAGIC);
+    store_u32(data + 4,  header->group_index);
+    data[8]  = (U8)header->num_bytes;
+    data[9]  = (U8)(header->num_bytes >> 8);
+    data[10] = header->format;
+    data[11] = header->num_sectors;
+    data[12] = header->sequence;
+    data[13] = 0U;
+    data[14] = 0U;
+    data[15] = 0U;
+    store_u32(data + 16, header->data_check);
+    store_u32(data + HEADER_OFF_CHECK, calc_check(data, HEADER_OFF_CHECK));
+}
+
+/*********************************************************************
+*
+*       load_header
+*
+*  Return value
+*    ==0    OK, header valid.
+*    ==1    No header, the slot has never been written.
+*    < 0    Header invalid.
+*/
+static int load_header(const U8 * data, lz4_header_t * header)
+{
+    int r = 1;
+
+    if(load_u32(data) == HEADER_MAGIC)
+    {
+        header->group_index = load_u32(data + 4);
+        header->num_bytes   = (U32)data[8] | ((U32)data[9] << 8);
+        header->format      = data[10];
+        header->num_sectors = data[11];
+        header->sequence    = data[12];
+        header->data_check  = load_u32(data + 16);
+        r = (load_u32(data + HEADER_OFF_CHECK) == calc_check(data, HEADER_OFF_CHECK)) ? 0 : -1;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_hash
+*/
+static U32 lz4_hash(U32 value)
+{
+    return (U32)(value * 2654435761UL) >> (32U - FS_LZ4_HASH_BITS);
+}
+
+/*********************************************************************
+*
+*       lz4_put_length
+*
+*  Function description
+*    Stores the part of a length that does not fit into the token.
+*/
+static U32 lz4_put_length(U8 * dest, U32 pos, U32 length)
+{
+    U32 num_bytes = length - 15U;
+
+    while(num_bytes >= 255U)
+    {
+        dest[pos] = 255U;
+        pos++;
+        num_bytes -= 255U;
+    }
+    dest[pos] = (U8)num_bytes;
+
+    return pos + 1U;
+}
+
+/*********************************************************************
+*
+*       lz4_put_sequence
+*
+*  Function description
+*    Stores literals followed by an optional match in the LZ4 block format.
+*
+*  Parameters
+*    match_len      Number of bytes of the match, 0 for the last sequence.
+*
+*  Return value
+*    Position behind the sequence or 0 if dest is too small.
+*/
+static U32 lz4_put_sequence(U8 * dest, U32 pos, U32 dest_size, const U8 * literals, U32 literal_len, U32 offset, U32 match_len)
+{
+    U32 num_bytes = 1U + literal_len + ((literal_len >= 15U) ? (((literal_len - 15U) / 255U) + 1U) : 0U);
+    U32 match_code = (match_len != 0U) ? (match_len - MIN_MATCH) : 0U;
+    U32 r = 0U;
+
+    if(match_len != 0U)
+    {
+        num_bytes += 2U + ((match_code >= 15U) ? (((match_code - 15U) / 255U) + 1U) : 0U);
+    }
+    if(num_bytes <= (dest_size - pos))
+    {
+        U8 * token = &dest[pos];
+
+        *token = (U8)(((literal_len < 15U) ? literal_len : 15U) << 4);
+        pos++;
+        if(literal_len >= 15U)
+        {
+            pos = lz4_put_length(dest, pos, literal_len);
+        }
+        FS_MEMCPY(&dest[pos], literals, literal_len);
+        pos += literal_len;
+        if(match_len != 0U)
+        {
+            dest[pos]      = (U8)offset;
+            dest[pos + 1U] = (U8)(offset >> 8);
+            pos += 2U;
+            *token |= (U8)((match_code < 15U) ? match_code : 15U);
+            if(match_code >= 15U)
+            {
+                pos = lz4_put_length(dest, pos, match_code);
+            }
+        }
+        r = pos;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_compress
+*
+*  Function description
+*    Compresses a block of data in the LZ4 block format.
+*
+*  Return value
+*    !=0    Number of bytes of compressed data.
+*    ==0    The compressed data does not fit into dest.
+*
+*  Additional information
+*    Greedy single-pass compressor. Each position is looked up in a hash
+*    table of the positions of previous 4-byte sequences; the search
+*    advances faster through data without matches.
+*/
+static U32 lz4_compress(U16 * hash_table, const U8 * src, U32 src_size, U8 * dest, U32 dest_size)
+{
+    U32  pos      = 0U;
+    U32  anchor   = 0U;
+    U32  pos_dest = 0U;
+    bool is_full  = false;
+
+    FS_MEMSET(hash_table, 0, sizeof(U16) << FS_LZ4_HASH_BITS);
+    if(src_size > MF_LIMIT)
+    {
+        U32 pos_limit = src_size - MF_LIMIT;
+
+        while(pos < pos_limit)
+        {
+            U32 value = load_u32(&src[pos]);
+            U32 h = lz4_hash(value);
+            U32 candidate = hash_table[h];
+
+            hash_table[h] = (U16)pos;
+            if((candidate < pos) && ((pos - candidate) <= MAX_OFFSET) && (load_u32(&src[candidate]) == value))
+            {
+                U32 match_len = MIN_MATCH;
+
+                while(((pos + match_len) < (src_size - LAST_LITERALS)) && (src[candidate + match_len] == src[pos + match_len]))
+                {
+                    match_len++;
+                }
+                pos_dest = lz4_put_sequence(dest, pos_dest, dest_size, &src[anchor], pos - anchor, pos - candidate, match_len);
+                if(pos_dest == 0U)
+                {
+                    is_full = true;
+                    break;
+                }
+                pos   += match_len;
+                anchor = pos;
+            }
+            else
+            {
+                pos += 1U + ((pos - anchor) >> 6);
+            }
+        }
+    }
+    if(!is_full)
+    {
+        pos_dest = lz4_put_sequence(dest, pos_dest, dest_size, &src[anchor], src_size - anchor, 0U, 0U);
+    }
+
+    return pos_dest;
+}
+
+/*********************************************************************
+*
+*       lz4_get_length
+*
+*  Function description
+*    Adds the part of a length that did not fit into the token.
+*
+*  Return value
+*    ==0    OK, length decoded.
+*    !=0    The data ends within the length.
+*/
+static int lz4_get_length(const U8 * src, U32 src_size, U32 * p_pos, U32 * p_length)
+{
+    int r = 1;
+    U32 pos = *p_pos;
+
+    while(pos < src_size)
+    {
+        U8 value = src[pos];
+
+        pos++;
+        *p_length += value;
+        if(value != 255U)
+        {
+            r = 0;
+            break;
+        }
+    }
+    *p_pos = pos;
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_decompress
+*
+*  Function description
+*    Decompresses a block of data stored in the LZ4 block format.
+*
+*  Return value
+*    ==0    OK, exactly dest_size bytes decompressed.
+*    !=0    The data is corrupted.
+*
+*  Additional information
+*    All the lengths and offsets are checked so that corrupted data
+*    cannot cause an access outside of the buffers.
+*/
+static int lz4_decompress(const U8 * src, U32 src_size, U8 * dest, U32 dest_size)
+{
+    U32 pos = 0U;
+    U32 pos_dest = 0U;
+    int r = 1;
+
+    while(pos < src_size)
+    {
+        U8  token = src[pos];
+        U32 literal_len = (U32)token >> 4;
+        U32 match_len = (U32)token & 15U;
+        U32 offset;
+
+        pos++;
+        if((literal_len == 15U) && (lz4_get_length(src, src_size, &pos, &literal_len) != 0))
+        {
+            break;
+        }
+        if((literal_len > (src_size - pos)) || (literal_len > (dest_size - pos_dest)))
+        {
+            break;
+        }
+        FS_MEMCPY(&dest[pos_dest], &src[pos], literal_len);
+        pos      += literal_len;
+        pos_dest += literal_len;
+        if(pos == src_size)
+        {
+            r = (pos_dest == dest_size) ? 0 : 1;    /* Last sequence, literals only. */
+            break;
+        }
+        if((src_size - pos) < 2U)
+        {
+            break;
+        }
+        offset = (U32)src[pos] | ((U32)src[pos + 1U] << 8);
+        pos += 2U;
+        if((offset == 0U) || (offset > pos_dest))
+        {
+            break;
+        }
+        if((match_len == 15U) && (lz4_get_length(src, src_size, &pos, &match_len) != 0))
+        {
+            break;
+        }
+        match_len += MIN_MATCH;
+        if(match_len > (dest_size - pos_dest))
+        {
+            break;
+        }
+        /* The match can overlap the data being produced. */
+        for(U32 i = 0U; i < match_len; i++)
+        {
+            dest[pos_dest] = dest[pos_dest - offset];
+            pos_dest++;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, buffers ready.
+*    !=0    An error occurred.
+*/
+static int init_if_required(lz4_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info;
+
+        FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+        r = inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+        if((r == 0) && (dev_info.BytesPerSector > FS_LZ4_HEADER_SIZE))
+        {
+            U32 group_bytes = (U32)inst->group_size * dev_info.BytesPerSector;
+            U32 hash_bytes  = (U32)sizeof(U16) << FS_LZ4_HASH_BITS;
+            U32 align       = (4U - ((U32)((uintptr_t)inst->buffer) & 3U)) & 3U;
+            U32 num_bytes   = hash_bytes + group_bytes + group_bytes + dev_info.BytesPerSector;
+
+            if((group_bytes > FS_LZ4_MAX_GROUP_BYTES) || (inst->buffer_size < align) || ((inst->buffer_size - align) < num_bytes))
+            {
+                r = 1;          /* Buffer too small or group too large. */
+            }
+            else
+            {
+                U8 * data = inst->buffer + align;
+
+                inst->bytes_per_sector = dev_info.BytesPerSector;
+                inst->group_bytes      = group_bytes;
+                inst->num_groups       = dev_info.NumSectors / (NUM_SLOTS * ((U32)inst->group_size + 1U));
+                inst->hash_table       = (U16 *)(void *)data;
+                inst->group_data       = data + hash_bytes;
+                inst->stored_data      = inst->group_data + group_bytes;
+                inst->map              = (U16 *)(void *)(inst->stored_data + group_bytes + dev_info.BytesPerSector);
+                inst->num_map_entries  = (inst->buffer_size - align - num_bytes) / (U32)sizeof(U16);
+                if(inst->num_map_entries > inst->num_groups)
+                {
+                    inst->num_map_entries = inst->num_groups;
+                }
+                FS_MEMSET(inst->map, 0, inst->num_map_entries * sizeof(U16));
+                inst->cached_group = GROUP_NONE;
+                inst->is_inited    = true;
+            }
+        }
+        else
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       map_get / map_set
+*/
+static U16 map_get(const lz4_inst_t * inst, U32 group_index)
+{
+    return (group_index < inst->num_map_entries) ? inst->map[group_index] : (U16)MAP_UNKNOWN;
+}
+
+static void map_set(lz4_inst_t * inst, U32 group_index, U16 value)
+{
+    if(group_index < inst->num_map_entries)
+    {
+        inst->map[group_index] = value;
+    }
+}
+
+/*********************************************************************
+*
+*       get_slot_sector
+*
+*  Function description
+*    Returns the index of the first sector of a slot on the storage device.
+*/
+static U32 get_slot_sector(const lz4_inst_t * inst, U32 group_index, U32 slot)
+{
+    U32 slot_size = (U32)inst->group_size + 1U;
+
+    return (group_index * NUM_SLOTS * slot_size) + (slot * slot_size);
+}
+
+/*********************************************************************
+*
+*       read_header
+*
+*  Function description
+*    Reads the header of a slot.
+*
+*  Return value
+*    ==0    The slot holds a header of the group.
+*    ==1    The slot holds no valid header of the group.
+*    < 0    The storage device reported an error.
+*/
+static int read_header(lz4_inst_t * inst, U32 group_index, U32 slot, lz4_header_t * header)
+{
+    int r;
+
+    r = inst->device_type->pfRead(inst->device_unit, get_slot_sector(inst, group_index, slot), inst->stored_data, 1U);
+    if(r != 0)
+    {
+        r = -1;
+    }
+    else
+    {
+        inst->stat.ReadSectorDeviceCnt++;
+        r = load_header(inst->stored_data, header);
+        if((r != 0) || (header->group_index != group_index) || ((header->sequence & 1U) != slot))
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       load_slot
+*
+*  Function description
+*    Reads the version of a group stored in a slot and decompresses it.
+*
+*  Parameters
+*    inst           Driver instance.
+*    group_index    Index of the group.
+*    slot           Index of the slot (0 or 1).
+*    num_sectors    Number of sectors used in the slot if known, else 0.
+*
+*  Return value
+*    ==0    OK, group in group_data.
+*    ==1    The slot holds no complete version of the group.
+*    < 0    The storage device reported an error.
+*/
+static int load_slot(lz4_inst_t * inst, U32 group_index, U32 slot, U32 num_sectors)
+{
+    U32 first_sector = get_slot_sector(inst, group_index, slot);
+    U32 num_sectors_read = (num_sectors != 0U) ? num_sectors : 1U;
+    lz4_header_t header;
+    int r;
+
+    r = inst->device_type->pfRead(inst->device_unit, first_sector, inst->stored_data, num_sectors_read);
+    if(r != 0)
+    {
+        r = -1;
+    }
+    else
+    {
+        inst->stat.ReadSectorDeviceCnt += num_sectors_read;
+        r = load_header(inst->stored_data, &header);
+        if((r == 0) && (header.group_index == group_index) && ((header.sequence & 1U) == slot) &&
+           (header.num_sectors != 0U) && (header.num_sectors <= (inst->group_size + 1U)) && (header.num_bytes != 0U) &&
+           ((header.num_bytes + FS_LZ4_HEADER_SIZE) <= ((U32)header.num_sectors * inst->bytes_per_sector)))
+        {
+            if(header.num_sectors > num_sectors_read)
+            {
+                r = inst->device_type->pfRead(inst->device_unit, first_sector + num_sectors_read,
+                                              inst->stored_data + (num_sectors_read * inst->bytes_per_sector),
+                                              header.num_sectors - num_sectors_read);
+                inst->stat.ReadSectorDeviceCnt += header.num_sectors - num_sectors_read;
+                r = (r == 0) ? 0 : -1;
+            }
+            if(r == 0)
+            {
+                /* The check value detects a write interrupted by a power failure. */
+                if(calc_check(inst->stored_data + FS_LZ4_HEADER_SIZE, header.num_bytes) != header.data_check)
+                {
+                    r = 1;
+                }
+                else if(header.format == FORMAT_LZ4)
+                {
+                    r = (lz4_decompress(inst->stored_data + FS_LZ4_HEADER_SIZE, header.num_bytes, inst->group_data, inst->group_bytes) == 0) ? 0 : 1;
+                }
+                else if((header.format == FORMAT_RAW) && (header.num_bytes == inst->group_bytes))
+                {
+                    FS_MEMCPY(inst->group_data, inst->stored_data + FS_LZ4_HEADER_SIZE, inst->group_bytes);
+                }
+                else
+                {
+                    r = 1;
+                }
+            }
+            if(r == 0)
+            {
+                inst->cached_sequence = header.sequence;
+                map_set(inst, group_index, (U16)(((U16)header.sequence << 8) | header.num_sectors));
+            }
+        }
+        else
+        {
+            r = 1;      /* No header, header corrupted or written for another group. */
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       load_group
+*
+*  Function description
+*    Reads the current version of a group from the storage device
+*    and decompresses it.
+*
+*  Return value
+*    ==0    OK, group in group_data.
+*    ==1    No slot holds a complete version of the group.
+*    < 0    The storage device reported an error.
+*
+*  Additional information
+*    If the slots are not known from the map, the headers of both slots
+*    are read and the slot with the newer sequence number is tried first.
+*    The other slot is used if the data of the newer one is incomplete
+*    because a power failure interrupted its write. A group without any
+*    valid header, or whose only version is incomplete, has never been
+*    written successfully and reads as 0.
+*
+*    cached_sequence is set also if 1 is returned, so that the group can
+*    be written completely without overwriting the slot with the newer
+*    header.
+*/
+static int load_group(lz4_inst_t * inst, U32 group_index)
+{
+    U16 entry = map_get(inst, group_index);
+    U8  num_sectors = (U8)entry;
+    int r = 1;
+
+    inst->cached_group = GROUP_NONE;
+    if(num_sectors == MAP_EMPTY)
+    {
+        FS_MEMSET(inst->group_data, 0, inst->group_bytes);
+        inst->cached_sequence = (U8)(entry >> 8);
+        r = 0;
+    }
+    else if(num_sectors != MAP_UNKNOWN)
+    {
+        r = load_slot(inst, group_index, (U32)(entry >> 8) & 1U, num_sectors);
+    }
+    else
+    {
+        /* Determined below. */
+    }
+    if(r == 1)
+    {
+        lz4_header_t headers[NUM_SLOTS];
+        int results[NUM_SLOTS];
+        U32 slot_new;
+
+        results[0] = read_header(inst, group_index, 0U, &headers[0]);
+        results[1] = (results[0] < 0) ? results[0] : read_header(inst, group_index, 1U, &headers[1]);
+        if((results[0] < 0) || (results[1] < 0))
+        {
+            r = -1;
+        }
+        else if((results[0] != 0) && (results[1] != 0))
+        {
+            FS_MEMSET(inst->group_data, 0, inst->group_bytes);
+            inst->cached_sequence = 0xFFU;      /* The first version is written to slot 0. */
+            map_set(inst, group_index, (U16)(0xFF00U | MAP_EMPTY));
+            r = 0;
+        }
+        else
+        {
+            if(results[0] != 0)
+            {
+                slot_new = 1U;
+            }
+            else if(results[1] != 0)
+            {
+                slot_new = 0U;
+            }
+            else
+            {
+                U8 diff = (U8)(headers[1].sequence - headers[0].sequence);
+
+                slot_new = ((diff != 0U) && (diff < 0x80U)) ? 1U : 0U;
+            }
+            r = load_slot(inst, group_index, slot_new, headers[slot_new].num_sectors);
+            if((r == 1) && (results[slot_new ^ 1U] == 0))
+            {
+                r = load_slot(inst, group_index, slot_new ^ 1U, headers[slot_new ^ 1U].num_sectors);
+            }
+            if(r == 1)
+            {
+                inst->cached_sequence = headers[slot_new].sequence;
+                if(results[slot_new ^ 1U] != 0)
+                {
+                    /* The first write of the group has been interrupted. */
+                    FS_MEMSET(inst->group_data, 0, inst->group_bytes);
+                    r = 0;
+                }
+            }
+        }
+    }
+    if(r == 0)
+    {
+        inst->cached_group = group_index;
+    }
+    else
+    {
+        map_set(inst, group_index, MAP_UNKNOWN);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       store_group
+*
+*  Function description
+*    Compresses the cached group and writes it to the storage device.
+*
+*  Return value
+*    ==0    OK, group stored.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The group is written to the slot that does not hold the version
+*    the cached data was read from, so that this version remains valid
+*    if the write is interrupted. The sectors of the slot not used by
+*    the data are released on the storage device.
+*/
+static int store_group(lz4_inst_t * inst, U32 group_index)
+{
+    U32 num_bytes_max = inst->group_bytes - FS_LZ4_HEADER_SIZE;     /* The group has to get at least one sector smaller. */
+    U32 slot_size = (U32)inst->group_size + 1U;
+    lz4_header_t header;
+    U32 first_sector;
+    U32 num_bytes;
+    int r;
+
+    num_bytes = lz4_compress(inst->hash_table, inst->group_data, inst->group_bytes, inst->stored_data + FS_LZ4_HEADER_SIZE, num_bytes_max);
+    header.format = FORMAT_LZ4;
+    if(num_bytes == 0U)
+    {
+        FS_MEMCPY(inst->stored_data + FS_LZ4_HEADER_SIZE, inst->group_data, inst->group_bytes);
+        num_bytes     = inst->group_bytes;
+        header.format = FORMAT_RAW;
+        inst->stat.WriteGroupRawCnt++;
+    }
+    header.group_index = group_index;
+    header.num_bytes   = num_bytes;
+    header.num_sectors = (U8)((num_bytes + FS_LZ4_HEADER_SIZE + inst->bytes_per_sector - 1U) / inst->bytes_per_sector);
+    header.sequence    = (U8)(inst->cached_sequence + 1U);
+    header.data_check  = calc_check(inst->stored_data + FS_LZ4_HEADER_SIZE, num_bytes);
+    store_header(inst->stored_data, &header);
+    num_bytes += FS_LZ4_HEADER_SIZE;
+    FS_MEMSET(inst->stored_data + num_bytes, 0, ((U32)header.num_sectors * inst->bytes_per_sector) - num_bytes);
+    first_sector = get_slot_sector(inst, group_index, (U32)header.sequence & 1U);
+    r = inst->device_type->pfWrite(inst->device_unit, first_sector, inst->stored_data, header.num_sectors, 0U);
+    inst->stat.WriteGroupCnt++;
+    inst->stat.WriteSectorDeviceCnt += header.num_sectors;
+    if(r == 0)
+    {
+        inst->cached_sequence = header.sequence;
+        map_set(inst, group_index, (U16)(((U16)header.sequence << 8) | header.num_sectors));
+        if(header.num_sectors < slot_size)
+        {
+            U32 num_sectors_free = slot_size - header.num_sectors;
+
+            (void) inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_FREE_SECTORS, (I32)(first_sector + header.num_sectors), &num_sectors_free);
+        }
+    }
+    else
+    {
+        map_set(inst, group_index, MAP_UNKNOWN);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       free_groups
+*
+*  Function description
+*    Informs the storage device about the slots of the groups
+*    completely covered by a range of sectors.
+*/
+static int free_groups(lz4_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    U32 first_group = (first_sector + inst->group_size - 1U) / inst->group_size;
+    U32 end_group   = (first_sector + num_sectors) / inst->group_size;
+    int r = 0;
+
+    if(end_group > inst->num_groups)
+    {
+        end_group = inst->num_groups;
+    }
+    if(end_group > first_group)
+    {
+        U32 num_sectors_device = (end_group - first_group) * NUM_SLOTS * ((U32)inst->group_size + 1U);
+
+        for(U32 i = first_group; i < end_group; i++)
+        {
+            map_set(inst, i, MAP_UNKNOWN);
+        }
+        if((inst->cached_group >= first_group) && (inst->cached_group < end_group))
+        {
+            inst->cached_group = GROUP_NONE;
+        }
+        r = inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_FREE_SECTORS, (I32)get_slot_sector(inst, first_group, 0U), &num_sectors_device);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       is_range_valid
+*/
+static bool is_range_valid(const lz4_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    U32 num_sectors_total = inst->num_groups * inst->group_size;
+
+    return (sector_index < num_sectors_total) && (num_sectors <= (num_sectors_total - sector_index));
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 12,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       lz4_get_name
+*/
+static const char * lz4_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "lz4";
+}
+
+/*********************************************************************
+*
+*       lz4_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int lz4_add_device(void)
+{
+    int r = -1;
+
+    if(lz4_num_units < FS_LZ4_NUM_UNITS)
+    {
+        r = (int)lz4_num_units;
+        lz4_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_read
+*
+*  Function description
+*    Reads sectors from the cached group or decompresses them from
+*    the storage device.
+*/
+static int lz4_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+    U8 * data = (U8 *)pBuffer;
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL) && (init_if_required(inst) == 0) &&
+       is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        r = 0;
+        inst->stat.ReadSectorCnt += NumSectors;
+        while(NumSectors != 0U)
+        {
+            U32 group_index = SectorIndex / inst->group_size;
+            U32 offset      = SectorIndex % inst->group_size;
+            U32 num_sectors = inst->group_size - offset;
+
+            if(num_sectors > NumSectors)
+            {
+                num_sectors = NumSectors;
+            }
+            if(group_index != inst->cached_group)
+            {
+                r = load_group(inst, group_index);
+                if(r != 0)
+                {
+                    break;
+                }
+            }
+            FS_MEMCPY(data, inst->group_data + (offset * inst->bytes_per_sector), num_sectors * inst->bytes_per_sector);
+            data        += num_sectors * inst->bytes_per_sector;
+            SectorIndex += num_sectors;
+            NumSectors  -= num_sectors;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_write
+*
+*  Function description
+*    Stores the modified groups compressed to the storage device.
+*
+*  Additional information
+*    The data of a group written only in part is read first. A group
+*    written completely is read only if the slot of its current version
+*    is not known.
+*/
+static int lz4_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+    const U8 * data = (const U8 *)pBuffer;
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL) && (init_if_required(inst) == 0) &&
+       is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        r = 0;
+        inst->stat.WriteSectorCnt += NumSectors;
+        while(NumSectors != 0U)
+        {
+            U32 group_index = SectorIndex / inst->group_size;
+            U32 offset      = SectorIndex % inst->group_size;
+            U32 num_sectors = inst->group_size - offset;
+
+            if(num_sectors > NumSectors)
+            {
+                num_sectors = NumSectors;
+            }
+            if(group_index != inst->cached_group)
+            {
+                U16 entry = map_get(inst, group_index);
+
+                if(num_sectors < inst->group_size)
+                {
+                    r = load_group(inst, group_index);
+                }
+                else if((U8)entry == MAP_UNKNOWN)
+                {
+                    r = load_group(inst, group_index);
+                    r = (r == 1) ? 0 : r;       /* No valid version, the group is overwritten completely. */
+                }
+                else
+                {
+                    inst->cached_sequence = (U8)(entry >> 8);
+                }
+                if(r != 0)
+                {
+                    break;
+                }
+            }
+            for(U32 i = 0U; i < num_sectors; i++)
+            {
+                FS_MEMCPY(inst->group_data + ((offset + i) * inst->bytes_per_sector), data, inst->bytes_per_sector);
+                if(RepeatSame == 0U)
+                {
+                    data += inst->bytes_per_sector;
+                }
+            }
+            inst->cached_group = group_index;
+            r = store_group(inst, group_index);
+            if(r != 0)
+            {
+                inst->cached_group = GROUP_NONE;
+                break;
+            }
+            SectorIndex += num_sectors;
+            NumSectors  -= num_sectors;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_ioctl
+*/
+static int lz4_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_GET_DEVINFO:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+                if(r == 0)
+                {
+                    FS_DEV_INFO * dev_info = (FS_DEV_INFO *)pBuffer;
+
+                    dev_info->NumSectors = inst->num_groups * inst->group_size;
+                }
+            }
+            break;
+        case FS_CMD_UNMOUNT:
+        case FS_CMD_UNMOUNT_FORCED:
+            /* The storage medium can be replaced while unmounted. */
+            inst->is_inited = false;
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = free_groups(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(lz4_inst_t));
+            if(lz4_num_units != 0U)
+            {
+                lz4_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_init_medium
+*/
+static int lz4_init_medium(U8 Unit)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = 0;
+        if(inst->device_type->pfInitMedium != NULL)
+        {
+            r = inst->device_type->pfInitMedium(inst->device_unit);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_get_status
+*/
+static int lz4_get_status(U8 Unit)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfGetStatus(inst->device_unit);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       lz4_get_num_units
+*/
+static int lz4_get_num_units(void)
+{
+    return (int)lz4_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_LZ4_Driver =
+{
+    lz4_get_name,
+    lz4_add_device,
+    lz4_read,
+    lz4_write,
+    lz4_ioctl,
+    lz4_init_medium,
+    lz4_get_status,
+    lz4_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_LZ4_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*   GroupSize     Number of sectors compressed together (2 to 64).
+*   pBuffer       Memory for the group buffers. Use FS_SIZEOF_LZ4()
+*                 to calculate the minimum size. Each additional two
+*                 bytes hold the stored slot and size of one group.
+*   NumBytes      Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_LZ4_RESULT_OK          Configured successfully.
+*   FS_LZ4_RESULT_BADPARAM    Invalid parameters.
+*
+*  Larger groups compress better but make writes to a part of a group
+*  more expensive. Each group occupies two slots of GroupSize + 1 sectors
+*  on the storage device, so that a group interrupted by a power failure
+*  while being written keeps its previous contents. The capacity reported
+*  to the file system is therefore less than half the capacity of the
+*  storage device. The sectors of the slots not used by the compressed
+*  data are released via FS_CMD_FREE_SECTORS, so that a storage device
+*  that maps its sectors, for example the NAND or NOR driver, uses only
+*  about the compressed size. The storage device has to be formatted
+*  again after the group size is changed.
+*
+*******************************************************************************/
+FS_LZ4_Result_t FS_LZ4_Configure(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, U8 GroupSize, void * pBuffer, U32 NumBytes)
+{
+    FS_LZ4_Result_t result = FS_LZ4_RESULT_BADPARAM;
+    lz4_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (pBuffer != NULL) && (NumBytes != 0U) &&
+       (GroupSize >= MIN_GROUP_SIZE) && (GroupSize <= MAX_GROUP_SIZE))
+    {
+        FS_MEMSET(inst, 0, sizeof(lz4_inst_t));
+        inst->device_type  = pDeviceType;
+        inst->device_unit  = DeviceUnit;
+        inst->group_size   = GroupSize;
+        inst->buffer       = (U8 *)pBuffer;
+        inst->buffer_size  = NumBytes;
+        inst->cached_group = GROUP_NONE;
+        result = FS_LZ4_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_LZ4_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_LZ4_GetStatCounters(U8 Unit, FS_LZ4_STAT_COUNTERS * pStat)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_LZ4_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_LZ4_ResetStatCounters(U8 Unit)
+{
+    lz4_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
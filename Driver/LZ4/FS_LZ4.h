@@ -0,0 +1,135 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_LZ4.h
+Purpose     : Logical driver that stores groups of sectors compressed.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_LZ4_H     // Avoid recursive and multiple inclusion
+#define FS_LZ4_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_LZ4_NUM_UNITS
+#define FS_LZ4_NUM_UNITS                (2U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_LZ4_HASH_BITS
+#define FS_LZ4_HASH_BITS                (10U)   /* Size of the match table of the compressor as power of 2. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define FS_LZ4_MAX_GROUP_BYTES          (32768U)    /* Maximum number of bytes in a group of sectors. */
+#define FS_LZ4_HEADER_SIZE              (24U)       /* Number of bytes in front of the data of a stored group. */
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCnt;          /* Number of sectors read by the file system. */
+    U32 WriteSectorCnt;         /* Number of sectors written by the file system. */
+    U32 ReadSectorDeviceCnt;    /* Number of sectors read from the storage device. */
+    U32 WriteSectorDeviceCnt;   /* Number of sectors written to the storage device. */
+    U32 WriteGroupCnt;          /* Number of groups stored. */
+    U32 WriteGroupRawCnt;       /* Number of groups stored uncompressed because they did not compress. */
+} FS_LZ4_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_LZ4_RESULT_OK = 0U,
+    FS_LZ4_RESULT_BADPARAM,
+} FS_LZ4_Result_t;
+
+/*********************************************************************
+*
+*       Buffer size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_LZ4_Configure()
+*    for groups of GroupSize sectors of SectorSize bytes. Two bytes per
+*    group can be added for the map of the stored group slots and sizes.
+*/
+#define FS_SIZEOF_LZ4(GroupSize, SectorSize)                                    \
+    ((((U32)(GroupSize) * 2U) + 1U) * (U32)(SectorSize) + (2UL << FS_LZ4_HASH_BITS) + 4U)
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_LZ4_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_LZ4_Result_t FS_LZ4_Configure            (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, U8 GroupSize, void * pBuffer, U32 NumBytes);
+void            FS_LZ4_GetStatCounters      (U8 Unit, FS_LZ4_STAT_COUNTERS * pStat);
+void            FS_LZ4_ResetStatCounters    (U8 Unit);
+
+#endif  // FS_LZ4_H
+
+/*************************** End of file ****************************/
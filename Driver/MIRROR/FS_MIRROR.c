@@ -0,0 +1,2231 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_MIRROR.c
+Purpose     : Logical driver that mirrors the sectors on several storage devices.
+              Each sector written by the file system is written to all
+              the storage devices (replicas) so that the data remains
+              available when one of them fails. Since every replica holds
+              all the data, a read request can be served by any of them.
+              The replica is selected per request: always the first one,
+              the replicas in turn, by the range of sectors so that each
+              replica serves its own part of the volume, or the replica
+              that transferred the fewest sectors recently. A failed read
+              is repeated on the other replicas.
+              With an RTOS, large read requests can be split between the
+              replicas and the writes to the replicas performed at the same
+              time by worker tasks, one less than the number of replicas.
+              This requires storage device drivers that can be called
+              concurrently for different units.
+              Optionally, the driver keeps the replicas consistent across
+              unclean shutdowns and storage device replacements. The regions
+              of the volume about to be written are recorded in a bitmap
+              stored on every replica, so that after a power loss only these
+              regions are copied from one replica to the others. A replica
+              that is new or missed writes is marked stale and rebuilt from
+              the others. The copying is performed in steps limited in size
+              and frequency, and its progress is saved so that it continues
+              where it stopped after a power loss.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_MIRROR.h"
+#include "FS_OS.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_MIRROR_LOAD_DECAY_SHIFT
+#define FS_MIRROR_LOAD_DECAY_SHIFT      (3U)    /* The recent load of a replica decreases by 1/2^n with each read request. */
+#endif
+
+#ifndef FS_MIRROR_RESYNC_SAVE_REGIONS
+#define FS_MIRROR_RESYNC_SAVE_REGIONS   (16U)   /* Number of regions rebuilt between two saves of the rebuild progress. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define OP_READ                         (0U)
+#define OP_WRITE                        (1U)
+
+/* Layout of the sector that follows the dirty-region bitmap in the metadata. */
+#define META_MAGIC                      (0x5252494DUL)  /* "MIRR" */
+#define META_OFF_MAGIC                  (0U)
+#define META_OFF_ARRAY_ID               (4U)
+#define META_OFF_SEQUENCE               (8U)
+#define META_OFF_REGION_SIZE            (12U)
+#define META_OFF_NUM_REGIONS            (16U)
+#define META_OFF_STALE_MASK             (20U)
+#define META_OFF_REBUILD_CURSOR         (24U)
+#define META_OFF_CHECK                  (28U)
+#define META_NUM_SLOTS                  (2U)
+
+#if defined(COMPONENT_RTOS_AWARE)
+#define MIRROR_SEMA_MAX_COUNT           (1LU)
+#define MIRROR_SEMA_INIT_COUNT          (0LU)
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    const FS_DEVICE_TYPE * device_type;
+    U8                     device_unit;
+    U32                    num_sectors;     /* Capacity of the storage device. */
+    U32                    load;            /* Number of sectors read recently, decaying. */
+} mirror_storage_t;
+
+typedef struct
+{
+    U8    op;
+    U8    repeat_same;
+    U8    storage_index;
+    U32   sector_index;
+    U32   num_sectors;
+    U8  * data;
+} mirror_request_t;
+
+typedef struct
+{
+    U8   * buffer;              /* Set by FS_MIRROR_ConfigureResync(). NULL if the resynchronization is disabled. */
+    U32    num_bytes;
+    U32    region_size;         /* Number of sectors per region of the bitmap. */
+    U32    step_sectors;        /* Maximum number of sectors copied per step. 0 means the size of the copy buffer. */
+    U32    interval_ms;         /* Minimum time between two steps performed during the accesses of the file system. */
+    U32    num_regions;
+    U32    num_sectors_bitmap;  /* Number of sectors in a metadata slot without the header sector. */
+    U32    meta_start;          /* Index of the first sector of the metadata on each replica. */
+    U8   * map_intent;          /* Bitmap of the regions possibly being written, as stored, followed by the header sector. */
+    U8   * map_resync;          /* Bitmap of the regions that still have to be copied from the source replica. */
+    U8   * copy_buffer;
+    U32    num_sectors_copy;
+    U32    num_regions_dirty;   /* Number of bits set in map_resync. */
+    U32    scan_region;         /* Region at which the search for dirty regions continues. */
+    U32    region_offset;       /* Number of sectors of the current dirty region already copied. */
+    U32    array_id;
+    U32    sequence;
+    U32    stale_mask;          /* Replicas without a complete copy of the data (bit n for replica n). */
+    U32    failed_mask;         /* Replicas that reported a write error and are not accessed anymore. */
+    U32    rebuild_cursor;      /* The stale replicas hold valid data below this sector index. */
+    U8     source;              /* Replica the dirty regions are copied from. num_storages if none is valid. */
+    U32    time_last;
+} mirror_resync_t;
+
+typedef struct
+{
+    U32  array_id;
+    U32  sequence;
+    U32  stale_mask;
+    U32  rebuild_cursor;
+} mirror_meta_t;
+
+#if defined(COMPONENT_RTOS_AWARE)
+typedef struct
+{
+    cy_thread_t         thread;
+    cy_semaphore_t      sema_start;
+    cy_semaphore_t      sema_done;
+    U8                  unit;
+    mirror_request_t    request;
+    int                 result;
+    bool                stop_requested;
+} mirror_worker_t;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+typedef struct
+{
+    mirror_storage_t        storages[FS_MIRROR_MAX_DEVICES];
+    U8                      num_storages;
+    bool                    is_inited;          /* Set when the capacity has been calculated. */
+    U16                     bytes_per_sector;
+    U32                     num_sectors;
+    U8                      read_policy;
+    U32                     range_size;         /* Number of sectors per range with FS_MIRROR_READ_RANGE. */
+    U8                      storage_next;       /* Next replica with FS_MIRROR_READ_ROUND_ROBIN. */
+    U32                     min_split_sectors;  /* Minimum number of sectors of a read request to be split. */
+#if defined(COMPONENT_RTOS_AWARE)
+    mirror_worker_t         workers[FS_MIRROR_MAX_DEVICES - 1U];
+    U8                      num_workers;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    mirror_resync_t         resync;
+    FS_MIRROR_STAT_COUNTERS stat;
+} mirror_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static mirror_inst_t mirror_inst[FS_MIRROR_NUM_UNITS];
+static U8            mirror_num_units;
+static U32           mirror_num_arrays;     /* Number of arrays created since start-up. */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static mirror_inst_t * get_inst(U8 unit)
+{
+    mirror_inst_t * inst = NULL;
+
+    if(unit < FS_MIRROR_NUM_UNITS)
+    {
+        inst = &mirror_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       transfer_storage
+*
+*  Function description
+*    Performs a request on one replica.
+*/
+static int transfer_storage(const mirror_inst_t * inst, const mirror_request_t * req)
+{
+    const mirror_storage_t * storage = &inst->storages[req->storage_index];
+    int r;
+
+    if(req->op == OP_READ)
+    {
+        r = storage->device_type->pfRead(storage->device_unit, req->sector_index, req->data, req->num_sectors);
+    }
+    else
+    {
+        r = storage->device_type->pfWrite(storage->device_unit, req->sector_index, req->data, req->num_sectors, req->repeat_same);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       select_storage
+*
+*  Function description
+*    Selects the replica that serves a read request.
+*
+*  Parameters
+*    exclude_mask   Replicas that must not be selected (bit n for replica n).
+*
+*  Return value
+*    Index of the replica or num_storages if all are excluded.
+*/
+static U8 select_storage(mirror_inst_t * inst, U32 sector_index, U32 exclude_mask)
+{
+    U8  num_storages  = inst->num_storages;
+    U8  storage_first = 0U;
+    U8  storage_index = num_storages;
+
+    if(inst->read_policy == FS_MIRROR_READ_ROUND_ROBIN)
+    {
+        storage_first = inst->storage_next;
+    }
+    else if(inst->read_policy == FS_MIRROR_READ_RANGE)
+    {
+        storage_first = (U8)((sector_index / inst->range_size) % num_storages);
+    }
+    else
+    {
+        /* Search from the first replica. */
+    }
+
+    for(U8 i = 0U; i < num_storages; i++)
+    {
+        U8 index = (U8)((storage_first + i) % num_storages);
+
+        if((exclude_mask & (1UL << index)) == 0U)
+        {
+            if(inst->read_policy != FS_MIRROR_READ_LEAST_LOADED)
+            {
+                storage_index = index;
+                break;
+            }
+            if((storage_index == num_storages) || (inst->storages[index].load < inst->storages[storage_index].load))
+            {
+                storage_index = index;
+            }
+        }
+    }
+    if(storage_index < num_storages)
+    {
+        inst->storage_next = (U8)((storage_index + 1U) % num_storages);
+    }
+
+    return storage_index;
+}
+
+/*********************************************************************
+*
+*       read_with_retry
+*
+*  Function description
+*    Reads sectors from the selected replica and, on error, from the other ones.
+*/
+static int read_with_retry(mirror_inst_t * inst, mirror_request_t * req, U32 exclude_mask)
+{
+    int r = 1;
+
+    req->storage_index = select_storage(inst, req->sector_index, exclude_mask);
+    while(req->storage_index < inst->num_storages)
+    {
+        mirror_storage_t * storage = &inst->storages[req->storage_index];
+
+        storage->load += req->num_sectors;
+        inst->stat.ReadSectorCntPerDevice[req->storage_index] += req->num_sectors;
+        r = transfer_storage(inst, req);
+        if(r == 0)
+        {
+            break;
+        }
+        inst->stat.ReadRetryCnt++;
+        exclude_mask |= 1UL << req->storage_index;
+        req->storage_index = select_storage(inst, req->sector_index, exclude_mask);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       decay_load
+*/
+static void decay_load(mirror_inst_t * inst)
+{
+    for(U8 i = 0U; i < inst->num_storages; i++)
+    {
+        inst->storages[i].load -= inst->storages[i].load >> FS_MIRROR_LOAD_DECAY_SHIFT;
+    }
+}
+
+#if defined(COMPONENT_RTOS_AWARE)
+
+/*********************************************************************
+*
+*       worker_task
+*
+*  Function description
+*    Main loop of a task that transfers the parts of requests.
+*/
+static void worker_task(cy_thread_arg_t arg)
+{
+    mirror_worker_t * worker = (mirror_worker_t *)arg;
+
+    for(;;)
+    {
+        cy_rslt_t result = cy_rtos_get_semaphore(&worker->sema_start, CY_RTOS_NEVER_TIMEOUT, false);
+
+        CY_ASSERT(CY_RSLT_SUCCESS == result);
+        FS_USE_PARA(result);
+
+        if(worker->stop_requested)
+        {
+            break;
+        }
+        worker->result = transfer_storage(get_inst(worker->unit), &worker->request);
+        (void) cy_rtos_set_semaphore(&worker->sema_done, false);
+    }
+
+    (void) cy_rtos_exit_thread();
+}
+
+/*********************************************************************
+*
+*       stop_workers
+*/
+static void stop_workers(mirror_inst_t * inst)
+{
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        mirror_worker_t * worker = &inst->workers[i];
+
+        worker->stop_requested = true;
+        (void) cy_rtos_set_semaphore(&worker->sema_start, false);
+        (void) cy_rtos_join_thread(&worker->thread);
+        (void) cy_rtos_deinit_semaphore(&worker->sema_done);
+        (void) cy_rtos_deinit_semaphore(&worker->sema_start);
+    }
+    inst->num_workers = 0U;
+}
+
+/*********************************************************************
+*
+*       start_workers
+*
+*  Return value
+*    ==0    OK, one worker per additional replica running.
+*    !=0    An error occurred. No worker is running.
+*/
+static int start_workers(mirror_inst_t * inst, U8 unit)
+{
+    int r = 0;
+
+    while(inst->num_workers < (inst->num_storages - 1U))
+    {
+        mirror_worker_t * worker = &inst->workers[inst->num_workers];
+        cy_rslt_t rslt;
+
+        FS_MEMSET(worker, 0, sizeof(mirror_worker_t));
+        worker->unit = unit;
+        rslt = cy_rtos_init_semaphore(&worker->sema_start, MIRROR_SEMA_MAX_COUNT, MIRROR_SEMA_INIT_COUNT);
+        if(CY_RSLT_SUCCESS == rslt)
+        {
+            rslt = cy_rtos_init_semaphore(&worker->sema_done, MIRROR_SEMA_MAX_COUNT, MIRROR_SEMA_INIT_COUNT);
+            if(CY_RSLT_SUCCESS == rslt)
+            {
+                rslt = cy_rtos_create_thread(&worker->thread, worker_task, "FS_MIRROR", NULL, FS_MIRROR_STACK_SIZE,
+                                             CY_RTOS_PRIORITY_ABOVENORMAL, (cy_thread_arg_t)worker);
+                if(CY_RSLT_SUCCESS != rslt)
+                {
+                    (void) cy_rtos_deinit_semaphore(&worker->sema_done);
+                }
+            }
+            if(CY_RSLT_SUCCESS != rslt)
+            {
+                (void) cy_rtos_deinit_semaphore(&worker->sema_start);
+            }
+        }
+        if(CY_RSLT_SUCCESS != rslt)
+        {
+            stop_workers(inst);
+            r = 1;
+            break;
+        }
+        inst->num_workers++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       read_split
+*
+*  Function description
+*    Reads a large request with one part of consecutive sectors
+*    from each replica at the same time.
+*
+*  Additional information
+*    A part that could not be read is read again from the other replicas
+*    after all the parts have been transferred.
+*/
+static int read_split(mirror_inst_t * inst, const mirror_request_t * req)
+{
+    U32 num_parts = (U32)inst->num_workers + 1U;
+    U32 num_sectors_part = (req->num_sectors + num_parts - 1U) / num_parts;
+    mirror_request_t req_part = *req;
+    int r;
+
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        mirror_worker_t * worker = &inst->workers[i];
+        U32 offset = num_sectors_part * (i + 1U);
+
+        worker->request               = *req;
+        worker->request.storage_index = i + 1U;
+        worker->request.sector_index  = req->sector_index + offset;
+        worker->request.num_sectors   = (offset < req->num_sectors) ? (req->num_sectors - offset) : 0U;
+        if(worker->request.num_sectors > num_sectors_part)
+        {
+            worker->request.num_sectors = num_sectors_part;
+        }
+        worker->request.data          = req->data + (offset * inst->bytes_per_sector);
+        worker->result                = 0;
+        inst->stat.ReadSectorCntPerDevice[i + 1U] += worker->request.num_sectors;
+        if(worker->request.num_sectors != 0U)
+        {
+            (void) cy_rtos_set_semaphore(&worker->sema_start, false);
+        }
+    }
+    req_part.storage_index = 0U;
+    req_part.num_sectors   = num_sectors_part;
+    inst->stat.ReadSectorCntPerDevice[0] += num_sectors_part;
+    r = transfer_storage(inst, &req_part);
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        if(inst->workers[i].request.num_sectors != 0U)
+        {
+            (void) cy_rtos_get_semaphore(&inst->workers[i].sema_done, CY_RTOS_NEVER_TIMEOUT, false);
+        }
+    }
+    /* The failed parts are read again when no replica is accessed by a worker anymore. */
+    if(r != 0)
+    {
+        inst->stat.ReadRetryCnt++;
+        r = read_with_retry(inst, &req_part, 1UL);
+    }
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        mirror_worker_t * worker = &inst->workers[i];
+
+        if((r == 0) && (worker->request.num_sectors != 0U) && (worker->result != 0))
+        {
+            inst->stat.ReadRetryCnt++;
+            r = read_with_retry(inst, &worker->request, 1UL << (i + 1U));
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       write_parallel
+*
+*  Function description
+*    Writes a request to the replicas at the same time.
+*
+*  Return value
+*    Replicas that reported an error (bit n for replica n).
+*/
+static U32 write_parallel(mirror_inst_t * inst, const mirror_request_t * req, U32 exclude_mask)
+{
+    mirror_request_t req_part = *req;
+    U32 fail_mask = 0U;
+
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        mirror_worker_t * worker = &inst->workers[i];
+
+        worker->request               = *req;
+        worker->request.storage_index = i + 1U;
+        worker->result                = 0;
+        if((exclude_mask & (1UL << (i + 1U))) != 0U)
+        {
+            worker->request.num_sectors = 0U;
+        }
+        else
+        {
+            (void) cy_rtos_set_semaphore(&worker->sema_start, false);
+        }
+    }
+    if((exclude_mask & 1UL) == 0U)
+    {
+        req_part.storage_index = 0U;
+        if(transfer_storage(inst, &req_part) != 0)
+        {
+            fail_mask |= 1UL;
+        }
+    }
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        mirror_worker_t * worker = &inst->workers[i];
+
+        if(worker->request.num_sectors != 0U)
+        {
+            (void) cy_rtos_get_semaphore(&worker->sema_done, CY_RTOS_NEVER_TIMEOUT, false);
+            if(worker->result != 0)
+            {
+                fail_mask |= 1UL << (i + 1U);
+            }
+        }
+    }
+
+    return fail_mask;
+}
+
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       write_storages
+*
+*  Function description
+*    Writes a request to all the replicas that are not excluded.
+*
+*  Return value
+*    Replicas that reported an error (bit n for replica n).
+*/
+static U32 write_storages(mirror_inst_t * inst, mirror_request_t * req, U32 exclude_mask)
+{
+    U32 fail_mask = 0U;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    if(inst->num_workers != 0U)
+    {
+        fail_mask = write_parallel(inst, req, exclude_mask);
+    }
+    else
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    {
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            if((exclude_mask & (1UL << i)) == 0U)
+            {
+                req->storage_index = i;
+                if(transfer_storage(inst, req) != 0)
+                {
+                    fail_mask |= 1UL << i;
+                }
+            }
+        }
+    }
+
+    return fail_mask;
+}
+
+/*********************************************************************
+*
+*       is_range_valid
+*/
+static bool is_range_valid(const mirror_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    return (sector_index < inst->num_sectors) && (num_sectors <= (inst->num_sectors - sector_index));
+}
+
+/*********************************************************************
+*
+*       forward_ioctl
+*
+*  Function description
+*    Sends a command to all the replicas.
+*
+*  Return value
+*    Value returned by the first replica that reported an error, or 0.
+*/
+static int forward_ioctl(const mirror_inst_t * inst, I32 cmd, I32 aux, void * p)
+{
+    int r = 0;
+
+    for(U8 i = 0U; i < inst->num_storages; i++)
+    {
+        int r_storage = inst->storages[i].device_type->pfIoCtl(inst->storages[i].device_unit, cmd, aux, p);
+
+        if(r == 0)
+        {
+            r = r_storage;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       load_u32 / store_u32
+*/
+static U32 load_u32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+static void store_u32(U8 * data, U32 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+    data[2] = (U8)(value >> 16);
+    data[3] = (U8)(value >> 24);
+}
+
+/*********************************************************************
+*
+*       get_min
+*/
+static U32 get_min(U32 a, U32 b)
+{
+    return (a < b) ? a : b;
+}
+
+/*********************************************************************
+*
+*       mix_u32
+*
+*  Function description
+*    Combines a value into a hash.
+*/
+static U32 mix_u32(U32 hash, U32 value)
+{
+    hash ^= value;
+    hash *= 0x9E3779B1UL;
+
+    return hash ^ (hash >> 16);
+}
+
+/*********************************************************************
+*
+*       get_all_mask
+*/
+static U32 get_all_mask(const mirror_inst_t * inst)
+{
+    return (1UL << inst->num_storages) - 1U;
+}
+
+/*********************************************************************
+*
+*       is_region_dirty / set_region_dirty
+*/
+static bool is_region_dirty(const U8 * map, U32 region)
+{
+    return (map[region >> 3] & (1U << (region & 7U))) != 0U;
+}
+
+static void set_region_dirty(U8 * map, U32 region, bool is_dirty)
+{
+    if(is_dirty)
+    {
+        map[region >> 3] |= (U8)(1U << (region & 7U));
+    }
+    else
+    {
+        map[region >> 3] &= (U8)~(1U << (region & 7U));
+    }
+}
+
+/*********************************************************************
+*
+*       is_range_dirty
+*
+*  Function description
+*    Checks if any sector of the range is in a region that still has to
+*    be copied from the source replica.
+*/
+static bool is_range_dirty(const mirror_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    const mirror_resync_t * resync = &inst->resync;
+    bool is_dirty = false;
+
+    if(resync->num_regions_dirty != 0U)
+    {
+        U32 region_last = (sector_index + num_sectors - 1U) / resync->region_size;
+
+        for(U32 region = sector_index / resync->region_size; region <= region_last; region++)
+        {
+            if(is_region_dirty(resync->map_resync, region))
+            {
+                is_dirty = true;
+                break;
+            }
+        }
+    }
+
+    return is_dirty;
+}
+
+/*********************************************************************
+*
+*       get_read_exclude_mask
+*
+*  Function description
+*    Returns the replicas that do not hold valid data for a range of sectors.
+*/
+static U32 get_read_exclude_mask(const mirror_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    const mirror_resync_t * resync = &inst->resync;
+    U32 exclude_mask = 0U;
+
+    if(resync->buffer != NULL)
+    {
+        exclude_mask = resync->failed_mask;
+        if((sector_index + num_sectors) > resync->rebuild_cursor)
+        {
+            exclude_mask |= resync->stale_mask;
+        }
+        if(is_range_dirty(inst, sector_index, num_sectors))
+        {
+            exclude_mask |= get_all_mask(inst) & ~(1UL << resync->source);
+        }
+    }
+
+    return exclude_mask;
+}
+
+/*********************************************************************
+*
+*       calc_meta_check
+*
+*  Function description
+*    Calculates the check value of the bitmap and of the header fields.
+*/
+static U32 calc_meta_check(const mirror_inst_t * inst)
+{
+    const U8 * data = inst->resync.map_intent;
+    U32 num_bytes = (inst->resync.num_sectors_bitmap * inst->bytes_per_sector) + META_OFF_CHECK;
+    U32 check = META_MAGIC;
+
+    for(U32 i = 0U; i < num_bytes; i++)
+    {
+        check = ((check << 1) | (check >> 31)) ^ data[i];
+    }
+
+    return ~check;
+}
+
+/*********************************************************************
+*
+*       decode_meta
+*
+*  Function description
+*    Checks the metadata read into map_intent and returns its header fields.
+*
+*  Return value
+*    ==true     The metadata is valid and matches the configuration.
+*    ==false    The metadata is invalid.
+*/
+static bool decode_meta(const mirror_inst_t * inst, mirror_meta_t * meta)
+{
+    const mirror_resync_t * resync = &inst->resync;
+    const U8 * header = resync->map_intent + (resync->num_sectors_bitmap * inst->bytes_per_sector);
+    bool is_valid = false;
+
+    if((load_u32(header + META_OFF_MAGIC) == META_MAGIC) &&
+       (load_u32(header + META_OFF_REGION_SIZE) == resync->region_size) &&
+       (load_u32(header + META_OFF_NUM_REGIONS) == resync->num_regions) &&
+       (load_u32(header + META_OFF_CHECK) == calc_meta_check(inst)))
+    {
+        meta->array_id       = load_u32(header + META_OFF_ARRAY_ID);
+        meta->sequence       = load_u32(header + META_OFF_SEQUENCE);
+        meta->stale_mask     = load_u32(header + META_OFF_STALE_MASK);
+        meta->rebuild_cursor = load_u32(header + META_OFF_REBUILD_CURSOR);
+        is_valid = (meta->rebuild_cursor < inst->num_sectors);
+    }
+
+    return is_valid;
+}
+
+/*********************************************************************
+*
+*       calc_array_id
+*
+*  Function description
+*    Generates the identifier of a new array.
+*
+*  Parameters
+*    seed   Hash of the metadata areas read from the replicas.
+*
+*  Additional information
+*    The identifier has to differ from the one of an array a replica
+*    belonged to before, so that the replica is detected as stale when
+*    it is added to this array. No random number generator is available
+*    to the driver. Therefore the contents found in the metadata areas,
+*    the time, the number of arrays created since start-up and the
+*    geometry of the replicas are combined. Two arrays can still get the
+*    same identifier if they are created at the same time on blank
+*    storage devices of the same size.
+*/
+static U32 calc_array_id(const mirror_inst_t * inst, U32 seed)
+{
+    U32 id;
+
+    mirror_num_arrays++;
+    id = mix_u32(seed, FS_X_OS_GetTime());
+    id = mix_u32(id, mirror_num_arrays);
+    id = mix_u32(id, inst->resync.num_regions);
+    for(U8 i = 0U; i < inst->num_storages; i++)
+    {
+        const mirror_storage_t * storage = &inst->storages[i];
+
+        id = mix_u32(id, storage->num_sectors);
+        id = mix_u32(id, ((U32)i << 8) | storage->device_unit);
+    }
+
+    return id;
+}
+
+/*********************************************************************
+*
+*       encode_meta
+*/
+static void encode_meta(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+    U8 * header = resync->map_intent + (resync->num_sectors_bitmap * inst->bytes_per_sector);
+
+    FS_MEMSET(header, 0, inst->bytes_per_sector);
+    store_u32(header + META_OFF_MAGIC,          META_MAGIC);
+    store_u32(header + META_OFF_ARRAY_ID,       resync->array_id);
+    store_u32(header + META_OFF_SEQUENCE,       resync->sequence);
+    store_u32(header + META_OFF_REGION_SIZE,    resync->region_size);
+    store_u32(header + META_OFF_NUM_REGIONS,    resync->num_regions);
+    store_u32(header + META_OFF_STALE_MASK,     resync->stale_mask);
+    store_u32(header + META_OFF_REBUILD_CURSOR, resync->rebuild_cursor);
+    store_u32(header + META_OFF_CHECK,          calc_meta_check(inst));
+}
+
+/*********************************************************************
+*
+*       get_slot_sector
+*/
+static U32 get_slot_sector(const mirror_inst_t * inst, U32 slot)
+{
+    return inst->resync.meta_start + (slot * (inst->resync.num_sectors_bitmap + 1U));
+}
+
+/*********************************************************************
+*
+*       select_source
+*
+*  Function description
+*    Selects the replica the dirty regions are copied from.
+*/
+static void select_source(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+
+    resync->source = 0U;
+    while((resync->source < inst->num_storages) &&
+          (((resync->failed_mask | resync->stale_mask) & (1UL << resync->source)) != 0U))
+    {
+        resync->source++;
+    }
+}
+
+/*********************************************************************
+*
+*       mark_failed
+*
+*  Function description
+*    Stops accessing the replicas that reported a write error.
+*
+*  Additional information
+*    A failed replica has to be rebuilt completely. The rebuild of the
+*    other stale replicas starts again with it.
+*/
+static void mark_failed(mirror_inst_t * inst, U32 fail_mask)
+{
+    mirror_resync_t * resync = &inst->resync;
+
+    if((resync->stale_mask & fail_mask) != fail_mask)
+    {
+        resync->rebuild_cursor = 0U;
+    }
+    resync->failed_mask |= fail_mask;
+    resync->stale_mask  |= fail_mask;
+    select_source(inst);
+}
+
+/*********************************************************************
+*
+*       save_meta
+*
+*  Function description
+*    Writes the bitmap and the state of the replicas to all the replicas
+*    that did not fail.
+*
+*  Return value
+*    ==0    OK, metadata written to at least one replica.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The two metadata slots are used alternately so that a slot with
+*    valid data remains if the write is interrupted.
+*/
+static int save_meta(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+    mirror_request_t req;
+    U32 fail_mask;
+
+    req.op          = OP_WRITE;
+    req.repeat_same = 0U;
+    req.num_sectors = resync->num_sectors_bitmap + 1U;
+    req.data        = resync->map_intent;
+    do
+    {
+        resync->sequence++;
+        encode_meta(inst);
+        req.sector_index = get_slot_sector(inst, resync->sequence % META_NUM_SLOTS);
+        fail_mask = write_storages(inst, &req, resync->failed_mask);
+        if(fail_mask != 0U)
+        {
+            mark_failed(inst, fail_mask);     /* Records the error on the remaining replicas. */
+        }
+    } while((fail_mask != 0U) && (resync->failed_mask != get_all_mask(inst)));
+
+    return (resync->failed_mask == get_all_mask(inst)) ? 1 : 0;
+}
+
+/*********************************************************************
+*
+*       load_map
+*
+*  Function description
+*    Loads the bitmap read into map_intent as the regions to be copied.
+*/
+static void load_map(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+
+    resync->num_regions_dirty = 0U;
+    for(U32 region = 0U; region < resync->num_regions; region++)
+    {
+        bool is_dirty = is_region_dirty(resync->map_intent, region);
+
+        set_region_dirty(resync->map_resync, region, is_dirty);
+        if(is_dirty)
+        {
+            resync->num_regions_dirty++;
+        }
+    }
+    resync->scan_region   = 0U;
+    resync->region_offset = 0U;
+}
+
+/*********************************************************************
+*
+*       mount_resync
+*
+*  Function description
+*    Reads the metadata of all the replicas and determines which of
+*    them have to be resynchronized.
+*
+*  Return value
+*    ==0    OK, state of the replicas known.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The metadata with the highest sequence number is used. A replica
+*    whose metadata is invalid, belongs to another array or is older
+*    is stale. The metadata of a replica may be one save behind if the
+*    power failed while the metadata was being written. Since the data
+*    is written only after the metadata has been saved on all the
+*    replicas, such a replica holds the same data. If no replica holds
+*    valid metadata, the replicas are considered new and in sync.
+*/
+static int mount_resync(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+    mirror_meta_t metas[FS_MIRROR_MAX_DEVICES];
+    U32 slots[FS_MIRROR_MAX_DEVICES];
+    U32 valid_mask = 0U;
+    U8  storage_ref = inst->num_storages;
+    U32 seed = 0U;
+    int r = 0;
+
+    resync->failed_mask = 0U;
+    for(U8 i = 0U; i < inst->num_storages; i++)
+    {
+        for(U32 slot = 0U; slot < META_NUM_SLOTS; slot++)
+        {
+            mirror_request_t req;
+            mirror_meta_t meta;
+
+            req.op            = OP_READ;
+            req.repeat_same   = 0U;
+            req.storage_index = i;
+            req.sector_index  = get_slot_sector(inst, slot);
+            req.num_sectors   = resync->num_sectors_bitmap + 1U;
+            req.data          = resync->map_intent;
+            if(transfer_storage(inst, &req) != 0)
+            {
+                resync->failed_mask |= 1UL << i;
+                valid_mask &= ~(1UL << i);
+                break;
+            }
+            seed = mix_u32(seed, calc_meta_check(inst));
+            if(decode_meta(inst, &meta) &&
+               (((valid_mask & (1UL << i)) == 0U) || ((I32)(meta.sequence - metas[i].sequence) > 0)))
+            {
+                metas[i]    = meta;
+                slots[i]    = slot;
+                valid_mask |= 1UL << i;
+            }
+        }
+        if(((valid_mask & (1UL << i)) != 0U) &&
+           ((storage_ref == inst->num_storages) || ((I32)(metas[i].sequence - metas[storage_ref].sequence) > 0)))
+        {
+            storage_ref = i;
+        }
+    }
+    if(resync->failed_mask == get_all_mask(inst))
+    {
+        r = 1;
+    }
+    else if(storage_ref == inst->num_storages)
+    {
+        /* New array. */
+        FS_MEMSET(resync->map_intent, 0, resync->num_sectors_bitmap * inst->bytes_per_sector);
+        resync->array_id       = calc_array_id(inst, seed);
+        resync->sequence       = 0U;
+        resync->stale_mask     = resync->failed_mask;
+        resync->rebuild_cursor = 0U;
+        load_map(inst);
+        select_source(inst);
+        r = save_meta(inst);
+    }
+    else
+    {
+        const mirror_meta_t * meta_ref = &metas[storage_ref];
+        mirror_request_t req;
+        U32 stale_mask;
+
+        resync->array_id       = meta_ref->array_id;
+        resync->sequence       = meta_ref->sequence;
+        resync->stale_mask     = meta_ref->stale_mask & get_all_mask(inst);
+        resync->rebuild_cursor = meta_ref->rebuild_cursor;
+        stale_mask = resync->failed_mask;
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            const mirror_meta_t * meta = &metas[i];
+
+            if(((valid_mask & (1UL << i)) == 0U) || (meta->array_id != resync->array_id) ||
+               ((meta->sequence != resync->sequence) && (meta->sequence != (resync->sequence - 1U))))
+            {
+                stale_mask |= 1UL << i;
+            }
+        }
+        if((resync->stale_mask & stale_mask) != stale_mask)
+        {
+            resync->rebuild_cursor = 0U;
+        }
+        resync->stale_mask |= stale_mask;
+        req.op            = OP_READ;
+        req.repeat_same   = 0U;
+        req.storage_index = storage_ref;
+        req.sector_index  = get_slot_sector(inst, slots[storage_ref]);
+        req.num_sectors   = resync->num_sectors_bitmap + 1U;
+        req.data          = resync->map_intent;
+        r = transfer_storage(inst, &req);
+        if(r == 0)
+        {
+            load_map(inst);
+            select_source(inst);
+            if(resync->source == inst->num_storages)
+            {
+                /* No replica holds a complete copy. Use the best one available. */
+                resync->source = storage_ref;
+                resync->stale_mask &= ~(1UL << storage_ref);
+            }
+            if((resync->stale_mask != meta_ref->stale_mask) || (resync->rebuild_cursor != meta_ref->rebuild_cursor) ||
+               (stale_mask != 0U))
+            {
+                r = save_meta(inst);
+            }
+        }
+    }
+    resync->time_last = FS_X_OS_GetTime();
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mark_intent
+*
+*  Function description
+*    Records the regions about to be written on all the replicas.
+*
+*  Return value
+*    ==0    OK, the regions can be written.
+*    !=0    An error occurred.
+*/
+static int mark_intent(mirror_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    mirror_resync_t * resync = &inst->resync;
+    bool is_changed = false;
+    int r = 0;
+
+    if(resync->buffer != NULL)
+    {
+        U32 region_last = (sector_index + num_sectors - 1U) / resync->region_size;
+
+        for(U32 region = sector_index / resync->region_size; region <= region_last; region++)
+        {
+            if(!is_region_dirty(resync->map_intent, region))
+            {
+                set_region_dirty(resync->map_intent, region, true);
+                is_changed = true;
+            }
+        }
+        if(is_changed)
+        {
+            r = save_meta(inst);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       clear_intent
+*
+*  Function description
+*    Removes the regions that are in sync from the stored bitmap.
+*
+*  Additional information
+*    Called when the file system requests that the data is written to
+*    the storage media, after the replicas have been synchronized.
+*/
+static int clear_intent(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+    U32 num_bytes = (resync->num_regions + 7U) / 8U;
+    int r = 0;
+
+    if((resync->buffer != NULL) && inst->is_inited &&
+       (FS_MEMCMP(resync->map_intent, resync->map_resync, num_bytes) != 0))
+    {
+        FS_MEMCPY(resync->map_intent, resync->map_resync, num_bytes);
+        r = save_meta(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       copy_sectors
+*
+*  Function description
+*    Copies sectors from the source replica to other replicas.
+*
+*  Return value
+*    ==0    OK, sectors copied to the replicas that did not fail.
+*    !=0    The sectors could not be read.
+*
+*  Additional information
+*    If the source replica cannot be read, the sectors are read from
+*    another replica and written to the source replica too. Otherwise
+*    the source replica would keep data that differs from the other
+*    replicas once the region is no longer dirty.
+*/
+static int copy_sectors(mirror_inst_t * inst, U32 sector_index, U32 num_sectors, U32 dest_mask)
+{
+    mirror_resync_t * resync = &inst->resync;
+    mirror_request_t req;
+    int r;
+
+    req.op            = OP_READ;
+    req.repeat_same   = 0U;
+    req.storage_index = resync->source;
+    req.sector_index  = sector_index;
+    req.num_sectors   = num_sectors;
+    req.data          = resync->copy_buffer;
+    r = transfer_storage(inst, &req);
+    if(r != 0)
+    {
+        r = read_with_retry(inst, &req, resync->failed_mask | resync->stale_mask | (1UL << resync->source));
+        dest_mask |= 1UL << resync->source;
+    }
+    if(r == 0)
+    {
+        U32 fail_mask;
+
+        req.op    = OP_WRITE;
+        fail_mask = write_storages(inst, &req, get_all_mask(inst) & ~dest_mask);
+        if(fail_mask != 0U)
+        {
+            mark_failed(inst, fail_mask);
+            (void) save_meta(inst);
+        }
+        inst->stat.ResyncSectorCnt += num_sectors;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_num_sectors_pending
+*
+*  Function description
+*    Returns the number of sectors that still have to be copied.
+*/
+static U32 get_num_sectors_pending(const mirror_inst_t * inst)
+{
+    const mirror_resync_t * resync = &inst->resync;
+    U32 num_sectors = 0U;
+
+    if((resync->buffer != NULL) && inst->is_inited && (resync->source < inst->num_storages))
+    {
+        num_sectors = (resync->num_regions_dirty * resync->region_size) - resync->region_offset;
+        if((resync->stale_mask & ~resync->failed_mask) != 0U)
+        {
+            num_sectors += inst->num_sectors - resync->rebuild_cursor;
+        }
+    }
+
+    return num_sectors;
+}
+
+/*********************************************************************
+*
+*       resync_step
+*
+*  Function description
+*    Copies a limited number of sectors to the replicas that are not
+*    in sync.
+*
+*  Return value
+*    ==0    OK, sectors copied or nothing to copy.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The dirty regions are copied first because they are read from the
+*    source replica only. The progress of the rebuild of stale replicas
+*    is saved regularly so that it can be continued after a power loss.
+*/
+static int resync_step(mirror_inst_t * inst, U32 num_sectors_max)
+{
+    mirror_resync_t * resync = &inst->resync;
+    U32 num_sectors_save = resync->region_size * FS_MIRROR_RESYNC_SAVE_REGIONS;
+    int r = 0;
+
+    while((r == 0) && (num_sectors_max != 0U) && (get_num_sectors_pending(inst) != 0U))
+    {
+        U32 dest_mask = get_all_mask(inst) & ~(resync->failed_mask | (1UL << resync->source));
+        U32 sector_index;
+        U32 num_sectors;
+
+        if(resync->num_regions_dirty != 0U)
+        {
+            U32 region = resync->scan_region;
+            U32 sector_end;
+
+            while(!is_region_dirty(resync->map_resync, region))
+            {
+                region = (region + 1U) % resync->num_regions;
+                resync->region_offset = 0U;
+            }
+            resync->scan_region = region;
+            sector_index = (region * resync->region_size) + resync->region_offset;
+            sector_end   = (region + 1U) * resync->region_size;
+            if(sector_end > inst->num_sectors)
+            {
+                sector_end = inst->num_sectors;
+            }
+            num_sectors = get_min(sector_end - sector_index, get_min(num_sectors_max, resync->num_sectors_copy));
+            if(dest_mask != 0U)
+            {
+                r = copy_sectors(inst, sector_index, num_sectors, dest_mask);
+            }
+            if(r == 0)
+            {
+                resync->region_offset += num_sectors;
+                if((sector_index + num_sectors) == sector_end)
+                {
+                    set_region_dirty(resync->map_resync, region, false);
+                    resync->num_regions_dirty--;
+                    resync->region_offset = 0U;
+                    resync->scan_region   = (region + 1U) % resync->num_regions;
+                }
+            }
+        }
+        else
+        {
+            sector_index = resync->rebuild_cursor;
+            num_sectors  = get_min(inst->num_sectors - sector_index, get_min(num_sectors_max, resync->num_sectors_copy));
+            r = copy_sectors(inst, sector_index, num_sectors, resync->stale_mask & dest_mask);
+            if((r == 0) && (resync->rebuild_cursor == sector_index))
+            {
+                resync->rebuild_cursor += num_sectors;
+                if(resync->rebuild_cursor == inst->num_sectors)
+                {
+                    resync->stale_mask    &= resync->failed_mask;
+                    resync->rebuild_cursor = 0U;
+                    r = save_meta(inst);
+                }
+                else if((resync->rebuild_cursor / num_sectors_save) != (sector_index / num_sectors_save))
+                {
+                    r = save_meta(inst);
+                }
+                else
+                {
+                    /* Progress is saved later. */
+                }
+            }
+        }
+        num_sectors_max -= num_sectors;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_step_sectors
+*/
+static U32 get_step_sectors(const mirror_inst_t * inst)
+{
+    return (inst->resync.step_sectors != 0U) ? inst->resync.step_sectors : inst->resync.num_sectors_copy;
+}
+
+/*********************************************************************
+*
+*       resync_if_due
+*
+*  Function description
+*    Performs a resynchronization step if the configured interval elapsed.
+*/
+static void resync_if_due(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+
+    if((resync->interval_ms != 0U) && (get_num_sectors_pending(inst) != 0U))
+    {
+        U32 time_now = FS_X_OS_GetTime();
+
+        if((time_now - resync->time_last) >= resync->interval_ms)
+        {
+            resync->time_last = time_now;
+            (void) resync_step(inst, get_step_sectors(inst));
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       init_resync
+*
+*  Function description
+*    Places the metadata at the end of the replicas and divides the
+*    buffer.
+*
+*  Return value
+*    ==0    OK, capacity known.
+*    !=0    The buffer is too small or the storage is too small.
+*
+*  Additional information
+*    Buffer layout: dirty-region bitmap as stored, header sector,
+*    copy buffer, bitmap of the regions to be copied.
+*/
+static int init_resync(mirror_inst_t * inst)
+{
+    mirror_resync_t * resync = &inst->resync;
+    U32 bytes_per_sector = inst->bytes_per_sector;
+    U32 num_bytes_map = FS_MIRROR_NUM_BYTES_BITMAP(inst->num_sectors, resync->region_size);
+    U32 num_bytes_meta;
+    int r = 1;
+
+    resync->num_sectors_bitmap = (num_bytes_map + bytes_per_sector - 1U) / bytes_per_sector;
+    num_bytes_meta = (resync->num_sectors_bitmap + 1U) * bytes_per_sector;
+    if((resync->num_bytes >= (num_bytes_meta + num_bytes_map + bytes_per_sector)) &&
+       (inst->num_sectors > (META_NUM_SLOTS * (resync->num_sectors_bitmap + 1U))))
+    {
+        inst->num_sectors       -= META_NUM_SLOTS * (resync->num_sectors_bitmap + 1U);
+        resync->meta_start       = inst->num_sectors;
+        resync->num_regions      = (inst->num_sectors + resync->region_size - 1U) / resync->region_size;
+        resync->map_intent       = resync->buffer;
+        resync->copy_buffer      = resync->buffer + num_bytes_meta;
+        resync->num_sectors_copy = (resync->num_bytes - num_bytes_meta - num_bytes_map) / bytes_per_sector;
+        resync->map_resync       = resync->copy_buffer + (resync->num_sectors_copy * bytes_per_sector);
+        r = mount_resync(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, capacity known.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    All the replicas have to use the same sector size. The capacity
+*    is determined by the smallest replica, less the metadata used for
+*    the resynchronization.
+*/
+static int init_if_required(mirror_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        U32 num_sectors = 0xFFFFFFFFUL;
+        U16 bytes_per_sector = 0U;
+
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            const mirror_storage_t * storage = &inst->storages[i];
+            FS_DEV_INFO dev_info;
+
+            FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+            r = storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+            if((r != 0) || (dev_info.BytesPerSector == 0U) ||
+               ((bytes_per_sector != 0U) && (bytes_per_sector != dev_info.BytesPerSector)))
+            {
+                r = 1;
+                break;
+            }
+            bytes_per_sector = dev_info.BytesPerSector;
+            inst->storages[i].num_sectors = dev_info.NumSectors;
+            if(dev_info.NumSectors < num_sectors)
+            {
+                num_sectors = dev_info.NumSectors;
+            }
+        }
+        if((r == 0) && (inst->num_storages != 0U))
+        {
+            inst->bytes_per_sector = bytes_per_sector;
+            inst->num_sectors      = num_sectors;
+            if(inst->resync.buffer != NULL)
+            {
+                r = init_resync(inst);
+            }
+            inst->is_inited = (r == 0);
+        }
+        else
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 17,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       mirror_get_name
+*/
+static const char * mirror_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "mirror";
+}
+
+/*********************************************************************
+*
+*       mirror_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int mirror_add_device(void)
+{
+    int r = -1;
+
+    if(mirror_num_units < FS_MIRROR_NUM_UNITS)
+    {
+        r = (int)mirror_num_units;
+        mirror_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_read
+*/
+static int mirror_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        mirror_request_t req;
+        U32 exclude_mask = get_read_exclude_mask(inst, SectorIndex, NumSectors);
+
+        req.op            = OP_READ;
+        req.repeat_same   = 0U;
+        req.storage_index = 0U;
+        req.sector_index  = SectorIndex;
+        req.num_sectors   = NumSectors;
+        req.data          = (U8 *)pBuffer;
+        inst->stat.ReadSectorCnt += NumSectors;
+        decay_load(inst);
+#if defined(COMPONENT_RTOS_AWARE)
+        if((inst->num_workers != 0U) && (NumSectors >= inst->min_split_sectors) && (exclude_mask == 0U))
+        {
+            inst->stat.ReadSplitCnt++;
+            r = read_split(inst, &req);
+        }
+        else
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        {
+            r = read_with_retry(inst, &req, exclude_mask);
+        }
+        resync_if_due(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_write
+*/
+static int mirror_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        mirror_request_t req;
+
+        req.op            = OP_WRITE;
+        req.repeat_same   = RepeatSame;
+        req.storage_index = 0U;
+        req.sector_index  = SectorIndex;
+        req.num_sectors   = NumSectors;
+        CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by the storage device drivers');
+        req.data          = (U8 *)pBuffer;
+        inst->stat.WriteSectorCnt += NumSectors;
+        r = mark_intent(inst, SectorIndex, NumSectors);
+        if(r == 0)
+        {
+            U32 fail_mask = write_storages(inst, &req, inst->resync.failed_mask);
+
+            if(inst->resync.buffer == NULL)
+            {
+                r = (fail_mask != 0U) ? 1 : 0;
+            }
+            else
+            {
+                /* The volume remains usable as long as one replica can be written. */
+                if(fail_mask != 0U)
+                {
+                    mark_failed(inst, fail_mask);
+                    r = save_meta(inst);
+                }
+                resync_if_due(inst);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_ioctl
+*
+*  Additional information
+*    The commands are sent to all the replicas.
+*/
+static int mirror_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_GET_DEVINFO:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = inst->storages[0].device_type->pfIoCtl(inst->storages[0].device_unit, Cmd, Aux, pBuffer);
+                if(r == 0)
+                {
+                    FS_DEV_INFO * dev_info = (FS_DEV_INFO *)pBuffer;
+
+                    dev_info->NumSectors = inst->num_sectors;
+                }
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+        case FS_CMD_GET_CLEAN_CNT:
+            {
+                int value_total = 0;
+
+                if(inst->resync.buffer != NULL)
+                {
+                    (void) init_if_required(inst);
+                }
+                r = 0;
+                if(get_num_sectors_pending(inst) != 0U)
+                {
+                    U32 step_sectors = get_step_sectors(inst);
+
+                    if(Cmd == FS_CMD_CLEAN_ONE)
+                    {
+                        /* The replicas are cleaned after the resynchronization. */
+                        r = (resync_step(inst, step_sectors) == 0) ? 0 : -1;
+                        if(pBuffer != NULL)
+                        {
+                            *(int *)pBuffer = 1;
+                        }
+                        break;
+                    }
+                    value_total = (int)((get_num_sectors_pending(inst) + step_sectors - 1U) / step_sectors);
+                }
+                for(U8 i = 0U; i < inst->num_storages; i++)
+                {
+                    int value = 0;
+
+                    if(inst->storages[i].device_type->pfIoCtl(inst->storages[i].device_unit, Cmd, Aux, &value) != 0)
+                    {
+                        r = -1;
+                    }
+                    if(Cmd == FS_CMD_CLEAN_ONE)
+                    {
+                        value_total |= value;           /* More to clean on any replica. */
+                    }
+                    else
+                    {
+                        value_total += value;
+                    }
+                }
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = value_total;
+                }
+            }
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+#if defined(COMPONENT_RTOS_AWARE)
+            stop_workers(inst);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+            FS_MEMSET(inst, 0, sizeof(mirror_inst_t));
+            if(mirror_num_units != 0U)
+            {
+                mirror_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        case FS_CMD_CLEAN:
+            r = 0;
+            if((inst->resync.buffer != NULL) && (init_if_required(inst) == 0))
+            {
+                while((r == 0) && (get_num_sectors_pending(inst) != 0U))
+                {
+                    r = resync_step(inst, get_step_sectors(inst));
+                }
+                if(r == 0)
+                {
+                    r = clear_intent(inst);
+                }
+            }
+            if(r == 0)
+            {
+                r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            }
+            break;
+        case FS_CMD_SYNC:
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            if(r == 0)
+            {
+                r = clear_intent(inst);         /* Only after the data is on the storage media. */
+            }
+            break;
+        default:
+            if((Cmd == FS_CMD_UNMOUNT) && (inst->resync.buffer != NULL) && inst->is_inited)
+            {
+                if(forward_ioctl(inst, FS_CMD_SYNC, 0, NULL) == 0)
+                {
+                    (void) clear_intent(inst);
+                }
+            }
+            if((Cmd == FS_CMD_UNMOUNT) || (Cmd == FS_CMD_UNMOUNT_FORCED))
+            {
+                inst->is_inited = false;        /* The storage media can be replaced while unmounted. */
+            }
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_init_medium
+*/
+static int mirror_init_medium(U8 Unit)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        r = 0;
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            if(inst->storages[i].device_type->pfInitMedium != NULL)
+            {
+                r = inst->storages[i].device_type->pfInitMedium(inst->storages[i].device_unit);
+                if(r != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_get_status
+*
+*  Return value
+*    FS_MEDIA_IS_PRESENT only if all the storage media are present.
+*/
+static int mirror_get_status(U8 Unit)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        r = FS_MEDIA_IS_PRESENT;
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            int status = inst->storages[i].device_type->pfGetStatus(inst->storages[i].device_unit);
+
+            if(status == FS_MEDIA_NOT_PRESENT)
+            {
+                r = FS_MEDIA_NOT_PRESENT;
+                break;
+            }
+            if(status != FS_MEDIA_IS_PRESENT)
+            {
+                r = status;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mirror_get_num_units
+*/
+static int mirror_get_num_units(void)
+{
+    return (int)mirror_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_MIRROR_Driver =
+{
+    mirror_get_name,
+    mirror_add_device,
+    mirror_read,
+    mirror_write,
+    mirror_ioctl,
+    mirror_init_medium,
+    mirror_get_status,
+    mirror_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_AddStorage
+****************************************************************************//**
+*
+*  Assigns a replica to a driver instance. Has to be called from
+*  FS_X_AddDevices() after the driver has been added via FS_AddDevice().
+*  The storage device has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Replica assigned.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters, too many replicas
+*                                or parallel transfers enabled.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_AddStorage(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (inst->num_storages < FS_MIRROR_MAX_DEVICES))
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        if(inst->num_workers == 0U)
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        {
+            inst->storages[inst->num_storages].device_type = pDeviceType;
+            inst->storages[inst->num_storages].device_unit = DeviceUnit;
+            inst->storages[inst->num_storages].load        = 0U;
+            inst->num_storages++;
+            inst->is_inited = false;
+            result = FS_MIRROR_RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_SetReadPolicy
+****************************************************************************//**
+*
+*  Selects how the replica that serves a read request is chosen.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   Policy        FS_MIRROR_READ_PRIMARY, FS_MIRROR_READ_ROUND_ROBIN,
+*                 FS_MIRROR_READ_RANGE or FS_MIRROR_READ_LEAST_LOADED.
+*   RangeSize     Number of consecutive sectors served by the same
+*                 replica with FS_MIRROR_READ_RANGE. Ignored otherwise.
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Policy selected.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters.
+*
+*  FS_MIRROR_READ_RANGE keeps the sectors read by a replica local, which
+*  helps storage devices with an internal cache. Since the file system
+*  sends one request at a time, FS_MIRROR_READ_LEAST_LOADED balances the
+*  number of sectors recently read from each replica instead of the
+*  number of outstanding requests.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_SetReadPolicy(U8 Unit, U8 Policy, U32 RangeSize)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (Policy <= FS_MIRROR_READ_LEAST_LOADED) &&
+       ((Policy != FS_MIRROR_READ_RANGE) || (RangeSize != 0U)))
+    {
+        inst->read_policy  = Policy;
+        inst->range_size   = RangeSize;
+        inst->storage_next = 0U;
+        result = FS_MIRROR_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_SetParallel
+****************************************************************************//**
+*
+*  Enables or disables the parallel access to the replicas. Has to be
+*  called after all the replicas have been assigned.
+*
+*  Parameters
+*   Unit              Index of the driver instance (0-based).
+*   OnOff             1 to start one worker task per additional replica,
+*                     0 to stop the worker tasks.
+*   MinSplitSectors   Minimum number of sectors of a read request to be
+*                     split between the replicas.
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Mode changed.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters.
+*   FS_MIRROR_RESULT_ERROR       The worker tasks could not be created or
+*                                the application is built without an RTOS.
+*
+*  While enabled, the writes to the replicas are performed at the same
+*  time and large read requests are split into one part of consecutive
+*  sectors per replica. The storage device drivers have to support being
+*  called from different tasks at the same time for different units.
+*  No file system operation may be in progress on the volume when the
+*  mode is changed.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_SetParallel(U8 Unit, U8 OnOff, U32 MinSplitSectors)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (inst->num_storages != 0U) && ((OnOff == 0U) || (MinSplitSectors >= inst->num_storages)))
+    {
+        result = FS_MIRROR_RESULT_OK;
+#if defined(COMPONENT_RTOS_AWARE)
+        if(OnOff != 0U)
+        {
+            inst->min_split_sectors = MinSplitSectors;
+            if(start_workers(inst, Unit) != 0)
+            {
+                result = FS_MIRROR_RESULT_ERROR;
+            }
+        }
+        else
+        {
+            stop_workers(inst);
+        }
+#else
+        if(OnOff != 0U)
+        {
+            result = FS_MIRROR_RESULT_ERROR;
+        }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_ConfigureResync
+****************************************************************************//**
+*
+*  Enables the resynchronization of the replicas. Has to be called from
+*  FS_X_AddDevices() after the replicas have been assigned.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   RegionSize    Number of sectors per region of the dirty-region bitmap.
+*   pBuffer       Buffer for the bitmaps and for copying sectors.
+*   NumBytes      Number of bytes in pBuffer. FS_SIZEOF_MIRROR_RESYNC()
+*                 can be used to calculate it.
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Resynchronization enabled.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters.
+*
+*  The driver stores two copies of a bitmap with one bit per region and
+*  of the state of the replicas at the end of each replica, which reduces
+*  the capacity of the volume. The volume has to be formatted after the
+*  resynchronization is enabled. Before a region is written for the first
+*  time after the data was synchronized by the file system, its bit is
+*  set on all the replicas. After an unclean shutdown, only the regions
+*  whose bit is set are copied from one replica to the others; until
+*  then, they are read from that replica only. Larger regions reduce the
+*  number of bitmap updates but increase the number of sectors copied.
+*  A replica that holds no or older metadata, for example a replacement
+*  storage device, and a replica that reported a write error are rebuilt
+*  completely. A replacement storage device must not hold the metadata
+*  of another array. If no replica holds valid metadata, the replicas
+*  are assumed to be in sync.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_ConfigureResync(U8 Unit, U32 RegionSize, void * pBuffer, U32 NumBytes)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (RegionSize != 0U) && (pBuffer != NULL) && (NumBytes != 0U))
+    {
+        FS_MEMSET(&inst->resync, 0, sizeof(inst->resync));
+        inst->resync.buffer      = (U8 *)pBuffer;
+        inst->resync.num_bytes   = NumBytes;
+        inst->resync.region_size = RegionSize;
+        inst->resync.interval_ms = FS_MIRROR_RESYNC_INTERVAL_MS;
+        inst->is_inited = false;
+        result = FS_MIRROR_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_SetResyncRate
+****************************************************************************//**
+*
+*  Limits the rate at which sectors are copied between the replicas.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   NumSectors    Maximum number of sectors copied per step.
+*   IntervalMs    Minimum time in milliseconds between two steps performed
+*                 while the file system accesses the volume. 0 disables
+*                 these steps.
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Rate changed.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters.
+*
+*  A step is performed after a read or write request when the interval
+*  has elapsed, which requires FS_X_OS_GetTime() to return the system
+*  time in milliseconds. In addition, each call to FS_STORAGE_CleanOne()
+*  performs one step, so an application task can continue the
+*  resynchronization while the volume is idle. FS_STORAGE_Clean()
+*  completes it. FS_STORAGE_GetCleanCnt() includes the number of steps
+*  still required.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_SetResyncRate(U8 Unit, U32 NumSectors, U32 IntervalMs)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (inst->resync.buffer != NULL) && (NumSectors != 0U))
+    {
+        inst->resync.step_sectors = NumSectors;
+        inst->resync.interval_ms  = IntervalMs;
+        result = FS_MIRROR_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_MIRROR_GetResyncStatus
+****************************************************************************//**
+*
+*  Returns the progress of the resynchronization.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pStatus       [OUT] State of the replicas.
+*
+*  Return Value
+*   FS_MIRROR_RESULT_OK          Status returned.
+*   FS_MIRROR_RESULT_BADPARAM    Invalid parameters.
+*   FS_MIRROR_RESULT_ERROR       The resynchronization is not enabled or
+*                                the volume has not been accessed yet.
+*
+*  The values can be out of date by one request if the function is called
+*  while the file system accesses the volume.
+*
+*******************************************************************************/
+FS_MIRROR_Result_t FS_MIRROR_GetResyncStatus(U8 Unit, FS_MIRROR_RESYNC_STATUS * pStatus)
+{
+    FS_MIRROR_Result_t result = FS_MIRROR_RESULT_BADPARAM;
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStatus != NULL))
+    {
+        const mirror_resync_t * resync = &inst->resync;
+
+        result = FS_MIRROR_RESULT_ERROR;
+        if((resync->buffer != NULL) && inst->is_inited)
+        {
+            pStatus->NumSectors        = inst->num_sectors;
+            pStatus->NumSectorsRebuilt = ((resync->stale_mask & ~resync->failed_mask) != 0U) ? resync->rebuild_cursor : inst->num_sectors;
+            pStatus->NumRegions        = resync->num_regions;
+            pStatus->NumRegionsDirty   = resync->num_regions_dirty;
+            pStatus->StaleMask         = resync->stale_mask;
+            pStatus->FailedMask        = resync->failed_mask;
+            if(resync->source == inst->num_storages)
+            {
+                pStatus->OperatingMode = FS_RAID_OPERATING_MODE_FAILURE;
+            }
+            else if(resync->stale_mask != 0U)
+            {
+                pStatus->OperatingMode = FS_RAID_OPERATING_MODE_DEGRADED;
+            }
+            else
+            {
+                pStatus->OperatingMode = FS_RAID_OPERATING_MODE_NORMAL;
+            }
+            result = FS_MIRROR_RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_MIRROR_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_MIRROR_GetStatCounters(U8 Unit, FS_MIRROR_STAT_COUNTERS * pStat)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_MIRROR_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_MIRROR_ResetStatCounters(U8 Unit)
+{
+    mirror_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
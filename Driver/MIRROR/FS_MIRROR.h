@@ -0,0 +1,161 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_MIRROR.h
+Purpose     : Logical driver that mirrors the sectors on several storage devices.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_MIRROR_H     // Avoid recursive and multiple inclusion
+#define FS_MIRROR_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_MIRROR_NUM_UNITS
+#define FS_MIRROR_NUM_UNITS             (1U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_MIRROR_MAX_DEVICES
+#define FS_MIRROR_MAX_DEVICES           (3U)    /* Maximum number of replicas per driver instance. */
+#endif
+
+#ifndef FS_MIRROR_STACK_SIZE
+#define FS_MIRROR_STACK_SIZE            (2048U) /* Stack size in bytes of the tasks that access the storage devices in parallel. */
+#endif
+
+#ifndef FS_MIRROR_RESYNC_INTERVAL_MS
+#define FS_MIRROR_RESYNC_INTERVAL_MS    (100U)  /* Default minimum time in milliseconds between two resynchronization steps. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Selection of the replica that serves a read request. */
+#define FS_MIRROR_READ_PRIMARY          (0U)    /* The first storage device. Default. */
+#define FS_MIRROR_READ_ROUND_ROBIN      (1U)    /* The replicas in turn. */
+#define FS_MIRROR_READ_RANGE            (2U)    /* The replica assigned to the range of sectors. */
+#define FS_MIRROR_READ_LEAST_LOADED     (3U)    /* The replica that transferred the fewest sectors recently. */
+
+/* Number of bytes in a dirty-region bitmap. */
+#define FS_MIRROR_NUM_BYTES_BITMAP(NumSectors, RegionSize)                         \
+    (((((NumSectors) + (RegionSize)) - 1U) / (RegionSize) + 7U) / 8U)
+
+/* Number of bytes in the buffer passed to FS_MIRROR_ConfigureResync(). NumSectors is the
+   number of sectors of the smallest replica, NumSectorsCopy the number of sectors copied at once. */
+#define FS_SIZEOF_MIRROR_RESYNC(NumSectors, RegionSize, BytesPerSector, NumSectorsCopy)                            \
+    ((((FS_MIRROR_NUM_BYTES_BITMAP(NumSectors, RegionSize) + (BytesPerSector)) - 1U) / (BytesPerSector) + 1U +   \
+      (NumSectorsCopy)) * (BytesPerSector) + FS_MIRROR_NUM_BYTES_BITMAP(NumSectors, RegionSize))
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCnt;                                  /* Number of sectors read by the file system. */
+    U32 WriteSectorCnt;                                 /* Number of sectors written by the file system. */
+    U32 ReadSectorCntPerDevice[FS_MIRROR_MAX_DEVICES];  /* Number of sectors read from each replica. */
+    U32 ReadSplitCnt;                                   /* Number of read requests split between the replicas. */
+    U32 ReadRetryCnt;                                   /* Number of read requests repeated on another replica after an error. */
+    U32 ResyncSectorCnt;                                /* Number of sectors copied to resynchronize the replicas. */
+} FS_MIRROR_STAT_COUNTERS;
+
+typedef struct
+{
+    U32 NumSectors;                                     /* Number of sectors of the volume. */
+    U32 NumSectorsRebuilt;                              /* Number of sectors already copied to the stale replicas. */
+    U32 NumRegions;                                     /* Number of regions of the dirty-region bitmap. */
+    U32 NumRegionsDirty;                                /* Number of regions still to be copied after an unclean shutdown. */
+    U32 StaleMask;                                      /* Replicas without a complete copy of the data (bit n for replica n). */
+    U32 FailedMask;                                     /* Replicas not accessed anymore after a write error (bit n for replica n). */
+    U8  OperatingMode;                                  /* FS_RAID_OPERATING_MODE_NORMAL, _DEGRADED or _FAILURE. */
+} FS_MIRROR_RESYNC_STATUS;
+
+typedef enum
+{
+    FS_MIRROR_RESULT_OK = 0U,
+    FS_MIRROR_RESULT_BADPARAM,
+    FS_MIRROR_RESULT_ERROR,
+} FS_MIRROR_Result_t;
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_MIRROR_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_MIRROR_Result_t FS_MIRROR_AddStorage         (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit);
+FS_MIRROR_Result_t FS_MIRROR_SetReadPolicy      (U8 Unit, U8 Policy, U32 RangeSize);
+FS_MIRROR_Result_t FS_MIRROR_SetParallel        (U8 Unit, U8 OnOff, U32 MinSplitSectors);
+FS_MIRROR_Result_t FS_MIRROR_ConfigureResync    (U8 Unit, U32 RegionSize, void * pBuffer, U32 NumBytes);
+FS_MIRROR_Result_t FS_MIRROR_SetResyncRate      (U8 Unit, U32 NumSectors, U32 IntervalMs);
+FS_MIRROR_Result_t FS_MIRROR_GetResyncStatus    (U8 Unit, FS_MIRROR_RESYNC_STATUS * pStatus);
+void               FS_MIRROR_GetStatCounters    (U8 Unit, FS_MIRROR_STAT_COUNTERS * pStat);
+void               FS_MIRROR_ResetStatCounters  (U8 Unit);
+
+#endif  // FS_MIRROR_H
+
+/*************************** End of file ****************************/
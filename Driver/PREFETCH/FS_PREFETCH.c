@@ -0,0 +1,922 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_PREFETCH.c
+Purpose     : Logical driver that reads sectors in advance based on the
+              detected access pattern.
+              The read requests are assigned to streams by their distance
+              to the previous requests so that the accesses to the FAT and
+              to the directories do not disturb the detection of a file
+              being read. A stream that reads sectors at a constant
+              distance, forward or backward, reads a window of sectors in
+              advance with a single request to the storage device. The
+              window grows while the sectors read in advance are used and
+              shrinks when they are not. Random accesses and strides that
+              would waste more than half of the transferred sectors are
+              passed to the storage device unchanged.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_PREFETCH.h"
+#include "FS_HINT.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*      Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_PREFETCH_MAX_DISTANCE
+#define FS_PREFETCH_MAX_DISTANCE        (64U)   /* Maximum distance in sectors of a request to the previous one of the same stream. */
+#endif
+
+#ifndef FS_PREFETCH_MIN_MATCHES
+#define FS_PREFETCH_MIN_MATCHES         (2U)    /* Number of requests at the same distance before reading in advance. */
+#endif
+
+#ifndef FS_PREFETCH_MAX_WASTE_PERCENT
+#define FS_PREFETCH_MAX_WASTE_PERCENT   (50U)   /* Maximum share of the sectors read in advance that are skipped by a stride. */
+#endif
+
+#ifndef FS_PREFETCH_INITIAL_REQUESTS
+#define FS_PREFETCH_INITIAL_REQUESTS    (4U)    /* Initial window size as number of requests. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define STREAM_NONE                     (0xFFU)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U8  * buffer;
+    U32   buf_first;            /* Index of the first sector in the buffer. */
+    U32   buf_num;              /* Number of sectors in the buffer, 0 if empty. */
+    U32   buf_num_used;         /* Number of sectors requested from the buffer. */
+    U32   last_sector;          /* First sector of the last request. */
+    U32   last_num;             /* Number of sectors of the last request. */
+    I32   stride;               /* Distance between the first sectors of the last two requests. */
+    U32   num_matches;          /* Number of consecutive requests at the distance stride. */
+    U32   window;               /* Number of sectors to be read in advance, 0 if not determined yet. */
+    U32   time_used;
+    bool  is_active;
+} prefetch_stream_t;
+
+typedef struct
+{
+    const FS_DEVICE_TYPE      * device_type;
+    U8                          device_unit;
+    bool                        is_inited;      /* Set when the buffer layout has been calculated. */
+    U8                        * buffer;
+    U32                         buffer_size;
+    U16                         bytes_per_sector;
+    U32                         num_sectors_device;
+    U32                         max_window;     /* Number of sectors that fit in the buffer of a stream. */
+    U32                         time_now;
+    prefetch_stream_t           streams[FS_PREFETCH_NUM_STREAMS];
+    FS_PREFETCH_STAT_COUNTERS   stat;
+} prefetch_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static prefetch_inst_t prefetch_inst[FS_PREFETCH_NUM_UNITS];
+static U8              prefetch_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static prefetch_inst_t * get_inst(U8 unit)
+{
+    prefetch_inst_t * inst = NULL;
+
+    if(unit < FS_PREFETCH_NUM_UNITS)
+    {
+        inst = &prefetch_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       get_distance
+*/
+static U32 get_distance(U32 sector_index0, U32 sector_index1)
+{
+    return (sector_index0 > sector_index1) ? (sector_index0 - sector_index1) : (sector_index1 - sector_index0);
+}
+
+/*********************************************************************
+*
+*       drop_buffer
+*
+*  Function description
+*    Empties the buffer of a stream and accounts the sectors read in
+*    advance that were not used.
+*/
+static void drop_buffer(prefetch_inst_t * inst, prefetch_stream_t * stream)
+{
+    if(stream->buf_num > stream->buf_num_used)
+    {
+        inst->stat.DiscardSectorCnt += stream->buf_num - stream->buf_num_used;
+    }
+    stream->buf_num      = 0U;
+    stream->buf_num_used = 0U;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, buffers ready.
+*    !=0    An error occurred.
+*/
+static int init_if_required(prefetch_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info;
+
+        FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+        r = inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+        if((r == 0) && (dev_info.BytesPerSector != 0U))
+        {
+            U32 max_window = inst->buffer_size / ((U32)dev_info.BytesPerSector * FS_PREFETCH_NUM_STREAMS);
+
+            if(max_window < 2U)
+            {
+                r = 1;          /* Buffer too small. */
+            }
+            else
+            {
+                inst->bytes_per_sector   = dev_info.BytesPerSector;
+                inst->num_sectors_device = dev_info.NumSectors;
+                inst->max_window         = max_window;
+                inst->time_now           = 0U;
+                FS_MEMSET(inst->streams, 0, sizeof(inst->streams));
+                for(U32 i = 0U; i < FS_PREFETCH_NUM_STREAMS; i++)
+                {
+                    inst->streams[i].buffer = inst->buffer + (i * max_window * dev_info.BytesPerSector);
+                }
+                inst->is_inited = true;
+            }
+        }
+        else
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_stream
+*
+*  Function description
+*    Returns the stream a read request belongs to.
+*
+*  Additional information
+*    A request belongs to the stream that buffers its first sector or
+*    to the stream with the closest previous request. A request too far
+*    away from all streams starts a new stream replacing, in this order,
+*    an unused stream, the least recently used stream without a detected
+*    pattern or the least recently used stream.
+*/
+static prefetch_stream_t * get_stream(prefetch_inst_t * inst, U32 sector_index, bool * p_is_new)
+{
+    U8  stream_found = STREAM_NONE;
+    U32 distance_min = FS_PREFETCH_MAX_DISTANCE + 1U;
+    prefetch_stream_t * stream;
+
+    for(U8 i = 0U; i < FS_PREFETCH_NUM_STREAMS; i++)
+    {
+        stream = &inst->streams[i];
+        if(stream->is_active)
+        {
+            U32 distance = get_distance(sector_index, stream->last_sector);
+
+            if((stream->buf_num != 0U) && (sector_index >= stream->buf_first) && ((sector_index - stream->buf_first) < stream->buf_num))
+            {
+                distance = 0U;
+            }
+            if(distance < distance_min)
+            {
+                distance_min = distance;
+                stream_found = i;
+            }
+        }
+    }
+
+    *p_is_new = false;
+    if(stream_found == STREAM_NONE)
+    {
+        U32 age_max = 0U;
+        bool is_confirmed_found = true;
+
+        for(U8 i = 0U; i < FS_PREFETCH_NUM_STREAMS; i++)
+        {
+            U32 age;
+            bool is_confirmed;
+
+            stream = &inst->streams[i];
+            if(!stream->is_active)
+            {
+                stream_found = i;
+                break;
+            }
+            age = inst->time_now - stream->time_used;
+            is_confirmed = (stream->num_matches >= FS_PREFETCH_MIN_MATCHES);
+            if((stream_found == STREAM_NONE) || (is_confirmed_found && !is_confirmed) ||
+               ((is_confirmed_found == is_confirmed) && (age > age_max)))
+            {
+                stream_found = i;
+                age_max = age;
+                is_confirmed_found = is_confirmed;
+            }
+        }
+        stream = &inst->streams[stream_found];
+        drop_buffer(inst, stream);
+        stream->is_active   = true;
+        stream->last_sector = sector_index;
+        stream->last_num    = 0U;
+        stream->stride      = 0;
+        stream->num_matches = 0U;
+        stream->window      = 0U;
+        *p_is_new = true;
+    }
+
+    return &inst->streams[stream_found];
+}
+
+/*********************************************************************
+*
+*       update_pattern
+*/
+static void update_pattern(prefetch_stream_t * stream, U32 sector_index, U32 num_sectors)
+{
+    I32 stride = (I32)(sector_index - stream->last_sector);
+
+    if((stride == stream->stride) && (stride != 0))
+    {
+        stream->num_matches++;
+    }
+    else
+    {
+        stream->stride      = stride;
+        stream->num_matches = 1U;
+        stream->window      = 0U;       /* Start again with the initial window. */
+    }
+    stream->last_sector = sector_index;
+    stream->last_num    = num_sectors;
+}
+
+/*********************************************************************
+*
+*       get_stride_span
+*
+*  Function description
+*    Returns the number of sectors a request of the stream advances
+*    the read-ahead window, at least the size of the request.
+*/
+static U32 get_stride_span(const prefetch_stream_t * stream)
+{
+    U32 span = (stream->stride < 0) ? (U32)(-stream->stride) : (U32)stream->stride;
+
+    if(span < stream->last_num)
+    {
+        span = stream->last_num;
+    }
+
+    return span;
+}
+
+/*********************************************************************
+*
+*       is_pattern_detected
+*
+*  Function description
+*    Checks if reading in advance is worthwhile for a stream.
+*
+*  Additional information
+*    The requests have to be at the same distance and the gaps between
+*    them must not exceed FS_PREFETCH_MAX_WASTE_PERCENT of the sectors
+*    read in advance because the gaps are transferred as well.
+*/
+static bool is_pattern_detected(const prefetch_stream_t * stream)
+{
+    bool r = false;
+
+    if((stream->num_matches >= FS_PREFETCH_MIN_MATCHES) && (stream->stride != 0))
+    {
+        U32 span = get_stride_span(stream);
+
+        r = ((span - stream->last_num) * 100U) <= (span * FS_PREFETCH_MAX_WASTE_PERCENT);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       force_sequential
+*
+*  Function description
+*    Sets up a stream declared as sequential via FS_ACCESS_HINT_SEQUENTIAL
+*    without waiting for the pattern to be detected. The read-ahead
+*    starts with the largest window.
+*/
+static void force_sequential(const prefetch_inst_t * inst, prefetch_stream_t * stream)
+{
+    stream->stride      = (I32)stream->last_num;
+    stream->num_matches = FS_PREFETCH_MIN_MATCHES;
+    stream->window      = inst->max_window;
+}
+
+/*********************************************************************
+*
+*       adapt_window
+*
+*  Function description
+*    Calculates the number of sectors to be read in advance from the
+*    usage of the previously read sectors.
+*
+*  Additional information
+*    The window is doubled when at least 3/4 of the sectors expected to
+*    be requested were requested before the stream left the window and
+*    halved when less than half were. With strides only every n-th sector
+*    is expected to be requested.
+*/
+static void adapt_window(prefetch_inst_t * inst, prefetch_stream_t * stream)
+{
+    U32 span = get_stride_span(stream);
+    U32 window_min = span;
+
+    if(stream->window == 0U)
+    {
+        stream->window = span * FS_PREFETCH_INITIAL_REQUESTS;
+    }
+    else if(stream->buf_num != 0U)
+    {
+        U32 num_expected = (stream->buf_num * stream->last_num) / span;
+
+        if((stream->buf_num_used * 4U) >= (num_expected * 3U))
+        {
+            if(stream->window < inst->max_window)
+            {
+                stream->window *= 2U;
+                inst->stat.WindowGrowCnt++;
+            }
+        }
+        else if((stream->buf_num_used * 2U) < num_expected)
+        {
+            if(stream->window > window_min)
+            {
+                stream->window /= 2U;
+                inst->stat.WindowShrinkCnt++;
+            }
+        }
+        else
+        {
+            /* Keep the size. */
+        }
+    }
+    else
+    {
+        /* First read of the pattern. */
+    }
+
+    if(stream->window > inst->max_window)
+    {
+        stream->window = inst->max_window;
+    }
+    if(stream->window < window_min)
+    {
+        stream->window = window_min;
+    }
+}
+
+/*********************************************************************
+*
+*       fill_buffer
+*
+*  Function description
+*    Reads the requested sectors together with the ones expected to be
+*    requested next into the buffer of the stream.
+*
+*  Return value
+*    ==0    OK, requested sectors buffered.
+*    !=0    An error occurred.
+*/
+static int fill_buffer(prefetch_inst_t * inst, prefetch_stream_t * stream, U32 sector_index, U32 num_sectors)
+{
+    U32 first_sector;
+    U32 num_sectors_read = stream->window;
+    int r;
+
+    if(num_sectors_read < num_sectors)
+    {
+        num_sectors_read = num_sectors;
+    }
+    if(stream->stride > 0)
+    {
+        first_sector = sector_index;
+        if((inst->num_sectors_device > first_sector) && (num_sectors_read > (inst->num_sectors_device - first_sector)))
+        {
+            num_sectors_read = inst->num_sectors_device - first_sector;
+        }
+    }
+    else
+    {
+        U32 end_sector = sector_index + num_sectors;
+
+        if(num_sectors_read > end_sector)
+        {
+            num_sectors_read = end_sector;
+        }
+        first_sector = end_sector - num_sectors_read;
+    }
+
+    drop_buffer(inst, stream);
+    r = inst->device_type->pfRead(inst->device_unit, first_sector, stream->buffer, num_sectors_read);
+    if(r == 0)
+    {
+        stream->buf_first = first_sector;
+        stream->buf_num   = num_sectors_read;
+        inst->stat.PrefetchSectorCnt += num_sectors_read;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       update_buffers
+*
+*  Function description
+*    Copies written sectors to the buffers that store them.
+*/
+static void update_buffers(prefetch_inst_t * inst, U32 sector_index, const U8 * data, U32 num_sectors, U8 repeat_same)
+{
+    for(U32 i = 0U; i < FS_PREFETCH_NUM_STREAMS; i++)
+    {
+        prefetch_stream_t * stream = &inst->streams[i];
+
+        if(stream->buf_num != 0U)
+        {
+            for(U32 k = 0U; k < num_sectors; k++)
+            {
+                U32 off = (sector_index + k) - stream->buf_first;
+
+                if(((sector_index + k) >= stream->buf_first) && (off < stream->buf_num))
+                {
+                    FS_MEMCPY(stream->buffer + (off * inst->bytes_per_sector),
+                              (repeat_same != 0U) ? data : (data + (k * inst->bytes_per_sector)), inst->bytes_per_sector);
+                }
+            }
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       invalidate_range
+*/
+static void invalidate_range(prefetch_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    for(U32 i = 0U; i < FS_PREFETCH_NUM_STREAMS; i++)
+    {
+        prefetch_stream_t * stream = &inst->streams[i];
+
+        if((stream->buf_num != 0U) && (first_sector < (stream->buf_first + stream->buf_num)) && (stream->buf_first < (first_sector + num_sectors)))
+        {
+            drop_buffer(inst, stream);
+        }
+    }
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 12,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       prefetch_get_name
+*/
+static const char * prefetch_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "prefetch";
+}
+
+/*********************************************************************
+*
+*       prefetch_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int prefetch_add_device(void)
+{
+    int r = -1;
+
+    if(prefetch_num_units < FS_PREFETCH_NUM_UNITS)
+    {
+        r = (int)prefetch_num_units;
+        prefetch_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_read
+*
+*  Function description
+*    Reads sectors from the read-ahead buffer or from the storage device.
+*
+*  Additional information
+*    Requests larger than the buffer of a stream and requests with the
+*    FS_ACCESS_HINT_RANDOM hint are passed to the storage device unchanged.
+*    With the FS_ACCESS_HINT_SEQUENTIAL hint the read-ahead starts with
+*    the first request.
+*/
+static int prefetch_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+    U8  hint = FS_HINT_GetCurrent();
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        if((init_if_required(inst) != 0) || (NumSectors > inst->max_window) || (hint == FS_ACCESS_HINT_RANDOM))
+        {
+            r = inst->device_type->pfRead(inst->device_unit, SectorIndex, pBuffer, NumSectors);
+        }
+        else
+        {
+            bool is_new;
+            prefetch_stream_t * stream = get_stream(inst, SectorIndex, &is_new);
+
+            inst->stat.ReadSectorCnt += NumSectors;
+            inst->time_now++;
+            stream->time_used = inst->time_now;
+            if(!is_new)
+            {
+                update_pattern(stream, SectorIndex, NumSectors);
+            }
+            else
+            {
+                stream->last_num = NumSectors;
+            }
+            if((hint == FS_ACCESS_HINT_SEQUENTIAL) && (!is_pattern_detected(stream)))
+            {
+                force_sequential(inst, stream);
+            }
+
+            if((NumSectors <= stream->buf_num) && (SectorIndex >= stream->buf_first) &&
+               ((SectorIndex - stream->buf_first) <= (stream->buf_num - NumSectors)))
+            {
+                FS_MEMCPY(pBuffer, stream->buffer + ((SectorIndex - stream->buf_first) * inst->bytes_per_sector), NumSectors * inst->bytes_per_sector);
+                stream->buf_num_used += NumSectors;
+                inst->stat.ReadSectorHitCnt += NumSectors;
+                r = 0;
+            }
+            else if(is_pattern_detected(stream))
+            {
+                adapt_window(inst, stream);
+                r = fill_buffer(inst, stream, SectorIndex, NumSectors);
+                if(r == 0)
+                {
+                    FS_MEMCPY(pBuffer, stream->buffer + ((SectorIndex - stream->buf_first) * inst->bytes_per_sector), NumSectors * inst->bytes_per_sector);
+                    stream->buf_num_used = NumSectors;
+                }
+                else
+                {
+                    r = inst->device_type->pfRead(inst->device_unit, SectorIndex, pBuffer, NumSectors);
+                }
+            }
+            else
+            {
+                /* No pattern, no reading in advance. */
+                r = inst->device_type->pfRead(inst->device_unit, SectorIndex, pBuffer, NumSectors);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_write
+*
+*  Function description
+*    Writes sectors to the storage device and updates the buffered copies.
+*/
+static int prefetch_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfWrite(inst->device_unit, SectorIndex, pBuffer, NumSectors, RepeatSame);
+        if(inst->is_inited)
+        {
+            if(r == 0)
+            {
+                update_buffers(inst, SectorIndex, (const U8 *)pBuffer, NumSectors, RepeatSame);
+            }
+            else
+            {
+                /* The contents of the sectors on the storage device is unknown. */
+                invalidate_range(inst, SectorIndex, NumSectors);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_ioctl
+*/
+static int prefetch_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_UNMOUNT:
+        case FS_CMD_UNMOUNT_FORCED:
+            /* The storage medium can be replaced while unmounted. */
+            inst->is_inited = false;
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if(inst->is_inited && (pBuffer != NULL))
+            {
+                invalidate_range(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(prefetch_inst_t));
+            if(prefetch_num_units != 0U)
+            {
+                prefetch_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_init_medium
+*/
+static int prefetch_init_medium(U8 Unit)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = 0;
+        if(inst->device_type->pfInitMedium != NULL)
+        {
+            r = inst->device_type->pfInitMedium(inst->device_unit);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_get_status
+*/
+static int prefetch_get_status(U8 Unit)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfGetStatus(inst->device_unit);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       prefetch_get_num_units
+*/
+static int prefetch_get_num_units(void)
+{
+    return (int)prefetch_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_PREFETCH_Driver =
+{
+    prefetch_get_name,
+    prefetch_add_device,
+    prefetch_read,
+    prefetch_write,
+    prefetch_ioctl,
+    prefetch_init_medium,
+    prefetch_get_status,
+    prefetch_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_PREFETCH_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*   pBuffer       Memory for the read-ahead buffers. Use FS_SIZEOF_PREFETCH()
+*                 to calculate the size required for a maximum window size.
+*   NumBytes      Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_PREFETCH_RESULT_OK          Configured successfully.
+*   FS_PREFETCH_RESULT_BADPARAM    Invalid parameters.
+*
+*  The buffer is divided between FS_PREFETCH_NUM_STREAMS streams. Unlike
+*  FS_READAHEAD the driver does not need to be enabled via
+*  FS_CMD_ENABLE_READ_AHEAD; it reads in advance whenever it detects
+*  a sequential or strided access.
+*
+*******************************************************************************/
+FS_PREFETCH_Result_t FS_PREFETCH_Configure(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes)
+{
+    FS_PREFETCH_Result_t result = FS_PREFETCH_RESULT_BADPARAM;
+    prefetch_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (pBuffer != NULL) && (NumBytes != 0U))
+    {
+        FS_MEMSET(inst, 0, sizeof(prefetch_inst_t));
+        inst->device_type = pDeviceType;
+        inst->device_unit = DeviceUnit;
+        inst->buffer      = (U8 *)pBuffer;
+        inst->buffer_size = NumBytes;
+        result = FS_PREFETCH_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_PREFETCH_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_PREFETCH_GetStatCounters(U8 Unit, FS_PREFETCH_STAT_COUNTERS * pStat)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_PREFETCH_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_PREFETCH_ResetStatCounters(U8 Unit)
+{
+    prefetch_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
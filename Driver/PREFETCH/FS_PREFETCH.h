@@ -0,0 +1,126 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_PREFETCH.h
+Purpose     : Logical driver that reads sectors in advance based on the
+              detected access pattern.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_PREFETCH_H     // Avoid recursive and multiple inclusion
+#define FS_PREFETCH_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_PREFETCH_NUM_UNITS
+#define FS_PREFETCH_NUM_UNITS           (2U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_PREFETCH_NUM_STREAMS
+#define FS_PREFETCH_NUM_STREAMS         (4U)    /* Number of access streams tracked per driver instance. */
+#endif
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCnt;          /* Number of sectors requested by the file system. */
+    U32 ReadSectorHitCnt;       /* Number of sectors served from the read-ahead buffers. */
+    U32 PrefetchSectorCnt;      /* Number of sectors read into the read-ahead buffers. */
+    U32 DiscardSectorCnt;       /* Number of sectors read in advance that were never requested. */
+    U32 WindowGrowCnt;          /* Number of times a read-ahead window was enlarged. */
+    U32 WindowShrinkCnt;        /* Number of times a read-ahead window was reduced. */
+} FS_PREFETCH_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_PREFETCH_RESULT_OK = 0U,
+    FS_PREFETCH_RESULT_BADPARAM,
+} FS_PREFETCH_Result_t;
+
+/*********************************************************************
+*
+*       Buffer size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_PREFETCH_Configure()
+*    for a maximum read-ahead window of NumSectors sectors of SectorSize
+*    bytes per stream.
+*/
+#define FS_SIZEOF_PREFETCH(NumSectors, SectorSize)  ((U32)(NumSectors) * (U32)(SectorSize) * FS_PREFETCH_NUM_STREAMS)
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_PREFETCH_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_PREFETCH_Result_t FS_PREFETCH_Configure          (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes);
+void                 FS_PREFETCH_GetStatCounters    (U8 Unit, FS_PREFETCH_STAT_COUNTERS * pStat);
+void                 FS_PREFETCH_ResetStatCounters  (U8 Unit);
+
+#endif  // FS_PREFETCH_H
+
+/*************************** End of file ****************************/
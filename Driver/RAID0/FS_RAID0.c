@@ -0,0 +1,1028 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_RAID0.c
+Purpose     : Logical driver that stripes the sectors over several storage devices.
+              Consecutive stripes of a configurable number of sectors are
+              stored in turn on each of the storage devices so that the
+              capacities and the transfer rates of the devices add up.
+              A request spanning several stripes is split into one part
+              per storage device. With an RTOS the parts can be transferred
+              in parallel by worker tasks, one less than the number of
+              storage devices, while the calling task transfers the first
+              part. This requires storage device drivers that can be called
+              concurrently for different units, for example two SD cards
+              connected to different SD host controllers.
+              The driver provides no redundancy; a failure of one storage
+              device makes the data of the entire volume unusable.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_RAID0.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define OP_READ                         (0U)
+#define OP_WRITE                        (1U)
+#define OP_FREE                         (2U)
+
+#if defined(COMPONENT_RTOS_AWARE)
+#define RAID0_SEMA_MAX_COUNT            (1LU)
+#define RAID0_SEMA_INIT_COUNT           (0LU)
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    const FS_DEVICE_TYPE * device_type;
+    U8                     device_unit;
+} raid0_storage_t;
+
+typedef struct
+{
+    U8    op;
+    U8    repeat_same;
+    U32   sector_index;
+    U32   num_sectors;
+    U8  * data;
+} raid0_request_t;
+
+#if defined(COMPONENT_RTOS_AWARE)
+typedef struct
+{
+    cy_thread_t      thread;
+    cy_semaphore_t   sema_start;
+    cy_semaphore_t   sema_done;
+    U8               unit;
+    U8               storage_index;     /* Storage device to be accessed by the current request. */
+    int              result;
+    bool             stop_requested;
+} raid0_worker_t;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+typedef struct
+{
+    raid0_storage_t         storages[FS_RAID0_MAX_DEVICES];
+    U8                      num_storages;
+    U32                     stripe_size;        /* Number of sectors per stripe. */
+    bool                    is_inited;          /* Set when the capacity has been calculated. */
+    U16                     bytes_per_sector;
+    U32                     num_stripes;        /* Number of stripes per storage device. */
+    raid0_request_t         request;            /* Request transferred in parallel. */
+#if defined(COMPONENT_RTOS_AWARE)
+    raid0_worker_t          workers[FS_RAID0_MAX_DEVICES - 1U];
+    U8                      num_workers;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    FS_RAID0_STAT_COUNTERS  stat;
+} raid0_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static raid0_inst_t raid0_inst[FS_RAID0_NUM_UNITS];
+static U8           raid0_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static raid0_inst_t * get_inst(U8 unit)
+{
+    raid0_inst_t * inst = NULL;
+
+    if(unit < FS_RAID0_NUM_UNITS)
+    {
+        inst = &raid0_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       get_num_sectors
+*
+*  Function description
+*    Returns the number of sectors presented to the file system.
+*    init_if_required() limits the number of stripes so that the
+*    result fits into 32 bits.
+*/
+static U32 get_num_sectors(const raid0_inst_t * inst)
+{
+    return inst->num_stripes * inst->stripe_size * inst->num_storages;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, capacity known.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    All the storage devices have to use the same sector size. The
+*    capacity is determined by the smallest storage device and is
+*    limited to the whole stripes that can be addressed with 32-bit
+*    sector indexes.
+*/
+static int init_if_required(raid0_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        U32 num_stripes = 0xFFFFFFFFUL;
+        U16 bytes_per_sector = 0U;
+
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            const raid0_storage_t * storage = &inst->storages[i];
+            FS_DEV_INFO dev_info;
+
+            FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+            r = storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+            if((r != 0) || (dev_info.BytesPerSector == 0U) ||
+               ((bytes_per_sector != 0U) && (bytes_per_sector != dev_info.BytesPerSector)))
+            {
+                r = 1;
+                break;
+            }
+            bytes_per_sector = dev_info.BytesPerSector;
+            if((dev_info.NumSectors / inst->stripe_size) < num_stripes)
+            {
+                num_stripes = dev_info.NumSectors / inst->stripe_size;
+            }
+        }
+        if((r == 0) && (inst->num_storages != 0U))
+        {
+            U64 num_sectors_row = (U64)inst->stripe_size * inst->num_storages;
+
+            if(((U64)num_stripes * num_sectors_row) > 0xFFFFFFFFULL)
+            {
+                num_stripes = (U32)(0xFFFFFFFFULL / num_sectors_row);
+            }
+        }
+        if((r == 0) && (inst->num_storages != 0U) && (num_stripes != 0U))
+        {
+            inst->bytes_per_sector = bytes_per_sector;
+            inst->num_stripes      = num_stripes;
+            inst->is_inited        = true;
+        }
+        else
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       transfer_part
+*
+*  Function description
+*    Performs a request on one storage device.
+*/
+static int transfer_part(const raid0_inst_t * inst, U8 storage_index, const raid0_request_t * req, U32 sector_index, U32 num_sectors, U8 * data)
+{
+    const raid0_storage_t * storage = &inst->storages[storage_index];
+    int r;
+
+    if(req->op == OP_READ)
+    {
+        r = storage->device_type->pfRead(storage->device_unit, sector_index, data, num_sectors);
+    }
+    else if(req->op == OP_WRITE)
+    {
+        r = storage->device_type->pfWrite(storage->device_unit, sector_index, data, num_sectors, req->repeat_same);
+    }
+    else
+    {
+        r = storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_FREE_SECTORS, (I32)sector_index, &num_sectors);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       transfer_storage
+*
+*  Function description
+*    Performs the part of a request that belongs to one storage device.
+*
+*  Additional information
+*    The stripes of a storage device are consecutive on the storage
+*    device but not in the buffer of the file system. Each stripe is
+*    therefore transferred separately except when the same data is
+*    written to all sectors or sectors are freed.
+*/
+static int transfer_storage(const raid0_inst_t * inst, U8 storage_index, const raid0_request_t * req)
+{
+    U32  stripe_size = inst->stripe_size;
+    U32  end         = req->sector_index + req->num_sectors;
+    U32  stripe      = req->sector_index / stripe_size;
+    bool is_mergeable = (req->op == OP_FREE) || (req->repeat_same != 0U);
+    U32  run_sector  = 0U;
+    U32  run_num     = 0U;
+    U8 * run_data    = NULL;
+    int  r = 0;
+
+    /* First stripe of the request located on this storage device. */
+    stripe += ((U32)storage_index + inst->num_storages - (stripe % inst->num_storages)) % inst->num_storages;
+    while((stripe * stripe_size) < end)
+    {
+        U32 first = stripe * stripe_size;
+        U32 last  = first + stripe_size;
+        U32 sector_index;
+        U8 * data;
+
+        if(first < req->sector_index)
+        {
+            first = req->sector_index;
+        }
+        if(last > end)
+        {
+            last = end;
+        }
+        sector_index = ((stripe / inst->num_storages) * stripe_size) + (first % stripe_size);
+        data = (req->repeat_same != 0U) ? req->data : (req->data + ((first - req->sector_index) * inst->bytes_per_sector));
+        if(is_mergeable && (run_num != 0U) && (sector_index == (run_sector + run_num)))
+        {
+            run_num += last - first;
+        }
+        else
+        {
+            if(run_num != 0U)
+            {
+                r = transfer_part(inst, storage_index, req, run_sector, run_num, run_data);
+                if(r != 0)
+                {
+                    break;
+                }
+            }
+            run_sector = sector_index;
+            run_num    = last - first;
+            run_data   = data;
+        }
+        stripe += inst->num_storages;
+    }
+    if((r == 0) && (run_num != 0U))
+    {
+        r = transfer_part(inst, storage_index, req, run_sector, run_num, run_data);
+    }
+
+    return r;
+}
+
+#if defined(COMPONENT_RTOS_AWARE)
+
+/*********************************************************************
+*
+*       worker_task
+*
+*  Function description
+*    Main loop of a task that transfers the parts of requests.
+*/
+static void worker_task(cy_thread_arg_t arg)
+{
+    raid0_worker_t * worker = (raid0_worker_t *)arg;
+
+    for(;;)
+    {
+        cy_rslt_t result = cy_rtos_get_semaphore(&worker->sema_start, CY_RTOS_NEVER_TIMEOUT, false);
+
+        CY_ASSERT(CY_RSLT_SUCCESS == result);
+        FS_USE_PARA(result);
+
+        if(worker->stop_requested)
+        {
+            break;
+        }
+        {
+            const raid0_inst_t * inst = get_inst(worker->unit);
+
+            worker->result = transfer_storage(inst, worker->storage_index, &inst->request);
+        }
+        (void) cy_rtos_set_semaphore(&worker->sema_done, false);
+    }
+
+    (void) cy_rtos_exit_thread();
+}
+
+/*********************************************************************
+*
+*       stop_workers
+*/
+static void stop_workers(raid0_inst_t * inst)
+{
+    for(U8 i = 0U; i < inst->num_workers; i++)
+    {
+        raid0_worker_t * worker = &inst->workers[i];
+
+        worker->stop_requested = true;
+        (void) cy_rtos_set_semaphore(&worker->sema_start, false);
+        (void) cy_rtos_join_thread(&worker->thread);
+        (void) cy_rtos_deinit_semaphore(&worker->sema_done);
+        (void) cy_rtos_deinit_semaphore(&worker->sema_start);
+    }
+    inst->num_workers = 0U;
+}
+
+/*********************************************************************
+*
+*       start_workers
+*
+*  Return value
+*    ==0    OK, one worker per additional storage device running.
+*    !=0    An error occurred. No worker is running.
+*/
+static int start_workers(raid0_inst_t * inst, U8 unit)
+{
+    int r = 0;
+
+    while(inst->num_workers < (inst->num_storages - 1U))
+    {
+        raid0_worker_t * worker = &inst->workers[inst->num_workers];
+        cy_rslt_t rslt;
+
+        FS_MEMSET(worker, 0, sizeof(raid0_worker_t));
+        worker->unit = unit;
+        rslt = cy_rtos_init_semaphore(&worker->sema_start, RAID0_SEMA_MAX_COUNT, RAID0_SEMA_INIT_COUNT);
+        if(CY_RSLT_SUCCESS == rslt)
+        {
+            rslt = cy_rtos_init_semaphore(&worker->sema_done, RAID0_SEMA_MAX_COUNT, RAID0_SEMA_INIT_COUNT);
+            if(CY_RSLT_SUCCESS == rslt)
+            {
+                rslt = cy_rtos_create_thread(&worker->thread, worker_task, "FS_RAID0", NULL, FS_RAID0_STACK_SIZE,
+                                             CY_RTOS_PRIORITY_ABOVENORMAL, (cy_thread_arg_t)worker);
+                if(CY_RSLT_SUCCESS != rslt)
+                {
+                    (void) cy_rtos_deinit_semaphore(&worker->sema_done);
+                }
+            }
+            if(CY_RSLT_SUCCESS != rslt)
+            {
+                (void) cy_rtos_deinit_semaphore(&worker->sema_start);
+            }
+        }
+        if(CY_RSLT_SUCCESS != rslt)
+        {
+            stop_workers(inst);
+            r = 1;
+            break;
+        }
+        inst->num_workers++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       transfer_parallel
+*
+*  Function description
+*    Performs a request with the parts of the storage devices transferred
+*    in parallel. The calling task transfers the part of the storage device
+*    that stores the first sector.
+*/
+static int transfer_parallel(raid0_inst_t * inst, const raid0_request_t * req)
+{
+    U32 num_stripes = (((req->sector_index % inst->stripe_size) + req->num_sectors + inst->stripe_size) - 1U) / inst->stripe_size;
+    U8  storage_first = (U8)((req->sector_index / inst->stripe_size) % inst->num_storages);
+    U8  num_parts = (num_stripes < inst->num_storages) ? (U8)num_stripes : inst->num_storages;
+    int r;
+
+    inst->request = *req;
+    for(U8 i = 1U; i < num_parts; i++)
+    {
+        raid0_worker_t * worker = &inst->workers[i - 1U];
+
+        worker->storage_index = (U8)((storage_first + i) % inst->num_storages);
+        worker->result        = 0;
+        (void) cy_rtos_set_semaphore(&worker->sema_start, false);
+    }
+    r = transfer_storage(inst, storage_first, req);
+    for(U8 i = 1U; i < num_parts; i++)
+    {
+        raid0_worker_t * worker = &inst->workers[i - 1U];
+
+        (void) cy_rtos_get_semaphore(&worker->sema_done, CY_RTOS_NEVER_TIMEOUT, false);
+        if(r == 0)
+        {
+            r = worker->result;
+        }
+    }
+
+    return r;
+}
+
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       transfer
+*
+*  Return value
+*    ==0    OK, request performed on all the storage devices.
+*    !=0    An error occurred.
+*/
+static int transfer(raid0_inst_t * inst, const raid0_request_t * req)
+{
+    int r = 0;
+    bool is_multi = (((req->sector_index % inst->stripe_size) + req->num_sectors) > inst->stripe_size);
+
+#if defined(COMPONENT_RTOS_AWARE)
+    if(is_multi && (req->op != OP_FREE) && (inst->num_workers != 0U))
+    {
+        if(req->op == OP_READ)
+        {
+            inst->stat.ReadParallelCnt++;
+        }
+        else
+        {
+            inst->stat.WriteParallelCnt++;
+        }
+        r = transfer_parallel(inst, req);
+    }
+    else
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    if(is_multi)
+    {
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            r = transfer_storage(inst, i, req);
+            if(r != 0)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        r = transfer_storage(inst, (U8)((req->sector_index / inst->stripe_size) % inst->num_storages), req);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       is_range_valid
+*/
+static bool is_range_valid(const raid0_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    U32 num_sectors_total = get_num_sectors(inst);
+
+    return (sector_index < num_sectors_total) && (num_sectors <= (num_sectors_total - sector_index));
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 14,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       raid0_get_name
+*/
+static const char * raid0_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "raid0";
+}
+
+/*********************************************************************
+*
+*       raid0_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int raid0_add_device(void)
+{
+    int r = -1;
+
+    if(raid0_num_units < FS_RAID0_NUM_UNITS)
+    {
+        r = (int)raid0_num_units;
+        raid0_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_read
+*/
+static int raid0_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        raid0_request_t req;
+
+        req.op           = OP_READ;
+        req.repeat_same  = 0U;
+        req.sector_index = SectorIndex;
+        req.num_sectors  = NumSectors;
+        req.data         = (U8 *)pBuffer;
+        inst->stat.ReadSectorCnt += NumSectors;
+        r = transfer(inst, &req);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_write
+*/
+static int raid0_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        raid0_request_t req;
+
+        req.op           = OP_WRITE;
+        req.repeat_same  = RepeatSame;
+        req.sector_index = SectorIndex;
+        req.num_sectors  = NumSectors;
+        CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by the storage device drivers');
+        req.data         = (U8 *)pBuffer;
+        inst->stat.WriteSectorCnt += NumSectors;
+        r = transfer(inst, &req);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_ioctl
+*
+*  Additional information
+*    The commands that are not related to a sector are sent to all
+*    the storage devices.
+*/
+static int raid0_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_GET_DEVINFO:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = inst->storages[0].device_type->pfIoCtl(inst->storages[0].device_unit, Cmd, Aux, pBuffer);
+                if(r == 0)
+                {
+                    FS_DEV_INFO * dev_info = (FS_DEV_INFO *)pBuffer;
+
+                    dev_info->NumSectors     = get_num_sectors(inst);
+                    dev_info->BytesPerSector = inst->bytes_per_sector;
+                }
+            }
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, (U32)Aux, *(U32 *)pBuffer))
+            {
+                raid0_request_t req;
+
+                req.op           = OP_FREE;
+                req.repeat_same  = 0U;
+                req.sector_index = (U32)Aux;
+                req.num_sectors  = *(U32 *)pBuffer;
+                req.data         = NULL;
+                r = transfer(inst, &req);
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+        case FS_CMD_GET_CLEAN_CNT:
+            {
+                int value_total = 0;
+
+                r = 0;
+                for(U8 i = 0U; i < inst->num_storages; i++)
+                {
+                    int value = 0;
+
+                    if(inst->storages[i].device_type->pfIoCtl(inst->storages[i].device_unit, Cmd, Aux, &value) != 0)
+                    {
+                        r = -1;
+                    }
+                    if(Cmd == FS_CMD_CLEAN_ONE)
+                    {
+                        value_total |= value;           /* More to clean on any storage device. */
+                    }
+                    else
+                    {
+                        value_total += value;
+                    }
+                }
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = value_total;
+                }
+            }
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = 0;
+            for(U8 i = 0U; i < inst->num_storages; i++)
+            {
+                if(inst->storages[i].device_type->pfIoCtl(inst->storages[i].device_unit, Cmd, Aux, pBuffer) != 0)
+                {
+                    r = -1;
+                }
+            }
+#if defined(COMPONENT_RTOS_AWARE)
+            stop_workers(inst);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+            FS_MEMSET(inst, 0, sizeof(raid0_inst_t));
+            if(raid0_num_units != 0U)
+            {
+                raid0_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            if((Cmd == FS_CMD_UNMOUNT) || (Cmd == FS_CMD_UNMOUNT_FORCED))
+            {
+                inst->is_inited = false;        /* The storage media can be replaced while unmounted. */
+            }
+            r = 0;
+            for(U8 i = 0U; i < inst->num_storages; i++)
+            {
+                int r_storage = inst->storages[i].device_type->pfIoCtl(inst->storages[i].device_unit, Cmd, Aux, pBuffer);
+
+                if(r == 0)
+                {
+                    r = r_storage;
+                }
+            }
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_init_medium
+*/
+static int raid0_init_medium(U8 Unit)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        r = 0;
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            if(inst->storages[i].device_type->pfInitMedium != NULL)
+            {
+                r = inst->storages[i].device_type->pfInitMedium(inst->storages[i].device_unit);
+                if(r != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_get_status
+*
+*  Return value
+*    FS_MEDIA_IS_PRESENT only if all the storage media are present.
+*/
+static int raid0_get_status(U8 Unit)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        r = FS_MEDIA_IS_PRESENT;
+        for(U8 i = 0U; i < inst->num_storages; i++)
+        {
+            int status = inst->storages[i].device_type->pfGetStatus(inst->storages[i].device_unit);
+
+            if(status == FS_MEDIA_NOT_PRESENT)
+            {
+                r = FS_MEDIA_NOT_PRESENT;
+                break;
+            }
+            if(status != FS_MEDIA_IS_PRESENT)
+            {
+                r = status;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       raid0_get_num_units
+*/
+static int raid0_get_num_units(void)
+{
+    return (int)raid0_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_RAID0_Driver =
+{
+    raid0_get_name,
+    raid0_add_device,
+    raid0_read,
+    raid0_write,
+    raid0_ioctl,
+    raid0_init_medium,
+    raid0_get_status,
+    raid0_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_RAID0_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice() and before the
+*  storage devices are assigned via FS_RAID0_AddStorage().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   StripeSize    Number of consecutive sectors stored on the same storage
+*                 device. A multiple of the erase or write unit of the
+*                 storage devices gives the best performance.
+*
+*  Return Value
+*   FS_RAID0_RESULT_OK          Configured successfully.
+*   FS_RAID0_RESULT_BADPARAM    Invalid parameters.
+*
+*******************************************************************************/
+FS_RAID0_Result_t FS_RAID0_Configure(U8 Unit, U32 StripeSize)
+{
+    FS_RAID0_Result_t result = FS_RAID0_RESULT_BADPARAM;
+    raid0_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (StripeSize != 0U))
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        stop_workers(inst);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        FS_MEMSET(inst, 0, sizeof(raid0_inst_t));
+        inst->stripe_size = StripeSize;
+        result = FS_RAID0_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_RAID0_AddStorage
+****************************************************************************//**
+*
+*  Assigns a storage device to a driver instance. The storage devices
+*  store the stripes in the order they are added. The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*
+*  Return Value
+*   FS_RAID0_RESULT_OK          Storage device assigned.
+*   FS_RAID0_RESULT_BADPARAM    Invalid parameters, too many storage
+*                               devices or parallel transfers enabled.
+*
+*******************************************************************************/
+FS_RAID0_Result_t FS_RAID0_AddStorage(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit)
+{
+    FS_RAID0_Result_t result = FS_RAID0_RESULT_BADPARAM;
+    raid0_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (inst->stripe_size != 0U) &&
+       (inst->num_storages < FS_RAID0_MAX_DEVICES))
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        if(inst->num_workers == 0U)
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        {
+            inst->storages[inst->num_storages].device_type = pDeviceType;
+            inst->storages[inst->num_storages].device_unit = DeviceUnit;
+            inst->num_storages++;
+            inst->is_inited = false;
+            result = FS_RAID0_RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_RAID0_SetParallel
+****************************************************************************//**
+*
+*  Enables or disables the parallel transfer of the parts of a request
+*  that belong to different storage devices. Has to be called after all
+*  the storage devices have been assigned.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   OnOff         1 to start one worker task per additional storage
+*                 device, 0 to stop the worker tasks.
+*
+*  Return Value
+*   FS_RAID0_RESULT_OK          Mode changed.
+*   FS_RAID0_RESULT_BADPARAM    Invalid parameters.
+*   FS_RAID0_RESULT_ERROR       The worker tasks could not be created or
+*                               the application is built without an RTOS.
+*
+*  The storage device drivers have to support being called from
+*  different tasks at the same time for different units. No file system
+*  operation may be in progress on the volume when the mode is changed.
+*
+*******************************************************************************/
+FS_RAID0_Result_t FS_RAID0_SetParallel(U8 Unit, U8 OnOff)
+{
+    FS_RAID0_Result_t result = FS_RAID0_RESULT_BADPARAM;
+    raid0_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (inst->num_storages != 0U))
+    {
+        result = FS_RAID0_RESULT_OK;
+#if defined(COMPONENT_RTOS_AWARE)
+        if(OnOff != 0U)
+        {
+            if(start_workers(inst, Unit) != 0)
+            {
+                result = FS_RAID0_RESULT_ERROR;
+            }
+        }
+        else
+        {
+            stop_workers(inst);
+        }
+#else
+        if(OnOff != 0U)
+        {
+            result = FS_RAID0_RESULT_ERROR;
+        }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_RAID0_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_RAID0_GetStatCounters(U8 Unit, FS_RAID0_STAT_COUNTERS * pStat)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_RAID0_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_RAID0_ResetStatCounters(U8 Unit)
+{
+    raid0_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
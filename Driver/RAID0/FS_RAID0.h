@@ -0,0 +1,119 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_RAID0.h
+Purpose     : Logical driver that stripes the sectors over several storage devices.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_RAID0_H     // Avoid recursive and multiple inclusion
+#define FS_RAID0_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_RAID0_NUM_UNITS
+#define FS_RAID0_NUM_UNITS              (1U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_RAID0_MAX_DEVICES
+#define FS_RAID0_MAX_DEVICES            (4U)    /* Maximum number of storage devices per driver instance. */
+#endif
+
+#ifndef FS_RAID0_STACK_SIZE
+#define FS_RAID0_STACK_SIZE             (2048U) /* Stack size in bytes of the tasks that access the storage devices in parallel. */
+#endif
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCnt;          /* Number of sectors read by the file system. */
+    U32 WriteSectorCnt;         /* Number of sectors written by the file system. */
+    U32 ReadParallelCnt;        /* Number of read requests split over several storage devices in parallel. */
+    U32 WriteParallelCnt;       /* Number of write requests split over several storage devices in parallel. */
+} FS_RAID0_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_RAID0_RESULT_OK = 0U,
+    FS_RAID0_RESULT_BADPARAM,
+    FS_RAID0_RESULT_ERROR,
+} FS_RAID0_Result_t;
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_RAID0_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_RAID0_Result_t FS_RAID0_Configure            (U8 Unit, U32 StripeSize);
+FS_RAID0_Result_t FS_RAID0_AddStorage           (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit);
+FS_RAID0_Result_t FS_RAID0_SetParallel          (U8 Unit, U8 OnOff);
+void              FS_RAID0_GetStatCounters      (U8 Unit, FS_RAID0_STAT_COUNTERS * pStat);
+void              FS_RAID0_ResetStatCounters    (U8 Unit);
+
+#endif  // FS_RAID0_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,1442 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_TIER.c
+Purpose     : Logical driver that keeps the frequently accessed sectors
+              on a fast storage device in front of a large one.
+              The volume has the capacity of the large storage device
+              (capacity storage), for example an SD card. It is divided
+              into extents of consecutive sectors. The extents accessed
+              most often, typically those holding the allocation table,
+              the directories and small files updated frequently, are
+              moved to slots on the fast storage device (hot storage),
+              for example a NOR flash, and are then accessed only there.
+              The accesses to the extents are counted and halved
+              regularly so that extents no longer used become cold.
+              An extent that reaches the promotion threshold is moved
+              to a free slot or replaces the coldest extent, which is
+              copied back to the capacity storage. The extents are moved
+              one at a time, after a request when the configured interval
+              elapsed or when the application cleans the storage.
+              The assignment of the slots is stored on the hot storage,
+              in two copies used alternately, so that the volume remains
+              consistent after a power loss. A hot storage whose
+              assignment cannot be used, for example after a change of
+              the extent size, is not mounted until it is low-level
+              formatted.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_TIER.h"
+#include "FS_OS.h"
+#include "FS_HINT.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_TIER_AGING_PERIOD
+#define FS_TIER_AGING_PERIOD            (1024U) /* Number of accessed extents after which all the access counts are halved. */
+#endif
+
+#ifndef FS_TIER_WRITE_WEIGHT
+#define FS_TIER_WRITE_WEIGHT            (2U)    /* Access count added by a write. A read adds 1. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define OP_READ                         (0U)
+#define OP_WRITE                        (1U)
+
+#define EXTENT_FREE                     (0xFFFFFFFFUL)  /* Value in the map of a free slot. */
+#define SLOT_NONE                       (0xFFFFU)
+#define MAX_NUM_SLOTS                   (0xFFFEU)
+#define COUNT_MAX                       (0xFFFFU)
+
+#define SLOT_FLAG_DIRTY                 (1U)    /* The extent has been written since it was moved to the hot storage. */
+
+/* Layout of the sector that follows the map in the metadata. */
+#define META_MAGIC                      (0x52454954UL)  /* "TIER" */
+#define META_OFF_MAGIC                  (0U)
+#define META_OFF_SEQUENCE               (4U)
+#define META_OFF_EXTENT_SIZE            (8U)
+#define META_OFF_NUM_SLOTS              (12U)
+#define META_OFF_CHECK                  (16U)
+#define META_NUM_COPIES                 (2U)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    const FS_DEVICE_TYPE * device_type;
+    U8                     device_unit;
+} tier_storage_t;
+
+typedef struct
+{
+    U32 extent;
+    U16 count;          /* 0 if the entry is free. */
+} tier_candidate_t;
+
+typedef struct
+{
+    tier_storage_t          hot;
+    tier_storage_t          capacity;
+    U8                    * buffer;
+    U32                     num_bytes;
+    U32                     extent_size;            /* Number of sectors per extent. */
+    U16                     promote_threshold;
+    U32                     interval_ms;
+    bool                    is_inited;              /* Set when the capacity has been calculated and the map loaded. */
+    bool                    is_meta_invalid;        /* Set when the hot storage holds metadata that cannot be used. */
+    bool                    is_meta_reset;          /* Set by a low-level format. The map is initialized instead of loaded. */
+    U16                     bytes_per_sector;
+    U32                     num_sectors;
+    U32                     num_slots;
+    U32                     num_sectors_map;        /* Number of sectors in a copy of the metadata without the header sector. */
+    U32                     slot_start;             /* Index of the first sector of the slots on the hot storage. */
+    U8                    * map;                    /* Extent stored in each slot, as stored, followed by the header sector. */
+    U16                   * counts;                 /* Access count of the extent in each slot. */
+    U16                   * next;                   /* Next slot in the same hash bucket. */
+    U16                   * buckets;                /* First slot of each hash bucket. */
+    U8                    * flags;
+    U32                     bucket_mask;
+    U8                    * copy_buffer;
+    U32                     num_sectors_copy;
+    U32                     sequence;
+    U32                     num_accesses;           /* Number of accessed extents since the access counts were halved. */
+    U32                     time_last;
+    tier_candidate_t        candidates[FS_TIER_NUM_CANDIDATES];
+    FS_TIER_STAT_COUNTERS   stat;
+} tier_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static tier_inst_t tier_inst[FS_TIER_NUM_UNITS];
+static U8          tier_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static tier_inst_t * get_inst(U8 unit)
+{
+    tier_inst_t * inst = NULL;
+
+    if(unit < FS_TIER_NUM_UNITS)
+    {
+        inst = &tier_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       load_u32 / store_u32
+*/
+static U32 load_u32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+static void store_u32(U8 * data, U32 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+    data[2] = (U8)(value >> 16);
+    data[3] = (U8)(value >> 24);
+}
+
+/*********************************************************************
+*
+*       get_min
+*/
+static U32 get_min(U32 a, U32 b)
+{
+    return (a < b) ? a : b;
+}
+
+/*********************************************************************
+*
+*       get_slot_extent / set_slot_extent
+*/
+static U32 get_slot_extent(const tier_inst_t * inst, U32 slot)
+{
+    return load_u32(inst->map + (slot * 4U));
+}
+
+static void set_slot_extent(tier_inst_t * inst, U32 slot, U32 extent)
+{
+    store_u32(inst->map + (slot * 4U), extent);
+}
+
+/*********************************************************************
+*
+*       find_slot
+*
+*  Return value
+*    Slot that stores the extent or SLOT_NONE.
+*/
+static U16 find_slot(const tier_inst_t * inst, U32 extent)
+{
+    U16 slot = inst->buckets[extent & inst->bucket_mask];
+
+    while((slot != SLOT_NONE) && (get_slot_extent(inst, slot) != extent))
+    {
+        slot = inst->next[slot];
+    }
+
+    return slot;
+}
+
+/*********************************************************************
+*
+*       link_slot / unlink_slot
+*
+*  Function description
+*    Adds a slot to or removes it from the hash bucket of its extent.
+*/
+static void link_slot(tier_inst_t * inst, U16 slot)
+{
+    U16 * head = &inst->buckets[get_slot_extent(inst, slot) & inst->bucket_mask];
+
+    inst->next[slot] = *head;
+    *head = slot;
+}
+
+static void unlink_slot(tier_inst_t * inst, U16 slot)
+{
+    U16 * link = &inst->buckets[get_slot_extent(inst, slot) & inst->bucket_mask];
+
+    while(*link != slot)
+    {
+        link = &inst->next[*link];
+    }
+    *link = inst->next[slot];
+}
+
+/*********************************************************************
+*
+*       transfer_storage
+*/
+static int transfer_storage(const tier_storage_t * storage, U8 op, U32 sector_index, U8 * data, U32 num_sectors, U8 repeat_same)
+{
+    int r;
+
+    if(op == OP_READ)
+    {
+        r = storage->device_type->pfRead(storage->device_unit, sector_index, data, num_sectors);
+    }
+    else
+    {
+        r = storage->device_type->pfWrite(storage->device_unit, sector_index, data, num_sectors, repeat_same);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       calc_meta_check
+*
+*  Function description
+*    Calculates the check value of the map and of the header fields.
+*/
+static U32 calc_meta_check(const tier_inst_t * inst)
+{
+    U32 num_bytes = (inst->num_sectors_map * inst->bytes_per_sector) + META_OFF_CHECK;
+    U32 check = META_MAGIC;
+
+    for(U32 i = 0U; i < num_bytes; i++)
+    {
+        check = ((check << 1) | (check >> 31)) ^ inst->map[i];
+    }
+
+    return ~check;
+}
+
+/*********************************************************************
+*
+*       save_meta
+*
+*  Function description
+*    Writes the map to the hot storage.
+*
+*  Additional information
+*    The two copies are written alternately so that a valid one
+*    remains if the write is interrupted. The header sector is written
+*    last.
+*/
+static int save_meta(tier_inst_t * inst)
+{
+    U8 * header = inst->map + (inst->num_sectors_map * inst->bytes_per_sector);
+    U32 num_sectors = inst->num_sectors_map + 1U;
+
+    inst->sequence++;
+    FS_MEMSET(header, 0, inst->bytes_per_sector);
+    store_u32(header + META_OFF_MAGIC,       META_MAGIC);
+    store_u32(header + META_OFF_SEQUENCE,    inst->sequence);
+    store_u32(header + META_OFF_EXTENT_SIZE, inst->extent_size);
+    store_u32(header + META_OFF_NUM_SLOTS,   inst->num_slots);
+    store_u32(header + META_OFF_CHECK,       calc_meta_check(inst));
+
+    return transfer_storage(&inst->hot, OP_WRITE, (inst->sequence % META_NUM_COPIES) * num_sectors,
+                            inst->map, num_sectors, 0U);
+}
+
+/*********************************************************************
+*
+*       load_meta
+*
+*  Function description
+*    Reads the most recent valid copy of the map from the hot storage.
+*
+*  Return value
+*    ==0    OK, map loaded.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The hot storage is new and all the slots are free only if no copy
+*    carries the magic value. A copy written for a different extent size
+*    or number of slots, or whose check value does not match, is not
+*    valid. If no copy is valid but one carries the magic value, the
+*    slots may hold the only up-to-date data of their extents, so an
+*    error is reported instead of discarding them. The hot storage is
+*    initialized again only via a low-level format.
+*/
+static int load_meta(tier_inst_t * inst)
+{
+    const U8 * header = inst->map + (inst->num_sectors_map * inst->bytes_per_sector);
+    U32 num_sectors = inst->num_sectors_map + 1U;
+    U32 sequence = 0U;
+    U32 copy_latest = META_NUM_COPIES;
+    bool is_magic_found = false;
+    int r = 0;
+
+    inst->is_meta_invalid = false;
+    for(U32 copy = 0U; (copy < META_NUM_COPIES) && (!inst->is_meta_reset); copy++)
+    {
+        r = transfer_storage(&inst->hot, OP_READ, copy * num_sectors, inst->map, num_sectors, 0U);
+        if(r != 0)
+        {
+            break;
+        }
+        if(load_u32(header + META_OFF_MAGIC) == META_MAGIC)
+        {
+            is_magic_found = true;
+        }
+        if((load_u32(header + META_OFF_MAGIC) == META_MAGIC) &&
+           (load_u32(header + META_OFF_EXTENT_SIZE) == inst->extent_size) &&
+           (load_u32(header + META_OFF_NUM_SLOTS) == inst->num_slots) &&
+           (load_u32(header + META_OFF_CHECK) == calc_meta_check(inst)) &&
+           ((copy_latest == META_NUM_COPIES) || ((I32)(load_u32(header + META_OFF_SEQUENCE) - sequence) > 0)))
+        {
+            sequence    = load_u32(header + META_OFF_SEQUENCE);
+            copy_latest = copy;
+        }
+    }
+    if(r == 0)
+    {
+        if((copy_latest == META_NUM_COPIES) && is_magic_found)
+        {
+            inst->is_meta_invalid = true;
+            r = 1;
+        }
+        else if(copy_latest == META_NUM_COPIES)
+        {
+            FS_MEMSET(inst->map, 0xFF, inst->num_slots * 4U);
+            inst->sequence = 0U;
+            r = save_meta(inst);
+            if(r == 0)
+            {
+                inst->is_meta_reset = false;
+            }
+        }
+        else
+        {
+            r = transfer_storage(&inst->hot, OP_READ, copy_latest * num_sectors, inst->map, num_sectors, 0U);
+            inst->sequence = sequence;
+        }
+    }
+    if(r == 0)
+    {
+        FS_MEMSET(inst->buckets, 0xFF, (inst->bucket_mask + 1U) * sizeof(U16));
+        for(U16 slot = 0U; slot < inst->num_slots; slot++)
+        {
+            inst->counts[slot] = 0U;
+            inst->flags[slot]  = SLOT_FLAG_DIRTY;           /* The state before the power loss is not known. */
+            if(get_slot_extent(inst, slot) != EXTENT_FREE)
+            {
+                link_slot(inst, slot);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Return value
+*    ==0    OK, capacity known and map loaded.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    Both storage devices have to use the same sector size. Buffer
+*    layout: copy buffer, map as stored followed by the header sector,
+*    access counts, hash links, hash buckets, slot flags.
+*/
+static int init_if_required(tier_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info_hot;
+        FS_DEV_INFO dev_info_capacity;
+
+        r = 1;
+        FS_MEMSET(&dev_info_hot, 0, sizeof(dev_info_hot));
+        FS_MEMSET(&dev_info_capacity, 0, sizeof(dev_info_capacity));
+        if((inst->hot.device_type != NULL) && (inst->capacity.device_type != NULL) && (inst->buffer != NULL) &&
+           (inst->hot.device_type->pfIoCtl(inst->hot.device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info_hot) == 0) &&
+           (inst->capacity.device_type->pfIoCtl(inst->capacity.device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info_capacity) == 0) &&
+           (dev_info_hot.BytesPerSector != 0U) && (dev_info_hot.BytesPerSector == dev_info_capacity.BytesPerSector))
+        {
+            U32 bytes_per_sector = dev_info_hot.BytesPerSector;
+            U32 num_slots = get_min(dev_info_hot.NumSectors / inst->extent_size, MAX_NUM_SLOTS);
+            U32 num_sectors_map = ((num_slots * 4U) + bytes_per_sector - 1U) / bytes_per_sector;
+            U32 num_sectors_meta = META_NUM_COPIES * (num_sectors_map + 1U);
+            U32 num_buckets = 1U;
+            U32 num_bytes_fixed;
+
+            if(dev_info_hot.NumSectors > num_sectors_meta)
+            {
+                num_slots = get_min(num_slots, (dev_info_hot.NumSectors - num_sectors_meta) / inst->extent_size);
+            }
+            else
+            {
+                num_slots = 0U;
+            }
+            while(num_buckets < num_slots)
+            {
+                num_buckets <<= 1;
+            }
+            num_bytes_fixed = ((num_sectors_map + 1U) * bytes_per_sector) + (num_slots * 5U) + (num_buckets * 2U);
+            if((num_slots != 0U) && (inst->num_bytes >= (num_bytes_fixed + bytes_per_sector)))
+            {
+                U8 * p;
+
+                inst->bytes_per_sector = (U16)bytes_per_sector;
+                inst->num_sectors      = dev_info_capacity.NumSectors;
+                inst->num_slots        = num_slots;
+                inst->num_sectors_map  = num_sectors_map;
+                inst->slot_start       = num_sectors_meta;
+                inst->bucket_mask      = num_buckets - 1U;
+                inst->num_sectors_copy = (inst->num_bytes - num_bytes_fixed) / bytes_per_sector;
+                p = inst->buffer;
+                inst->copy_buffer = p;
+                p += inst->num_sectors_copy * bytes_per_sector;
+                inst->map = p;
+                p += (num_sectors_map + 1U) * bytes_per_sector;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->counts = (U16 *)p;
+                p += num_slots * 2U;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->next = (U16 *)p;
+                p += num_slots * 2U;
+                CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The buffer is aligned as the sector buffers of the file system');
+                inst->buckets = (U16 *)p;
+                p += num_buckets * 2U;
+                inst->flags = p;
+                FS_MEMSET(inst->candidates, 0, sizeof(inst->candidates));
+                inst->num_accesses = 0U;
+                inst->time_last    = FS_X_OS_GetTime();
+                r = load_meta(inst);
+                inst->is_inited = (r == 0);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       age_counts
+*
+*  Function description
+*    Halves all the access counts so that extents no longer used
+*    become cold.
+*/
+static void age_counts(tier_inst_t * inst)
+{
+    for(U32 slot = 0U; slot < inst->num_slots; slot++)
+    {
+        inst->counts[slot] >>= 1;
+    }
+    for(U32 i = 0U; i < FS_TIER_NUM_CANDIDATES; i++)
+    {
+        inst->candidates[i].count >>= 1;
+    }
+    inst->num_accesses = 0U;
+}
+
+/*********************************************************************
+*
+*       add_count
+*/
+static U16 add_count(U16 count, U32 weight)
+{
+    return (U16)get_min((U32)count + weight, COUNT_MAX);
+}
+
+/*********************************************************************
+*
+*       count_access
+*
+*  Function description
+*    Counts an access to an extent.
+*
+*  Additional information
+*    An extent on the capacity storage replaces the candidate with the
+*    lowest count if it is not a candidate yet. Accesses declared with
+*    FS_ACCESS_HINT_NOREUSE are not counted.
+*/
+static void count_access(tier_inst_t * inst, U32 extent, U16 slot, U8 op)
+{
+    U32 weight = (op == OP_WRITE) ? FS_TIER_WRITE_WEIGHT : 1U;
+
+    if(FS_HINT_GetCurrent() != FS_ACCESS_HINT_NOREUSE)
+    {
+        if(slot != SLOT_NONE)
+        {
+            inst->counts[slot] = add_count(inst->counts[slot], weight);
+        }
+        else
+        {
+            tier_candidate_t * candidate = &inst->candidates[0];
+
+            for(U32 i = 0U; i < FS_TIER_NUM_CANDIDATES; i++)
+            {
+                tier_candidate_t * entry = &inst->candidates[i];
+
+                if((entry->count != 0U) && (entry->extent == extent))
+                {
+                    candidate = entry;
+                    break;
+                }
+                if(entry->count < candidate->count)
+                {
+                    candidate = entry;
+                }
+            }
+            if((candidate->count == 0U) || (candidate->extent != extent))
+            {
+                candidate->extent = extent;
+                candidate->count  = 0U;
+            }
+            candidate->count = add_count(candidate->count, weight);
+        }
+        inst->num_accesses++;
+        if(inst->num_accesses >= FS_TIER_AGING_PERIOD)
+        {
+            age_counts(inst);
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       transfer
+*
+*  Function description
+*    Splits a request into the parts stored on each storage device.
+*
+*  Additional information
+*    The consecutive extents on the capacity storage are transferred
+*    in one request.
+*/
+static int transfer(tier_inst_t * inst, U8 op, U32 sector_index, U8 * data, U32 num_sectors, U8 repeat_same)
+{
+    U32 extent_size = inst->extent_size;
+    int r = 0;
+
+    while((r == 0) && (num_sectors != 0U))
+    {
+        U32 extent = sector_index / extent_size;
+        U32 num_sectors_part = get_min(extent_size - (sector_index % extent_size), num_sectors);
+        U16 slot = find_slot(inst, extent);
+
+        count_access(inst, extent, slot, op);
+        if(slot != SLOT_NONE)
+        {
+            r = transfer_storage(&inst->hot, op, inst->slot_start + (slot * extent_size) + (sector_index % extent_size),
+                                 data, num_sectors_part, repeat_same);
+            if(op == OP_WRITE)
+            {
+                inst->flags[slot] |= SLOT_FLAG_DIRTY;
+                inst->stat.WriteSectorCntHot += num_sectors_part;
+            }
+            else
+            {
+                inst->stat.ReadSectorCntHot += num_sectors_part;
+            }
+        }
+        else
+        {
+            while(num_sectors_part < num_sectors)
+            {
+                U16 slot_next;
+
+                extent++;
+                slot_next = find_slot(inst, extent);
+                if(slot_next != SLOT_NONE)
+                {
+                    break;
+                }
+                count_access(inst, extent, slot_next, op);
+                num_sectors_part += get_min(extent_size, num_sectors - num_sectors_part);
+            }
+            r = transfer_storage(&inst->capacity, op, sector_index, data, num_sectors_part, repeat_same);
+            if(op == OP_WRITE)
+            {
+                inst->stat.WriteSectorCntCapacity += num_sectors_part;
+            }
+            else
+            {
+                inst->stat.ReadSectorCntCapacity += num_sectors_part;
+            }
+        }
+        sector_index += num_sectors_part;
+        num_sectors  -= num_sectors_part;
+        if(repeat_same == 0U)
+        {
+            data += num_sectors_part * inst->bytes_per_sector;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       copy_extent
+*
+*  Function description
+*    Copies the sectors of an extent between the storage devices.
+*/
+static int copy_extent(tier_inst_t * inst, const tier_storage_t * storage_src, U32 sector_src,
+                       const tier_storage_t * storage_dest, U32 sector_dest)
+{
+    U32 num_sectors = inst->extent_size;
+    U32 sector_end = sector_src + num_sectors;
+    int r = 0;
+
+    if(storage_src == &inst->capacity)
+    {
+        /* The last extent can be shorter than the others. */
+        num_sectors = (sector_end > inst->num_sectors) ? (inst->num_sectors - sector_src) : num_sectors;
+    }
+    else
+    {
+        num_sectors = (sector_dest + num_sectors > inst->num_sectors) ? (inst->num_sectors - sector_dest) : num_sectors;
+    }
+    while((r == 0) && (num_sectors != 0U))
+    {
+        U32 num_sectors_part = get_min(num_sectors, inst->num_sectors_copy);
+
+        r = transfer_storage(storage_src, OP_READ, sector_src, inst->copy_buffer, num_sectors_part, 0U);
+        if(r == 0)
+        {
+            r = transfer_storage(storage_dest, OP_WRITE, sector_dest, inst->copy_buffer, num_sectors_part, 0U);
+        }
+        inst->stat.MigrateSectorCnt += num_sectors_part;
+        sector_src  += num_sectors_part;
+        sector_dest += num_sectors_part;
+        num_sectors -= num_sectors_part;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_migration
+*
+*  Function description
+*    Searches for the candidate to be moved to the hot storage and
+*    the slot that receives it.
+*
+*  Return value
+*    ==true     An extent has to be moved.
+*    ==false    Nothing to do.
+*/
+static bool find_migration(const tier_inst_t * inst, U32 * candidate_index, U16 * slot)
+{
+    bool is_found = false;
+    U32 index_best = FS_TIER_NUM_CANDIDATES;
+    U16 slot_coldest = SLOT_NONE;
+
+    for(U32 i = 0U; i < FS_TIER_NUM_CANDIDATES; i++)
+    {
+        const tier_candidate_t * candidate = &inst->candidates[i];
+
+        if((candidate->count >= inst->promote_threshold) &&
+           ((index_best == FS_TIER_NUM_CANDIDATES) || (candidate->count > inst->candidates[index_best].count)))
+        {
+            index_best = i;
+        }
+    }
+    if(index_best < FS_TIER_NUM_CANDIDATES)
+    {
+        for(U16 i = 0U; i < inst->num_slots; i++)
+        {
+            if(get_slot_extent(inst, i) == EXTENT_FREE)
+            {
+                slot_coldest = i;
+                break;
+            }
+            if((slot_coldest == SLOT_NONE) || (inst->counts[i] < inst->counts[slot_coldest]))
+            {
+                slot_coldest = i;
+            }
+        }
+        /* An extent is replaced only by one accessed more often. */
+        if((get_slot_extent(inst, slot_coldest) == EXTENT_FREE) ||
+           (inst->counts[slot_coldest] < inst->candidates[index_best].count))
+        {
+            *candidate_index = index_best;
+            *slot            = slot_coldest;
+            is_found         = true;
+        }
+    }
+
+    return is_found;
+}
+
+/*********************************************************************
+*
+*       migrate_step
+*
+*  Function description
+*    Moves at most one extent to the hot storage.
+*
+*  Return value
+*    ==0    OK, extent moved or nothing to do.
+*    !=0    An error occurred.
+*
+*  Additional information
+*    The extent replaced is copied back to the capacity storage before
+*    its slot is released, and the promoted extent is copied before its
+*    slot is assigned, so that the map on the hot storage always refers
+*    to valid data.
+*/
+static int migrate_step(tier_inst_t * inst)
+{
+    U32 candidate_index;
+    U16 slot;
+    int r = 0;
+
+    if(find_migration(inst, &candidate_index, &slot))
+    {
+        tier_candidate_t * candidate = &inst->candidates[candidate_index];
+        U32 extent_old = get_slot_extent(inst, slot);
+        U32 sector_slot = inst->slot_start + (slot * inst->extent_size);
+
+        if(extent_old != EXTENT_FREE)
+        {
+            if((inst->flags[slot] & SLOT_FLAG_DIRTY) != 0U)
+            {
+                r = copy_extent(inst, &inst->hot, sector_slot, &inst->capacity, extent_old * inst->extent_size);
+            }
+            if(r == 0)
+            {
+                unlink_slot(inst, slot);
+                set_slot_extent(inst, slot, EXTENT_FREE);
+                r = save_meta(inst);
+                inst->stat.DemoteCnt++;
+            }
+        }
+        if(r == 0)
+        {
+            r = copy_extent(inst, &inst->capacity, candidate->extent * inst->extent_size, &inst->hot, sector_slot);
+        }
+        if(r == 0)
+        {
+            set_slot_extent(inst, slot, candidate->extent);
+            link_slot(inst, slot);
+            inst->counts[slot] = candidate->count;
+            inst->flags[slot]  = 0U;
+            candidate->count   = 0U;
+            r = save_meta(inst);
+            inst->stat.PromoteCnt++;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       migrate_if_due
+*
+*  Function description
+*    Moves an extent if the configured interval elapsed.
+*/
+static void migrate_if_due(tier_inst_t * inst)
+{
+    if(inst->interval_ms != 0U)
+    {
+        U32 time_now = FS_X_OS_GetTime();
+
+        if((time_now - inst->time_last) >= inst->interval_ms)
+        {
+            inst->time_last = time_now;
+            (void) migrate_step(inst);
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       is_range_valid
+*/
+static bool is_range_valid(const tier_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    return (sector_index < inst->num_sectors) && (num_sectors <= (inst->num_sectors - sector_index));
+}
+
+/*********************************************************************
+*
+*       forward_ioctl
+*
+*  Function description
+*    Sends a command to both storage devices.
+*
+*  Return value
+*    Value returned by the first storage device that reported an error, or 0.
+*/
+static int forward_ioctl(const tier_inst_t * inst, I32 cmd, I32 aux, void * p)
+{
+    int r = inst->hot.device_type->pfIoCtl(inst->hot.device_unit, cmd, aux, p);
+    int r_capacity = inst->capacity.device_type->pfIoCtl(inst->capacity.device_unit, cmd, aux, p);
+
+    return (r != 0) ? r : r_capacity;
+}
+
+/*********************************************************************
+*
+*       format_storage
+*
+*  Function description
+*    Low-level formats a storage device if it supports it.
+*
+*  Additional information
+*    Storage devices that do not have to be low-level formatted, for
+*    example SD cards, report an error in response to
+*    FS_CMD_REQUIRES_FORMAT and are left unchanged.
+*/
+static int format_storage(const tier_storage_t * storage)
+{
+    int r = 0;
+
+    if(storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_REQUIRES_FORMAT, 0, NULL) >= 0)
+    {
+        r = storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_FORMAT_LOW_LEVEL, 0, NULL);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       free_sectors
+*
+*  Function description
+*    Informs the storage devices about sectors no longer in use.
+*/
+static int free_sectors(const tier_inst_t * inst, U32 sector_index, U32 num_sectors)
+{
+    U32 extent_size = inst->extent_size;
+    int r = 0;
+
+    while(num_sectors != 0U)
+    {
+        U32 num_sectors_part = get_min(extent_size - (sector_index % extent_size), num_sectors);
+        U16 slot = find_slot(inst, sector_index / extent_size);
+        const tier_storage_t * storage = &inst->capacity;
+        U32 sector_storage = sector_index;
+        int r_storage;
+
+        if(slot != SLOT_NONE)
+        {
+            storage        = &inst->hot;
+            sector_storage = inst->slot_start + (slot * extent_size) + (sector_index % extent_size);
+        }
+        r_storage = storage->device_type->pfIoCtl(storage->device_unit, FS_CMD_FREE_SECTORS, (I32)sector_storage, &num_sectors_part);
+        if(r == 0)
+        {
+            r = r_storage;
+        }
+        sector_index += num_sectors_part;
+        num_sectors  -= num_sectors_part;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 15,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       tier_get_name
+*/
+static const char * tier_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "tier";
+}
+
+/*********************************************************************
+*
+*       tier_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int tier_add_device(void)
+{
+    int r = -1;
+
+    if(tier_num_units < FS_TIER_NUM_UNITS)
+    {
+        tier_inst_t * inst = &tier_inst[tier_num_units];
+
+        inst->promote_threshold = FS_TIER_PROMOTE_THRESHOLD;
+        inst->interval_ms       = FS_TIER_MIGRATE_INTERVAL_MS;
+        r = (int)tier_num_units;
+        tier_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_read
+*/
+static int tier_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    tier_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        r = transfer(inst, OP_READ, SectorIndex, (U8 *)pBuffer, NumSectors, 0U);
+        migrate_if_due(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_write
+*/
+static int tier_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    tier_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, SectorIndex, NumSectors))
+    {
+        CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by the storage device drivers');
+        r = transfer(inst, OP_WRITE, SectorIndex, (U8 *)pBuffer, NumSectors, RepeatSame);
+        migrate_if_due(inst);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_ioctl
+*/
+static int tier_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    tier_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->hot.device_type != NULL) && (inst->capacity.device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_GET_DEVINFO:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0))
+            {
+                r = inst->capacity.device_type->pfIoCtl(inst->capacity.device_unit, Cmd, Aux, pBuffer);
+            }
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if((pBuffer != NULL) && (init_if_required(inst) == 0) && is_range_valid(inst, (U32)Aux, *(U32 *)pBuffer))
+            {
+                r = free_sectors(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+        case FS_CMD_GET_CLEAN_CNT:
+            {
+                int value_total = 0;
+                int value = 0;
+
+                r = 0;
+                if(init_if_required(inst) == 0)
+                {
+                    U32 candidate_index;
+                    U16 slot;
+
+                    if(find_migration(inst, &candidate_index, &slot))
+                    {
+                        if(Cmd == FS_CMD_CLEAN_ONE)
+                        {
+                            r = (migrate_step(inst) == 0) ? 0 : -1;
+                        }
+                        value_total = 1;
+                    }
+                }
+                if(inst->hot.device_type->pfIoCtl(inst->hot.device_unit, Cmd, Aux, &value) != 0)
+                {
+                    r = -1;
+                }
+                value_total = (Cmd == FS_CMD_CLEAN_ONE) ? (value_total | value) : (value_total + value);
+                value = 0;
+                if(inst->capacity.device_type->pfIoCtl(inst->capacity.device_unit, Cmd, Aux, &value) != 0)
+                {
+                    r = -1;
+                }
+                value_total = (Cmd == FS_CMD_CLEAN_ONE) ? (value_total | value) : (value_total + value);
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = value_total;
+                }
+            }
+            break;
+        case FS_CMD_REQUIRES_FORMAT:
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            (void) init_if_required(inst);
+            if(inst->is_meta_invalid)
+            {
+                r = 1;
+            }
+            else if(r < 0)
+            {
+                r = 0;          /* The storage devices do not have to be formatted. */
+            }
+            else
+            {
+                /* Result of the storage devices. */
+            }
+            break;
+        case FS_CMD_FORMAT_LOW_LEVEL:
+            /* The slots are discarded together with the data of the volume. */
+            r = format_storage(&inst->hot);
+            if(r == 0)
+            {
+                r = format_storage(&inst->capacity);
+            }
+            if(r == 0)
+            {
+                inst->is_inited     = false;
+                inst->is_meta_reset = true;
+                r = (init_if_required(inst) == 0) ? 0 : -1;
+            }
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(tier_inst_t));
+            if(tier_num_units != 0U)
+            {
+                tier_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            if((Cmd == FS_CMD_UNMOUNT) || (Cmd == FS_CMD_UNMOUNT_FORCED))
+            {
+                inst->is_inited = false;        /* The storage media can be replaced while unmounted. */
+            }
+            r = forward_ioctl(inst, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_init_medium
+*/
+static int tier_init_medium(U8 Unit)
+{
+    tier_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->hot.device_type != NULL) && (inst->capacity.device_type != NULL))
+    {
+        r = 0;
+        if(inst->hot.device_type->pfInitMedium != NULL)
+        {
+            r = inst->hot.device_type->pfInitMedium(inst->hot.device_unit);
+        }
+        if((r == 0) && (inst->capacity.device_type->pfInitMedium != NULL))
+        {
+            r = inst->capacity.device_type->pfInitMedium(inst->capacity.device_unit);
+        }
+        if(r == 0)
+        {
+            r = init_if_required(inst);     /* Reports metadata that cannot be used. */
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_get_status
+*
+*  Return value
+*    FS_MEDIA_IS_PRESENT only if both storage media are present.
+*/
+static int tier_get_status(U8 Unit)
+{
+    tier_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->hot.device_type != NULL) && (inst->capacity.device_type != NULL))
+    {
+        r = inst->capacity.device_type->pfGetStatus(inst->capacity.device_unit);
+        if(r != FS_MEDIA_NOT_PRESENT)
+        {
+            int status = inst->hot.device_type->pfGetStatus(inst->hot.device_unit);
+
+            if(status != FS_MEDIA_IS_PRESENT)
+            {
+                r = status;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       tier_get_num_units
+*/
+static int tier_get_num_units(void)
+{
+    return (int)tier_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_TIER_Driver =
+{
+    tier_get_name,
+    tier_add_device,
+    tier_read,
+    tier_write,
+    tier_ioctl,
+    tier_init_medium,
+    tier_get_status,
+    tier_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_TIER_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   ExtentSize    Number of consecutive sectors moved together between
+*                 the storage devices.
+*   pBuffer       Buffer for the map of the hot storage and for copying
+*                 sectors. Has to be 32-bit aligned.
+*   NumBytes      Number of bytes in pBuffer. FS_SIZEOF_TIER() can be
+*                 used to calculate it.
+*
+*  Return Value
+*   FS_TIER_RESULT_OK          Driver instance configured.
+*   FS_TIER_RESULT_BADPARAM    Invalid parameters.
+*
+*  The hot storage holds as many extents as fit after the two copies of
+*  the map. The extent size must not be changed once data is stored on
+*  the volume, since the extents on the hot storage would be lost.
+*  Smaller extents make better use of the hot storage, larger ones
+*  reduce the number of migrations and the size of the map.
+*
+*******************************************************************************/
+FS_TIER_Result_t FS_TIER_Configure(U8 Unit, U32 ExtentSize, void * pBuffer, U32 NumBytes)
+{
+    FS_TIER_Result_t result = FS_TIER_RESULT_BADPARAM;
+    tier_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (ExtentSize != 0U) && (pBuffer != NULL) && (NumBytes != 0U))
+    {
+        inst->extent_size = ExtentSize;
+        inst->buffer      = (U8 *)pBuffer;
+        inst->num_bytes   = NumBytes;
+        inst->is_inited   = false;
+        result = FS_TIER_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_TIER_SetHotStorage
+****************************************************************************//**
+*
+*  Sets the fast storage device that holds the frequently accessed
+*  extents. Has to be called from FS_X_AddDevices(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver, for example FS_NOR_BM_Driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*
+*  Return Value
+*   FS_TIER_RESULT_OK          Storage device set.
+*   FS_TIER_RESULT_BADPARAM    Invalid parameters.
+*
+*******************************************************************************/
+FS_TIER_Result_t FS_TIER_SetHotStorage(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit)
+{
+    FS_TIER_Result_t result = FS_TIER_RESULT_BADPARAM;
+    tier_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL))
+    {
+        inst->hot.device_type = pDeviceType;
+        inst->hot.device_unit = DeviceUnit;
+        inst->is_inited       = false;
+        result = FS_TIER_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_TIER_SetCapacityStorage
+****************************************************************************//**
+*
+*  Sets the storage device that determines the capacity of the volume.
+*  Has to be called from FS_X_AddDevices(). The storage device has to be
+*  added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver, for example FS_MMC_CM_Driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*
+*  Return Value
+*   FS_TIER_RESULT_OK          Storage device set.
+*   FS_TIER_RESULT_BADPARAM    Invalid parameters.
+*
+*******************************************************************************/
+FS_TIER_Result_t FS_TIER_SetCapacityStorage(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit)
+{
+    FS_TIER_Result_t result = FS_TIER_RESULT_BADPARAM;
+    tier_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL))
+    {
+        inst->capacity.device_type = pDeviceType;
+        inst->capacity.device_unit = DeviceUnit;
+        inst->is_inited            = false;
+        result = FS_TIER_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_TIER_SetMigration
+****************************************************************************//**
+*
+*  Configures when extents are moved to the hot storage.
+*
+*  Parameters
+*   Unit               Index of the driver instance (0-based).
+*   PromoteThreshold   Access count from which an extent is moved to the
+*                      hot storage. A read counts 1, a write
+*                      FS_TIER_WRITE_WEIGHT.
+*   IntervalMs         Minimum time in milliseconds between two
+*                      migrations performed while the file system
+*                      accesses the volume. 0 disables these migrations.
+*
+*  Return Value
+*   FS_TIER_RESULT_OK          Configuration changed.
+*   FS_TIER_RESULT_BADPARAM    Invalid parameters.
+*
+*  A migration is performed after a read or write request when the
+*  interval has elapsed, which requires FS_X_OS_GetTime() to return the
+*  system time in milliseconds. In addition, each call to
+*  FS_STORAGE_CleanOne() performs one migration, so an application task
+*  can move the extents while the volume is idle.
+*
+*******************************************************************************/
+FS_TIER_Result_t FS_TIER_SetMigration(U8 Unit, U16 PromoteThreshold, U32 IntervalMs)
+{
+    FS_TIER_Result_t result = FS_TIER_RESULT_BADPARAM;
+    tier_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (PromoteThreshold != 0U))
+    {
+        inst->promote_threshold = PromoteThreshold;
+        inst->interval_ms       = IntervalMs;
+        result = FS_TIER_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_TIER_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_TIER_GetStatCounters(U8 Unit, FS_TIER_STAT_COUNTERS * pStat)
+{
+    tier_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_TIER_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_TIER_ResetStatCounters(U8 Unit)
+{
+    tier_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
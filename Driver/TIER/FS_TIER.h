@@ -0,0 +1,139 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_TIER.h
+Purpose     : Logical driver that keeps the frequently accessed sectors
+              on a fast storage device in front of a large one.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_TIER_H     // Avoid recursive and multiple inclusion
+#define FS_TIER_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_TIER_NUM_UNITS
+#define FS_TIER_NUM_UNITS               (1U)    /* Maximum number of driver instances. */
+#endif
+
+#ifndef FS_TIER_NUM_CANDIDATES
+#define FS_TIER_NUM_CANDIDATES          (32U)   /* Number of extents on the capacity storage whose accesses are counted. */
+#endif
+
+#ifndef FS_TIER_PROMOTE_THRESHOLD
+#define FS_TIER_PROMOTE_THRESHOLD       (8U)    /* Default number of accesses after which an extent is moved to the hot storage. */
+#endif
+
+#ifndef FS_TIER_MIGRATE_INTERVAL_MS
+#define FS_TIER_MIGRATE_INTERVAL_MS     (100U)  /* Default minimum time in milliseconds between two migrations. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Number of bytes in the buffer passed to FS_TIER_Configure(). NumSlots is the number of
+   extents that fit on the hot storage, NumSectorsCopy the number of sectors copied at once. */
+#define FS_SIZEOF_TIER(NumSlots, BytesPerSector, NumSectorsCopy)                                   \
+    (((((((NumSlots) * 4U) + (BytesPerSector)) - 1U) / (BytesPerSector)) + 1U + (NumSectorsCopy)) * \
+     (BytesPerSector) + ((NumSlots) * 9U))
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32 ReadSectorCntHot;           /* Number of sectors read from the hot storage. */
+    U32 ReadSectorCntCapacity;      /* Number of sectors read from the capacity storage. */
+    U32 WriteSectorCntHot;          /* Number of sectors written to the hot storage. */
+    U32 WriteSectorCntCapacity;     /* Number of sectors written to the capacity storage. */
+    U32 PromoteCnt;                 /* Number of extents moved to the hot storage. */
+    U32 DemoteCnt;                  /* Number of extents moved back to the capacity storage. */
+    U32 MigrateSectorCnt;           /* Number of sectors copied between the storage devices. */
+} FS_TIER_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_TIER_RESULT_OK = 0U,
+    FS_TIER_RESULT_BADPARAM,
+} FS_TIER_Result_t;
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_TIER_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_TIER_Result_t FS_TIER_Configure          (U8 Unit, U32 ExtentSize, void * pBuffer, U32 NumBytes);
+FS_TIER_Result_t FS_TIER_SetHotStorage      (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit);
+FS_TIER_Result_t FS_TIER_SetCapacityStorage (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit);
+FS_TIER_Result_t FS_TIER_SetMigration       (U8 Unit, U16 PromoteThreshold, U32 IntervalMs);
+void             FS_TIER_GetStatCounters    (U8 Unit, FS_TIER_STAT_COUNTERS * pStat);
+void             FS_TIER_ResetStatCounters  (U8 Unit);
+
+#endif  // FS_TIER_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,911 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_WRCOAL.c
+Purpose     : Logical driver that coalesces sector write operations.
+              The sectors written by the file system are collected in a
+              RAM buffer. A sector written again while buffered replaces
+              the buffered copy. When the buffer is flushed the sectors are
+              sorted by their index and consecutive sectors are passed to
+              the storage device with a single write request. Typically
+              placed between FS_WRBUF and a NOR_BM or SD card driver in order
+              to reduce the number of program operations of small appends.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_WRCOAL.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define ENTRY_NONE                      (0xFFFFU)
+#define MAX_NUM_ENTRIES                 (0xFFFEU)
+#define SECTOR_INDEX_INVALID            (0xFFFFFFFFUL)
+#define BUFFER_ALIGNMENT                (4U)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    const FS_DEVICE_TYPE    * device_type;
+    U8                        device_unit;
+    bool                      is_inited;        /* Set when the buffer layout has been calculated. */
+    U8                      * buffer;
+    U32                       buffer_size;
+    FS_WRCOAL_SECTOR_INFO   * sectors;
+    U8                      * sector_data;
+    U16                       bytes_per_sector;
+    U16                       num_entries;      /* Number of sectors that can be buffered. The entry after the last one is used for sorting. */
+    U16                       num_used;         /* Number of entries filled, including the ones of freed sectors. */
+    U16                       num_freed;        /* Number of entries of sectors freed while buffered. */
+    U32                       flush_threshold;  /* 0 means flush only when the buffer is full. */
+    FS_WRCOAL_STAT_COUNTERS   stat;
+} wrcoal_inst_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static wrcoal_inst_t wrcoal_inst[FS_WRCOAL_NUM_UNITS];
+static U8            wrcoal_num_units;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_inst
+*/
+static wrcoal_inst_t * get_inst(U8 unit)
+{
+    wrcoal_inst_t * inst = NULL;
+
+    if(unit < FS_WRCOAL_NUM_UNITS)
+    {
+        inst = &wrcoal_inst[unit];
+    }
+
+    return inst;
+}
+
+/*********************************************************************
+*
+*       get_sector_data
+*/
+static U8 * get_sector_data(const wrcoal_inst_t * inst, U16 entry)
+{
+    return inst->sector_data + ((U32)entry * inst->bytes_per_sector);
+}
+
+/*********************************************************************
+*
+*       hash_get_bucket
+*/
+static U16 * hash_get_bucket(wrcoal_inst_t * inst, U32 sector_index)
+{
+    return &inst->sectors[sector_index % inst->num_entries].HashHead;
+}
+
+/*********************************************************************
+*
+*       hash_find
+*
+*  Return value
+*    Index of the entry storing the sector or ENTRY_NONE if not buffered.
+*/
+static U16 hash_find(wrcoal_inst_t * inst, U32 sector_index)
+{
+    U16 entry = *hash_get_bucket(inst, sector_index);
+
+    while((entry != ENTRY_NONE) && (inst->sectors[entry].SectorIndex != sector_index))
+    {
+        entry = inst->sectors[entry].HashNext;
+    }
+
+    return entry;
+}
+
+/*********************************************************************
+*
+*       hash_add
+*/
+static void hash_add(wrcoal_inst_t * inst, U16 entry)
+{
+    U16 * bucket = hash_get_bucket(inst, inst->sectors[entry].SectorIndex);
+
+    inst->sectors[entry].HashNext = *bucket;
+    *bucket = entry;
+}
+
+/*********************************************************************
+*
+*       hash_remove
+*/
+static void hash_remove(wrcoal_inst_t * inst, U16 entry)
+{
+    U16 * link = hash_get_bucket(inst, inst->sectors[entry].SectorIndex);
+
+    while(*link != ENTRY_NONE)
+    {
+        if(*link == entry)
+        {
+            *link = inst->sectors[entry].HashNext;
+            break;
+        }
+        link = &inst->sectors[*link].HashNext;
+    }
+    inst->sectors[entry].HashNext = ENTRY_NONE;
+}
+
+/*********************************************************************
+*
+*       hash_rebuild
+*
+*  Function description
+*    Indexes the entries in use again after they were moved.
+*/
+static void hash_rebuild(wrcoal_inst_t * inst)
+{
+    for(U16 entry = 0U; entry < inst->num_entries; entry++)
+    {
+        inst->sectors[entry].HashHead = ENTRY_NONE;
+    }
+    for(U16 entry = 0U; entry < inst->num_used; entry++)
+    {
+        if(inst->sectors[entry].SectorIndex != SECTOR_INDEX_INVALID)
+        {
+            hash_add(inst, entry);
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       init_if_required
+*
+*  Function description
+*    Calculates the number of sectors that fit in the buffer using
+*    the sector size reported by the storage device.
+*
+*  Return value
+*    ==0    OK, buffer ready.
+*    !=0    An error occurred.
+*/
+static int init_if_required(wrcoal_inst_t * inst)
+{
+    int r = 0;
+
+    if(!inst->is_inited)
+    {
+        FS_DEV_INFO dev_info;
+        U32 num_entries;
+
+        FS_MEMSET(&dev_info, 0, sizeof(dev_info));
+        r = inst->device_type->pfIoCtl(inst->device_unit, FS_CMD_GET_DEVINFO, 0, &dev_info);
+        if((r == 0) && (dev_info.BytesPerSector != 0U))
+        {
+            num_entries = inst->buffer_size / (U32)(sizeof(FS_WRCOAL_SECTOR_INFO) + dev_info.BytesPerSector);
+            if(num_entries > MAX_NUM_ENTRIES)
+            {
+                num_entries = MAX_NUM_ENTRIES;
+            }
+            if(num_entries < 2U)
+            {
+                r = 1;          /* Buffer too small. */
+            }
+            else
+            {
+                num_entries--;  /* One entry is used for sorting. */
+                inst->bytes_per_sector = dev_info.BytesPerSector;
+                inst->num_entries      = (U16)num_entries;
+                inst->sectors          = (FS_WRCOAL_SECTOR_INFO *)(void *)inst->buffer;
+                inst->sector_data      = inst->buffer + ((num_entries + 1U) * sizeof(FS_WRCOAL_SECTOR_INFO));
+                inst->num_used         = 0U;
+                inst->num_freed        = 0U;
+                hash_rebuild(inst);
+                inst->is_inited        = true;
+            }
+        }
+        else
+        {
+            r = 1;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       compact
+*
+*  Function description
+*    Closes the gaps left by sectors freed while buffered.
+*/
+static void compact(wrcoal_inst_t * inst)
+{
+    U16 entry_dst = 0U;
+
+    for(U16 entry_src = 0U; entry_src < inst->num_used; entry_src++)
+    {
+        if(inst->sectors[entry_src].SectorIndex != SECTOR_INDEX_INVALID)
+        {
+            if(entry_src != entry_dst)
+            {
+                inst->sectors[entry_dst].SectorIndex = inst->sectors[entry_src].SectorIndex;
+                FS_MEMCPY(get_sector_data(inst, entry_dst), get_sector_data(inst, entry_src), inst->bytes_per_sector);
+            }
+            entry_dst++;
+        }
+    }
+    inst->num_used  = entry_dst;
+    inst->num_freed = 0U;
+}
+
+/*********************************************************************
+*
+*       sort
+*
+*  Function description
+*    Moves the buffered sectors in ascending order of their index.
+*
+*  Additional information
+*    The order is calculated first via insertion sort which is fast
+*    for the typical, almost sorted, write sequences. The sector data
+*    is then moved along the cycles of the permutation so that each
+*    sector is copied only once, using the spare entry at the end of
+*    the buffer as temporary storage.
+*/
+static void sort(wrcoal_inst_t * inst)
+{
+    FS_WRCOAL_SECTOR_INFO * sectors = inst->sectors;
+    U8 * data_tmp = get_sector_data(inst, inst->num_entries);
+
+    for(U16 pos = 0U; pos < inst->num_used; pos++)
+    {
+        U16 entry = pos;
+        U16 i = pos;
+
+        while((i > 0U) && (sectors[sectors[i - 1U].Order].SectorIndex > sectors[entry].SectorIndex))
+        {
+            sectors[i].Order = sectors[i - 1U].Order;
+            i--;
+        }
+        sectors[i].Order = entry;
+    }
+
+    for(U16 pos = 0U; pos < inst->num_used; pos++)
+    {
+        if(sectors[pos].Order != pos)
+        {
+            U32 sector_index_tmp = sectors[pos].SectorIndex;
+            U16 entry_dst = pos;
+
+            FS_MEMCPY(data_tmp, get_sector_data(inst, pos), inst->bytes_per_sector);
+            while(sectors[entry_dst].Order != pos)
+            {
+                U16 entry_src = sectors[entry_dst].Order;
+
+                sectors[entry_dst].SectorIndex = sectors[entry_src].SectorIndex;
+                FS_MEMCPY(get_sector_data(inst, entry_dst), get_sector_data(inst, entry_src), inst->bytes_per_sector);
+                sectors[entry_dst].Order = entry_dst;
+                entry_dst = entry_src;
+            }
+            sectors[entry_dst].SectorIndex = sector_index_tmp;
+            FS_MEMCPY(get_sector_data(inst, entry_dst), data_tmp, inst->bytes_per_sector);
+            sectors[entry_dst].Order = entry_dst;
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       flush
+*
+*  Function description
+*    Writes all buffered sectors to the storage device.
+*
+*  Return value
+*    ==0    OK, buffer empty.
+*    !=0    An error occurred. The sectors remain buffered.
+*/
+static int flush(wrcoal_inst_t * inst)
+{
+    int r = 0;
+
+    if(inst->num_freed != 0U)
+    {
+        compact(inst);
+    }
+
+    if(inst->num_used != 0U)
+    {
+        U16 pos = 0U;
+
+        sort(inst);
+        while(pos < inst->num_used)
+        {
+            U32 sector_index = inst->sectors[pos].SectorIndex;
+            U16 num_sectors = 1U;
+
+            while(((pos + num_sectors) < inst->num_used) && (inst->sectors[pos + num_sectors].SectorIndex == (sector_index + num_sectors)))
+            {
+                num_sectors++;
+            }
+            r = inst->device_type->pfWrite(inst->device_unit, sector_index, get_sector_data(inst, pos), num_sectors, 0U);
+            if(r != 0)
+            {
+                break;
+            }
+            inst->stat.WriteRequestCnt++;
+            inst->stat.WriteSectorDeviceCnt += num_sectors;
+            pos += num_sectors;
+        }
+        inst->stat.FlushCnt++;
+
+        if(r == 0)
+        {
+            inst->num_used = 0U;
+        }
+        hash_rebuild(inst);     /* The entries were moved by sort(). */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       discard_range
+*
+*  Function description
+*    Removes the buffered copies of sectors that are no longer in use.
+*/
+static void discard_range(wrcoal_inst_t * inst, U32 first_sector, U32 num_sectors)
+{
+    for(U16 entry = 0U; entry < inst->num_used; entry++)
+    {
+        U32 sector_index = inst->sectors[entry].SectorIndex;
+
+        if((sector_index != SECTOR_INDEX_INVALID) && (sector_index >= first_sector) && ((sector_index - first_sector) < num_sectors))
+        {
+            hash_remove(inst, entry);
+            inst->sectors[entry].SectorIndex = SECTOR_INDEX_INVALID;
+            inst->num_freed++;
+        }
+    }
+    if(inst->num_freed == inst->num_used)
+    {
+        inst->num_used  = 0U;
+        inst->num_freed = 0U;
+    }
+}
+
+/*********************************************************************
+*
+*      Public code (via callback)
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 12,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       wrcoal_get_name
+*/
+static const char * wrcoal_get_name(U8 Unit)
+{
+    FS_USE_PARA(Unit);
+    return "wrcoal";
+}
+
+/*********************************************************************
+*
+*       wrcoal_add_device
+*
+*  Return value
+*    >=0    Index of the created driver instance.
+*    < 0    Too many driver instances.
+*/
+static int wrcoal_add_device(void)
+{
+    int r = -1;
+
+    if(wrcoal_num_units < FS_WRCOAL_NUM_UNITS)
+    {
+        r = (int)wrcoal_num_units;
+        wrcoal_num_units++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_read
+*
+*  Function description
+*    Reads sectors from the buffer and the missing ones from the storage device.
+*/
+static int wrcoal_read(U8 Unit, U32 SectorIndex, void * pBuffer, U32 NumSectors)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+    U8 * data = (U8 *)pBuffer;
+    U32  i = 0U;
+    int  r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        if((init_if_required(inst) != 0) || (inst->num_used == 0U))
+        {
+            r = inst->device_type->pfRead(inst->device_unit, SectorIndex, pBuffer, NumSectors);
+        }
+        else
+        {
+            r = 0;
+            while(i < NumSectors)
+            {
+                U16 entry = hash_find(inst, SectorIndex + i);
+
+                if(entry != ENTRY_NONE)
+                {
+                    FS_MEMCPY(data + (i * inst->bytes_per_sector), get_sector_data(inst, entry), inst->bytes_per_sector);
+                    i++;
+                }
+                else
+                {
+                    U32 num_sectors = 1U;
+
+                    while(((i + num_sectors) < NumSectors) && (hash_find(inst, SectorIndex + i + num_sectors) == ENTRY_NONE))
+                    {
+                        num_sectors++;
+                    }
+                    r = inst->device_type->pfRead(inst->device_unit, SectorIndex + i, data + (i * inst->bytes_per_sector), num_sectors);
+                    if(r != 0)
+                    {
+                        break;
+                    }
+                    i += num_sectors;
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_write
+*
+*  Function description
+*    Stores sectors to the buffer.
+*
+*  Additional information
+*    The buffer is flushed when it is full or when the number of buffered
+*    sectors reaches the threshold set via FS_WRCOAL_SetFlushThreshold().
+*    Requests that do not fit in the buffer are written to the storage
+*    device after the buffer has been flushed.
+*/
+static int wrcoal_write(U8 Unit, U32 SectorIndex, const void * pBuffer, U32 NumSectors, U8 RepeatSame)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+    const U8 * data = (const U8 *)pBuffer;
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        if(init_if_required(inst) != 0)
+        {
+            r = inst->device_type->pfWrite(inst->device_unit, SectorIndex, pBuffer, NumSectors, RepeatSame);
+        }
+        else if(NumSectors >= inst->num_entries)
+        {
+            inst->stat.WriteSectorCnt += NumSectors;
+            r = flush(inst);
+            if(r == 0)
+            {
+                r = inst->device_type->pfWrite(inst->device_unit, SectorIndex, pBuffer, NumSectors, RepeatSame);
+                if(r == 0)
+                {
+                    inst->stat.WriteRequestCnt++;
+                    inst->stat.WriteSectorDeviceCnt += NumSectors;
+                }
+            }
+        }
+        else
+        {
+            inst->stat.WriteSectorCnt += NumSectors;
+            r = 0;
+            for(U32 i = 0U; i < NumSectors; i++)
+            {
+                U16 entry = hash_find(inst, SectorIndex + i);
+
+                if(entry != ENTRY_NONE)
+                {
+                    inst->stat.WriteSectorMergedCnt++;
+                }
+                else
+                {
+                    if(inst->num_used >= inst->num_entries)
+                    {
+                        r = flush(inst);
+                        if(r != 0)
+                        {
+                            break;
+                        }
+                    }
+                    entry = inst->num_used;
+                    inst->num_used++;
+                    inst->sectors[entry].SectorIndex = SectorIndex + i;
+                    hash_add(inst, entry);
+                }
+                FS_MEMCPY(get_sector_data(inst, entry), (RepeatSame != 0U) ? data : (data + (i * inst->bytes_per_sector)), inst->bytes_per_sector);
+            }
+            if((r == 0) && (inst->flush_threshold != 0U) && ((U32)inst->num_used - inst->num_freed) >= inst->flush_threshold)
+            {
+                r = flush(inst);
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_ioctl
+*/
+static int wrcoal_ioctl(U8 Unit, I32 Cmd, I32 Aux, void * pBuffer)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+    int r = -1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        switch(Cmd)
+        {
+        case FS_CMD_SYNC:
+        case FS_CMD_SYNC_SECTORS:
+        case FS_CMD_CLEAN:
+            r = 0;
+            if(inst->is_inited && (flush(inst) != 0))
+            {
+                r = -1;
+            }
+            if(inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer) != 0)
+            {
+                r = -1;
+            }
+            break;
+        case FS_CMD_CLEAN_ONE:
+            if(inst->is_inited && (inst->num_used != 0U))
+            {
+                r = (flush(inst) != 0) ? -1 : 0;
+                if(pBuffer != NULL)
+                {
+                    *(int *)pBuffer = 1;    /* The storage device can have work to do as well. */
+                }
+            }
+            else
+            {
+                r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            }
+            break;
+        case FS_CMD_GET_CLEAN_CNT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            if(inst->is_inited && (pBuffer != NULL))
+            {
+                if(r != 0)
+                {
+                    *(int *)pBuffer = 0;    /* Not supported by the storage device. */
+                    r = 0;
+                }
+                if(inst->num_used != 0U)
+                {
+                    *(int *)pBuffer += 1;
+                }
+            }
+            break;
+        case FS_CMD_UNMOUNT:
+            r = 0;
+            if(inst->is_inited && (flush(inst) != 0))
+            {
+                r = -1;
+            }
+            /* The storage medium can be replaced while unmounted. */
+            inst->is_inited = false;
+            if(inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer) != 0)
+            {
+                r = -1;
+            }
+            break;
+        case FS_CMD_UNMOUNT_FORCED:
+            /* Buffered sectors are discarded. */
+            inst->is_inited = false;
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        case FS_CMD_FREE_SECTORS:
+            if(inst->is_inited && (pBuffer != NULL))
+            {
+                discard_range(inst, (U32)Aux, *(U32 *)pBuffer);
+            }
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+#if FS_SUPPORT_DEINIT
+        case FS_CMD_DEINIT:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            FS_MEMSET(inst, 0, sizeof(wrcoal_inst_t));
+            if(wrcoal_num_units != 0U)
+            {
+                wrcoal_num_units--;
+            }
+            break;
+#endif // FS_SUPPORT_DEINIT
+        default:
+            r = inst->device_type->pfIoCtl(inst->device_unit, Cmd, Aux, pBuffer);
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_init_medium
+*/
+static int wrcoal_init_medium(U8 Unit)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+    int r = 1;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = 0;
+        if(inst->device_type->pfInitMedium != NULL)
+        {
+            r = inst->device_type->pfInitMedium(inst->device_unit);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_get_status
+*/
+static int wrcoal_get_status(U8 Unit)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+    int r = FS_MEDIA_STATE_UNKNOWN;
+
+    if((inst != NULL) && (inst->device_type != NULL))
+    {
+        r = inst->device_type->pfGetStatus(inst->device_unit);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       wrcoal_get_num_units
+*/
+static int wrcoal_get_num_units(void)
+{
+    return (int)wrcoal_num_units;
+}
+
+/*********************************************************************
+*
+*       Public const
+*
+**********************************************************************
+*/
+const FS_DEVICE_TYPE FS_WRCOAL_Driver =
+{
+    wrcoal_get_name,
+    wrcoal_add_device,
+    wrcoal_read,
+    wrcoal_write,
+    wrcoal_ioctl,
+    wrcoal_init_medium,
+    wrcoal_get_status,
+    wrcoal_get_num_units
+};
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+
+/*******************************************************************************
+* Function Name: FS_WRCOAL_Configure
+****************************************************************************//**
+*
+*  Configures a driver instance. Has to be called from FS_X_AddDevices()
+*  after the driver has been added via FS_AddDevice(). The storage device
+*  has to be added via FS_AddPhysDevice().
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   pDeviceType   Storage device driver.
+*   DeviceUnit    Index of the storage device driver instance (0-based).
+*   pBuffer       Memory for the buffered sectors. Use FS_SIZEOF_WRCOAL()
+*                 to calculate the size required for a number of sectors.
+*   NumBytes      Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_WRCOAL_RESULT_OK          Configured successfully.
+*   FS_WRCOAL_RESULT_BADPARAM    Invalid parameters.
+*
+*  To coalesce the sectors written by FS_WRBUF, pass FS_WRCOAL_Driver
+*  to FS_WRBUF_Configure() as storage device and configure the storage
+*  device via FS_WRCOAL_Configure(). The buffered sectors are written on
+*  FS_STORAGE_Sync(), FS_Unmount() and when the buffer is full. Sectors
+*  written between two of these events reach the storage device in
+*  ascending order of their index, not in the order they were written.
+*
+*******************************************************************************/
+FS_WRCOAL_Result_t FS_WRCOAL_Configure(U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes)
+{
+    FS_WRCOAL_Result_t result = FS_WRCOAL_RESULT_BADPARAM;
+    wrcoal_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pDeviceType != NULL) && (pBuffer != NULL))
+    {
+        U32 num_bytes_skip = (BUFFER_ALIGNMENT - ((U32)(uintptr_t)pBuffer % BUFFER_ALIGNMENT)) % BUFFER_ALIGNMENT;
+
+        if(NumBytes > num_bytes_skip)
+        {
+            FS_MEMSET(inst, 0, sizeof(wrcoal_inst_t));
+            inst->device_type = pDeviceType;
+            inst->device_unit = DeviceUnit;
+            inst->buffer      = (U8 *)pBuffer + num_bytes_skip;
+            inst->buffer_size = NumBytes - num_bytes_skip;
+            result = FS_WRCOAL_RESULT_OK;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_WRCOAL_SetFlushThreshold
+****************************************************************************//**
+*
+*  Configures the number of buffered sectors that triggers a flush.
+*
+*  Parameters
+*   Unit          Index of the driver instance (0-based).
+*   NumSectors    Number of different sectors buffered before they are
+*                 written to the storage device. 0 flushes the buffer
+*                 only when it is full (default).
+*
+*  Return Value
+*   FS_WRCOAL_RESULT_OK          Threshold set.
+*   FS_WRCOAL_RESULT_BADPARAM    Invalid parameters.
+*
+*  A lower threshold limits the amount of data lost on a power failure
+*  at the cost of shorter bursts.
+*
+*******************************************************************************/
+FS_WRCOAL_Result_t FS_WRCOAL_SetFlushThreshold(U8 Unit, U32 NumSectors)
+{
+    FS_WRCOAL_Result_t result = FS_WRCOAL_RESULT_BADPARAM;
+    wrcoal_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        inst->flush_threshold = NumSectors;
+        result = FS_WRCOAL_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_WRCOAL_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*    pStat      [OUT] Values of the statistical counters.
+*/
+void FS_WRCOAL_GetStatCounters(U8 Unit, FS_WRCOAL_STAT_COUNTERS * pStat)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+
+    if((inst != NULL) && (pStat != NULL))
+    {
+        *pStat = inst->stat;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_WRCOAL_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*
+*  Parameters
+*    Unit       Index of the driver instance (0-based).
+*/
+void FS_WRCOAL_ResetStatCounters(U8 Unit)
+{
+    wrcoal_inst_t * inst = get_inst(Unit);
+
+    if(inst != NULL)
+    {
+        FS_MEMSET(&inst->stat, 0, sizeof(inst->stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,131 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_WRCOAL.h
+Purpose     : Logical driver that coalesces sector write operations.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_WRCOAL_H     // Avoid recursive and multiple inclusion
+#define FS_WRCOAL_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_WRCOAL_NUM_UNITS
+#define FS_WRCOAL_NUM_UNITS             (2U)    /* Maximum number of driver instances. */
+#endif
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+/* Management information of a buffered sector. FS internal structure. */
+typedef struct
+{
+    U32 SectorIndex;        /* Index of the buffered sector. */
+    U16 HashHead;           /* First entry of the hash bucket with the same index. */
+    U16 HashNext;           /* Next entry in the same hash bucket. */
+    U16 Order;              /* Entry stored at this position after sorting. */
+} FS_WRCOAL_SECTOR_INFO;
+
+typedef struct
+{
+    U32 WriteSectorCnt;         /* Number of sectors written by the file system. */
+    U32 WriteSectorMergedCnt;   /* Number of sector writes that replaced a buffered copy of the same sector. */
+    U32 FlushCnt;               /* Number of times the buffer was written to the storage device. */
+    U32 WriteRequestCnt;        /* Number of write requests sent to the storage device. */
+    U32 WriteSectorDeviceCnt;   /* Number of sectors written to the storage device. */
+} FS_WRCOAL_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_WRCOAL_RESULT_OK = 0U,
+    FS_WRCOAL_RESULT_BADPARAM,
+} FS_WRCOAL_Result_t;
+
+/*********************************************************************
+*
+*       Buffer size
+*
+*  Description
+*    Calculates the number of bytes to be passed to FS_WRCOAL_Configure()
+*    in order to buffer NumSectors sectors of SectorSize bytes. One
+*    additional sector is used internally for sorting.
+*/
+#define FS_SIZEOF_WRCOAL_SECTOR_INFO                sizeof(FS_WRCOAL_SECTOR_INFO)
+#define FS_SIZEOF_WRCOAL(NumSectors, SectorSize)    ((FS_SIZEOF_WRCOAL_SECTOR_INFO + (SectorSize)) * ((NumSectors) + 1U))
+
+/*********************************************************************
+*
+*       Public data
+*
+**********************************************************************
+*/
+extern const FS_DEVICE_TYPE FS_WRCOAL_Driver;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_WRCOAL_Result_t FS_WRCOAL_Configure            (U8 Unit, const FS_DEVICE_TYPE * pDeviceType, U8 DeviceUnit, void * pBuffer, U32 NumBytes);
+FS_WRCOAL_Result_t FS_WRCOAL_SetFlushThreshold    (U8 Unit, U32 NumSectors);
+void               FS_WRCOAL_GetStatCounters      (U8 Unit, FS_WRCOAL_STAT_COUNTERS * pStat);
+void               FS_WRCOAL_ResetStatCounters    (U8 Unit);
+
+#endif  // FS_WRCOAL_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,716 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_AIO.c
+Purpose     : Asynchronous file I/O served by a pool of worker tasks.
+              The file system API is synchronous. This module queues read,
+              write and synchronization requests and executes them in the
+              context of worker tasks so that the requesting task does not
+              block while the storage device is busy. Without the RTOS_AWARE
+              component the requests are executed immediately in the context
+              of the caller.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_OS.h"
+#include "FS_AIO.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*      Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_AIO_DEFAULT_STACK_SIZE
+#define FS_AIO_DEFAULT_STACK_SIZE       (2048U)     /* in bytes. */
+#endif
+
+#ifndef FS_AIO_DEFAULT_QUEUE_DEPTH
+#define FS_AIO_DEFAULT_QUEUE_DEPTH      (8U)
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#if defined(COMPONENT_RTOS_AWARE)
+#define AIO_SEMA_INIT_COUNT             (0LU)
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+#if defined(COMPONENT_RTOS_AWARE)
+typedef struct
+{
+    cy_mutex_t       mutex;             /* Protects the queue of the worker. */
+    cy_semaphore_t   sema_pending;      /* Counts the requests waiting in the queue. */
+    cy_thread_t      thread;
+    FS_AIO_REQUEST * queue_head;
+    FS_AIO_REQUEST * queue_tail;
+    FS_AIO_REQUEST * active_req;        /* Request which is currently executed. */
+    uint32_t         num_queued;
+    bool             stop_requested;
+} aio_worker_t;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static bool     aio_initialized = false;
+static uint16_t aio_queue_depth;
+
+#if defined(COMPONENT_RTOS_AWARE)
+static uint8_t      aio_num_workers;
+static aio_worker_t aio_workers[FS_AIO_MAX_WORKERS];
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       execute_request
+*
+*  Function description
+*    Performs the file system operation described by a request.
+*
+*  Additional information
+*    The completion callback is invoked here but the request is not
+*    marked as done. This is done by complete_request() after the
+*    worker stopped referencing the request.
+*/
+static void execute_request(FS_AIO_REQUEST * pReq)
+{
+    U32 num_bytes_done = 0U;
+    int result = FS_ERRCODE_OK;
+
+    switch(pReq->Operation)
+    {
+    case FS_AIO_OP_READ:
+        num_bytes_done = FS_Read(pReq->pFile, pReq->pData, pReq->NumBytes);
+        break;
+    case FS_AIO_OP_WRITE:
+        num_bytes_done = FS_Write(pReq->pFile, pReq->pData, pReq->NumBytes);
+        break;
+    default:
+        result = FS_SyncFile(pReq->pFile);
+        break;
+    }
+
+    if(pReq->Operation != FS_AIO_OP_SYNC)
+    {
+        if(num_bytes_done != pReq->NumBytes)
+        {
+            /* FS_Read() and FS_Write() report the reason of a short transfer
+             * only via the error indicator of the file handle.
+             */
+            result = (int)FS_FError(pReq->pFile);
+            if(result == FS_ERRCODE_OK)
+            {
+                result = FS_ERRCODE_EOF;
+            }
+        }
+    }
+
+    pReq->NumBytesDone = num_bytes_done;
+    pReq->Result       = result;
+
+    if(pReq->pfOnComplete != NULL)
+    {
+        pReq->pfOnComplete(pReq);
+    }
+}
+
+/*********************************************************************
+*
+*       complete_request
+*
+*  Function description
+*    Marks a request as done and signals the optional semaphore.
+*
+*  Additional information
+*    The application is allowed to reuse the request as soon as its
+*    status changes to done. Therefore this has to be the last access
+*    of the module to the request.
+*/
+static void complete_request(FS_AIO_REQUEST * pReq)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    /* The semaphore is not read from the request after the status changed. */
+    cy_semaphore_t * sema_done = pReq->pSemaDone;
+
+    pReq->Status = FS_AIO_STATUS_DONE;
+    if(sema_done != NULL)
+    {
+        (void) cy_rtos_set_semaphore(sema_done, false);
+    }
+#else
+    pReq->Status = FS_AIO_STATUS_DONE;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+#if defined(COMPONENT_RTOS_AWARE)
+
+/*********************************************************************
+*
+*       get_worker
+*
+*  Function description
+*    Returns the worker responsible for a file handle.
+*
+*  Additional information
+*    All the requests for the same file handle are served by the same
+*    worker in the order they were submitted. The requests for different
+*    file handles can be served in parallel by different workers.
+*/
+static aio_worker_t * get_worker(const FS_FILE * pFile)
+{
+    uintptr_t key = (uintptr_t)pFile;
+
+    key ^= key >> 7;
+    return &aio_workers[(key >> 2) % aio_num_workers];
+}
+
+/*********************************************************************
+*
+*       worker_task
+*
+*  Function description
+*    Main loop of a worker task.
+*/
+static void worker_task(cy_thread_arg_t arg)
+{
+    aio_worker_t   * worker = (aio_worker_t *)arg;
+    FS_AIO_REQUEST * pReq;
+    bool             stop = false;
+
+    while(!stop)
+    {
+        cy_rslt_t result = cy_rtos_get_semaphore(&worker->sema_pending, CY_RTOS_NEVER_TIMEOUT, false);
+
+        CY_ASSERT(CY_RSLT_SUCCESS == result);
+        FS_USE_PARA(result);
+
+        (void) cy_rtos_get_mutex(&worker->mutex, CY_RTOS_NEVER_TIMEOUT);
+        pReq = worker->queue_head;
+        if(pReq != NULL)
+        {
+            worker->queue_head = pReq->pNext;
+            if(worker->queue_head == NULL)
+            {
+                worker->queue_tail = NULL;
+            }
+            worker->num_queued--;
+            worker->active_req = pReq;
+            pReq->Status = FS_AIO_STATUS_ACTIVE;
+        }
+        else
+        {
+            /* The semaphore is signaled without a request only on DeInit
+             * after all the queued requests have been processed.
+             */
+            stop = worker->stop_requested;
+        }
+        (void) cy_rtos_set_mutex(&worker->mutex);
+
+        if(pReq != NULL)
+        {
+            execute_request(pReq);
+
+            (void) cy_rtos_get_mutex(&worker->mutex, CY_RTOS_NEVER_TIMEOUT);
+            worker->active_req = NULL;
+            (void) cy_rtos_set_mutex(&worker->mutex);
+
+            complete_request(pReq);
+        }
+    }
+
+    (void) cy_rtos_exit_thread();
+}
+
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       submit_request
+*
+*  Function description
+*    Adds a request to the queue of the worker responsible for the file handle.
+*
+*  Return value
+*    FS_ERRCODE_OK                      Request queued (or executed without RTOS).
+*    FS_ERRCODE_INVALID_PARA            Invalid parameters.
+*    FS_ERRCODE_INVALID_USAGE           Module not initialized or request still in use.
+*    FS_ERRCODE_BUFFER_NOT_AVAILABLE    The queue of the worker is full.
+*/
+static int submit_request(FS_AIO_REQUEST * pReq, FS_FILE * pFile, U8 operation, void * pData, U32 num_bytes,
+                          FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext)
+{
+    int r = FS_ERRCODE_OK;
+
+    if((pReq == NULL) || (pFile == NULL) || ((operation != FS_AIO_OP_SYNC) && (pData == NULL) && (num_bytes != 0U)))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if((!aio_initialized) || (pReq->Status == FS_AIO_STATUS_QUEUED) || (pReq->Status == FS_AIO_STATUS_ACTIVE))
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else
+    {
+        pReq->pFile        = pFile;
+        pReq->pData        = pData;
+        pReq->NumBytes     = num_bytes;
+        pReq->NumBytesDone = 0U;
+        pReq->Result       = FS_ERRCODE_OK;
+        pReq->pfOnComplete = pfOnComplete;
+        pReq->pContext     = pContext;
+        pReq->Operation    = operation;
+        pReq->pNext        = NULL;
+
+#if defined(COMPONENT_RTOS_AWARE)
+        aio_worker_t * worker = get_worker(pFile);
+
+        (void) cy_rtos_get_mutex(&worker->mutex, CY_RTOS_NEVER_TIMEOUT);
+        if((worker->num_queued >= aio_queue_depth) || worker->stop_requested)
+        {
+            r = FS_ERRCODE_BUFFER_NOT_AVAILABLE;
+        }
+        else
+        {
+            pReq->Status = FS_AIO_STATUS_QUEUED;
+            if(worker->queue_tail == NULL)
+            {
+                worker->queue_head = pReq;
+            }
+            else
+            {
+                worker->queue_tail->pNext = pReq;
+            }
+            worker->queue_tail = pReq;
+            worker->num_queued++;
+        }
+        (void) cy_rtos_set_mutex(&worker->mutex);
+
+        if(r == FS_ERRCODE_OK)
+        {
+            (void) cy_rtos_set_semaphore(&worker->sema_pending, false);
+        }
+#else
+        pReq->Status = FS_AIO_STATUS_ACTIVE;
+        execute_request(pReq);
+        complete_request(pReq);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 8,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_AIO_Init
+****************************************************************************//**
+*
+*  Creates the worker tasks that serve the asynchronous requests.
+*  Has to be called after FS_Init() and before any request is submitted.
+*
+*  Parameters
+*   UserConfig  Module configuration. NULL selects one worker with the
+*               default queue depth, stack size and normal priority.
+*
+*  Return Value
+*   FS_AIO_RESULT_OK          Initialized successfully.
+*   FS_AIO_RESULT_BADPARAM    Invalid parameters or already initialized.
+*   FS_AIO_RESULT_ERROR       The OS resources could not be created.
+*
+*******************************************************************************/
+FS_AIO_Result_t FS_AIO_Init(const FS_AIO_Config_t * UserConfig)
+{
+    FS_AIO_Result_t result = FS_AIO_RESULT_OK;
+    FS_AIO_Config_t config;
+
+    if(UserConfig != NULL)
+    {
+        config = *UserConfig;
+    }
+    else
+    {
+        config.NumWorkers = 1U;
+        config.QueueDepth = FS_AIO_DEFAULT_QUEUE_DEPTH;
+        config.StackSize  = FS_AIO_DEFAULT_STACK_SIZE;
+#if defined(COMPONENT_RTOS_AWARE)
+        config.Priority   = (uint32_t)CY_RTOS_PRIORITY_NORMAL;
+#else
+        config.Priority   = 0U;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    if(aio_initialized || (config.NumWorkers == 0U) || (config.NumWorkers > FS_AIO_MAX_WORKERS) || (config.QueueDepth == 0U))
+    {
+        result = FS_AIO_RESULT_BADPARAM;
+    }
+    else
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        uint8_t worker_index;
+
+        aio_queue_depth = config.QueueDepth;
+        aio_num_workers = 0U;
+        for(worker_index = 0U; worker_index < config.NumWorkers; worker_index++)
+        {
+            aio_worker_t * worker = &aio_workers[worker_index];
+            cy_rslt_t rslt;
+
+            FS_MEMSET(worker, 0, sizeof(aio_worker_t));
+            rslt = cy_rtos_init_mutex(&worker->mutex);
+            if(CY_RSLT_SUCCESS == rslt)
+            {
+                rslt = cy_rtos_init_semaphore(&worker->sema_pending, (uint32_t)config.QueueDepth + 1U, AIO_SEMA_INIT_COUNT);
+                if(CY_RSLT_SUCCESS == rslt)
+                {
+                    rslt = cy_rtos_create_thread(&worker->thread, worker_task, "FS_AIO", NULL, config.StackSize,
+                                                 (cy_thread_priority_t)config.Priority, (cy_thread_arg_t)worker);
+                    if(CY_RSLT_SUCCESS != rslt)
+                    {
+                        (void) cy_rtos_deinit_semaphore(&worker->sema_pending);
+                    }
+                }
+                if(CY_RSLT_SUCCESS != rslt)
+                {
+                    (void) cy_rtos_deinit_mutex(&worker->mutex);
+                }
+            }
+
+            if(CY_RSLT_SUCCESS != rslt)
+            {
+                result = FS_AIO_RESULT_ERROR;
+                break;
+            }
+            aio_num_workers++;
+        }
+
+        /* The workers started so far are stopped in FS_AIO_DeInit(). */
+        aio_initialized = true;
+        if(result != FS_AIO_RESULT_OK)
+        {
+            (void) FS_AIO_DeInit();
+        }
+#else
+        aio_queue_depth = config.QueueDepth;
+        aio_initialized = true;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_AIO_DeInit
+****************************************************************************//**
+*
+*  Stops the worker tasks and releases the OS resources. The requests
+*  already queued are executed before the workers terminate. New requests
+*  are rejected as soon as this function is called.
+*
+*  Return Value
+*   FS_AIO_RESULT_OK          Deinitialized successfully.
+*   FS_AIO_RESULT_BADPARAM    The module is not initialized.
+*
+*******************************************************************************/
+FS_AIO_Result_t FS_AIO_DeInit(void)
+{
+    FS_AIO_Result_t result = FS_AIO_RESULT_BADPARAM;
+
+    if(aio_initialized)
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        uint8_t worker_index;
+
+        for(worker_index = 0U; worker_index < aio_num_workers; worker_index++)
+        {
+            aio_worker_t * worker = &aio_workers[worker_index];
+
+            (void) cy_rtos_get_mutex(&worker->mutex, CY_RTOS_NEVER_TIMEOUT);
+            worker->stop_requested = true;
+            (void) cy_rtos_set_mutex(&worker->mutex);
+            (void) cy_rtos_set_semaphore(&worker->sema_pending, false);
+        }
+
+        for(worker_index = 0U; worker_index < aio_num_workers; worker_index++)
+        {
+            aio_worker_t * worker = &aio_workers[worker_index];
+
+            (void) cy_rtos_join_thread(&worker->thread);
+            (void) cy_rtos_deinit_semaphore(&worker->sema_pending);
+            (void) cy_rtos_deinit_mutex(&worker->mutex);
+        }
+        aio_num_workers = 0U;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        aio_initialized = false;
+        result = FS_AIO_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_AIO_InitRequest
+*
+*  Function description
+*    Prepares a request control block for the first use.
+*
+*  Parameters
+*    pReq           [OUT] Control block of the request.
+*
+*  Additional information
+*    The submit functions reject a request that is still queued or
+*    active. The status of a request provided by the application is
+*    undefined unless initialized, therefore this function has to be
+*    called once for each control block before it is submitted the
+*    first time. It must not be called while the request is pending.
+*    Optional fields such as pSemaDone have to be set after the call.
+*/
+void FS_AIO_InitRequest(FS_AIO_REQUEST * pReq)
+{
+    if(pReq != NULL)
+    {
+        FS_MEMSET(pReq, 0, sizeof(FS_AIO_REQUEST));
+        pReq->Status = FS_AIO_STATUS_IDLE;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_ReadAsync
+*
+*  Function description
+*    Requests the reading of data from a file without waiting for the
+*    operation to complete.
+*
+*  Parameters
+*    pReq           [IN]  Control block of the request initialized via
+*                         FS_AIO_InitRequest(). Must remain valid until
+*                         the request completes.
+*    pFile          Handle to an opened file.
+*    pData          [OUT] Read data. Must remain valid until the request completes.
+*    NumBytes       Number of bytes to be read.
+*    pfOnComplete   Function to be called on completion. Can be NULL.
+*    pContext       Application-defined value stored to pReq->pContext.
+*
+*  Return value
+*    ==0    OK, the request was queued.
+*    !=0    Error code indicating the failure reason. The request was not queued.
+*
+*  Additional information
+*    The data is read from the current position of the file pointer at
+*    the time the request is executed. The requests submitted for the
+*    same file handle are executed in the order they were submitted.
+*    The result of the operation is stored to pReq->Result and the number
+*    of bytes read to pReq->NumBytesDone. The file handle must not be
+*    closed while requests for it are pending (see FS_AIO_GetNumPending()).
+*/
+int FS_ReadAsync(FS_AIO_REQUEST * pReq, FS_FILE * pFile, void * pData, U32 NumBytes, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext)
+{
+    return submit_request(pReq, pFile, FS_AIO_OP_READ, pData, NumBytes, pfOnComplete, pContext);
+}
+
+/*********************************************************************
+*
+*       FS_WriteAsync
+*
+*  Function description
+*    Requests the writing of data to a file without waiting for the
+*    operation to complete.
+*
+*  Parameters
+*    pReq           [IN]  Control block of the request initialized via
+*                         FS_AIO_InitRequest(). Must remain valid until
+*                         the request completes.
+*    pFile          Handle to an opened file.
+*    pData          [IN]  Data to be written. Must remain valid until the request completes.
+*    NumBytes       Number of bytes to be written.
+*    pfOnComplete   Function to be called on completion. Can be NULL.
+*    pContext       Application-defined value stored to pReq->pContext.
+*
+*  Return value
+*    ==0    OK, the request was queued.
+*    !=0    Error code indicating the failure reason. The request was not queued.
+*
+*  Additional information
+*    Refer to FS_ReadAsync() for the ordering and completion rules.
+*/
+int FS_WriteAsync(FS_AIO_REQUEST * pReq, FS_FILE * pFile, const void * pData, U32 NumBytes, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext)
+{
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by FS_Write()');
+    return submit_request(pReq, pFile, FS_AIO_OP_WRITE, (void *)pData, NumBytes, pfOnComplete, pContext);
+}
+
+/*********************************************************************
+*
+*       FS_SyncFileAsync
+*
+*  Function description
+*    Requests the synchronization of a file to storage without waiting
+*    for the operation to complete.
+*
+*  Parameters
+*    pReq           [IN]  Control block of the request initialized via
+*                         FS_AIO_InitRequest(). Must remain valid until
+*                         the request completes.
+*    pFile          Handle to an opened file.
+*    pfOnComplete   Function to be called on completion. Can be NULL.
+*    pContext       Application-defined value stored to pReq->pContext.
+*
+*  Return value
+*    ==0    OK, the request was queued.
+*    !=0    Error code indicating the failure reason. The request was not queued.
+*
+*  Additional information
+*    The synchronization is performed after all the requests submitted
+*    before for the same file handle completed.
+*/
+int FS_SyncFileAsync(FS_AIO_REQUEST * pReq, FS_FILE * pFile, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext)
+{
+    return submit_request(pReq, pFile, FS_AIO_OP_SYNC, NULL, 0U, pfOnComplete, pContext);
+}
+
+/*********************************************************************
+*
+*       FS_AIO_IsDone
+*
+*  Function description
+*    Checks if a request has been completed.
+*
+*  Return value
+*    ==1    The request completed. pReq->Result holds the result.
+*    ==0    The request is still pending.
+*/
+int FS_AIO_IsDone(const FS_AIO_REQUEST * pReq)
+{
+    int r = 0;
+
+    if(pReq->Status == FS_AIO_STATUS_DONE)
+    {
+        r = 1;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_AIO_GetNumPending
+*
+*  Function description
+*    Returns the number of requests not yet completed for a file handle.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*
+*  Return value
+*    Number of queued requests including the one being executed.
+*
+*  Additional information
+*    The application has to make sure that this function returns 0
+*    before closing the file handle.
+*/
+U32 FS_AIO_GetNumPending(FS_FILE * pFile)
+{
+    U32 num_pending = 0U;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    if(aio_initialized && (pFile != NULL))
+    {
+        aio_worker_t   * worker = get_worker(pFile);
+        FS_AIO_REQUEST * pReq;
+
+        (void) cy_rtos_get_mutex(&worker->mutex, CY_RTOS_NEVER_TIMEOUT);
+        for(pReq = worker->queue_head; pReq != NULL; pReq = pReq->pNext)
+        {
+            if(pReq->pFile == pFile)
+            {
+                num_pending++;
+            }
+        }
+        if((worker->active_req != NULL) && (worker->active_req->pFile == pFile))
+        {
+            num_pending++;
+        }
+        (void) cy_rtos_set_mutex(&worker->mutex);
+    }
+#else
+    FS_USE_PARA(pFile);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+    return num_pending;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
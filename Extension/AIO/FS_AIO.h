@@ -0,0 +1,157 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_AIO.h
+Purpose     : Asynchronous file I/O served by a pool of worker tasks.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_AIO_H     // Avoid recursive and multiple inclusion
+#define FS_AIO_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_AIO_MAX_WORKERS
+#define FS_AIO_MAX_WORKERS              (4U)    /* Maximum number of worker tasks. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Values of FS_AIO_REQUEST::Status */
+#define FS_AIO_STATUS_IDLE              (0U)    /* The request is not in use. */
+#define FS_AIO_STATUS_QUEUED            (1U)    /* The request waits to be processed by a worker. */
+#define FS_AIO_STATUS_ACTIVE            (2U)    /* The request is processed by a worker. */
+#define FS_AIO_STATUS_DONE              (3U)    /* The request is completed and can be reused. */
+
+/* Values of FS_AIO_REQUEST::Operation */
+#define FS_AIO_OP_READ                  (0U)
+#define FS_AIO_OP_WRITE                 (1U)
+#define FS_AIO_OP_SYNC                  (2U)
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+struct FS_AIO_REQUEST;
+
+/* Called in the context of the worker task when a request completes.
+ * The request can be reused only after the callback returns. The callback
+ * must not wait for other requests because this would block the worker.
+ */
+typedef void FS_AIO_ON_COMPLETE(struct FS_AIO_REQUEST * pReq);
+
+/* Control block of an asynchronous request. It is provided by the application
+ * and must remain valid until the request is completed. The file system does
+ * not allocate memory for the requests. A control block has to be initialized
+ * via FS_AIO_InitRequest() before it is submitted the first time.
+ */
+typedef struct FS_AIO_REQUEST
+{
+    FS_FILE              * pFile;           /* File handle the operation is performed on. */
+    void                 * pData;           /* Data to be read or written. */
+    U32                    NumBytes;        /* Number of bytes requested. */
+    U32                    NumBytesDone;    /* Number of bytes actually transferred. */
+    int                    Result;          /* FS_ERRCODE_OK or an error code once completed. */
+    FS_AIO_ON_COMPLETE   * pfOnComplete;    /* Optional completion callback. */
+    void                 * pContext;        /* Application-defined data passed through to the callback. */
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_semaphore_t       * pSemaDone;       /* Optional semaphore set when the request completes. */
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    U8                     Operation;       /* FS_AIO_OP_... Set by the submit functions. */
+    volatile U8            Status;          /* FS_AIO_STATUS_... Set by the module. */
+    struct FS_AIO_REQUEST * pNext;          /* Internal. Link to the next queued request. */
+} FS_AIO_REQUEST;
+
+typedef struct
+{
+    uint8_t  NumWorkers;    /* Number of worker tasks (1 to FS_AIO_MAX_WORKERS). */
+    uint16_t QueueDepth;    /* Maximum number of requests pending per worker. */
+    uint32_t StackSize;     /* Stack size of a worker task in bytes. */
+    uint32_t Priority;      /* Priority of the worker tasks (cy_thread_priority_t). */
+} FS_AIO_Config_t;
+
+typedef enum
+{
+    FS_AIO_RESULT_OK = 0U,
+    FS_AIO_RESULT_BADPARAM,
+    FS_AIO_RESULT_ERROR,
+} FS_AIO_Result_t;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_AIO_Result_t FS_AIO_Init        (const FS_AIO_Config_t * UserConfig);
+FS_AIO_Result_t FS_AIO_DeInit      (void);
+void            FS_AIO_InitRequest (FS_AIO_REQUEST * pReq);
+int             FS_ReadAsync       (FS_AIO_REQUEST * pReq, FS_FILE * pFile,       void * pData, U32 NumBytes, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext);
+int             FS_WriteAsync      (FS_AIO_REQUEST * pReq, FS_FILE * pFile, const void * pData, U32 NumBytes, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext);
+int             FS_SyncFileAsync   (FS_AIO_REQUEST * pReq, FS_FILE * pFile, FS_AIO_ON_COMPLETE * pfOnComplete, void * pContext);
+int             FS_AIO_IsDone      (const FS_AIO_REQUEST * pReq);
+U32             FS_AIO_GetNumPending(FS_FILE * pFile);
+
+#endif  // FS_AIO_H
+
+/*************************** End of file ****************************/
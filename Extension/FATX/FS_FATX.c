@@ -0,0 +1,1554 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX.c
+Purpose     : Access to the on-disk structures of a FAT volume.
+              The FAT implementation of the file system is delivered as
+              a library. The modules of the FATX extension implement
+              functionality that the file system API does not offer by
+              reading the boot sector, the allocation table and the
+              directories of a volume via the storage layer. The volume
+              is locked and synchronized while these structures are
+              accessed, so that the data read is consistent with the
+              modifications made via the file system API.
+              The OS layer has to create recursive locks because the
+              file system API is called with the volume locked.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "FS_Storage.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define SECTOR_INDEX_INVALID            (0xFFFFFFFFUL)
+#define DIR_ENTRY_SIZE                  (32U)
+#define DIR_ENTRY_END                   (0x00U)     /* First byte of the entry that follows the last one. */
+#define DIR_ENTRY_DELETED               (0xE5U)
+#define DIR_ENTRY_E5                    (0x05U)     /* First character of the short name is 0xE5. */
+#define ATTR_LONG_NAME                  (0x0FU)
+#define ATTR_LONG_NAME_MASK             (0x3FU)
+#define ATTR_VOLUME_ID                  (0x08U)
+#define LFN_LAST                        (0x40U)     /* Set in the sequence number of the last part of a long name. */
+#define LFN_SEQ_MASK                    (0x1FU)
+#define LFN_CHARS_PER_ENTRY             (13U)
+#define LFN_MAX_ENTRIES                 (20U)       /* A long name has at most 255 characters. */
+#define NT_LOWER_BASE                   (0x08U)     /* The base of the short name is displayed in lower case. */
+#define NT_LOWER_EXT                    (0x10U)     /* The extension of the short name is displayed in lower case. */
+#define NUM_CLUSTERS_FAT12              (4085UL)
+#define NUM_CLUSTERS_FAT16              (65525UL)
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static bool     fatx_initialized = false;
+static U8     * fatx_buffer;
+static U32      fatx_buffer_size;
+static FS_FATX_FIND_FUNC * fatx_pfFind;     /* Searches a directory. Set by the directory index. */
+static FS_FATX_PATH_FIND_FUNC * fatx_pfPathFind;  /* Searches a directory path. Set by the path cache. */
+static FS_FATX_PATH_ADD_FUNC  * fatx_pfPathAdd;
+static FS_FATX_FREE_RUN_FUNC  * fatx_pfFreeRun;   /* Searches for free clusters. Set by the free-cluster map. */
+
+#if defined(COMPONENT_RTOS_AWARE)
+static cy_mutex_t fatx_mutex;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       lock / unlock
+*/
+static void lock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_get_mutex(&fatx_mutex, CY_RTOS_NEVER_TIMEOUT);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+static void unlock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_set_mutex(&fatx_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+/*********************************************************************
+*
+*       lock_volume / unlock_volume
+*/
+static void lock_volume(const char * sVolumeName)
+{
+#if (FS_OS_LOCKING == FS_OS_LOCKING_DRIVER)
+    FS_LockVolume(sVolumeName);
+#elif (FS_OS_LOCKING == FS_OS_LOCKING_API)
+    FS_USE_PARA(sVolumeName);
+    FS_Lock();
+#else
+    FS_USE_PARA(sVolumeName);
+#endif
+}
+
+static void unlock_volume(const char * sVolumeName)
+{
+#if (FS_OS_LOCKING == FS_OS_LOCKING_DRIVER)
+    FS_UnlockVolume(sVolumeName);
+#elif (FS_OS_LOCKING == FS_OS_LOCKING_API)
+    FS_USE_PARA(sVolumeName);
+    FS_Unlock();
+#else
+    FS_USE_PARA(sVolumeName);
+#endif
+}
+
+/*********************************************************************
+*
+*       load_u16 / load_u32
+*/
+static U16 load_u16(const U8 * data)
+{
+    return (U16)((U32)data[0] | ((U32)data[1] << 8));
+}
+
+static U32 load_u32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+/*********************************************************************
+*
+*       to_upper
+*/
+static char to_upper(char c)
+{
+    return ((c >= 'a') && (c <= 'z')) ? (char)(c - ('a' - 'A')) : c;
+}
+
+/*********************************************************************
+*
+*       to_lower
+*/
+static char to_lower(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (char)(c + ('a' - 'A')) : c;
+}
+
+/*********************************************************************
+*
+*       is_delimiter
+*/
+static bool is_delimiter(char c)
+{
+    return (c == FS_DIRECTORY_DELIMITER) || (c == '/') || (c == '\\');
+}
+
+/*********************************************************************
+*
+*       skip_component
+*
+*  Function description
+*    Returns the position after the next component of a path.
+*/
+static const char * skip_component(const char * sPath)
+{
+    while(is_delimiter(*sPath))
+    {
+        sPath++;
+    }
+    while((*sPath != '\0') && (!is_delimiter(*sPath)))
+    {
+        sPath++;
+    }
+
+    return sPath;
+}
+
+/*********************************************************************
+*
+*       is_name_equal
+*
+*  Function description
+*    Compares a file name with a path component ignoring the case
+*    of the ASCII letters.
+*/
+static bool is_name_equal(const char * sName, const char * sComponent, U32 len)
+{
+    U32 i = 0U;
+
+    while((i < len) && (sName[i] != '\0') && (to_upper(sName[i]) == to_upper(sComponent[i])))
+    {
+        i++;
+    }
+
+    return (i == len) && (sName[i] == '\0');
+}
+
+/*********************************************************************
+*
+*       is_bpb_valid
+*/
+static bool is_bpb_valid(const U8 * data)
+{
+    U32 bytes_per_sector    = load_u16(data + 11);
+    U32 sectors_per_cluster = data[13];
+
+    return ((data[0] == 0xEBU) || (data[0] == 0xE9U)) &&
+           ((bytes_per_sector == 512U) || (bytes_per_sector == 1024U) || (bytes_per_sector == 2048U) || (bytes_per_sector == 4096U)) &&
+           (sectors_per_cluster != 0U) && ((sectors_per_cluster & (sectors_per_cluster - 1U)) == 0U) &&
+           (load_u16(data + 14) != 0U) && (data[16] != 0U);
+}
+
+/*********************************************************************
+*
+*       read_fat_sector
+*/
+static int read_fat_sector(FS_FATX_VOLUME * pVolume, U32 sector_index)
+{
+    int r = 0;
+
+    if(pVolume->SectorIndexFAT != sector_index)
+    {
+        pVolume->SectorIndexFAT = SECTOR_INDEX_INVALID;
+        r = FS_STORAGE_ReadSector(pVolume->acVolumeName, pVolume->pFAT, sector_index);
+        if(r == 0)
+        {
+            pVolume->SectorIndexFAT = sector_index;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       read_fat_byte
+*/
+static int read_fat_byte(FS_FATX_VOLUME * pVolume, U32 off, U32 * value)
+{
+    int r = read_fat_sector(pVolume, pVolume->FirstSectorFAT + (off / pVolume->BytesPerSector));
+
+    if(r == 0)
+    {
+        *value = pVolume->pFAT[off % pVolume->BytesPerSector];
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       init_buffers
+*
+*  Function description
+*    Assigns the work buffer to the volume: one sector for directory
+*    and data sectors, one sector for allocation table sectors and the
+*    rest for the directory window.
+*/
+static void init_buffers(FS_FATX_VOLUME * pVolume)
+{
+    U32 num_sectors = fatx_buffer_size / pVolume->BytesPerSector;
+
+    pVolume->pData               = fatx_buffer;
+    pVolume->pFAT                = fatx_buffer + pVolume->BytesPerSector;
+    pVolume->pDirWindow          = fatx_buffer + (2U * (U32)pVolume->BytesPerSector);
+    pVolume->SectorIndexData     = SECTOR_INDEX_INVALID;
+    pVolume->SectorIndexFAT      = SECTOR_INDEX_INVALID;
+    pVolume->DirWindowNumSectors = 0U;
+    pVolume->DirWindowMaxSectors = (num_sectors > 3U) ? (num_sectors - 2U) : 0U;
+}
+
+/*********************************************************************
+*
+*       read_dir_sector
+*
+*  Function description
+*    Returns the sector of a directory listing.
+*
+*  Additional information
+*    If the work buffer is large enough the sectors of a directory are
+*    read via one read operation per cluster, or per window of the
+*    root directory of FAT12/16, and held until FS_FATX_End().
+*/
+static int read_dir_sector(const FS_FATX_DIR * pDir, const U8 ** ppSector)
+{
+    FS_FATX_VOLUME * pVolume = pDir->pVolume;
+    U32 sector_index = pDir->SectorIndex;
+    int r = 0;
+
+    if(pVolume->DirWindowMaxSectors == 0U)
+    {
+        r = FS_FATX_ReadSector(pVolume, sector_index);
+        *ppSector = pVolume->pData;
+    }
+    else
+    {
+        if((pVolume->DirWindowNumSectors == 0U) || (sector_index < pVolume->DirWindowFirstSector) ||
+           (sector_index >= (pVolume->DirWindowFirstSector + pVolume->DirWindowNumSectors)))
+        {
+            U32 num_sectors = SEGGER_MIN(pVolume->DirWindowMaxSectors, pDir->NumSectorsLeft + 1U);
+
+            pVolume->DirWindowNumSectors = 0U;
+            r = FS_STORAGE_ReadSectors(pVolume->acVolumeName, pVolume->pDirWindow, sector_index, num_sectors);
+            if(r == 0)
+            {
+                pVolume->DirWindowFirstSector = sector_index;
+                pVolume->DirWindowNumSectors  = num_sectors;
+            }
+            else
+            {
+                r = FS_ERRCODE_READ_FAILURE;
+            }
+        }
+        *ppSector = pVolume->pDirWindow + ((sector_index - pVolume->DirWindowFirstSector) * pVolume->BytesPerSector);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       mount
+*
+*  Function description
+*    Reads the layout of the volume from its boot sector.
+*
+*  Additional information
+*    The boot sector is either the first sector of the storage device
+*    or the first sector of the first partition.
+*/
+static int mount(FS_FATX_VOLUME * pVolume)
+{
+    U8 * data = pVolume->pData;
+    U32 sector_index = 0U;
+    int r;
+
+    r = FS_FATX_ReadSector(pVolume, 0U);
+    if((r == 0) && (!is_bpb_valid(data)))
+    {
+        if((data[510] == 0x55U) && (data[511] == 0xAAU) && (data[446U + 4U] != 0U))
+        {
+            sector_index = load_u32(data + 446U + 8U);
+            r = FS_FATX_ReadSector(pVolume, sector_index);
+        }
+        if((r == 0) && (!is_bpb_valid(data)))
+        {
+            r = FS_ERRCODE_INVALID_FS_TYPE;
+        }
+    }
+    if(r == 0)
+    {
+        U32 bytes_per_sector = load_u16(data + 11);
+        U32 num_sectors_fat  = load_u16(data + 22);
+        U32 num_sectors      = load_u16(data + 19);
+        U32 num_sectors_root = ((load_u16(data + 17) * DIR_ENTRY_SIZE) + bytes_per_sector - 1U) / bytes_per_sector;
+        U32 num_sectors_meta;
+
+        if(num_sectors_fat == 0U)
+        {
+            num_sectors_fat = load_u32(data + 36);
+        }
+        if(num_sectors == 0U)
+        {
+            num_sectors = load_u32(data + 32);
+        }
+        pVolume->BytesPerSector     = (U16)bytes_per_sector;
+        pVolume->SectorsPerCluster  = data[13];
+        pVolume->NumFATs            = data[16];
+        pVolume->NumSectorsFAT      = num_sectors_fat;
+        pVolume->FirstSectorFAT     = sector_index + load_u16(data + 14);
+        pVolume->FirstSectorRootDir = pVolume->FirstSectorFAT + (pVolume->NumFATs * num_sectors_fat);
+        pVolume->NumSectorsRootDir  = num_sectors_root;
+        pVolume->FirstSectorData    = pVolume->FirstSectorRootDir + num_sectors_root;
+        num_sectors_meta = pVolume->FirstSectorData - sector_index;
+        if((bytes_per_sector > (fatx_buffer_size / 2U)) || (num_sectors_fat == 0U) || (num_sectors <= num_sectors_meta))
+        {
+            r = (bytes_per_sector > (fatx_buffer_size / 2U)) ? FS_ERRCODE_BUFFER_TOO_SMALL : FS_ERRCODE_INVALID_FS_TYPE;
+        }
+        else
+        {
+            pVolume->NumClusters = (num_sectors - num_sectors_meta) / pVolume->SectorsPerCluster;
+            if(pVolume->NumClusters < NUM_CLUSTERS_FAT12)
+            {
+                pVolume->FATType = 12U;
+            }
+            else if(pVolume->NumClusters < NUM_CLUSTERS_FAT16)
+            {
+                pVolume->FATType = 16U;
+            }
+            else
+            {
+                pVolume->FATType = 32U;
+            }
+            pVolume->RootDirCluster = (pVolume->FATType == 32U) ? load_u32(data + 44) : 0U;
+            init_buffers(pVolume);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       format_short_name
+*/
+static void format_short_name(const U8 * p, char * sName)
+{
+    U32 n = 0U;
+
+    for(U32 i = 0U; (i < 8U) && (p[i] != (U8)' '); i++)
+    {
+        char c = (char)p[i];
+
+        if((i == 0U) && (p[i] == DIR_ENTRY_E5))
+        {
+            c = (char)DIR_ENTRY_DELETED;
+        }
+        sName[n] = ((p[12] & NT_LOWER_BASE) != 0U) ? to_lower(c) : c;
+        n++;
+    }
+    if(p[8] != (U8)' ')
+    {
+        sName[n] = '.';
+        n++;
+        for(U32 i = 8U; (i < 11U) && (p[i] != (U8)' '); i++)
+        {
+            sName[n] = ((p[12] & NT_LOWER_EXT) != 0U) ? to_lower((char)p[i]) : (char)p[i];
+            n++;
+        }
+    }
+    sName[n] = '\0';
+}
+
+/*********************************************************************
+*
+*       encode_long_name
+*
+*  Function description
+*    Converts a long name from UCS-2 to the encoding of the file names
+*    used by the file system.
+*
+*  Parameters
+*    paChar         Characters of the long name.
+*    NumChars       Number of characters in paChar.
+*    sName          [OUT] Encoded name (0-terminated).
+*    SizeOfName     Size of sName in bytes.
+*
+*  Return value
+*    Combination of FS_FATX_NAME_FLAG_... that indicates if the name
+*    was returned incompletely.
+*
+*  Additional information
+*    If the support for file name encoding is disabled, the file system
+*    stores one byte of a name in one UCS-2 character, so characters
+*    up to 0xFF are returned as one byte. Characters that cannot be
+*    encoded are returned as '_'.
+*/
+static U8 encode_long_name(const U16 * paChar, U32 NumChars, char * sName, unsigned SizeOfName)
+{
+#if FS_SUPPORT_FILE_NAME_ENCODING
+    const FS_UNICODE_CONV * pConv = FS_FAT_GetLFNConverter();
+#endif /* FS_SUPPORT_FILE_NAME_ENCODING */
+    U32 len = 0U;
+    U8 flags = 0U;
+
+    for(U32 i = 0U; i < NumChars; i++)
+    {
+        U8 abChar[4];
+        int num_bytes = 0;
+
+#if FS_SUPPORT_FILE_NAME_ENCODING
+        if(pConv != NULL)
+        {
+            num_bytes = pConv->pfEncodeChar(abChar, sizeof(abChar), paChar[i]);
+        }
+        else
+#endif /* FS_SUPPORT_FILE_NAME_ENCODING */
+        if(paChar[i] <= 0xFFU)
+        {
+            abChar[0] = (U8)paChar[i];
+            num_bytes = 1;
+        }
+        else
+        {
+            /* Not representable. */
+        }
+        if(num_bytes <= 0)
+        {
+            abChar[0] = (U8)'_';
+            num_bytes = 1;
+            flags    |= FS_FATX_NAME_FLAG_LOSSY;
+        }
+        if((len + (U32)num_bytes) > (SizeOfName - 1U))
+        {
+            flags |= FS_FATX_NAME_FLAG_TRUNCATED;
+            break;
+        }
+        FS_MEMCPY(&sName[len], abChar, (U32)num_bytes);
+        len += (U32)num_bytes;
+    }
+    sName[len] = '\0';
+
+    return flags;
+}
+
+/*********************************************************************
+*
+*       calc_lfn_checksum
+*/
+static U8 calc_lfn_checksum(const U8 * p)
+{
+    U8 sum = 0U;
+
+    for(U32 i = 0U; i < 11U; i++)
+    {
+        sum = (U8)((U8)((sum & 1U) << 7) + (U8)(sum >> 1) + p[i]);
+    }
+
+    return sum;
+}
+
+/*********************************************************************
+*
+*       advance_dir
+*
+*  Function description
+*    Moves a directory listing to the next sector.
+*
+*  Return value
+*    ==0                OK, next sector selected.
+*    ==FS_FATX_DIR_END  No more sectors in the directory.
+*    < 0                Error code indicating the failure reason.
+*/
+static int advance_dir(FS_FATX_DIR * pDir)
+{
+    int r = 0;
+
+    if(pDir->NumSectorsLeft != 0U)
+    {
+        pDir->SectorIndex++;
+        pDir->NumSectorsLeft--;
+    }
+    else if(pDir->Cluster == 0U)
+    {
+        r = FS_FATX_DIR_END;        /* End of the root directory of FAT12/16. */
+    }
+    else
+    {
+        U32 cluster;
+
+        r = FS_FATX_GetFATEntry(pDir->pVolume, pDir->Cluster, &cluster);
+        if(r == 0)
+        {
+            if(FS_FATX_IsClusterValid(pDir->pVolume, cluster) == 0)
+            {
+                r = FS_FATX_DIR_END;
+            }
+            else
+            {
+                pDir->Cluster        = cluster;
+                pDir->SectorIndex    = FS_FATX_ClusterToSector(pDir->pVolume, cluster);
+                pDir->NumSectorsLeft = (U32)pDir->pVolume->SectorsPerCluster - 1U;
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 23,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_FATX_Init
+****************************************************************************//**
+*
+*  Initializes the FATX extension.
+*
+*  Parameters
+*   pBuffer     Work buffer used to read the structures of a volume.
+*               Has to hold at least two logical sectors and has to be
+*               aligned as the sector buffers of the file system.
+*               The sectors after the first two are used to read
+*               directories with multi-sector read operations.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_FATX_RESULT_OK          Initialized successfully.
+*   FS_FATX_RESULT_BADPARAM    Invalid parameters or already initialized.
+*   FS_FATX_RESULT_ERROR       The OS resources could not be created.
+*
+*******************************************************************************/
+FS_FATX_Result_t FS_FATX_Init(void * pBuffer, U32 NumBytes)
+{
+    FS_FATX_Result_t result = FS_FATX_RESULT_BADPARAM;
+
+    if((!fatx_initialized) && (pBuffer != NULL) && (NumBytes >= 1024U))
+    {
+        fatx_buffer      = (U8 *)pBuffer;
+        fatx_buffer_size = NumBytes;
+        result = FS_FATX_RESULT_OK;
+#if defined(COMPONENT_RTOS_AWARE)
+        if(CY_RSLT_SUCCESS != cy_rtos_init_mutex(&fatx_mutex))
+        {
+            result = FS_FATX_RESULT_ERROR;
+        }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        if(result == FS_FATX_RESULT_OK)
+        {
+            fatx_initialized = true;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_FATX_DeInit
+****************************************************************************//**
+*
+*  Releases the resources of the FATX extension. No operation of the
+*  extension may be in progress when this function is called.
+*
+*  Return Value
+*   FS_FATX_RESULT_OK          Deinitialized successfully.
+*   FS_FATX_RESULT_BADPARAM    The extension is not initialized.
+*
+*******************************************************************************/
+FS_FATX_Result_t FS_FATX_DeInit(void)
+{
+    FS_FATX_Result_t result = FS_FATX_RESULT_BADPARAM;
+
+    if(fatx_initialized)
+    {
+        fatx_initialized = false;
+        fatx_buffer      = NULL;
+        fatx_buffer_size = 0U;
+#if defined(COMPONENT_RTOS_AWARE)
+        (void) cy_rtos_deinit_mutex(&fatx_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        result = FS_FATX_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_Lock / FS_FATX_Unlock
+*
+*  Function description
+*    Protects data shared between the modules of the extension.
+*
+*  Return value
+*    ==0    OK, locked. FS_FATX_Unlock() has to be called.
+*    !=0    The extension is not initialized.
+*
+*  Additional information
+*    The lock is recursive and can be held while FS_FATX_Begin()
+*    or FS_FATX_Resume() is called.
+*/
+int FS_FATX_Lock(void)
+{
+    int r = FS_ERRCODE_INVALID_USAGE;
+
+    if(fatx_initialized)
+    {
+        lock();
+        r = 0;
+    }
+
+    return r;
+}
+
+void FS_FATX_Unlock(void)
+{
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_LockVolume / FS_FATX_UnlockVolume
+*
+*  Function description
+*    Prevents the file system from accessing a volume while the lock
+*    is held. FS_FATX_Lock() is taken as well.
+*
+*  Parameters
+*    sVolumeName    Name of the volume, e.g. "mmc:0:".
+*
+*  Return value
+*    ==0    OK, locked. FS_FATX_UnlockVolume() has to be called.
+*    !=0    The extension is not initialized.
+*
+*  Additional information
+*    The file system API can be called while the lock is held.
+*    The locks are taken in the same order as by FS_FATX_Begin().
+*/
+int FS_FATX_LockVolume(const char * sVolumeName)
+{
+    int r = FS_FATX_Lock();
+
+    if(r == 0)
+    {
+        lock_volume(sVolumeName);
+    }
+
+    return r;
+}
+
+void FS_FATX_UnlockVolume(const char * sVolumeName)
+{
+    unlock_volume(sVolumeName);
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_ResolveVolumeName
+*
+*  Function description
+*    Converts a volume name to the form "<device>:<unit>:".
+*
+*  Parameters
+*    sVolumeName    [IN/OUT] Volume name. The buffer has to hold
+*                   FS_FATX_MAX_LEN_VOLUME_NAME characters.
+*
+*  Additional information
+*    An empty volume name is replaced by the name of the default volume
+*    and a missing unit number is set to 0 so that different names of
+*    the same volume compare equal. The modules of the extension use
+*    the resolved name to identify a volume.
+*/
+void FS_FATX_ResolveVolumeName(char * sVolumeName)
+{
+    U32 num_colons = 0U;
+    U32 len;
+
+    if(sVolumeName[0] == '\0')
+    {
+        (void) FS_GetVolumeName(0, sVolumeName, (int)FS_FATX_MAX_LEN_VOLUME_NAME);
+        sVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME - 1U] = '\0';
+    }
+    len = (U32)FS_STRLEN(sVolumeName);
+    for(U32 i = 0U; i < len; i++)
+    {
+        if(sVolumeName[i] == ':')
+        {
+            num_colons++;
+        }
+    }
+    if((num_colons == 1U) && ((len + 2U) < FS_FATX_MAX_LEN_VOLUME_NAME))
+    {
+        FS_STRCPY(&sVolumeName[len], "0:");
+    }
+}
+
+/*********************************************************************
+*
+*       FS_FATX_Begin
+*
+*  Function description
+*    Starts an operation on the volume that stores a file.
+*
+*  Parameters
+*    pVolume    [OUT] Layout of the volume.
+*    sFileName  Fully qualified name of a file or directory, for
+*               example "mmc:0:\dir\file.txt".
+*    psPath     [OUT] Name of the file or directory without the volume
+*               name. Can be NULL.
+*
+*  Return value
+*    ==0    OK, the operation has to be ended via FS_FATX_End().
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Locks the extension and the volume and writes the data cached by
+*    the file system to the storage device. The volume name stored in
+*    pVolume is resolved via FS_FATX_ResolveVolumeName().
+*/
+int FS_FATX_Begin(FS_FATX_VOLUME * pVolume, const char * sFileName, const char ** psPath)
+{
+    const char * sPath = sFileName;
+    U32 len = 0U;
+    int r = 0;
+
+    if((pVolume == NULL) || (sFileName == NULL))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if(!fatx_initialized)
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else
+    {
+        for(U32 i = 0U; sFileName[i] != '\0'; i++)
+        {
+            if(sFileName[i] == ':')
+            {
+                len   = i + 1U;
+                sPath = &sFileName[i + 1U];
+            }
+        }
+        if(len >= FS_FATX_MAX_LEN_VOLUME_NAME)
+        {
+            r = FS_ERRCODE_INVALID_PARA;
+        }
+    }
+    if(r == 0)
+    {
+        FS_MEMSET(pVolume, 0, sizeof(FS_FATX_VOLUME));
+        FS_MEMCPY(pVolume->acVolumeName, sFileName, len);
+        pVolume->acVolumeName[len] = '\0';
+        FS_FATX_ResolveVolumeName(pVolume->acVolumeName);
+        pVolume->pData           = fatx_buffer;
+        pVolume->pFAT            = fatx_buffer;
+        pVolume->SectorIndexData = SECTOR_INDEX_INVALID;
+        pVolume->SectorIndexFAT  = SECTOR_INDEX_INVALID;
+        lock();
+        lock_volume(pVolume->acVolumeName);
+        r = FS_Sync(pVolume->acVolumeName);
+        if(r == 0)
+        {
+            r = mount(pVolume);
+        }
+        if(r != 0)
+        {
+            unlock_volume(pVolume->acVolumeName);
+            unlock();
+        }
+        if(psPath != NULL)
+        {
+            *psPath = sPath;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_Resume
+*
+*  Function description
+*    Starts an operation on a volume whose layout is known.
+*
+*  Parameters
+*    pVolume    Layout of the volume returned by a previous FS_FATX_Begin().
+*
+*  Additional information
+*    Locks the extension and the volume like FS_FATX_Begin() but does
+*    not synchronize the volume and does not read the boot sector.
+*    The operation has to be ended via FS_FATX_End().
+*/
+void FS_FATX_Resume(FS_FATX_VOLUME * pVolume)
+{
+    lock();
+    lock_volume(pVolume->acVolumeName);
+    init_buffers(pVolume);
+}
+
+/*********************************************************************
+*
+*       FS_FATX_End
+*
+*  Function description
+*    Ends an operation started via FS_FATX_Begin().
+*
+*  Parameters
+*    pVolume    Layout of the volume.
+*/
+void FS_FATX_End(FS_FATX_VOLUME * pVolume)
+{
+    pVolume->SectorIndexData     = SECTOR_INDEX_INVALID;
+    pVolume->SectorIndexFAT      = SECTOR_INDEX_INVALID;
+    pVolume->DirWindowNumSectors = 0U;
+    unlock_volume(pVolume->acVolumeName);
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_ReadSector
+*
+*  Function description
+*    Makes a sector of the storage device available in pVolume->pData.
+*
+*  Parameters
+*    pVolume        Layout of the volume.
+*    SectorIndex    Index of the sector on the storage device.
+*
+*  Return value
+*    ==0    OK, sector read.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The allocation table sectors are buffered separately, so that
+*    a directory can be followed to the next cluster without reading
+*    the directory sector again.
+*/
+int FS_FATX_ReadSector(FS_FATX_VOLUME * pVolume, U32 SectorIndex)
+{
+    int r = 0;
+
+    if(pVolume->SectorIndexData != SectorIndex)
+    {
+        pVolume->SectorIndexData = SECTOR_INDEX_INVALID;
+        r = FS_STORAGE_ReadSector(pVolume->acVolumeName, pVolume->pData, SectorIndex);
+        if(r == 0)
+        {
+            pVolume->SectorIndexData = SectorIndex;
+        }
+        else
+        {
+            r = FS_ERRCODE_READ_FAILURE;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_GetFATEntry
+*
+*  Function description
+*    Returns the value stored in the allocation table for a cluster.
+*
+*  Parameters
+*    pVolume    Layout of the volume.
+*    Cluster    Id of the cluster.
+*    pValue     [OUT] Id of the next cluster in the chain, 0 for a free
+*               cluster or a value for which FS_FATX_IsClusterValid()
+*               returns 0 at the end of the chain.
+*
+*  Return value
+*    ==0    OK, value read.
+*    !=0    Error code indicating the failure reason.
+*/
+int FS_FATX_GetFATEntry(FS_FATX_VOLUME * pVolume, U32 Cluster, U32 * pValue)
+{
+    U32 value = 0U;
+    int r = 0;
+
+    if(FS_FATX_IsClusterValid(pVolume, Cluster) == 0)
+    {
+        r = FS_ERRCODE_INVALID_CLUSTER_CHAIN;
+    }
+    else if(pVolume->FATType == 32U)
+    {
+        U32 off = Cluster * 4U;
+
+        r = read_fat_sector(pVolume, pVolume->FirstSectorFAT + (off / pVolume->BytesPerSector));
+        if(r == 0)
+        {
+            value = load_u32(pVolume->pFAT + (off % pVolume->BytesPerSector)) & 0x0FFFFFFFUL;
+        }
+    }
+    else if(pVolume->FATType == 16U)
+    {
+        U32 off = Cluster * 2U;
+
+        r = read_fat_sector(pVolume, pVolume->FirstSectorFAT + (off / pVolume->BytesPerSector));
+        if(r == 0)
+        {
+            value = load_u16(pVolume->pFAT + (off % pVolume->BytesPerSector));
+        }
+    }
+    else
+    {
+        U32 off = Cluster + (Cluster / 2U);
+        U32 lo;
+        U32 hi = 0U;
+
+        r = read_fat_byte(pVolume, off, &lo);
+        if(r == 0)
+        {
+            r = read_fat_byte(pVolume, off + 1U, &hi);     /* The entry can span two sectors. */
+        }
+        value = lo | (hi << 8);
+        value = ((Cluster & 1U) != 0U) ? (value >> 4) : (value & 0xFFFU);
+    }
+    if(r != 0)
+    {
+        r = (r < 0) ? r : FS_ERRCODE_READ_FAILURE;
+    }
+    else
+    {
+        *pValue = value;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_IsClusterValid
+*
+*  Function description
+*    Checks if a value is the id of a cluster of the data area.
+*
+*  Return value
+*    ==1    Valid cluster id.
+*    ==0    Free, end-of-chain, bad or out of range.
+*/
+int FS_FATX_IsClusterValid(const FS_FATX_VOLUME * pVolume, U32 Cluster)
+{
+    return ((Cluster >= 2U) && (Cluster < (pVolume->NumClusters + 2U))) ? 1 : 0;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_ClusterToSector
+*
+*  Function description
+*    Returns the index on the storage device of the first sector of a cluster.
+*/
+U32 FS_FATX_ClusterToSector(const FS_FATX_VOLUME * pVolume, U32 Cluster)
+{
+    return pVolume->FirstSectorData + ((Cluster - 2U) * pVolume->SectorsPerCluster);
+}
+
+/*********************************************************************
+*
+*       FS_FATX_OpenDir
+*
+*  Function description
+*    Starts the listing of a directory.
+*
+*  Parameters
+*    pDir           [OUT] Position of the listing.
+*    pVolume        Layout of the volume.
+*    FirstCluster   First cluster of the directory or 0 for the root directory.
+*/
+void FS_FATX_OpenDir(FS_FATX_DIR * pDir, FS_FATX_VOLUME * pVolume, U32 FirstCluster)
+{
+    if(FirstCluster == 0U)
+    {
+        FirstCluster = pVolume->RootDirCluster;
+    }
+    FS_FATX_SeekDir(pDir, pVolume, FirstCluster, FirstCluster, 0U);
+}
+
+/*********************************************************************
+*
+*       FS_FATX_SeekDir
+*
+*  Function description
+*    Positions a directory listing on a given entry.
+*
+*  Parameters
+*    pDir           [OUT] Position of the listing.
+*    pVolume        Layout of the volume.
+*    FirstCluster   First cluster of the directory, 0 for the root
+*                   directory of FAT12/16.
+*    Cluster        Cluster of the directory that stores the entry
+*                   (StartCluster of FS_FATX_DIRENTRY).
+*    EntryIndex     Index of the entry in the directory (StartEntryIndex
+*                   of FS_FATX_DIRENTRY).
+*
+*  Additional information
+*    The next call to FS_FATX_ReadDirEntry() returns the file whose
+*    first directory entry is at the given position.
+*/
+void FS_FATX_SeekDir(FS_FATX_DIR * pDir, FS_FATX_VOLUME * pVolume, U32 FirstCluster, U32 Cluster, U32 EntryIndex)
+{
+    U32 entries_per_sector = (U32)pVolume->BytesPerSector / DIR_ENTRY_SIZE;
+    U32 sector_in_dir;
+
+    pDir->pVolume          = pVolume;
+    pDir->FirstCluster     = FirstCluster;
+    pDir->Cluster          = Cluster;
+    pDir->EntryIndex       = EntryIndex;
+    pDir->SectorEntryIndex = EntryIndex - (EntryIndex % entries_per_sector);
+    sector_in_dir = EntryIndex / entries_per_sector;
+    if(Cluster == 0U)
+    {
+        pDir->SectorIndex    = pVolume->FirstSectorRootDir + sector_in_dir;
+        pDir->NumSectorsLeft = pVolume->NumSectorsRootDir - 1U - sector_in_dir;
+    }
+    else
+    {
+        U32 sector_in_cluster = sector_in_dir % pVolume->SectorsPerCluster;
+
+        pDir->SectorIndex    = FS_FATX_ClusterToSector(pVolume, Cluster) + sector_in_cluster;
+        pDir->NumSectorsLeft = (U32)pVolume->SectorsPerCluster - 1U - sector_in_cluster;
+    }
+}
+
+/*********************************************************************
+*
+*       FS_FATX_ReadDirEntry
+*
+*  Function description
+*    Returns the next file or directory of a directory listing.
+*
+*  Parameters
+*    pDir           Position of the listing.
+*    pEntry         [OUT] Information about the entry.
+*    sName          [OUT] Long name of the entry or the short name if the
+*                   entry has no long name (0-terminated), in the encoding
+*                   of the file names used by the file system.
+*    SizeOfName     Size of sName in bytes. Longer names are truncated.
+*                   pEntry->NameFlags indicates if sName is incomplete.
+*
+*  Return value
+*    ==0                OK, entry returned.
+*    ==FS_FATX_DIR_END  No more entries.
+*    < 0                Error code indicating the failure reason.
+*
+*  Additional information
+*    Deleted entries, the volume label and the "." and ".." entries
+*    are skipped.
+*/
+int FS_FATX_ReadDirEntry(FS_FATX_DIR * pDir, FS_FATX_DIRENTRY * pEntry, char * sName, unsigned SizeOfName)
+{
+    FS_FATX_VOLUME * pVolume = pDir->pVolume;
+    U32 entries_per_sector = (U32)pVolume->BytesPerSector / DIR_ENTRY_SIZE;
+    U16 aLFN[LFN_MAX_ENTRIES * LFN_CHARS_PER_ENTRY];
+    U32 lfn_seq = 0U;           /* Sequence number of the next long name entry expected. 0 if none. */
+    U32 lfn_len = 0U;
+    U8  lfn_checksum = 0U;
+    U32 start_cluster = 0U;     /* Position of the first entry of the long name. */
+    U32 start_entry_index = 0U;
+    bool is_found = false;
+    int r = 0;
+
+    while((r == 0) && (!is_found))
+    {
+        U32 off = pDir->EntryIndex % entries_per_sector;
+        const U8 * p;
+
+        if(pDir->EntryIndex >= (pDir->SectorEntryIndex + entries_per_sector))
+        {
+            r = advance_dir(pDir);
+            if(r == 0)
+            {
+                pDir->SectorEntryIndex += entries_per_sector;
+            }
+        }
+        if(r == 0)
+        {
+            r = read_dir_sector(pDir, &p);
+        }
+        if(r != 0)
+        {
+            break;
+        }
+        p += off * DIR_ENTRY_SIZE;
+        if(p[0] == DIR_ENTRY_END)
+        {
+            r = FS_FATX_DIR_END;        /* Stay at the end. */
+            break;
+        }
+        else if(p[0] == DIR_ENTRY_DELETED)
+        {
+            lfn_seq = 0U;
+        }
+        else if((p[11] & ATTR_LONG_NAME_MASK) == ATTR_LONG_NAME)
+        {
+            U32 seq = (U32)p[0] & LFN_SEQ_MASK;
+
+            if((p[0] & LFN_LAST) != 0U)
+            {
+                start_cluster     = pDir->Cluster;
+                start_entry_index = pDir->EntryIndex;
+                lfn_seq      = seq;
+                lfn_checksum = p[13];
+                lfn_len      = seq * LFN_CHARS_PER_ENTRY;
+            }
+            if((seq == 0U) || (seq > LFN_MAX_ENTRIES) || (seq != lfn_seq) || (p[13] != lfn_checksum))
+            {
+                lfn_seq = 0U;           /* Orphaned part of a long name. */
+            }
+            else
+            {
+                static const U8 char_off[LFN_CHARS_PER_ENTRY] = {1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30};
+
+                for(U32 i = 0U; i < LFN_CHARS_PER_ENTRY; i++)
+                {
+                    U32 c   = load_u16(p + char_off[i]);
+                    U32 pos = ((seq - 1U) * LFN_CHARS_PER_ENTRY) + i;
+
+                    if(c == 0U)
+                    {
+                        if(pos < lfn_len)
+                        {
+                            lfn_len = pos;
+                        }
+                    }
+                    else if(pos < lfn_len)
+                    {
+                        aLFN[pos] = (U16)c;
+                    }
+                    else
+                    {
+                        /* Padding. */
+                    }
+                }
+                lfn_seq--;
+                if(lfn_seq == 0U)
+                {
+                    lfn_seq = 0xFFU;    /* Complete, the short entry has to follow. */
+                }
+            }
+        }
+        else if(((p[11] & ATTR_VOLUME_ID) != 0U) || (p[0] == (U8)'.'))
+        {
+            lfn_seq = 0U;
+        }
+        else
+        {
+            pEntry->Attributes     = p[11];
+            pEntry->FirstCluster   = load_u16(p + 26);
+            if(pVolume->FATType == 32U)
+            {
+                pEntry->FirstCluster |= (U32)load_u16(p + 20) << 16;
+            }
+            pEntry->FileSize       = load_u32(p + 28);
+            pEntry->CreationTime   = ((U32)load_u16(p + 16) << 16) | load_u16(p + 14);
+            pEntry->LastAccessTime = (U32)load_u16(p + 18) << 16;
+            pEntry->LastWriteTime  = ((U32)load_u16(p + 24) << 16) | load_u16(p + 22);
+            pEntry->SectorIndex    = pDir->SectorIndex;
+            pEntry->Offset         = (U16)(off * DIR_ENTRY_SIZE);
+            pEntry->EntryIndex     = pDir->EntryIndex;
+            pEntry->StartCluster    = pDir->Cluster;
+            pEntry->StartEntryIndex = pDir->EntryIndex;
+            format_short_name(p, pEntry->acShortName);
+            if((lfn_seq == 0xFFU) && (calc_lfn_checksum(p) == lfn_checksum))
+            {
+                pEntry->StartCluster    = start_cluster;
+                pEntry->StartEntryIndex = start_entry_index;
+                pEntry->NameFlags       = encode_long_name(aLFN, lfn_len, sName, SizeOfName);
+            }
+            else
+            {
+                U32 i = 0U;
+
+                while((pEntry->acShortName[i] != '\0') && (i < (SizeOfName - 1U)))
+                {
+                    sName[i] = pEntry->acShortName[i];
+                    i++;
+                }
+                sName[i] = '\0';
+                pEntry->NameFlags = (pEntry->acShortName[i] != '\0') ? FS_FATX_NAME_FLAG_TRUNCATED : 0U;
+            }
+            is_found = true;
+        }
+        pDir->EntryIndex++;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_IsNameEqual
+*
+*  Function description
+*    Checks if a path component is the name of a directory entry.
+*
+*  Parameters
+*    sName      Long name of the entry returned by FS_FATX_ReadDirEntry().
+*    pEntry     Entry returned by FS_FATX_ReadDirEntry().
+*    sComponent Path component. Does not have to be 0-terminated.
+*    Len        Number of characters in sComponent.
+*
+*  Return value
+*    ==1    The component is equal to the long or the short name.
+*    ==0    Not equal.
+*
+*  Additional information
+*    A long name that was returned incompletely is not compared,
+*    so that it cannot match the name of another file.
+*/
+int FS_FATX_IsNameEqual(const char * sName, const FS_FATX_DIRENTRY * pEntry, const char * sComponent, U32 Len)
+{
+    bool is_equal = is_name_equal(pEntry->acShortName, sComponent, Len);
+
+    if((!is_equal) && (pEntry->NameFlags == 0U))
+    {
+        is_equal = is_name_equal(sName, sComponent, Len);
+    }
+
+    return is_equal ? 1 : 0;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_SetFindFunc
+*
+*  Function description
+*    Replaces the linear search of directories by FS_FATX_FindEntry().
+*
+*  Parameters
+*    pfFind     Function that searches a directory or NULL to restore
+*               the linear search.
+*/
+void FS_FATX_SetFindFunc(FS_FATX_FIND_FUNC * pfFind)
+{
+    lock();
+    fatx_pfFind = pfFind;
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_SetPathFuncs
+*
+*  Function description
+*    Lets FS_FATX_FindEntry() start the search of a path in a directory
+*    other than the root directory.
+*
+*  Parameters
+*    pfFind     Returns the number of leading directory components of
+*               a path that it has resolved and the first cluster of the
+*               last of them. NULL to always start in the root directory.
+*    pfAdd      Called for each directory resolved by FS_FATX_FindEntry()
+*               that is followed by other path components, with the
+*               entry of the directory and the first cluster of its
+*               parent directory. Can be NULL.
+*/
+void FS_FATX_SetPathFuncs(FS_FATX_PATH_FIND_FUNC * pfFind, FS_FATX_PATH_ADD_FUNC * pfAdd)
+{
+    lock();
+    fatx_pfPathFind = pfFind;
+    fatx_pfPathAdd  = pfAdd;
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_SetFreeRunFunc
+*
+*  Function description
+*    Lets FS_FATX_FindFreeRun() look up free clusters without reading
+*    the entire allocation table.
+*
+*  Parameters
+*    pfFreeRun  Function that searches for free clusters or NULL to
+*               always search the allocation table.
+*/
+void FS_FATX_SetFreeRunFunc(FS_FATX_FREE_RUN_FUNC * pfFreeRun)
+{
+    lock();
+    fatx_pfFreeRun = pfFreeRun;
+    unlock();
+}
+
+/*********************************************************************
+*
+*       FS_FATX_FindEntry
+*
+*  Function description
+*    Searches for a file or directory.
+*
+*  Parameters
+*    pVolume    Layout of the volume.
+*    sPath      Name of the file or directory without the volume name.
+*    pEntry     [OUT] Information about the entry. For the root directory
+*               only FirstCluster (0) and Attributes are valid.
+*
+*  Return value
+*    ==0    OK, entry found.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The components of the path are compared with the long and the
+*    short names ignoring the case of ASCII letters.
+*/
+int FS_FATX_FindEntry(FS_FATX_VOLUME * pVolume, const char * sPath, FS_FATX_DIRENTRY * pEntry)
+{
+    char acName[256];
+    const char * sPathStart = sPath;
+    U32 dir_cluster = 0U;
+    U32 num_components = 0U;
+    int r = 0;
+
+    FS_MEMSET(pEntry, 0, sizeof(FS_FATX_DIRENTRY));
+    pEntry->Attributes = FS_ATTR_DIRECTORY;
+    if(fatx_pfPathFind != NULL)
+    {
+        num_components = fatx_pfPathFind(pVolume, sPath, &dir_cluster);
+        for(U32 i = 0U; i < num_components; i++)
+        {
+            sPath = skip_component(sPath);
+        }
+        pEntry->FirstCluster = dir_cluster;
+    }
+    while((r == 0) && (*sPath != '\0'))
+    {
+        U32 len = 0U;
+
+        while(is_delimiter(*sPath))
+        {
+            sPath++;
+        }
+        while((sPath[len] != '\0') && (!is_delimiter(sPath[len])))
+        {
+            len++;
+        }
+        if(len != 0U)
+        {
+            FS_FATX_DIR dir;
+
+            if((pEntry->Attributes & FS_ATTR_DIRECTORY) == 0U)
+            {
+                r = FS_ERRCODE_PATH_NOT_FOUND;
+                break;
+            }
+            if(fatx_pfFind != NULL)
+            {
+                r = fatx_pfFind(pVolume, dir_cluster, sPath, len, pEntry);
+            }
+            else
+            {
+                FS_FATX_OpenDir(&dir, pVolume, dir_cluster);
+                do
+                {
+                    r = FS_FATX_ReadDirEntry(&dir, pEntry, acName, sizeof(acName));
+                } while((r == 0) && (FS_FATX_IsNameEqual(acName, pEntry, sPath, len) == 0));
+            }
+            if(r == FS_FATX_DIR_END)
+            {
+                r = (sPath[len] == '\0') ? FS_ERRCODE_FILE_DIR_NOT_FOUND : FS_ERRCODE_PATH_NOT_FOUND;
+            }
+            sPath += len;
+            num_components++;
+            if((r == 0) && (fatx_pfPathAdd != NULL) && ((pEntry->Attributes & FS_ATTR_DIRECTORY) != 0U) && (*skip_component(sPath) != '\0'))
+            {
+                fatx_pfPathAdd(pVolume, sPathStart, num_components, dir_cluster, pEntry);
+            }
+            dir_cluster = pEntry->FirstCluster;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_FATX_FindFreeRun
+*
+*  Function description
+*    Searches the allocation table for contiguous free clusters.
+*
+*  Parameters
+*    pVolume        Layout of the volume.
+*    NumClusters    Number of clusters required.
+*    pStartCluster  [OUT] Id of the first free cluster of the run.
+*
+*  Return value
+*    ==0    OK, run found.
+*    !=0    Error code indicating the failure reason.
+*/
+int FS_FATX_FindFreeRun(FS_FATX_VOLUME * pVolume, U32 NumClusters, U32 * pStartCluster)
+{
+    U32 num_free = 0U;
+    U32 cluster = pVolume->NumClusters + 2U;
+    int r = FS_ERRCODE_VOLUME_FULL;
+
+    if(fatx_pfFreeRun != NULL)
+    {
+        r = fatx_pfFreeRun(pVolume, NumClusters, pStartCluster);
+        if(r == 1)
+        {
+            cluster = 2U;
+            r       = FS_ERRCODE_VOLUME_FULL;
+        }
+    }
+    else
+    {
+        cluster = 2U;
+    }
+    for(; cluster < (pVolume->NumClusters + 2U); cluster++)
+    {
+        U32 value;
+        int r_read = FS_FATX_GetFATEntry(pVolume, cluster, &value);
+
+        if(r_read != 0)
+        {
+            r = r_read;
+            break;
+        }
+        num_free = (value == 0U) ? (num_free + 1U) : 0U;
+        if(num_free >= NumClusters)
+        {
+            *pStartCluster = cluster + 1U - num_free;
+            r = 0;
+            break;
+        }
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
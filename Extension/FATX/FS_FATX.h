@@ -0,0 +1,279 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX.h
+Purpose     : FAT file system extensions that work on the on-disk
+              structures of a volume.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_FATX_H     // Avoid recursive and multiple inclusion
+#define FS_FATX_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_FATX_MAX_LEN_VOLUME_NAME
+#define FS_FATX_MAX_LEN_VOLUME_NAME     (16U)   /* Maximum number of characters in a volume name including the terminator, e.g. "mmc:0:". */
+#endif
+
+#ifndef FS_FATX_PATHCACHE_MAX_LEN
+#define FS_FATX_PATHCACHE_MAX_LEN       (64U)   /* Maximum number of characters in a path stored in the path cache including the terminator. */
+#endif
+
+#ifndef FS_FATX_DIRLIST_MAX_LEN_NAME
+#define FS_FATX_DIRLIST_MAX_LEN_NAME    (256U)  /* Maximum number of bytes in a name returned by FS_ReadDirList() including the terminator. */
+#endif
+
+#ifndef FS_FATX_DIRINDEX_MAX_DIRS
+#define FS_FATX_DIRINDEX_MAX_DIRS       (4U)    /* Maximum number of directories held in the directory index. */
+#endif
+
+#ifndef FS_FATX_FREEMAP_FILE_NAME
+#define FS_FATX_FREEMAP_FILE_NAME       "FREEMAP.SYS"   /* Name of the file in the root directory that stores the checkpoint of the free-cluster map. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Flags of FS_AllocateFile(). */
+#define FS_ALLOCATE_FLAG_CONTIGUOUS     (1U << 0)   /* Fail if the clusters cannot be allocated contiguously. */
+
+/* Flags in FS_FATX_DIRENTRY::NameFlags. */
+#define FS_FATX_NAME_FLAG_TRUNCATED     (1U << 0)   /* The name did not fit into the buffer. */
+#define FS_FATX_NAME_FLAG_LOSSY         (1U << 1)   /* The name contains characters that cannot be encoded, returned as '_'. */
+
+/* Return values of FS_FATX_ReadDirEntry(). */
+#define FS_FATX_DIR_END                 (1)         /* No more entries in the directory. */
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef enum
+{
+    FS_FATX_RESULT_OK = 0U,
+    FS_FATX_RESULT_BADPARAM,
+    FS_FATX_RESULT_ERROR,
+} FS_FATX_Result_t;
+
+/* Layout of a mounted FAT volume. Used by the modules of the FATX extension. */
+typedef struct
+{
+    char   acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    U8   * pData;                   /* Buffer for directory and data sectors. */
+    U8   * pFAT;                    /* Buffer for allocation table sectors. */
+    U32    SectorIndexData;         /* Sector held in pData or 0xFFFFFFFF. */
+    U32    SectorIndexFAT;          /* Sector held in pFAT or 0xFFFFFFFF. */
+    U8   * pDirWindow;              /* Buffer for consecutive directory sectors. */
+    U32    DirWindowFirstSector;    /* First sector held in pDirWindow. */
+    U32    DirWindowNumSectors;     /* Number of sectors held in pDirWindow, 0 if none. */
+    U32    DirWindowMaxSectors;     /* Capacity of pDirWindow in sectors, 0 if the directories are read sector by sector. */
+    U32    FirstSectorFAT;          /* Index of the first sector of the first allocation table on the storage device. */
+    U32    NumSectorsFAT;           /* Number of sectors in one allocation table. */
+    U32    FirstSectorRootDir;      /* Index of the first sector of the root directory (FAT12/16). */
+    U32    NumSectorsRootDir;       /* Number of sectors in the root directory (FAT12/16). */
+    U32    RootDirCluster;          /* Id of the first cluster of the root directory (FAT32), otherwise 0. */
+    U32    FirstSectorData;         /* Index of the sector of cluster 2 on the storage device. */
+    U32    NumClusters;             /* Number of clusters in the data area. */
+    U16    BytesPerSector;
+    U16    SectorsPerCluster;
+    U8     NumFATs;
+    U8     FATType;                 /* 12, 16 or 32. */
+} FS_FATX_VOLUME;
+
+/* Information about a directory entry. */
+typedef struct
+{
+    U32    FirstCluster;            /* Id of the first cluster, 0 for an empty file. */
+    U32    FileSize;                /* Size of the file in bytes. */
+    U32    CreationTime;            /* Date and time in the format of FS_GetFileTime(). */
+    U32    LastAccessTime;
+    U32    LastWriteTime;
+    U32    SectorIndex;             /* Sector that stores the short directory entry. */
+    U32    EntryIndex;              /* Index of the short directory entry in the directory (0-based). */
+    U32    StartCluster;            /* Cluster that stores the first directory entry of the file (long or short). */
+    U32    StartEntryIndex;         /* Index of the first directory entry of the file in the directory. */
+    U16    Offset;                  /* Byte offset of the short directory entry in the sector. */
+    U8     Attributes;              /* FS_ATTR_... */
+    U8     NameFlags;               /* FS_FATX_NAME_FLAG_..., set if the name returned with the entry is incomplete. */
+    char   acShortName[13];         /* Short name in the format NAME.EXT (0-terminated). */
+} FS_FATX_DIRENTRY;
+
+/* Clusters of a file that are stored one after the other. */
+typedef struct
+{
+    U32    FileCluster;             /* Index of the first cluster in the file (0-based). */
+    U32    Cluster;                 /* Id of the first cluster on the volume. */
+    U32    NumClusters;             /* Number of clusters in the extent. */
+} FS_FILE_EXTENT;
+
+/* Extent map of an opened file. Allocated by the application and managed by the extension. */
+typedef struct FS_FILE_EXTENT_MAP
+{
+    struct FS_FILE_EXTENT_MAP * pNext;
+    FS_FILE        * pFile;
+    FS_FILE_EXTENT * paExtent;
+    U32              MaxExtents;
+    U32              NumExtents;
+    U32              NumClustersMapped;     /* Number of clusters described by paExtent. */
+    U32              DirSectorIndex;        /* Sector that stores the directory entry of the file. */
+    U16              DirOffset;             /* Byte offset of the directory entry in the sector. */
+    FS_FATX_VOLUME   Volume;
+} FS_FILE_EXTENT_MAP;
+
+/* Position of a directory listing. */
+typedef struct
+{
+    FS_FATX_VOLUME * pVolume;
+    U32    FirstCluster;            /* First cluster of the directory, 0 for the root directory of FAT12/16. */
+    U32    Cluster;                 /* Cluster being read. */
+    U32    SectorIndex;             /* Sector being read. */
+    U32    NumSectorsLeft;          /* Number of sectors left in the cluster or root directory after SectorIndex. */
+    U32    SectorEntryIndex;        /* Index of the first entry stored in SectorIndex. */
+    U32    EntryIndex;              /* Index of the next entry in the directory. */
+} FS_FATX_DIR;
+
+/* Position of a directory listing of FS_OpenDirList(). */
+typedef struct
+{
+    char        acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    FS_FATX_DIR Dir;
+    U8          IsEnd;          /* Set to 1 when all the entries have been returned. */
+} FS_DIR_LIST;
+
+/* Information about a directory entry returned by FS_ReadDirList(). */
+typedef struct
+{
+    char   acName[FS_FATX_DIRLIST_MAX_LEN_NAME];
+    U32    FileSize;                /* Size of the file in bytes, 0 for directories. */
+    U32    CreationTime;            /* Date and time in the format of FS_GetFileTime(). */
+    U32    LastAccessTime;
+    U32    LastWriteTime;
+    U8     Attributes;              /* FS_ATTR_... */
+    U8     NameFlags;               /* FS_FATX_NAME_FLAG_..., set if acName is not the complete name of the entry. */
+} FS_DIR_LIST_ENTRY;
+
+/* Searches a directory for a path component. Returns 0 if found, FS_FATX_DIR_END if not found, < 0 on error. */
+typedef int FS_FATX_FIND_FUNC(FS_FATX_VOLUME * pVolume, U32 DirCluster, const char * sName, U32 Len, FS_FATX_DIRENTRY * pEntry);
+
+/* Resolves leading directories of a path. Returns the number of path components resolved. */
+typedef U32 FS_FATX_PATH_FIND_FUNC(FS_FATX_VOLUME * pVolume, const char * sPath, U32 * pDirCluster);
+
+/* Records the directory specified by the first NumComponents components of a path. pEntry is the entry of the directory, stored in the directory that starts at ParentCluster. */
+typedef void FS_FATX_PATH_ADD_FUNC(FS_FATX_VOLUME * pVolume, const char * sPath, U32 NumComponents, U32 ParentCluster, const FS_FATX_DIRENTRY * pEntry);
+
+/* Searches for contiguous free clusters. Returns 0 if found, 1 if the search has to be done in the allocation table, < 0 on error. */
+typedef int FS_FATX_FREE_RUN_FUNC(FS_FATX_VOLUME * pVolume, U32 NumClusters, U32 * pStartCluster);
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_FATX_Result_t FS_FATX_Init             (void * pBuffer, U32 NumBytes);
+FS_FATX_Result_t FS_FATX_DeInit           (void);
+int              FS_AllocateFile          (const char * sFileName, U32 NumBytes, unsigned Flags);
+FS_FATX_Result_t FS_FATX_ConfigDirIndex   (void * pBuffer, U32 NumBytes);
+FS_FATX_Result_t FS_FATX_ConfigPathCache  (void * pBuffer, U32 NumBytes);
+int              FS_InvalidatePathCache   (const char * sDirName);
+int              FS_LookupFile            (const char * sFileName, FS_FILE_INFO * pInfo);
+int              FS_OpenDirList           (FS_DIR_LIST * pList, const char * sDirName);
+int              FS_ReadDirList           (FS_DIR_LIST * pList, FS_DIR_LIST_ENTRY * paEntry, unsigned MaxEntries);
+FS_FATX_Result_t FS_FATX_ConfigFreeMap    (void * pBuffer, U32 NumBytes);
+int              FS_LoadFreeMap           (const char * sVolumeName);
+int              FS_UnmountFreeMap        (const char * sVolumeName);
+int              FS_RefreshFreeMap        (const char * sVolumeName, U32 NumClusters);
+int              FS_GetFreeMapSpace       (const char * sVolumeName, U32 * pNumClustersFree, U32 * pBytesPerCluster);
+int              FS_CopyFileDirect        (const char * sFileNameSrc, const char * sFileNameDest, void * pBuffer, U32 NumBytes);
+int              FS_EnableExtentMap       (FS_FILE * pFile, const char * sFileName, FS_FILE_EXTENT_MAP * pMap, FS_FILE_EXTENT * paExtent, unsigned MaxExtents);
+int              FS_DisableExtentMap      (FS_FILE * pFile);
+int              FS_InvalidateExtentMap   (FS_FILE * pFile);
+U32              FS_ReadMapped            (FS_FILE * pFile, U32 Offset, void * pData, U32 NumBytes);
+
+/*********************************************************************
+*
+*       Internal code, used by the modules of the FATX extension
+*
+**********************************************************************
+*/
+int              FS_FATX_Lock             (void);
+void             FS_FATX_Unlock           (void);
+int              FS_FATX_LockVolume       (const char * sVolumeName);
+void             FS_FATX_UnlockVolume     (const char * sVolumeName);
+void             FS_FATX_ResolveVolumeName(char * sVolumeName);
+int              FS_FATX_Begin            (FS_FATX_VOLUME * pVolume, const char * sFileName, const char ** psPath);
+void             FS_FATX_Resume           (FS_FATX_VOLUME * pVolume);
+void             FS_FATX_End              (FS_FATX_VOLUME * pVolume);
+int              FS_FATX_ReadSector       (FS_FATX_VOLUME * pVolume, U32 SectorIndex);
+int              FS_FATX_GetFATEntry      (FS_FATX_VOLUME * pVolume, U32 Cluster, U32 * pValue);
+int              FS_FATX_IsClusterValid   (const FS_FATX_VOLUME * pVolume, U32 Cluster);
+U32              FS_FATX_ClusterToSector  (const FS_FATX_VOLUME * pVolume, U32 Cluster);
+void             FS_FATX_OpenDir          (FS_FATX_DIR * pDir, FS_FATX_VOLUME * pVolume, U32 FirstCluster);
+void             FS_FATX_SeekDir          (FS_FATX_DIR * pDir, FS_FATX_VOLUME * pVolume, U32 FirstCluster, U32 Cluster, U32 EntryIndex);
+int              FS_FATX_ReadDirEntry     (FS_FATX_DIR * pDir, FS_FATX_DIRENTRY * pEntry, char * sName, unsigned SizeOfName);
+int              FS_FATX_IsNameEqual      (const char * sName, const FS_FATX_DIRENTRY * pEntry, const char * sComponent, U32 Len);
+void             FS_FATX_SetFindFunc      (FS_FATX_FIND_FUNC * pfFind);
+void             FS_FATX_SetPathFuncs     (FS_FATX_PATH_FIND_FUNC * pfFind, FS_FATX_PATH_ADD_FUNC * pfAdd);
+void             FS_FATX_SetFreeRunFunc   (FS_FATX_FREE_RUN_FUNC * pfFreeRun);
+int              FS_FATX_FindEntry        (FS_FATX_VOLUME * pVolume, const char * sPath, FS_FATX_DIRENTRY * pEntry);
+int              FS_FATX_FindFreeRun      (FS_FATX_VOLUME * pVolume, U32 NumClusters, U32 * pStartCluster);
+
+#endif  // FS_FATX_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,394 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_Alloc.c
+Purpose     : Preallocation of files in contiguous clusters.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       find_file
+*
+*  Function description
+*    Returns the allocation of a file.
+*
+*  Return value
+*    ==0    OK, file found.
+*    ==1    File does not exist.
+*    < 0    Error code indicating the failure reason.
+*/
+static int find_file(const char * sFileName, FS_FATX_VOLUME * pVolume, FS_FATX_DIRENTRY * pEntry)
+{
+    const char * sPath;
+    int r;
+
+    r = FS_FATX_Begin(pVolume, sFileName, &sPath);
+    if(r == 0)
+    {
+        r = FS_FATX_FindEntry(pVolume, sPath, pEntry);
+        if(r == FS_ERRCODE_FILE_DIR_NOT_FOUND)
+        {
+            r = 1;
+        }
+        else if((r == 0) && ((pEntry->Attributes & FS_ATTR_DIRECTORY) != 0U))
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            /* Found or error. */
+        }
+        FS_FATX_End(pVolume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       check_free_run
+*
+*  Function description
+*    Checks if the volume has enough contiguous free clusters for a file.
+*/
+static int check_free_run(const char * sFileName, U32 NumClusters)
+{
+    FS_FATX_VOLUME volume;
+    U32 start_cluster;
+    int r;
+
+    r = FS_FATX_Begin(&volume, sFileName, NULL);
+    if(r == 0)
+    {
+        r = FS_FATX_FindFreeRun(&volume, NumClusters, &start_cluster);
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       is_contiguous
+*
+*  Function description
+*    Checks if the first clusters of a file are allocated one after
+*    the other.
+*
+*  Return value
+*    ==1    Contiguous.
+*    ==0    Fragmented.
+*    < 0    Error code indicating the failure reason.
+*/
+static int is_contiguous(const char * sFileName, U32 NumClusters)
+{
+    FS_FATX_VOLUME volume;
+    FS_FATX_DIRENTRY entry;
+    const char * sPath;
+    int r;
+
+    r = FS_FATX_Begin(&volume, sFileName, &sPath);
+    if(r == 0)
+    {
+        r = FS_FATX_FindEntry(&volume, sPath, &entry);
+        if(r == 0)
+        {
+            U32 cluster = entry.FirstCluster;
+
+            r = ((NumClusters == 0U) || (FS_FATX_IsClusterValid(&volume, cluster) != 0)) ? 1 : FS_ERRCODE_INVALID_CLUSTER_CHAIN;
+            for(U32 i = 1U; (i < NumClusters) && (r == 1); i++)
+            {
+                U32 next;
+
+                r = FS_FATX_GetFATEntry(&volume, cluster, &next);
+                if(r == 0)
+                {
+                    r = (next == (cluster + 1U)) ? 1 : 0;
+                }
+                cluster++;
+            }
+        }
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       set_file_size
+*
+*  Function description
+*    Extends a file via the file system.
+*
+*  Parameters
+*    sFileName  Fully qualified name of the file.
+*    NumBytes   New size of the file. A larger file is not truncated.
+*    pIsNew     [OUT] Set to true if the file was created.
+*    pPrevSize  [OUT] Size of the file before the call.
+*
+*  Additional information
+*    Whether the file exists is decided by the file system, not by
+*    the FATX parser, so that an existing file is never truncated.
+*/
+static int set_file_size(const char * sFileName, U32 NumBytes, bool * pIsNew, U32 * pPrevSize)
+{
+    FS_FILE * pFile;
+    U32 prev_size = 0U;
+    int r;
+
+    r = FS_FOpenEx(sFileName, "r+", &pFile);
+    if(r == FS_ERRCODE_FILE_DIR_NOT_FOUND)
+    {
+        r = FS_FOpenEx(sFileName, "w", &pFile);
+        if(r == 0)
+        {
+            *pIsNew = true;
+        }
+    }
+    if(r == 0)
+    {
+        prev_size = FS_GetFileSize(pFile);
+        if(prev_size < NumBytes)
+        {
+            r = FS_SetFileSize(pFile, NumBytes);
+        }
+        if(r == 0)
+        {
+            r = FS_FClose(pFile);
+        }
+        else
+        {
+            (void) FS_FClose(pFile);
+        }
+    }
+    *pPrevSize = prev_size;
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       restore_file_size
+*
+*  Function description
+*    Sets the size of an existing file.
+*/
+static int restore_file_size(const char * sFileName, U32 NumBytes)
+{
+    FS_FILE * pFile;
+    int r;
+
+    r = FS_FOpenEx(sFileName, "r+", &pFile);
+    if(r == 0)
+    {
+        r = FS_SetFileSize(pFile, NumBytes);
+        if(r == 0)
+        {
+            r = FS_FClose(pFile);
+        }
+        else
+        {
+            (void) FS_FClose(pFile);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 2,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       FS_AllocateFile
+*
+*  Function description
+*    Reserves storage for a file without writing the file data.
+*
+*  Parameters
+*    sFileName  Fully qualified name of the file. The file is created
+*               if it does not exist.
+*    NumBytes   Size of the file in bytes.
+*    Flags      Bitwise-OR combination of FS_ALLOCATE_FLAG_...
+*
+*  Return value
+*    ==0    OK, the file is stored in contiguous clusters.
+*    ==1    OK, the file is allocated but fragmented. Returned only
+*           if FS_ALLOCATE_FLAG_CONTIGUOUS is not set.
+*    < 0    Error code indicating the failure reason.
+*           FS_ERRCODE_VOLUME_FULL is returned if FS_ALLOCATE_FLAG_CONTIGUOUS
+*           is set and the clusters could not be allocated contiguously.
+*
+*  Additional information
+*    The file size is set to NumBytes via FS_SetFileSize(). The contents
+*    of the allocated area is undefined. The file is not truncated if it
+*    is larger than NumBytes. Data written later to the file within
+*    NumBytes does not allocate clusters, so a file that is stored
+*    contiguously can be written with multi-sector write operations.
+*
+*    The clusters are allocated by the file system. A contiguous free
+*    run large enough for the file is searched before the allocation
+*    to detect early that the request cannot be satisfied. The
+*    allocation is checked afterwards. If the clusters are fragmented
+*    and FS_ALLOCATE_FLAG_CONTIGUOUS is set the file is restored to
+*    its previous size, or removed if it was created by this function.
+*    Whether the file exists is decided by the file system, so that an
+*    existing file is neither truncated nor removed. The file must not
+*    be open.
+*/
+int FS_AllocateFile(const char * sFileName, U32 NumBytes, unsigned Flags)
+{
+    FS_FATX_VOLUME volume;
+    FS_FATX_DIRENTRY entry;
+    U32 bytes_per_cluster;
+    U32 num_clusters = 0U;
+    U32 prev_size = 0U;
+    bool is_new = false;
+    bool is_allocated = false;
+    bool is_contiguous_required = ((Flags & FS_ALLOCATE_FLAG_CONTIGUOUS) != 0U);
+    int r;
+
+    if(sFileName == NULL)
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = find_file(sFileName, &volume, &entry);
+    }
+    if(r == 1)
+    {
+        entry.FileSize = 0U;        /* Probably a new file. Only the file system decides. */
+        r = 0;
+    }
+    if(r == 0)
+    {
+        bytes_per_cluster = (U32)volume.BytesPerSector * volume.SectorsPerCluster;
+        num_clusters      = (NumBytes / bytes_per_cluster) + (((NumBytes % bytes_per_cluster) != 0U) ? 1U : 0U);
+        if(entry.FileSize >= NumBytes)
+        {
+            is_allocated = true;        /* Nothing to allocate, report the current state. */
+        }
+        else if((entry.FileSize == 0U) && is_contiguous_required)
+        {
+            r = check_free_run(sFileName, num_clusters);
+        }
+        else
+        {
+            /* The file system decides where the file is extended. */
+        }
+    }
+    if((r == 0) && (!is_allocated))
+    {
+        r = FS_FATX_LockVolume(volume.acVolumeName);
+        if(r == 0)
+        {
+            r = set_file_size(sFileName, NumBytes, &is_new, &prev_size);
+            is_allocated = (r == 0) && (prev_size >= NumBytes);
+            if(r == 0)
+            {
+                r = is_contiguous(sFileName, num_clusters);
+                if((r <= 0) && is_contiguous_required && (!is_allocated))
+                {
+                    /* Undo only what this call has done. */
+                    if(is_new)
+                    {
+                        (void) FS_Remove(sFileName);
+                    }
+                    else
+                    {
+                        (void) restore_file_size(sFileName, prev_size);
+                    }
+                }
+            }
+            FS_FATX_UnlockVolume(volume.acVolumeName);
+        }
+    }
+    else if(r == 0)
+    {
+        r = is_contiguous(sFileName, num_clusters);
+    }
+    else
+    {
+        /* Error. */
+    }
+    if(r == 1)
+    {
+        r = 0;
+    }
+    else if(r == 0)
+    {
+        r = (is_contiguous_required && (!is_allocated)) ? FS_ERRCODE_VOLUME_FULL : 1;
+    }
+    else
+    {
+        /* Error. */
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,450 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_Copy.c
+Purpose     : Copy of files via multi-sector transfers.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "FS_Storage.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define COPY_MAX_RUNS           (8U)    /* Number of cluster runs located per volume operation. */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32    SectorIndex;
+    U32    NumSectors;
+} copy_run_t;
+
+/* Position in the clusters of a file. */
+typedef struct
+{
+    const char * sFileName;
+    FS_FATX_DIRENTRY Entry;
+    U32          NextCluster;   /* First cluster that is not located yet, 0 at the end of the chain. */
+    U32          NumRuns;
+    U32          RunIndex;
+    copy_run_t   aRun[COPY_MAX_RUNS];
+    char         acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    U16          BytesPerSector;
+} copy_file_t;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       open_file
+*
+*  Function description
+*    Reads the directory entry of a file.
+*
+*  Return value
+*    ==0    OK, file found.
+*    ==1    File does not exist.
+*    < 0    Error code indicating the failure reason.
+*/
+static int open_file(copy_file_t * pFile, FS_FATX_VOLUME * pVolume, const char * sFileName)
+{
+    const char * sPath;
+    int r;
+
+    FS_MEMSET(pFile, 0, sizeof(copy_file_t));
+    pFile->sFileName = sFileName;
+    r = FS_FATX_Begin(pVolume, sFileName, &sPath);
+    if(r == 0)
+    {
+        r = FS_FATX_FindEntry(pVolume, sPath, &pFile->Entry);
+        if(r == FS_ERRCODE_FILE_DIR_NOT_FOUND)
+        {
+            r = 1;
+        }
+        else if((r == 0) && ((pFile->Entry.Attributes & FS_ATTR_DIRECTORY) != 0U))
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            /* Found or error. */
+        }
+        FS_STRCPY(pFile->acVolumeName, pVolume->acVolumeName);
+        pFile->NextCluster    = pFile->Entry.FirstCluster;
+        pFile->BytesPerSector = pVolume->BytesPerSector;
+        FS_FATX_End(pVolume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       locate_runs
+*
+*  Function description
+*    Locates the next clusters of a file.
+*
+*  Additional information
+*    Up to COPY_MAX_RUNS runs of consecutive clusters are located in
+*    one operation. Runs are not longer than max_sectors.
+*/
+static int locate_runs(copy_file_t * pFile, U32 max_sectors)
+{
+    FS_FATX_VOLUME volume;
+    int r;
+
+    pFile->NumRuns  = 0U;
+    pFile->RunIndex = 0U;
+    r = FS_FATX_Begin(&volume, pFile->sFileName, NULL);
+    if(r == 0)
+    {
+        U32 cluster = pFile->NextCluster;
+
+        while((r == 0) && (pFile->NumRuns < COPY_MAX_RUNS) && (max_sectors != 0U))
+        {
+            copy_run_t * pRun = &pFile->aRun[pFile->NumRuns];
+            U32 num_clusters = 1U;
+            U32 next = 0U;
+
+            if(FS_FATX_IsClusterValid(&volume, cluster) == 0)
+            {
+                r = FS_ERRCODE_INVALID_CLUSTER_CHAIN;
+                break;
+            }
+            for(;;)
+            {
+                r = FS_FATX_GetFATEntry(&volume, cluster + num_clusters - 1U, &next);
+                if((r != 0) || (next != (cluster + num_clusters)) || ((num_clusters * volume.SectorsPerCluster) >= max_sectors))
+                {
+                    break;
+                }
+                num_clusters++;
+            }
+            pRun->SectorIndex = FS_FATX_ClusterToSector(&volume, cluster);
+            pRun->NumSectors  = SEGGER_MIN(num_clusters * volume.SectorsPerCluster, max_sectors);
+            max_sectors -= pRun->NumSectors;
+            pFile->NumRuns++;
+            cluster = (FS_FATX_IsClusterValid(&volume, next) != 0) ? next : 0U;
+        }
+        pFile->NextCluster = cluster;
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_run
+*
+*  Function description
+*    Returns the current run of sectors of a file.
+*/
+static int get_run(copy_file_t * pFile, U32 max_sectors, copy_run_t ** ppRun)
+{
+    int r = 0;
+
+    if(pFile->RunIndex >= pFile->NumRuns)
+    {
+        r = locate_runs(pFile, max_sectors);
+    }
+    if(r == 0)
+    {
+        *ppRun = &pFile->aRun[pFile->RunIndex];
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       consume
+*/
+static void consume(copy_file_t * pFile, copy_run_t * pRun, U32 num_sectors)
+{
+    pRun->SectorIndex += num_sectors;
+    pRun->NumSectors  -= num_sectors;
+    if(pRun->NumSectors == 0U)
+    {
+        pFile->RunIndex++;
+    }
+}
+
+/*********************************************************************
+*
+*       copy_data
+*
+*  Function description
+*    Copies the sectors of the source file to the sectors of the
+*    destination file.
+*/
+static int copy_data(copy_file_t * pSrc, copy_file_t * pDest, U8 * pBuffer, U32 num_sectors_buffer)
+{
+    U32 num_sectors = (pSrc->Entry.FileSize / pSrc->BytesPerSector) + (((pSrc->Entry.FileSize % pSrc->BytesPerSector) != 0U) ? 1U : 0U);
+    int r = 0;
+
+    while((r == 0) && (num_sectors != 0U))
+    {
+        copy_run_t * pRunSrc  = NULL;
+        copy_run_t * pRunDest = NULL;
+        U32 n;
+
+        r = get_run(pSrc, num_sectors, &pRunSrc);
+        if(r == 0)
+        {
+            r = get_run(pDest, num_sectors, &pRunDest);
+        }
+        if(r != 0)
+        {
+            break;
+        }
+        n = SEGGER_MIN(SEGGER_MIN(pRunSrc->NumSectors, pRunDest->NumSectors), SEGGER_MIN(num_sectors_buffer, num_sectors));
+        r = FS_STORAGE_ReadSectors(pSrc->acVolumeName, pBuffer, pRunSrc->SectorIndex, n);
+        if(r == 0)
+        {
+            r = FS_STORAGE_WriteSectors(pDest->acVolumeName, pBuffer, pRunDest->SectorIndex, n);
+            r = (r == 0) ? 0 : FS_ERRCODE_WRITE_FAILURE;
+        }
+        else
+        {
+            r = FS_ERRCODE_READ_FAILURE;
+        }
+        consume(pSrc, pRunSrc, n);
+        consume(pDest, pRunDest, n);
+        num_sectors -= n;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       copy_locked
+*
+*  Function description
+*    Allocates the destination file and copies the data with both
+*    volumes locked.
+*
+*  Additional information
+*    The runs are located in several volume operations and the sectors
+*    are transferred between them. The volume locks prevent other tasks
+*    from changing the allocation of the files meanwhile. The locks
+*    are taken in the same order as by FS_FATX_Begin().
+*/
+static int copy_locked(copy_file_t * pSrc, copy_file_t * pDest, FS_FATX_VOLUME * pVolDest, const char * sFileNameDest, U8 * pBuffer, U32 num_sectors_buffer)
+{
+    char acVolumeNameDest[FS_FATX_MAX_LEN_VOLUME_NAME];
+    int r;
+
+    FS_STRCPY(acVolumeNameDest, pDest->acVolumeName);
+    r = FS_FATX_LockVolume(pSrc->acVolumeName);
+    if(r == 0)
+    {
+        r = FS_FATX_LockVolume(acVolumeNameDest);
+        if(r == 0)
+        {
+            r = FS_AllocateFile(sFileNameDest, pSrc->Entry.FileSize, 0U);
+            r = (r == 1) ? 0 : r;       /* Fragmented destination. */
+            if(r == 0)
+            {
+                r = open_file(pDest, pVolDest, sFileNameDest);
+            }
+            if(r == 0)
+            {
+                r = copy_data(pSrc, pDest, pBuffer, num_sectors_buffer);
+            }
+            FS_FATX_UnlockVolume(acVolumeNameDest);
+        }
+        FS_FATX_UnlockVolume(pSrc->acVolumeName);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       is_same_file
+*
+*  Function description
+*    Checks if the source and the destination are the same file.
+*/
+static bool is_same_file(const FS_FATX_VOLUME * pVolSrc, const copy_file_t * pSrc, const FS_FATX_VOLUME * pVolDest, const copy_file_t * pDest)
+{
+    return (FS_STRCMP(pSrc->acVolumeName, pDest->acVolumeName) == 0) && (pSrc->Entry.FirstCluster == pDest->Entry.FirstCluster) && (pSrc->Entry.SectorIndex == pDest->Entry.SectorIndex) &&
+           (pSrc->Entry.Offset == pDest->Entry.Offset) && (pVolSrc->FirstSectorData == pVolDest->FirstSectorData) &&
+           (pVolSrc->NumClusters == pVolDest->NumClusters);
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 1,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       FS_CopyFileDirect
+*
+*  Function description
+*    Copies a file via multi-sector transfers between the storage devices.
+*
+*  Parameters
+*    sFileNameSrc   Fully qualified name of the file to be copied.
+*    sFileNameDest  Fully qualified name of the copy. An existing file
+*                   is overwritten.
+*    pBuffer        Buffer for the data. Has to hold at least one
+*                   logical sector and has to be aligned as the sector
+*                   buffers of the file system.
+*    NumBytes       Size of pBuffer in bytes.
+*
+*  Return value
+*    ==0    OK, file copied.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Produces the same result as FS_CopyFileEx(). The destination file
+*    is allocated via FS_AllocateFile(), contiguously if the file system
+*    is able to, and the data is moved with the largest read and write
+*    operations that the cluster runs of both files and pBuffer permit,
+*    bypassing the file buffers. The sectors are transferred through the
+*    sector cache of the volumes, if one is configured. Both volumes are
+*    locked from the allocation until the last sector is written. The
+*    attributes and time stamps of the source file are copied to the
+*    destination.
+*
+*    FS_CopyFileEx() is used if the volumes have different sector sizes.
+*    The destination file is removed if the copy fails. Both files must
+*    not be open.
+*/
+int FS_CopyFileDirect(const char * sFileNameSrc, const char * sFileNameDest, void * pBuffer, U32 NumBytes)
+{
+    FS_FATX_VOLUME volume_src;
+    FS_FATX_VOLUME volume_dest;
+    copy_file_t src;
+    copy_file_t dest;
+    int r;
+
+    if((sFileNameSrc == NULL) || (sFileNameDest == NULL) || (pBuffer == NULL))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = open_file(&src, &volume_src, sFileNameSrc);
+        if(r == 1)
+        {
+            r = FS_ERRCODE_FILE_DIR_NOT_FOUND;
+        }
+    }
+    if(r == 0)
+    {
+        r = open_file(&dest, &volume_dest, sFileNameDest);
+        if((r == 0) && is_same_file(&volume_src, &src, &volume_dest, &dest))
+        {
+            r = FS_ERRCODE_INVALID_PARA;
+        }
+        else if(r == 0)
+        {
+            r = FS_Remove(sFileNameDest);
+        }
+        else if(r == 1)
+        {
+            r = 0;
+        }
+        else
+        {
+            /* Error. */
+        }
+    }
+    if(r == 0)
+    {
+        if((volume_src.BytesPerSector != volume_dest.BytesPerSector) || (NumBytes < volume_src.BytesPerSector))
+        {
+            r = FS_CopyFileEx(sFileNameSrc, sFileNameDest, pBuffer, NumBytes);
+        }
+        else
+        {
+            r = copy_locked(&src, &dest, &volume_dest, sFileNameDest, (U8 *)pBuffer, NumBytes / volume_src.BytesPerSector);
+            if(r == 0)
+            {
+                (void) FS_SetFileTimeEx(sFileNameDest, src.Entry.CreationTime,   FS_FILETIME_CREATE);
+                (void) FS_SetFileTimeEx(sFileNameDest, src.Entry.LastAccessTime, FS_FILETIME_ACCESS);
+                (void) FS_SetFileTimeEx(sFileNameDest, src.Entry.LastWriteTime,  FS_FILETIME_MODIFY);
+                r = FS_SetFileAttributes(sFileNameDest, src.Entry.Attributes & (U8)(FS_ATTR_READ_ONLY | FS_ATTR_HIDDEN | FS_ATTR_SYSTEM | FS_ATTR_ARCHIVE));
+            }
+            else
+            {
+                (void) FS_Remove(sFileNameDest);
+            }
+        }
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
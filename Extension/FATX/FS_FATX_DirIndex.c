@@ -0,0 +1,467 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_DirIndex.c
+Purpose     : Hash index of the names stored in recently used directories.
+              The index stores the position of the directory entries
+              of each name. An entry found via the index is read from
+              the storage and compared with the name, so that changes
+              made via the file system API are detected: if the name is
+              not found via the index the directory is searched linearly
+              and the index of the directory is rebuilt.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define MIN_SLOTS_PER_DIR       (16U)
+#define HASH_INIT               (2166136261UL)  /* FNV-1a */
+#define HASH_PRIME              (16777619UL)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    U32    Hash;            /* Hash of the name, 0 if the slot is free. */
+    U32    Cluster;         /* Position of the first directory entry of the file. */
+    U32    EntryIndex;
+} dirindex_slot_t;
+
+typedef struct
+{
+    char   acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    U32    DirCluster;      /* First cluster of the directory, 0 for the root directory. */
+    U32    LastUse;
+    U32    NumSlotsUsed;
+    bool   IsValid;
+    dirindex_slot_t * paSlot;
+} dirindex_dir_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static dirindex_dir_t dirindex_dirs[FS_FATX_DIRINDEX_MAX_DIRS];
+static U32            dirindex_num_slots;     /* Number of slots per directory. */
+static U32            dirindex_clock;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       calc_hash
+*
+*  Function description
+*    Calculates the hash of a name ignoring the case of ASCII letters.
+*/
+static U32 calc_hash(const char * sName, U32 len)
+{
+    U32 hash = HASH_INIT;
+
+    for(U32 i = 0U; i < len; i++)
+    {
+        U8 c = (U8)sName[i];
+
+        if((c >= (U8)'a') && (c <= (U8)'z'))
+        {
+            c = (U8)(c - ((U8)'a' - (U8)'A'));
+        }
+        hash = (hash ^ c) * HASH_PRIME;
+    }
+
+    return (hash == 0U) ? 1U : hash;
+}
+
+/*********************************************************************
+*
+*       find_dir
+*/
+static dirindex_dir_t * find_dir(const FS_FATX_VOLUME * pVolume, U32 dir_cluster)
+{
+    dirindex_dir_t * pDir = NULL;
+
+    for(U32 i = 0U; i < FS_FATX_DIRINDEX_MAX_DIRS; i++)
+    {
+        dirindex_dir_t * p = &dirindex_dirs[i];
+
+        if(p->IsValid && (p->DirCluster == dir_cluster) && (FS_STRCMP(p->acVolumeName, pVolume->acVolumeName) == 0))
+        {
+            pDir = p;
+            break;
+        }
+    }
+
+    return pDir;
+}
+
+/*********************************************************************
+*
+*       alloc_dir
+*
+*  Function description
+*    Returns the index of the directory used least recently.
+*/
+static dirindex_dir_t * alloc_dir(void)
+{
+    dirindex_dir_t * pDir = &dirindex_dirs[0];
+
+    for(U32 i = 1U; (i < FS_FATX_DIRINDEX_MAX_DIRS) && pDir->IsValid; i++)
+    {
+        dirindex_dir_t * p = &dirindex_dirs[i];
+
+        if((!p->IsValid) || ((dirindex_clock - p->LastUse) > (dirindex_clock - pDir->LastUse)))
+        {
+            pDir = p;
+        }
+    }
+
+    return pDir;
+}
+
+/*********************************************************************
+*
+*       add_name
+*
+*  Return value
+*    ==true     Name added.
+*    ==false    The index of the directory is full.
+*/
+static bool add_name(dirindex_dir_t * pDir, U32 hash, const FS_FATX_DIRENTRY * pEntry)
+{
+    bool r = false;
+
+    if((pDir->NumSlotsUsed + 1U) < ((dirindex_num_slots * 3U) / 4U))
+    {
+        U32 i = hash % dirindex_num_slots;
+
+        while(pDir->paSlot[i].Hash != 0U)
+        {
+            i = (i + 1U) % dirindex_num_slots;
+        }
+        pDir->paSlot[i].Hash       = hash;
+        pDir->paSlot[i].Cluster    = pEntry->StartCluster;
+        pDir->paSlot[i].EntryIndex = pEntry->StartEntryIndex;
+        pDir->NumSlotsUsed++;
+        r = true;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_indexed
+*
+*  Function description
+*    Searches a name via the index of a directory.
+*/
+static int find_indexed(const dirindex_dir_t * pDir, FS_FATX_VOLUME * pVolume, U32 hash, const char * sName, U32 len, FS_FATX_DIRENTRY * pEntry)
+{
+    char acName[256];
+    U32 first_cluster = (pDir->DirCluster == 0U) ? pVolume->RootDirCluster : pDir->DirCluster;
+    U32 i = hash % dirindex_num_slots;
+    int r = FS_FATX_DIR_END;
+
+    while((r == FS_FATX_DIR_END) && (pDir->paSlot[i].Hash != 0U))
+    {
+        const dirindex_slot_t * pSlot = &pDir->paSlot[i];
+
+        if(pSlot->Hash == hash)
+        {
+            FS_FATX_DIR dir;
+
+            FS_FATX_SeekDir(&dir, pVolume, first_cluster, pSlot->Cluster, pSlot->EntryIndex);
+            r = FS_FATX_ReadDirEntry(&dir, pEntry, acName, sizeof(acName));
+            if(r == 0)
+            {
+                if((pEntry->StartCluster != pSlot->Cluster) || (pEntry->StartEntryIndex != pSlot->EntryIndex) ||
+                   (FS_FATX_IsNameEqual(acName, pEntry, sName, len) == 0))
+                {
+                    r = FS_FATX_DIR_END;    /* The directory was modified. */
+                }
+            }
+            else if(r == FS_FATX_DIR_END)
+            {
+                /* The directory was modified. */
+            }
+            else
+            {
+                break;
+            }
+        }
+        i = (i + 1U) % dirindex_num_slots;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_and_index
+*
+*  Function description
+*    Searches a name linearly and builds the index of the directory.
+*/
+static int find_and_index(dirindex_dir_t * pDir, FS_FATX_VOLUME * pVolume, U32 dir_cluster, const char * sName, U32 len, FS_FATX_DIRENTRY * pEntry)
+{
+    char acName[256];
+    FS_FATX_DIRENTRY entry;
+    FS_FATX_DIR dir;
+    bool is_found = false;
+    int r;
+
+    FS_STRCPY(pDir->acVolumeName, pVolume->acVolumeName);
+    FS_MEMSET(pDir->paSlot, 0, dirindex_num_slots * sizeof(dirindex_slot_t));
+    pDir->DirCluster   = dir_cluster;
+    pDir->NumSlotsUsed = 0U;
+    pDir->IsValid      = true;
+    FS_FATX_OpenDir(&dir, pVolume, dir_cluster);
+    for(;;)
+    {
+        U32 hash_long;
+        U32 hash_short;
+
+        r = FS_FATX_ReadDirEntry(&dir, &entry, acName, sizeof(acName));
+        if(r != 0)
+        {
+            break;
+        }
+        if((!is_found) && (FS_FATX_IsNameEqual(acName, &entry, sName, len) != 0))
+        {
+            *pEntry  = entry;
+            is_found = true;
+        }
+        if(pDir->IsValid)
+        {
+            hash_long  = calc_hash(acName, (U32)FS_STRLEN(acName));
+            hash_short = calc_hash(entry.acShortName, (U32)FS_STRLEN(entry.acShortName));
+            pDir->IsValid = add_name(pDir, hash_long, &entry);
+            if(pDir->IsValid && (hash_short != hash_long))
+            {
+                pDir->IsValid = add_name(pDir, hash_short, &entry);
+            }
+        }
+    }
+    if(r < 0)
+    {
+        pDir->IsValid = false;
+    }
+    else if(is_found)
+    {
+        r = 0;
+    }
+    else
+    {
+        /* Not found. */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_in_dir
+*
+*  Function description
+*    Searches a directory for a path component via the index.
+*    Called by FS_FATX_FindEntry().
+*/
+static int find_in_dir(FS_FATX_VOLUME * pVolume, U32 DirCluster, const char * sName, U32 Len, FS_FATX_DIRENTRY * pEntry)
+{
+    dirindex_dir_t * pDir;
+    U32 hash = calc_hash(sName, Len);
+    int r = FS_FATX_DIR_END;
+
+    dirindex_clock++;
+    pDir = find_dir(pVolume, DirCluster);
+    if(pDir != NULL)
+    {
+        r = find_indexed(pDir, pVolume, hash, sName, Len, pEntry);
+    }
+    else
+    {
+        pDir = alloc_dir();
+    }
+    pDir->LastUse = dirindex_clock;
+    if(r == FS_FATX_DIR_END)
+    {
+        r = find_and_index(pDir, pVolume, DirCluster, sName, Len, pEntry);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 2,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_FATX_ConfigDirIndex
+****************************************************************************//**
+*
+*  Enables the hash index of directory names. The index is used whenever
+*  the FATX extension resolves a path, for example by FS_LookupFile(),
+*  FS_AllocateFile() or FS_EnableExtentMap().
+*
+*  Parameters
+*   pBuffer     Memory for the index or NULL to disable the index.
+*               It is shared equally by FS_FATX_DIRINDEX_MAX_DIRS directories.
+*               A directory is indexed if its number of names, counting
+*               the long and the short name of a file separately, is
+*               less than 3/4 of the slots of a directory. Each slot
+*               takes 12 bytes.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_FATX_RESULT_OK          Configured successfully.
+*   FS_FATX_RESULT_BADPARAM    Buffer too small or the extension is not initialized.
+*
+*******************************************************************************/
+FS_FATX_Result_t FS_FATX_ConfigDirIndex(void * pBuffer, U32 NumBytes)
+{
+    U32 num_slots = NumBytes / (FS_FATX_DIRINDEX_MAX_DIRS * sizeof(dirindex_slot_t));
+    FS_FATX_Result_t result = FS_FATX_RESULT_BADPARAM;
+
+    if(((pBuffer == NULL) || (num_slots >= MIN_SLOTS_PER_DIR)) && (FS_FATX_Lock() == 0))
+    {
+        FS_FATX_SetFindFunc(NULL);
+        FS_MEMSET(dirindex_dirs, 0, sizeof(dirindex_dirs));
+        dirindex_num_slots = 0U;
+        if(pBuffer != NULL)
+        {
+            dirindex_num_slots = num_slots;
+            for(U32 i = 0U; i < FS_FATX_DIRINDEX_MAX_DIRS; i++)
+            {
+                dirindex_dirs[i].paSlot = (dirindex_slot_t *)pBuffer + (i * num_slots);
+            }
+            FS_FATX_SetFindFunc(find_in_dir);
+        }
+        FS_FATX_Unlock();
+        result = FS_FATX_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_LookupFile
+*
+*  Function description
+*    Returns information about a file or directory.
+*
+*  Parameters
+*    sFileName  Fully qualified name of the file or directory.
+*    pInfo      [OUT] Attributes, time stamps and size.
+*
+*  Return value
+*    ==0    OK, information returned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Equivalent to FS_GetFileInfo(). The path is resolved via the
+*    directory index if enabled via FS_FATX_ConfigDirIndex(), so that
+*    a file in a large directory is found by reading the sectors that
+*    store its directory entries.
+*/
+int FS_LookupFile(const char * sFileName, FS_FILE_INFO * pInfo)
+{
+    FS_FATX_VOLUME volume;
+    FS_FATX_DIRENTRY entry;
+    const char * sPath;
+    int r;
+
+    if(pInfo == NULL)
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = FS_FATX_Begin(&volume, sFileName, &sPath);
+    }
+    if(r == 0)
+    {
+        r = FS_FATX_FindEntry(&volume, sPath, &entry);
+        if(r == 0)
+        {
+            pInfo->Attributes     = entry.Attributes;
+            pInfo->CreationTime   = entry.CreationTime;
+            pInfo->LastAccessTime = entry.LastAccessTime;
+            pInfo->LastWriteTime  = entry.LastWriteTime;
+            pInfo->FileSize       = ((entry.Attributes & FS_ATTR_DIRECTORY) != 0U) ? 0U : entry.FileSize;
+        }
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,213 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_DirList.c
+Purpose     : Listing of directories in batches.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 2,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       FS_OpenDirList
+*
+*  Function description
+*    Starts the listing of a directory.
+*
+*  Parameters
+*    pList      [OUT] Position of the listing.
+*    sDirName   Fully qualified name of the directory, for example
+*               "mmc:0:\dir". The name of the volume for the root
+*               directory.
+*
+*  Return value
+*    ==0    OK, the entries can be read via FS_ReadDirList().
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The listing does not allocate any resources and does not have
+*    to be closed.
+*/
+int FS_OpenDirList(FS_DIR_LIST * pList, const char * sDirName)
+{
+    FS_FATX_VOLUME volume;
+    FS_FATX_DIRENTRY entry;
+    const char * sPath;
+    int r;
+
+    if(pList == NULL)
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = FS_FATX_Begin(&volume, sDirName, &sPath);
+    }
+    if(r == 0)
+    {
+        r = FS_FATX_FindEntry(&volume, sPath, &entry);
+        if((r == 0) && ((entry.Attributes & FS_ATTR_DIRECTORY) == 0U))
+        {
+            r = FS_ERRCODE_NOT_A_DIR;
+        }
+        if(r == 0)
+        {
+            FS_STRCPY(pList->acVolumeName, volume.acVolumeName);
+            FS_FATX_OpenDir(&pList->Dir, &volume, entry.FirstCluster);
+            pList->Dir.pVolume = NULL;
+            pList->IsEnd       = 0U;
+        }
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_ReadDirList
+*
+*  Function description
+*    Returns the information about the next entries of a directory.
+*
+*  Parameters
+*    pList      Position of the listing opened via FS_OpenDirList().
+*    paEntry    [OUT] Information about the entries.
+*    MaxEntries Number of elements in paEntry.
+*
+*  Return value
+*    > 0    Number of entries stored to paEntry.
+*    ==0    No more entries in the directory.
+*    < 0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Returns the name, attributes, size and time stamps of the files
+*    and directories in one call with the volume locked, so that an
+*    FS_GetFileInfo() call per entry is not required. The "." and ".."
+*    entries are not returned.
+*
+*    The names are returned in the encoding used by the file system.
+*    The default FS_FATX_DIRLIST_MAX_LEN_NAME holds every long name
+*    if the support for file name encoding is disabled. A name that
+*    does not fit is truncated and FS_FATX_NAME_FLAG_TRUNCATED is set
+*    in NameFlags. FS_FATX_NAME_FLAG_LOSSY indicates that characters
+*    which cannot be encoded were replaced by '_'. Such a name cannot
+*    be used to open the entry.
+*
+*    The sectors of the directory are read via multi-sector read
+*    operations if the work buffer passed to FS_FATX_Init() holds
+*    more than three sectors. Entries created or removed between two
+*    calls may or may not be reported.
+*/
+int FS_ReadDirList(FS_DIR_LIST * pList, FS_DIR_LIST_ENTRY * paEntry, unsigned MaxEntries)
+{
+    FS_FATX_VOLUME volume;
+    FS_FATX_DIRENTRY entry;
+    unsigned num_entries = 0U;
+    int r;
+
+    if((pList == NULL) || (paEntry == NULL))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if((pList->IsEnd != 0U) || (MaxEntries == 0U))
+    {
+        r = 0;
+    }
+    else
+    {
+        r = FS_FATX_Begin(&volume, pList->acVolumeName, NULL);
+        if(r == 0)
+        {
+            pList->Dir.pVolume = &volume;
+            while(num_entries < MaxEntries)
+            {
+                FS_DIR_LIST_ENTRY * pInfo = &paEntry[num_entries];
+
+                r = FS_FATX_ReadDirEntry(&pList->Dir, &entry, pInfo->acName, sizeof(pInfo->acName));
+                if(r != 0)
+                {
+                    break;
+                }
+                pInfo->NameFlags      = entry.NameFlags;
+                pInfo->Attributes     = entry.Attributes;
+                pInfo->CreationTime   = entry.CreationTime;
+                pInfo->LastAccessTime = entry.LastAccessTime;
+                pInfo->LastWriteTime  = entry.LastWriteTime;
+                pInfo->FileSize       = ((entry.Attributes & FS_ATTR_DIRECTORY) != 0U) ? 0U : entry.FileSize;
+                num_entries++;
+            }
+            pList->Dir.pVolume = NULL;
+            FS_FATX_End(&volume);
+            if(r == FS_FATX_DIR_END)
+            {
+                pList->IsEnd = 1U;
+                r = 0;
+            }
+            if(r == 0)
+            {
+                r = (int)num_entries;
+            }
+        }
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
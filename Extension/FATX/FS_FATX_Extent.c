@@ -0,0 +1,611 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_Extent.c
+Purpose     : Extent maps for random access to large files.
+              The clusters of a file are described by a list of
+              extents that is built while the file is read. A read
+              at any offset of the mapped part of the file locates
+              the clusters without following the cluster chain.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "FS_Storage.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+
+/* Position in the cluster chain after the end of a full map. */
+typedef struct
+{
+    U32    FileCluster;     /* Index of the cluster in the file. */
+    U32    Cluster;         /* Id of the cluster. */
+} extent_cursor_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static FS_FILE_EXTENT_MAP * extent_maps;     /* List of the files with an extent map. */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       find_map
+*/
+static FS_FILE_EXTENT_MAP * find_map(const FS_FILE * pFile)
+{
+    FS_FILE_EXTENT_MAP * pMap = extent_maps;
+
+    while((pMap != NULL) && (pMap->pFile != pFile))
+    {
+        pMap = pMap->pNext;
+    }
+
+    return pMap;
+}
+
+/*********************************************************************
+*
+*       load_first_cluster
+*
+*  Function description
+*    Reads the id of the first cluster of the file from its directory entry.
+*/
+static int load_first_cluster(FS_FILE_EXTENT_MAP * pMap, U32 * pCluster)
+{
+    FS_FATX_VOLUME * pVolume = &pMap->Volume;
+    int r;
+
+    r = FS_FATX_ReadSector(pVolume, pMap->DirSectorIndex);
+    if(r == 0)
+    {
+        const U8 * p = pVolume->pData + pMap->DirOffset;
+
+        *pCluster = (U32)p[26] | ((U32)p[27] << 8);
+        if(pVolume->FATType == 32U)
+        {
+            *pCluster |= ((U32)p[20] << 16) | ((U32)p[21] << 24);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       add_cluster
+*
+*  Function description
+*    Appends a cluster to the extent map.
+*
+*  Return value
+*    ==true     Cluster added.
+*    ==false    The map is full.
+*/
+static bool add_cluster(FS_FILE_EXTENT_MAP * pMap, U32 cluster)
+{
+    FS_FILE_EXTENT * pExtent = NULL;
+
+    if(pMap->NumExtents != 0U)
+    {
+        pExtent = &pMap->paExtent[pMap->NumExtents - 1U];
+        if((pExtent->Cluster + pExtent->NumClusters) != cluster)
+        {
+            pExtent = NULL;
+        }
+    }
+    if((pExtent == NULL) && (pMap->NumExtents < pMap->MaxExtents))
+    {
+        pExtent = &pMap->paExtent[pMap->NumExtents];
+        pExtent->FileCluster = pMap->NumClustersMapped;
+        pExtent->Cluster     = cluster;
+        pExtent->NumClusters = 0U;
+        pMap->NumExtents++;
+    }
+    if(pExtent != NULL)
+    {
+        pExtent->NumClusters++;
+        pMap->NumClustersMapped++;
+    }
+
+    return pExtent != NULL;
+}
+
+/*********************************************************************
+*
+*       get_next_cluster
+*
+*  Function description
+*    Returns the cluster that follows a cluster of the file.
+*/
+static int get_next_cluster(FS_FATX_VOLUME * pVolume, U32 cluster, U32 * pNext)
+{
+    int r;
+
+    r = FS_FATX_GetFATEntry(pVolume, cluster, pNext);
+    if((r == 0) && (FS_FATX_IsClusterValid(pVolume, *pNext) == 0))
+    {
+        r = FS_ERRCODE_INVALID_CLUSTER_CHAIN;   /* The file is shorter than its size. */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       get_last_cluster
+*
+*  Function description
+*    Returns the id of the last mapped cluster.
+*/
+static U32 get_last_cluster(const FS_FILE_EXTENT_MAP * pMap)
+{
+    const FS_FILE_EXTENT * pExtent = &pMap->paExtent[pMap->NumExtents - 1U];
+
+    return pExtent->Cluster + pExtent->NumClusters - 1U;
+}
+
+/*********************************************************************
+*
+*       extend_map
+*
+*  Function description
+*    Follows the cluster chain until the map describes a given cluster
+*    of the file or the map is full.
+*/
+static int extend_map(FS_FILE_EXTENT_MAP * pMap, U32 file_cluster)
+{
+    FS_FATX_VOLUME * pVolume = &pMap->Volume;
+    U32 cluster;
+    int r = 0;
+
+    if(pMap->NumClustersMapped == 0U)
+    {
+        r = load_first_cluster(pMap, &cluster);
+        if((r == 0) && (FS_FATX_IsClusterValid(pVolume, cluster) == 0))
+        {
+            r = FS_ERRCODE_INVALID_CLUSTER_CHAIN;
+        }
+        if((r == 0) && (!add_cluster(pMap, cluster)))
+        {
+            r = FS_ERRCODE_INVALID_PARA;    /* No extents. */
+        }
+    }
+    else
+    {
+        cluster = get_last_cluster(pMap);
+    }
+    while((r == 0) && (pMap->NumClustersMapped <= file_cluster))
+    {
+        r = get_next_cluster(pVolume, cluster, &cluster);
+        if((r == 0) && (!add_cluster(pMap, cluster)))
+        {
+            break;
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       locate
+*
+*  Function description
+*    Returns the position of a cluster of the file on the volume.
+*
+*  Parameters
+*    pMap           Extent map of the file.
+*    file_cluster   Index of the cluster in the file.
+*    pCluster       [OUT] Id of the cluster.
+*    pNumClusters   [OUT] Number of clusters starting with pCluster
+*                   that are stored one after the other.
+*    pCursor        [IN/OUT] Position in the cluster chain after the
+*                   end of the map.
+*
+*  Additional information
+*    The extent is searched via binary search. The cluster chain is
+*    followed only for the clusters after the end of a full map,
+*    starting at the cursor. The cursor is advanced so that the chain
+*    is followed only once per read operation. file_cluster must not
+*    be smaller than the cluster of the cursor.
+*/
+static int locate(FS_FILE_EXTENT_MAP * pMap, U32 file_cluster, U32 * pCluster, U32 * pNumClusters, extent_cursor_t * pCursor)
+{
+    int r = 0;
+
+    if(file_cluster < pMap->NumClustersMapped)
+    {
+        U32 lo = 0U;
+        U32 hi = pMap->NumExtents - 1U;
+        const FS_FILE_EXTENT * pExtent;
+
+        while(lo < hi)
+        {
+            U32 mid = (lo + hi + 1U) / 2U;
+
+            if(pMap->paExtent[mid].FileCluster <= file_cluster)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1U;
+            }
+        }
+        pExtent = &pMap->paExtent[lo];
+        *pCluster     = pExtent->Cluster + (file_cluster - pExtent->FileCluster);
+        *pNumClusters = pExtent->NumClusters - (file_cluster - pExtent->FileCluster);
+    }
+    else
+    {
+        while((r == 0) && (pCursor->FileCluster < file_cluster))
+        {
+            r = get_next_cluster(&pMap->Volume, pCursor->Cluster, &pCursor->Cluster);
+            pCursor->FileCluster++;
+        }
+        *pCluster     = pCursor->Cluster;
+        *pNumClusters = 1U;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       read_mapped
+*/
+static U32 read_mapped(FS_FILE_EXTENT_MAP * pMap, U32 offset, U8 * pData, U32 num_bytes)
+{
+    FS_FATX_VOLUME * pVolume = &pMap->Volume;
+    U32 bytes_per_sector  = pVolume->BytesPerSector;
+    U32 bytes_per_cluster = bytes_per_sector * pVolume->SectorsPerCluster;
+    U32 num_bytes_read = 0U;
+    extent_cursor_t cursor;
+    int r;
+
+    r = extend_map(pMap, (offset + num_bytes - 1U) / bytes_per_cluster);
+    if(r == 0)
+    {
+        cursor.FileCluster = pMap->NumClustersMapped - 1U;
+        cursor.Cluster     = get_last_cluster(pMap);
+    }
+    while((r == 0) && (num_bytes != 0U))
+    {
+        U32 cluster;
+        U32 num_clusters;
+        U32 sector_in_cluster = (offset % bytes_per_cluster) / bytes_per_sector;
+        U32 off_in_sector     = offset % bytes_per_sector;
+        U32 sector_index;
+        U32 n;
+
+        r = locate(pMap, offset / bytes_per_cluster, &cluster, &num_clusters, &cursor);
+        if(r != 0)
+        {
+            break;
+        }
+        sector_index = FS_FATX_ClusterToSector(pVolume, cluster) + sector_in_cluster;
+        if((off_in_sector != 0U) || (num_bytes < bytes_per_sector))
+        {
+            r = FS_FATX_ReadSector(pVolume, sector_index);
+            n = SEGGER_MIN(bytes_per_sector - off_in_sector, num_bytes);
+            if(r == 0)
+            {
+                FS_MEMCPY(pData, pVolume->pData + off_in_sector, n);
+            }
+        }
+        else
+        {
+            U32 num_sectors = SEGGER_MIN(num_bytes / bytes_per_sector, (num_clusters * pVolume->SectorsPerCluster) - sector_in_cluster);
+
+            r = FS_STORAGE_ReadSectors(pVolume->acVolumeName, pData, sector_index, num_sectors);
+            n = num_sectors * bytes_per_sector;
+        }
+        if(r == 0)
+        {
+            pData          += n;
+            offset         += n;
+            num_bytes      -= n;
+            num_bytes_read += n;
+        }
+    }
+
+    return num_bytes_read;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 3,\
+'The third-party defines the function interface with basic numeral type')
+
+/*********************************************************************
+*
+*       FS_EnableExtentMap
+*
+*  Function description
+*    Enables the extent map for an opened file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    sFileName  Fully qualified name of the opened file.
+*    pMap       Control structure of the map. Has to remain valid
+*               until FS_DisableExtentMap() is called.
+*    paExtent   Storage for the extents. Has to remain valid until
+*               FS_DisableExtentMap() is called.
+*    MaxExtents Number of elements in paExtent.
+*
+*  Return value
+*    ==0    OK, map enabled.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The map is empty after this call and is extended on demand by
+*    FS_ReadMapped(). One extent describes any number of clusters
+*    stored one after the other, so that a file allocated via
+*    FS_AllocateFile() requires only one extent. When all the extents
+*    are used, the clusters after the last mapped one are located by
+*    following the cluster chain from the end of the map.
+*
+*    The map has to be disabled via FS_DisableExtentMap() before the
+*    file is closed. FS_InvalidateExtentMap() has to be called after
+*    the file is truncated. The file must not be renamed or moved
+*    while the map is enabled.
+*/
+int FS_EnableExtentMap(FS_FILE * pFile, const char * sFileName, FS_FILE_EXTENT_MAP * pMap, FS_FILE_EXTENT * paExtent, unsigned MaxExtents)
+{
+    FS_FATX_DIRENTRY entry;
+    const char * sPath;
+    int r;
+
+    if((pFile == NULL) || (sFileName == NULL) || (pMap == NULL) || (paExtent == NULL) || (MaxExtents == 0U))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = FS_FATX_Lock();
+    }
+    if(r == 0)
+    {
+        if(find_map(pFile) != NULL)
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            r = FS_FATX_Begin(&pMap->Volume, sFileName, &sPath);
+        }
+        if(r == 0)
+        {
+            r = FS_FATX_FindEntry(&pMap->Volume, sPath, &entry);
+            if((r == 0) && ((entry.Attributes & FS_ATTR_DIRECTORY) != 0U))
+            {
+                r = FS_ERRCODE_INVALID_USAGE;
+            }
+            FS_FATX_End(&pMap->Volume);
+        }
+        if(r == 0)
+        {
+            pMap->pFile             = pFile;
+            pMap->paExtent          = paExtent;
+            pMap->MaxExtents        = MaxExtents;
+            pMap->NumExtents        = 0U;
+            pMap->NumClustersMapped = 0U;
+            pMap->DirSectorIndex    = entry.SectorIndex;
+            pMap->DirOffset         = entry.Offset;
+            pMap->pNext             = extent_maps;
+            extent_maps = pMap;
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_DisableExtentMap
+*
+*  Function description
+*    Disables the extent map of a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*
+*  Return value
+*    ==0    OK, map disabled. The memory of the map can be reused.
+*    !=0    Error code indicating the failure reason.
+*/
+int FS_DisableExtentMap(FS_FILE * pFile)
+{
+    int r;
+
+    r = FS_FATX_Lock();
+    if(r == 0)
+    {
+        FS_FILE_EXTENT_MAP ** ppMap = &extent_maps;
+
+        while((*ppMap != NULL) && ((*ppMap)->pFile != pFile))
+        {
+            ppMap = &(*ppMap)->pNext;
+        }
+        if(*ppMap == NULL)
+        {
+            r = FS_ERRCODE_INVALID_PARA;
+        }
+        else
+        {
+            *ppMap = (*ppMap)->pNext;
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_InvalidateExtentMap
+*
+*  Function description
+*    Discards the extents of a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*
+*  Return value
+*    ==0    OK, the map is rebuilt on the next read.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Has to be called when clusters of the file are freed, for example
+*    after FS_Truncate() or FS_SetFileSize() with a smaller size.
+*    Clusters added to the end of the file do not require this call.
+*/
+int FS_InvalidateExtentMap(FS_FILE * pFile)
+{
+    int r;
+
+    r = FS_FATX_Lock();
+    if(r == 0)
+    {
+        FS_FILE_EXTENT_MAP * pMap = find_map(pFile);
+
+        if(pMap == NULL)
+        {
+            r = FS_ERRCODE_INVALID_PARA;
+        }
+        else
+        {
+            pMap->NumExtents        = 0U;
+            pMap->NumClustersMapped = 0U;
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_ReadMapped
+*
+*  Function description
+*    Reads data from a file at a given offset using its extent map.
+*
+*  Parameters
+*    pFile      Handle to an opened file with an enabled extent map.
+*    Offset     Byte offset in the file to read from.
+*    pData      [OUT] Data read from the file.
+*    NumBytes   Number of bytes to read.
+*
+*  Return value
+*    Number of bytes read. Less than NumBytes at the end of the file
+*    or in case of an error.
+*
+*  Additional information
+*    The file position is not changed. The data is read from the
+*    storage layer: sectors that are entirely inside the requested
+*    range are transferred directly into pData with one read per
+*    extent, the others via the work buffer of the extension.
+*    The file is synchronized first, so that data written via the
+*    same handle is read back.
+*/
+U32 FS_ReadMapped(FS_FILE * pFile, U32 Offset, void * pData, U32 NumBytes)
+{
+    FS_FILE_EXTENT_MAP * pMap;
+    U32 num_bytes_read = 0U;
+
+    if((pData != NULL) && (FS_FATX_Lock() == 0))
+    {
+        pMap = find_map(pFile);
+        if(pMap != NULL)
+        {
+            U32 file_size;
+
+            FS_FATX_Resume(&pMap->Volume);
+            if(FS_SyncFile(pFile) == 0)
+            {
+                file_size = FS_GetFileSize(pFile);
+                if(Offset < file_size)
+                {
+                    NumBytes = SEGGER_MIN(NumBytes, file_size - Offset);
+                    if(NumBytes != 0U)
+                    {
+                        num_bytes_read = read_mapped(pMap, Offset, (U8 *)pData, NumBytes);
+                    }
+                }
+            }
+            FS_FATX_End(&pMap->Volume);
+        }
+        FS_FATX_Unlock();
+    }
+
+    return num_bytes_read;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,858 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_FreeMap.c
+Purpose     : Map of the free clusters of a volume. The map holds one
+              bit per cluster in RAM, so that the number of free
+              clusters is known without reading the allocation table.
+              A checkpoint of the map is stored in a file in the root
+              directory and loaded after the volume is mounted.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define CHECKPOINT_MAGIC            0x50414D46U     /* "FMAP" */
+#define CHECKPOINT_SIZE_OF_HEADER   32U
+
+/* Byte offsets in the header of the checkpoint file. */
+#define CHECKPOINT_OFF_MAGIC        0U
+#define CHECKPOINT_OFF_NUM_CLUSTERS 4U
+#define CHECKPOINT_OFF_FIRST_SECTOR 8U      /* Index of the first data sector, identifies the layout of the volume. */
+#define CHECKPOINT_OFF_NUM_FREE     12U
+#define CHECKPOINT_OFF_CHECKSUM     16U
+#define CHECKPOINT_OFF_IS_VALID     20U
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    char   acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    U8   * pBits;                   /* One bit per cluster, set if the cluster is free. */
+    U32    NumBytes;                /* Capacity of pBits in bytes. */
+    U32    NumClusters;             /* Number of clusters in the map, 0 if no volume is mapped. */
+    U32    NumClustersFree;
+    U32    FirstSectorData;
+    U32    BytesPerCluster;
+    U32    RefreshIndex;            /* Index of the next cluster checked by FS_RefreshFreeMap(). */
+    bool   IsCheckpointValid;       /* Set if the checkpoint file is marked as valid. */
+    bool   IsCheckpointStale;       /* Set if the map has changed since the checkpoint was written. */
+} freemap_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static freemap_t freemap;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       get_le32
+*/
+static U32 get_le32(const U8 * data)
+{
+    return (U32)data[0] | ((U32)data[1] << 8) | ((U32)data[2] << 16) | ((U32)data[3] << 24);
+}
+
+/*********************************************************************
+*
+*       put_le32
+*/
+static void put_le32(U8 * data, U32 value)
+{
+    data[0] = (U8)value;
+    data[1] = (U8)(value >> 8);
+    data[2] = (U8)(value >> 16);
+    data[3] = (U8)(value >> 24);
+}
+
+/*********************************************************************
+*
+*       is_free
+*/
+static bool is_free(U32 index)
+{
+    return (freemap.pBits[index >> 3] & (1U << (index & 7U))) != 0U;
+}
+
+/*********************************************************************
+*
+*       set_free
+*
+*  Function description
+*    Updates the state of a cluster in the map.
+*
+*  Return value
+*    true     The state has changed.
+*    false    The state is unchanged.
+*/
+static bool set_free(U32 index, bool IsFree)
+{
+    U8 mask = (U8)(1U << (index & 7U));
+    bool is_changed = (is_free(index) != IsFree);
+
+    if(is_changed)
+    {
+        freemap.pBits[index >> 3] ^= mask;
+        freemap.IsCheckpointStale  = freemap.IsCheckpointValid;
+        if(IsFree)
+        {
+            freemap.NumClustersFree++;
+        }
+        else
+        {
+            freemap.NumClustersFree--;
+        }
+    }
+
+    return is_changed;
+}
+
+/*********************************************************************
+*
+*       calc_size_of_map
+*/
+static U32 calc_size_of_map(U32 NumClusters)
+{
+    return (NumClusters + 7U) >> 3;
+}
+
+/*********************************************************************
+*
+*       calc_checksum
+*/
+static U32 calc_checksum(const U8 * pData, U32 NumBytes)
+{
+    U32 sum = 0U;
+
+    for(U32 i = 0U; i < NumBytes; i++)
+    {
+        sum = ((sum << 1) | (sum >> 31)) + pData[i];
+    }
+
+    return sum;
+}
+
+/*********************************************************************
+*
+*       is_mapped
+*
+*  Function description
+*    Checks if the map describes the specified volume.
+*/
+static bool is_mapped(const char * sVolumeName)
+{
+    return (freemap.NumClusters != 0U) && (FS_STRCMP(freemap.acVolumeName, sVolumeName) == 0);
+}
+
+/*********************************************************************
+*
+*       get_file_name
+*
+*  Function description
+*    Returns the fully qualified name of the checkpoint file.
+*/
+static int get_file_name(const char * sVolumeName, char * sFileName, U32 SizeOfFileName)
+{
+    U32 len = (U32)FS_STRLEN(sVolumeName);
+    int r = FS_ERRCODE_INVALID_PARA;
+
+    if((len + sizeof(FS_FATX_FREEMAP_FILE_NAME) + 1U) <= SizeOfFileName)
+    {
+        FS_STRCPY(sFileName, sVolumeName);
+        sFileName[len] = FS_DIRECTORY_DELIMITER;
+        FS_STRCPY(&sFileName[len + 1U], FS_FATX_FREEMAP_FILE_NAME);
+        r = 0;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       scan
+*
+*  Function description
+*    Builds the map from the allocation table.
+*/
+static int scan(const char * sVolumeName)
+{
+    FS_FATX_VOLUME volume;
+    int r;
+
+    freemap.NumClusters = 0U;
+    r = FS_FATX_Begin(&volume, sVolumeName, NULL);
+    if(r == 0)
+    {
+        if(calc_size_of_map(volume.NumClusters) > freemap.NumBytes)
+        {
+            r = FS_ERRCODE_BUFFER_TOO_SMALL;
+        }
+        else
+        {
+            FS_MEMSET(freemap.pBits, 0, calc_size_of_map(volume.NumClusters));
+            freemap.NumClustersFree = 0U;
+            for(U32 i = 0U; i < volume.NumClusters; i++)
+            {
+                U32 value;
+
+                r = FS_FATX_GetFATEntry(&volume, i + 2U, &value);
+                if(r != 0)
+                {
+                    break;
+                }
+                (void) set_free(i, value == 0U);
+            }
+        }
+        if(r == 0)
+        {
+            FS_STRCPY(freemap.acVolumeName, volume.acVolumeName);
+            freemap.NumClusters     = volume.NumClusters;
+            freemap.FirstSectorData = volume.FirstSectorData;
+            freemap.BytesPerCluster = (U32)volume.BytesPerSector * volume.SectorsPerCluster;
+            freemap.RefreshIndex    = 0U;
+        }
+        FS_FATX_End(&volume);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       write_is_valid
+*
+*  Function description
+*    Marks the checkpoint file as valid or invalid.
+*/
+static int write_is_valid(const char * sFileName, bool IsValid)
+{
+    FS_FILE * pFile;
+    U8 abData[4];
+    int r;
+
+    put_le32(abData, IsValid ? 1U : 0U);
+    r = FS_FOpenEx(sFileName, "r+b", &pFile);
+    if(r == 0)
+    {
+        r = FS_FSeek(pFile, (I32)CHECKPOINT_OFF_IS_VALID, FS_SEEK_SET);
+        if((r == 0) && (FS_Write(pFile, abData, sizeof(abData)) != sizeof(abData)))
+        {
+            r = FS_ERRCODE_WRITE_FAILURE;
+        }
+        if(r == 0)
+        {
+            r = FS_FClose(pFile);
+        }
+        else
+        {
+            (void) FS_FClose(pFile);
+        }
+    }
+    freemap.IsCheckpointValid = (r == 0) && IsValid;
+    freemap.IsCheckpointStale = false;
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       load
+*
+*  Function description
+*    Reads the map from the checkpoint file.
+*
+*  Return value
+*    ==0    OK, map loaded.
+*    ==1    No valid checkpoint.
+*    < 0    Error code indicating the failure reason.
+*/
+static int load(const char * sFileName, const FS_FATX_VOLUME * pVolume)
+{
+    FS_FILE * pFile;
+    U8 abHeader[CHECKPOINT_SIZE_OF_HEADER];
+    U32 num_bytes = calc_size_of_map(pVolume->NumClusters);
+    int r;
+
+    freemap.NumClusters = 0U;
+    r = FS_FOpenEx(sFileName, "rb", &pFile);
+    if(r != 0)
+    {
+        r = 1;
+    }
+    else
+    {
+        if(num_bytes > freemap.NumBytes)
+        {
+            r = FS_ERRCODE_BUFFER_TOO_SMALL;
+        }
+        else if((FS_Read(pFile, abHeader, sizeof(abHeader)) != sizeof(abHeader))
+             || (get_le32(&abHeader[CHECKPOINT_OFF_MAGIC])        != CHECKPOINT_MAGIC)
+             || (get_le32(&abHeader[CHECKPOINT_OFF_NUM_CLUSTERS]) != pVolume->NumClusters)
+             || (get_le32(&abHeader[CHECKPOINT_OFF_FIRST_SECTOR]) != pVolume->FirstSectorData)
+             || (get_le32(&abHeader[CHECKPOINT_OFF_IS_VALID])     != 1U)
+             || (FS_Read(pFile, freemap.pBits, num_bytes) != num_bytes)
+             || (get_le32(&abHeader[CHECKPOINT_OFF_CHECKSUM])     != calc_checksum(freemap.pBits, num_bytes)))
+        {
+            r = 1;
+        }
+        else
+        {
+            /* Valid checkpoint. */
+        }
+        (void) FS_FClose(pFile);
+    }
+    if(r == 0)
+    {
+        FS_STRCPY(freemap.acVolumeName, pVolume->acVolumeName);
+        freemap.NumClusters     = pVolume->NumClusters;
+        freemap.NumClustersFree = get_le32(&abHeader[CHECKPOINT_OFF_NUM_FREE]);
+        freemap.FirstSectorData = pVolume->FirstSectorData;
+        freemap.BytesPerCluster = (U32)pVolume->BytesPerSector * pVolume->SectorsPerCluster;
+        freemap.RefreshIndex    = 0U;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       save
+*
+*  Function description
+*    Writes the map to the checkpoint file.
+*/
+static int save(const char * sFileName)
+{
+    FS_FILE * pFile;
+    U8 abHeader[CHECKPOINT_SIZE_OF_HEADER];
+    U32 num_bytes = calc_size_of_map(freemap.NumClusters);
+    int r;
+
+    FS_MEMSET(abHeader, 0, sizeof(abHeader));
+    put_le32(&abHeader[CHECKPOINT_OFF_MAGIC],        CHECKPOINT_MAGIC);
+    put_le32(&abHeader[CHECKPOINT_OFF_NUM_CLUSTERS], freemap.NumClusters);
+    put_le32(&abHeader[CHECKPOINT_OFF_FIRST_SECTOR], freemap.FirstSectorData);
+    put_le32(&abHeader[CHECKPOINT_OFF_NUM_FREE],     freemap.NumClustersFree);
+    put_le32(&abHeader[CHECKPOINT_OFF_CHECKSUM],     calc_checksum(freemap.pBits, num_bytes));
+    put_le32(&abHeader[CHECKPOINT_OFF_IS_VALID],     1U);
+    r = FS_FOpenEx(sFileName, "r+b", &pFile);
+    if(r == 0)
+    {
+        /* The map is written before the header, so that an interrupted write leaves an invalid checkpoint. */
+        r = FS_FSeek(pFile, (I32)CHECKPOINT_SIZE_OF_HEADER, FS_SEEK_SET);
+        if((r == 0) && (FS_Write(pFile, freemap.pBits, num_bytes) != num_bytes))
+        {
+            r = FS_ERRCODE_WRITE_FAILURE;
+        }
+        if(r == 0)
+        {
+            r = FS_FSeek(pFile, 0, FS_SEEK_SET);
+        }
+        if((r == 0) && (FS_Write(pFile, abHeader, sizeof(abHeader)) != sizeof(abHeader)))
+        {
+            r = FS_ERRCODE_WRITE_FAILURE;
+        }
+        if(r == 0)
+        {
+            r = FS_FClose(pFile);
+        }
+        else
+        {
+            (void) FS_FClose(pFile);
+        }
+    }
+    freemap.IsCheckpointValid = (r == 0);
+    freemap.IsCheckpointStale = false;
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_free_run
+*
+*  Function description
+*    Searches the map for contiguous free clusters. Called by
+*    FS_FATX_FindFreeRun() with the volume locked.
+*
+*  Additional information
+*    The clusters of a run found in the map are checked in the
+*    allocation table. Clusters that have been allocated since the
+*    map was updated are marked as such and the search continues.
+*    The allocation table is searched if the map has no run large
+*    enough, because clusters freed since the last update are not
+*    marked in the map.
+*/
+static int find_free_run(FS_FATX_VOLUME * pVolume, U32 NumClusters, U32 * pStartCluster)
+{
+    U32 num_free = 0U;
+    U32 i = 0U;
+    int r = 1;
+
+    if(is_mapped(pVolume->acVolumeName) && (freemap.FirstSectorData == pVolume->FirstSectorData) && (freemap.NumClusters == pVolume->NumClusters) && (NumClusters != 0U))
+    {
+        while(i < freemap.NumClusters)
+        {
+            if(((i & 7U) == 0U) && (num_free == 0U) && (freemap.pBits[i >> 3] == 0U))
+            {
+                i += 8U;                /* Eight allocated clusters. */
+            }
+            else if(!is_free(i))
+            {
+                num_free = 0U;
+                i++;
+            }
+            else
+            {
+                num_free++;
+                i++;
+                if(num_free >= NumClusters)
+                {
+                    U32 first = i - num_free;
+                    U32 j;
+
+                    for(j = first; j < i; j++)
+                    {
+                        U32 value;
+
+                        r = FS_FATX_GetFATEntry(pVolume, j + 2U, &value);
+                        if((r != 0) || (value != 0U))
+                        {
+                            break;
+                        }
+                    }
+                    if(r != 0)
+                    {
+                        break;
+                    }
+                    if(j == i)
+                    {
+                        *pStartCluster = first + 2U;
+                        break;
+                    }
+                    (void) set_free(j, false);
+                    num_free = 0U;
+                    i        = j + 1U;
+                    r        = 1;
+                }
+            }
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 2,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_FATX_ConfigFreeMap
+****************************************************************************//**
+*
+*  Sets the memory for the map of free clusters. The map describes one
+*  volume at a time and is filled by FS_LoadFreeMap().
+*
+*  Parameters
+*   pBuffer     Memory for the map or NULL to disable the map. One byte
+*               is required for every eight clusters of the volume.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_FATX_RESULT_OK          Configured successfully.
+*   FS_FATX_RESULT_BADPARAM    Buffer too small or the extension is not initialized.
+*
+*******************************************************************************/
+FS_FATX_Result_t FS_FATX_ConfigFreeMap(void * pBuffer, U32 NumBytes)
+{
+    FS_FATX_Result_t result = FS_FATX_RESULT_BADPARAM;
+
+    if(((pBuffer == NULL) || (NumBytes != 0U)) && (FS_FATX_Lock() == 0))
+    {
+        FS_FATX_SetFreeRunFunc(NULL);
+        FS_MEMSET(&freemap, 0, sizeof(freemap));
+        if(pBuffer != NULL)
+        {
+            freemap.pBits    = (U8 *)pBuffer;
+            freemap.NumBytes = NumBytes;
+            FS_FATX_SetFreeRunFunc(find_free_run);
+        }
+        FS_FATX_Unlock();
+        result = FS_FATX_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_LoadFreeMap
+*
+*  Function description
+*    Fills the map of free clusters for a volume.
+*
+*  Parameters
+*    sVolumeName    Name of the volume, e.g. "mmc:0:".
+*
+*  Return value
+*    ==0    OK, the map was loaded from the checkpoint file.
+*    ==1    OK, the map was built from the allocation table.
+*    < 0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The map is loaded from the checkpoint file written by
+*    FS_UnmountFreeMap() if the file is marked as valid. The file is
+*    then marked as invalid, so that the map is built again from the
+*    allocation table if the volume is not unmounted via
+*    FS_UnmountFreeMap(), for example because of a power failure.
+*    Building the map reads the entire allocation table.
+*
+*    The function has to be called after the volume is mounted and
+*    before it is modified. A checkpoint is trusted only if the volume
+*    has not been modified since FS_UnmountFreeMap() wrote it. The
+*    extension cannot detect modifications made by an application
+*    that does not follow this rule or by other systems, for example
+*    by a PC the storage card was inserted in. The checkpoint file
+*    has to be deleted in this case.
+*
+*    The map replaces the map of any other volume.
+*/
+int FS_LoadFreeMap(const char * sVolumeName)
+{
+    FS_FATX_VOLUME volume;
+    char acFileName[FS_FATX_MAX_LEN_VOLUME_NAME + sizeof(FS_FATX_FREEMAP_FILE_NAME) + 1U];
+    int r;
+
+    r = FS_FATX_Lock();
+    if(r == 0)
+    {
+        if(freemap.pBits == NULL)
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            r = FS_FATX_Begin(&volume, sVolumeName, NULL);
+        }
+        if(r == 0)
+        {
+            FS_FATX_End(&volume);
+            r = get_file_name(volume.acVolumeName, acFileName, sizeof(acFileName));
+        }
+        if(r == 0)
+        {
+            (void) FS_FATX_LockVolume(volume.acVolumeName);
+            r = load(acFileName, &volume);
+            if(r == 0)
+            {
+                r = write_is_valid(acFileName, false);
+                if(r != 0)
+                {
+                    freemap.NumClusters = 0U;
+                }
+            }
+            else if(r == 1)
+            {
+                freemap.IsCheckpointValid = false;
+                r = scan(volume.acVolumeName);
+                r = (r == 0) ? 1 : r;
+            }
+            else
+            {
+                /* Error. */
+            }
+            FS_FATX_UnlockVolume(volume.acVolumeName);
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_UnmountFreeMap
+*
+*  Function description
+*    Writes a checkpoint of the map of free clusters to a volume and
+*    unmounts the volume.
+*
+*  Parameters
+*    sVolumeName    Name of the volume, e.g. "mmc:0:".
+*
+*  Return value
+*    ==0    OK, checkpoint written and volume unmounted.
+*    !=0    Error code indicating the failure reason. The volume is
+*           unmounted anyway.
+*
+*  Additional information
+*    The function is intended to be called instead of FS_Unmount()
+*    before the power is switched off or the storage card is removed.
+*    The checkpoint file is created in the root directory if necessary
+*    and the map is built again from the allocation table, so that the
+*    checkpoint describes the volume exactly. The volume remains locked
+*    from the scan of the allocation table until it is unmounted, so
+*    that no other task can modify it after the checkpoint is written.
+*    Open files are closed by the unmount.
+*
+*    The map remains in RAM and can be used again after the volume is
+*    mounted and FS_LoadFreeMap() is called.
+*/
+int FS_UnmountFreeMap(const char * sVolumeName)
+{
+    FS_FATX_VOLUME volume;
+    char acFileName[FS_FATX_MAX_LEN_VOLUME_NAME + sizeof(FS_FATX_FREEMAP_FILE_NAME) + 1U];
+    int r;
+
+    r = FS_FATX_Lock();
+    if(r == 0)
+    {
+        if(freemap.pBits == NULL)
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            r = FS_FATX_Begin(&volume, sVolumeName, NULL);
+        }
+        if(r == 0)
+        {
+            FS_FATX_End(&volume);
+            r = get_file_name(volume.acVolumeName, acFileName, sizeof(acFileName));
+        }
+        if(r == 0)
+        {
+            (void) FS_FATX_LockVolume(volume.acVolumeName);
+            r = FS_AllocateFile(acFileName, CHECKPOINT_SIZE_OF_HEADER + calc_size_of_map(volume.NumClusters), 0U);
+            r = (r == 1) ? 0 : r;       /* The checkpoint file does not have to be contiguous. */
+            if(r == 0)
+            {
+                r = FS_SetFileAttributes(acFileName, FS_ATTR_HIDDEN | FS_ATTR_SYSTEM);
+            }
+            if(r == 0)
+            {
+                r = scan(volume.acVolumeName);
+            }
+            if(r == 0)
+            {
+                r = save(acFileName);
+            }
+            if(r == 0)
+            {
+                r = FS_Sync(volume.acVolumeName);
+            }
+            FS_Unmount(volume.acVolumeName);
+            FS_FATX_UnlockVolume(volume.acVolumeName);
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_RefreshFreeMap
+*
+*  Function description
+*    Compares a part of the map of free clusters with the allocation
+*    table.
+*
+*  Parameters
+*    sVolumeName    Name of the volume, e.g. "mmc:0:".
+*    NumClusters    Number of clusters to be checked.
+*
+*  Return value
+*    >=0    OK, number of clusters whose state has changed.
+*    < 0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The map is not updated when the file system allocates or frees
+*    clusters. This function is intended to be called periodically,
+*    for example from an idle task. Each call checks the next
+*    NumClusters clusters and wraps around at the end of the volume,
+*    so the map is exact after all the clusters have been checked
+*    once since the last modification. If the checkpoint file is still
+*    marked as valid, because the volume was mounted again without
+*    calling FS_LoadFreeMap(), it is marked as invalid when the first
+*    change is found here or by a search for free clusters.
+*
+*    FS_ERRCODE_INVALID_USAGE is returned and the map is discarded
+*    if the volume has been formatted or replaced. FS_LoadFreeMap()
+*    has to be called in this case.
+*/
+int FS_RefreshFreeMap(const char * sVolumeName, U32 NumClusters)
+{
+    FS_FATX_VOLUME volume;
+    char acFileName[FS_FATX_MAX_LEN_VOLUME_NAME + sizeof(FS_FATX_FREEMAP_FILE_NAME) + 1U];
+    int num_changed = 0;
+    int r;
+
+    r = FS_FATX_Lock();
+    if(r == 0)
+    {
+        r = FS_FATX_Begin(&volume, sVolumeName, NULL);
+        if(r == 0)
+        {
+            if((!is_mapped(volume.acVolumeName)) || (freemap.NumClusters != volume.NumClusters) || (freemap.FirstSectorData != volume.FirstSectorData))
+            {
+                freemap.NumClusters = 0U;
+                r = FS_ERRCODE_INVALID_USAGE;
+            }
+            for(U32 i = 0U; (r == 0) && (i < SEGGER_MIN(NumClusters, freemap.NumClusters)); i++)
+            {
+                U32 value;
+
+                r = FS_FATX_GetFATEntry(&volume, freemap.RefreshIndex + 2U, &value);
+                if((r == 0) && set_free(freemap.RefreshIndex, value == 0U))
+                {
+                    num_changed++;
+                }
+                freemap.RefreshIndex = ((freemap.RefreshIndex + 1U) < freemap.NumClusters) ? (freemap.RefreshIndex + 1U) : 0U;
+            }
+            FS_FATX_End(&volume);
+        }
+        if((r == 0) && freemap.IsCheckpointStale)
+        {
+            r = get_file_name(volume.acVolumeName, acFileName, sizeof(acFileName));
+            if(r == 0)
+            {
+                r = write_is_valid(acFileName, false);
+            }
+        }
+        FS_FATX_Unlock();
+    }
+
+    return (r == 0) ? num_changed : r;
+}
+
+/*********************************************************************
+*
+*       FS_GetFreeMapSpace
+*
+*  Function description
+*    Returns the number of free clusters recorded in the map.
+*
+*  Parameters
+*    sVolumeName        Name of the volume, e.g. "mmc:0:".
+*    pNumClustersFree   [OUT] Number of free clusters.
+*    pBytesPerCluster   [OUT] Size of a cluster in bytes. Can be NULL.
+*
+*  Return value
+*    ==0    OK, information returned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The function does not access the storage device. The value reflects the allocation table at the
+*    time the map was loaded, plus the changes found by
+*    FS_RefreshFreeMap() since then. The free space in bytes is
+*    *pNumClustersFree * *pBytesPerCluster; it can exceed the range
+*    of a U32.
+*/
+int FS_GetFreeMapSpace(const char * sVolumeName, U32 * pNumClustersFree, U32 * pBytesPerCluster)
+{
+    char acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    int r;
+
+    if((sVolumeName == NULL) || (pNumClustersFree == NULL) || (FS_STRLEN(sVolumeName) >= FS_FATX_MAX_LEN_VOLUME_NAME))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        FS_STRCPY(acVolumeName, sVolumeName);
+        FS_FATX_ResolveVolumeName(acVolumeName);
+        r = FS_FATX_Lock();
+    }
+    if(r == 0)
+    {
+        if(!is_mapped(acVolumeName))
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            *pNumClustersFree = freemap.NumClustersFree;
+            if(pBytesPerCluster != NULL)
+            {
+                *pBytesPerCluster = freemap.BytesPerCluster;
+            }
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
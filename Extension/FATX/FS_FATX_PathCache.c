@@ -0,0 +1,476 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FATX_PathCache.c
+Purpose     : Cache of the first clusters of recently used directories.
+              The cache maps a directory path to the first cluster of
+              the directory, so that the search of a path can start in
+              its deepest cached parent directory instead of the root
+              directory.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FATX.h"
+#include "cy_utils.h"
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define DELIMITER               '\\'    /* Delimiter of the normalized paths. */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    char   acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    char   acPath[FS_FATX_PATHCACHE_MAX_LEN];     /* Normalized path of the directory. */
+    U32    Len;                 /* Number of characters in acPath, 0 if the entry is free. */
+    U32    DirCluster;
+    U32    ParentCluster;       /* First cluster of the parent directory, 0 for the root directory of FAT12/16. */
+    U32    StartCluster;        /* Position of the entry of the directory in the parent directory. */
+    U32    StartEntryIndex;
+    U32    EntryIndex;          /* Index of the short entry of the directory in the parent directory. */
+    U32    LastUse;
+} pathcache_entry_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static pathcache_entry_t * pathcache_entries;
+static U32                 pathcache_num_entries;
+static U32                 pathcache_clock;
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       is_path_delimiter
+*/
+static bool is_path_delimiter(char c)
+{
+    return (c == FS_DIRECTORY_DELIMITER) || (c == '/') || (c == '\\');
+}
+
+/*********************************************************************
+*
+*       normalize
+*
+*  Function description
+*    Converts the leading components of a path into the format stored
+*    in the cache: upper case ASCII letters, no leading or trailing
+*    delimiters and one delimiter between the components.
+*
+*  Parameters
+*    sPath              Path to be converted.
+*    max_components     Maximum number of components to be converted.
+*    sBuffer            [OUT] Normalized path (0-terminated).
+*    pIsComplete        [OUT] Set to false if the path has more
+*                       components than converted. Can be NULL.
+*
+*  Return value
+*    Number of characters in sBuffer. Only entire components are
+*    converted that fit into FS_FATX_PATHCACHE_MAX_LEN.
+*/
+static U32 normalize(const char * sPath, U32 max_components, char * sBuffer, bool * pIsComplete)
+{
+    U32 len = 0U;
+    U32 num_components = 0U;
+
+    for(;;)
+    {
+        U32 len_component = 0U;
+        U32 pos = (len != 0U) ? (len + 1U) : 0U;
+
+        while(is_path_delimiter(*sPath))
+        {
+            sPath++;
+        }
+        while((sPath[len_component] != '\0') && (!is_path_delimiter(sPath[len_component])))
+        {
+            len_component++;
+        }
+        if((len_component == 0U) || (num_components == max_components) || ((pos + len_component) >= FS_FATX_PATHCACHE_MAX_LEN))
+        {
+            break;
+        }
+        if(len != 0U)
+        {
+            sBuffer[len] = DELIMITER;
+        }
+        for(U32 i = 0U; i < len_component; i++)
+        {
+            char c = sPath[i];
+
+            sBuffer[pos + i] = ((c >= 'a') && (c <= 'z')) ? (char)(c - ('a' - 'A')) : c;
+        }
+        len = pos + len_component;
+        sPath += len_component;
+        num_components++;
+    }
+    sBuffer[len] = '\0';
+    if(pIsComplete != NULL)
+    {
+        while(is_path_delimiter(*sPath))
+        {
+            sPath++;
+        }
+        *pIsComplete = (*sPath == '\0');
+    }
+
+    return len;
+}
+
+/*********************************************************************
+*
+*       count_components
+*/
+static U32 count_components(const char * sPath)
+{
+    U32 num_components = 1U;
+
+    for(U32 i = 0U; sPath[i] != '\0'; i++)
+    {
+        if(sPath[i] == DELIMITER)
+        {
+            num_components++;
+        }
+    }
+
+    return num_components;
+}
+
+/*********************************************************************
+*
+*       is_dir_valid
+*
+*  Function description
+*    Checks if a cached directory still exists under its cached name.
+*
+*  Additional information
+*    The entry of the directory is read at the cached position in the
+*    parent directory. Its name and first cluster have to match, so a
+*    directory that has been removed is detected even if its clusters
+*    have been reused by another directory.
+*/
+static bool is_dir_valid(FS_FATX_VOLUME * pVolume, const pathcache_entry_t * pCached)
+{
+    char acName[FS_FATX_PATHCACHE_MAX_LEN];
+    const char * sName = pCached->acPath;
+    FS_FATX_DIRENTRY entry;
+    FS_FATX_DIR dir;
+    bool r = false;
+
+    for(U32 i = 0U; i < pCached->Len; i++)
+    {
+        if(pCached->acPath[i] == DELIMITER)
+        {
+            sName = &pCached->acPath[i + 1U];
+        }
+    }
+    if((pCached->StartCluster == 0U) || (FS_FATX_IsClusterValid(pVolume, pCached->StartCluster) != 0))
+    {
+        FS_FATX_SeekDir(&dir, pVolume, pCached->ParentCluster, pCached->StartCluster, pCached->StartEntryIndex);
+        if(FS_FATX_ReadDirEntry(&dir, &entry, acName, sizeof(acName)) == 0)
+        {
+            r = (entry.EntryIndex == pCached->EntryIndex) && (entry.FirstCluster == pCached->DirCluster) &&
+                ((entry.Attributes & FS_ATTR_DIRECTORY) != 0U) &&
+                (FS_FATX_IsNameEqual(acName, &entry, sName, (U32)FS_STRLEN(sName)) != 0);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       find_path
+*
+*  Function description
+*    Returns the deepest cached parent directory of a path.
+*    Called by FS_FATX_FindEntry().
+*/
+static U32 find_path(FS_FATX_VOLUME * pVolume, const char * sPath, U32 * pDirCluster)
+{
+    char acPath[FS_FATX_PATHCACHE_MAX_LEN];
+    pathcache_entry_t * pEntry;
+    bool is_complete;
+    U32 len;
+    U32 num_components = 0U;
+
+    len = normalize(sPath, 0xFFFFFFFFUL, acPath, &is_complete);
+    do
+    {
+        pEntry = NULL;
+        for(U32 i = 0U; i < pathcache_num_entries; i++)
+        {
+            pathcache_entry_t * p = &pathcache_entries[i];
+
+            if((p->Len != 0U) && (p->Len <= len) &&
+               ((acPath[p->Len] == DELIMITER) || ((acPath[p->Len] == '\0') && (!is_complete))) &&
+               ((pEntry == NULL) || (p->Len > pEntry->Len)) &&
+               (FS_MEMCMP(acPath, p->acPath, p->Len) == 0) && (FS_STRCMP(p->acVolumeName, pVolume->acVolumeName) == 0))
+            {
+                pEntry = p;
+            }
+        }
+        if(pEntry != NULL)
+        {
+            if(is_dir_valid(pVolume, pEntry))
+            {
+                pathcache_clock++;
+                pEntry->LastUse = pathcache_clock;
+                *pDirCluster    = pEntry->DirCluster;
+                num_components  = count_components(pEntry->acPath);
+            }
+            else
+            {
+                pEntry->Len = 0U;   /* The directory was removed. */
+            }
+        }
+    } while((pEntry != NULL) && (num_components == 0U));
+
+    return num_components;
+}
+
+/*********************************************************************
+*
+*       add_path
+*
+*  Function description
+*    Stores the first cluster of a directory and the position of its
+*    entry in the cache. Called by FS_FATX_FindEntry().
+*/
+static void add_path(FS_FATX_VOLUME * pVolume, const char * sPath, U32 NumComponents, U32 ParentCluster, const FS_FATX_DIRENTRY * pDirEntry)
+{
+    char acPath[FS_FATX_PATHCACHE_MAX_LEN];
+    pathcache_entry_t * pEntry = NULL;
+    U32 len;
+
+    len = normalize(sPath, NumComponents, acPath, NULL);
+    if((len != 0U) && (count_components(acPath) == NumComponents))
+    {
+        for(U32 i = 0U; i < pathcache_num_entries; i++)
+        {
+            pathcache_entry_t * p = &pathcache_entries[i];
+
+            if((p->Len == len) && (FS_MEMCMP(acPath, p->acPath, len) == 0) && (FS_STRCMP(p->acVolumeName, pVolume->acVolumeName) == 0))
+            {
+                pEntry = p;         /* Already cached. */
+                break;
+            }
+            if((pEntry == NULL) || ((pEntry->Len != 0U) && ((p->Len == 0U) || ((pathcache_clock - p->LastUse) > (pathcache_clock - pEntry->LastUse)))))
+            {
+                pEntry = p;         /* Free or least recently used. */
+            }
+        }
+        pathcache_clock++;
+        FS_STRCPY(pEntry->acVolumeName, pVolume->acVolumeName);
+        FS_MEMCPY(pEntry->acPath, acPath, len + 1U);
+        pEntry->Len             = len;
+        pEntry->DirCluster      = pDirEntry->FirstCluster;
+        pEntry->ParentCluster   = ParentCluster;
+        pEntry->StartCluster    = pDirEntry->StartCluster;
+        pEntry->StartEntryIndex = pDirEntry->StartEntryIndex;
+        pEntry->EntryIndex      = pDirEntry->EntryIndex;
+        pEntry->LastUse         = pathcache_clock;
+    }
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 2,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_FATX_ConfigPathCache
+****************************************************************************//**
+*
+*  Enables the cache of directory paths. The cache is used whenever the
+*  FATX extension resolves a path, for example by FS_LookupFile().
+*
+*  Parameters
+*   pBuffer     Memory for the cache or NULL to disable the cache.
+*               Each cached directory takes FS_FATX_PATHCACHE_MAX_LEN
+*               plus about 50 bytes. Directories whose path is longer
+*               than FS_FATX_PATHCACHE_MAX_LEN - 1 characters are not cached.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_FATX_RESULT_OK          Configured successfully.
+*   FS_FATX_RESULT_BADPARAM    Buffer too small or the extension is not initialized.
+*
+*******************************************************************************/
+FS_FATX_Result_t FS_FATX_ConfigPathCache(void * pBuffer, U32 NumBytes)
+{
+    U32 num_entries = NumBytes / sizeof(pathcache_entry_t);
+    FS_FATX_Result_t result = FS_FATX_RESULT_BADPARAM;
+
+    if(((pBuffer == NULL) || (num_entries != 0U)) && (FS_FATX_Lock() == 0))
+    {
+        FS_FATX_SetPathFuncs(NULL, NULL);
+        pathcache_entries     = NULL;
+        pathcache_num_entries = 0U;
+        if(pBuffer != NULL)
+        {
+            pathcache_entries     = (pathcache_entry_t *)pBuffer;
+            pathcache_num_entries = num_entries;
+            FS_MEMSET(pBuffer, 0, num_entries * sizeof(pathcache_entry_t));
+            FS_FATX_SetPathFuncs(find_path, add_path);
+        }
+        FS_FATX_Unlock();
+        result = FS_FATX_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_InvalidatePathCache
+*
+*  Function description
+*    Removes a directory and its subdirectories from the path cache.
+*
+*  Parameters
+*    sDirName   Fully qualified name of the directory, the name of a
+*               volume to remove all the directories of the volume,
+*               or NULL to empty the cache.
+*
+*  Return value
+*    ==0    OK, directories removed.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Has to be called after a directory is renamed or moved, with the
+*    old name of the directory. A renamed directory is detected by
+*    the cache, but its cached subdirectories are not. Directories
+*    that are removed are detected by the cache, because the entry of
+*    each cached directory is checked when it is used. Calling this
+*    function after FS_RmDir() or FS_DeleteDir() releases the entries
+*    immediately. The cache has to be emptied after a volume is
+*    formatted. Different names of the same volume, for example ""
+*    for the default volume, "mmc:" and "mmc:0:", select the same
+*    directories.
+*/
+int FS_InvalidatePathCache(const char * sDirName)
+{
+    char acPath[FS_FATX_PATHCACHE_MAX_LEN];
+    char acVolumeName[FS_FATX_MAX_LEN_VOLUME_NAME];
+    const char * sPath = sDirName;
+    U32 len_volume = 0U;
+    U32 len = 0U;
+    int r;
+
+    if(sDirName != NULL)
+    {
+        for(U32 i = 0U; sDirName[i] != '\0'; i++)
+        {
+            if(sDirName[i] == ':')
+            {
+                len_volume = i + 1U;
+                sPath      = &sDirName[i + 1U];
+            }
+        }
+    }
+    if(len_volume >= FS_FATX_MAX_LEN_VOLUME_NAME)
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        if(sDirName != NULL)
+        {
+            FS_MEMCPY(acVolumeName, sDirName, len_volume);
+            acVolumeName[len_volume] = '\0';
+            FS_FATX_ResolveVolumeName(acVolumeName);   /* Same key as the entries added via FS_FATX_Begin(). */
+        }
+        r = FS_FATX_Lock();
+    }
+    if(r == 0)
+    {
+        if(sDirName != NULL)
+        {
+            len = normalize(sPath, 0xFFFFFFFFUL, acPath, NULL);
+        }
+        for(U32 i = 0U; i < pathcache_num_entries; i++)
+        {
+            pathcache_entry_t * p = &pathcache_entries[i];
+
+            if((sDirName == NULL) ||
+               ((FS_STRCMP(p->acVolumeName, acVolumeName) == 0) && (p->Len >= len) && (FS_MEMCMP(p->acPath, acPath, len) == 0) &&
+                ((len == 0U) || (p->acPath[len] == '\0') || (p->acPath[len] == DELIMITER))))
+            {
+                p->Len = 0U;
+            }
+        }
+        FS_FATX_Unlock();
+    }
+
+    return r;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,1048 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FILEIO.c
+Purpose     : Vectored, positional and zero-copy file I/O.
+              Protocol stacks typically assemble a record from several
+              buffers, for example a header, the payload and a trailer.
+              This module transfers such a list of buffers with one call.
+              Small buffers are gathered in a staging buffer so that the
+              file system is called once for all of them, and buffers at
+              least as large as the staging buffer are passed directly to
+              the file system, which transfers complete sectors between
+              the buffer and the storage device without copying. The
+              transfers are serialized so that a record is not interleaved
+              with the records of other tasks using the same functions.
+              Tasks sharing a file handle can read and write at a given
+              offset without changing the file position seen by the other
+              tasks and without a separate call to FS_FSeek().
+              Parsers of metadata-heavy files can access the file data in
+              place via views: a range of a file is read once into a view
+              buffer, sector-aligned so that the file system reads it
+              directly from the storage device, and the same buffer is
+              returned to all the readers of the range until it is released.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_FILEIO.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    FS_FILE * pFile;            /* File the data was read from or NULL if unused. */
+    U8      * data;
+    U32       offset;           /* Offset in the file of the first byte in data. */
+    U32       num_bytes;        /* Number of valid bytes in data. */
+    U32       file_size;        /* Size of the file when the data was read. */
+    U32       last_use;         /* Value of fileio_view_clock at the last access. */
+    U16       num_pins;         /* Number of views returned and not released yet. */
+    bool      is_stale;         /* The file was modified. Not returned to new readers. */
+} fileio_view_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static bool     fileio_initialized = false;
+static U8     * fileio_buffer;          /* Staging buffer for small segments. */
+static U32      fileio_buffer_size;
+static fileio_view_t fileio_views[FS_FILEIO_MAX_VIEWS];
+static U32      fileio_num_views;
+static U32      fileio_view_size;
+static U32      fileio_view_clock;
+
+#if defined(COMPONENT_RTOS_AWARE)
+static cy_mutex_t fileio_mutex;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       lock / unlock
+*/
+static void lock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    if(fileio_initialized)
+    {
+        (void) cy_rtos_get_mutex(&fileio_mutex, CY_RTOS_NEVER_TIMEOUT);
+    }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+static void unlock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    if(fileio_initialized)
+    {
+        (void) cy_rtos_set_mutex(&fileio_mutex);
+    }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+/*********************************************************************
+*
+*       transfer
+*/
+static U32 transfer(FS_FILE * pFile, U8 * pData, U32 num_bytes, bool is_write)
+{
+    U32 num_bytes_transferred;
+
+    if(is_write)
+    {
+        num_bytes_transferred = FS_Write(pFile, pData, num_bytes);
+    }
+    else
+    {
+        num_bytes_transferred = FS_Read(pFile, pData, num_bytes);
+    }
+
+    return num_bytes_transferred;
+}
+
+/*********************************************************************
+*
+*       invalidate_views
+*
+*  Function description
+*    Discards the view buffers that hold data of a file.
+*    The function has to be called with the module locked.
+*
+*  Parameters
+*    pFile      File handle or NULL for all files.
+*
+*  Additional information
+*    Pinned buffers remain valid for their readers and are reused
+*    after they are released.
+*/
+static void invalidate_views(const FS_FILE * pFile)
+{
+    for(U32 i = 0U; i < fileio_num_views; i++)
+    {
+        fileio_view_t * view = &fileio_views[i];
+
+        if((view->pFile != NULL) && ((pFile == NULL) || (view->pFile == pFile)))
+        {
+            if(view->num_pins != 0U)
+            {
+                view->is_stale = true;
+            }
+            else
+            {
+                view->pFile = NULL;
+            }
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       check_views
+*
+*  Function description
+*    Discards the view buffers of a file whose size changed since
+*    they were read.
+*    The function has to be called with the module locked.
+*
+*  Additional information
+*    The handle of a file is the only key of a view buffer that is
+*    available to this module, and the file system assigns the same
+*    handle to another file after it is closed. The size of the file
+*    detects most of the modifications that are not made via this
+*    module, including a handle that refers to a different file now.
+*/
+static void check_views(const FS_FILE * pFile, U32 file_size)
+{
+    for(U32 i = 0U; i < fileio_num_views; i++)
+    {
+        fileio_view_t * view = &fileio_views[i];
+
+        if((view->pFile == pFile) && (view->file_size != file_size))
+        {
+            if(view->num_pins != 0U)
+            {
+                view->is_stale = true;
+            }
+            else
+            {
+                view->pFile = NULL;
+            }
+        }
+    }
+}
+
+/*********************************************************************
+*
+*       set_pos
+*
+*  Function description
+*    Sets the file position to an offset from the beginning of the file.
+*
+*  Additional information
+*    FS_FSeek() takes a signed offset, so that offsets above 2 GB are
+*    set in two steps.
+*/
+static int set_pos(FS_FILE * pFile, U32 pos)
+{
+    int r;
+
+    if(pos <= 0x7FFFFFFFUL)
+    {
+        r = FS_FSeek(pFile, (I32)pos, FS_SEEK_SET);
+    }
+    else
+    {
+        r = FS_FSeek(pFile, 0x7FFFFFFFL, FS_SEEK_SET);
+        if(r == 0)
+        {
+            r = FS_FSeek(pFile, (I32)(pos - 0x7FFFFFFFUL), FS_SEEK_CUR);
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       transfer_at
+*
+*  Function description
+*    Reads or writes data at an offset and restores the file position.
+*
+*  Return value
+*    Number of bytes transferred.
+*/
+static U32 transfer_at(FS_FILE * pFile, U32 offset, U8 * pData, U32 num_bytes, bool is_write)
+{
+    U32 num_bytes_transferred = 0U;
+    U32 pos;
+
+    lock();
+    pos = (U32)FS_FTell(pFile);
+    if((pos != 0xFFFFFFFFUL) && (set_pos(pFile, offset) == 0))
+    {
+        num_bytes_transferred = transfer(pFile, pData, num_bytes, is_write);
+        (void) set_pos(pFile, pos);
+    }
+    if(is_write)
+    {
+        invalidate_views(pFile);
+    }
+    unlock();
+
+    return num_bytes_transferred;
+}
+
+/*********************************************************************
+*
+*       find_view
+*
+*  Function description
+*    Searches for a view buffer that holds a range of a file.
+*    The function has to be called with the module locked.
+*/
+static fileio_view_t * find_view(const FS_FILE * pFile, U32 offset, U32 num_bytes)
+{
+    fileio_view_t * view = NULL;
+
+    for(U32 i = 0U; i < fileio_num_views; i++)
+    {
+        fileio_view_t * v = &fileio_views[i];
+
+        if((v->pFile == pFile) && (!v->is_stale) && (offset >= v->offset) &&
+           ((offset - v->offset) <= v->num_bytes) && (num_bytes <= (v->num_bytes - (offset - v->offset))))
+        {
+            view = v;
+            break;
+        }
+    }
+
+    return view;
+}
+
+/*********************************************************************
+*
+*       load_view
+*
+*  Function description
+*    Reads a range of a file into the least recently used view buffer
+*    that is not pinned.
+*    The function has to be called with the module locked.
+*
+*  Return value
+*    View buffer or NULL if all the view buffers are pinned or
+*    the data could not be read.
+*/
+static fileio_view_t * load_view(FS_FILE * pFile, U32 offset, U32 file_size)
+{
+    fileio_view_t * view = NULL;
+
+    U32 age_max = 0U;
+
+    for(U32 i = 0U; i < fileio_num_views; i++)
+    {
+        fileio_view_t * v = &fileio_views[i];
+
+        if(v->num_pins == 0U)
+        {
+            if(v->pFile == NULL)
+            {
+                view = v;
+                break;
+            }
+            if((view == NULL) || ((fileio_view_clock - v->last_use) > age_max))
+            {
+                view    = v;
+                age_max = fileio_view_clock - v->last_use;
+            }
+        }
+    }
+    if(view != NULL)
+    {
+        int r;
+
+        view->pFile     = NULL;
+        view->is_stale  = false;
+        view->offset    = offset & ~(FS_FILEIO_VIEW_ALIGN - 1U);
+        view->file_size = file_size;
+        FS_ClearErr(pFile);
+        view->num_bytes = transfer_at(pFile, view->offset, view->data, fileio_view_size, false);
+        r = FS_FError(pFile);
+        if(r == FS_ERRCODE_EOF)
+        {
+            FS_ClearErr(pFile);         /* A view can extend beyond the end of the file. */
+        }
+        else if(r != FS_ERRCODE_OK)
+        {
+            view = NULL;
+        }
+        else
+        {
+            /* Read completely. */
+        }
+        if(view != NULL)
+        {
+            view->pFile = pFile;
+        }
+    }
+
+    return view;
+}
+
+/*********************************************************************
+*
+*       is_vec_valid
+*/
+static bool is_vec_valid(const FS_FILE * pFile, const FS_IOVEC * pIov, unsigned num_vecs)
+{
+    bool is_valid = (pFile != NULL) && ((pIov != NULL) || (num_vecs == 0U));
+
+    for(unsigned i = 0U; is_valid && (i < num_vecs); i++)
+    {
+        if((pIov[i].pData == NULL) && (pIov[i].NumBytes != 0U))
+        {
+            is_valid = false;
+        }
+    }
+
+    return is_valid;
+}
+
+/*********************************************************************
+*
+*       transfer_vec
+*
+*  Function description
+*    Reads or writes a list of buffers at the current file position.
+*
+*  Return value
+*    Number of bytes transferred. Less than the total size of the
+*    buffers if the end of the file was reached or an error occurred.
+*
+*  Additional information
+*    Consecutive segments smaller than the staging buffer are transferred
+*    with one call to the file system. The other segments are transferred
+*    directly from or into the buffer of the application.
+*/
+static U32 transfer_vec(FS_FILE * pFile, const FS_IOVEC * pIov, unsigned num_vecs, bool is_write)
+{
+    U32 num_bytes_total = 0U;
+    unsigned i = 0U;
+    bool is_short = false;
+
+    lock();
+    while((!is_short) && (i < num_vecs))
+    {
+        U32 num_bytes = pIov[i].NumBytes;
+        U32 num_bytes_transferred;
+
+        if(num_bytes >= fileio_buffer_size)
+        {
+            num_bytes_transferred = transfer(pFile, (U8 *)pIov[i].pData, num_bytes, is_write);
+            i++;
+        }
+        else
+        {
+            unsigned i_first = i;
+
+            num_bytes = 0U;
+            while((i < num_vecs) && (pIov[i].NumBytes < fileio_buffer_size) &&
+                  (pIov[i].NumBytes <= (fileio_buffer_size - num_bytes)))
+            {
+                if(is_write)
+                {
+                    FS_MEMCPY(fileio_buffer + num_bytes, pIov[i].pData, pIov[i].NumBytes);
+                }
+                num_bytes += pIov[i].NumBytes;
+                i++;
+            }
+            num_bytes_transferred = transfer(pFile, fileio_buffer, num_bytes, is_write);
+            if(!is_write)
+            {
+                U32 off = 0U;
+
+                for(unsigned k = i_first; (k < i) && (off < num_bytes_transferred); k++)
+                {
+                    U32 num_bytes_copy = pIov[k].NumBytes;
+
+                    if(num_bytes_copy > (num_bytes_transferred - off))
+                    {
+                        num_bytes_copy = num_bytes_transferred - off;
+                    }
+                    FS_MEMCPY(pIov[k].pData, fileio_buffer + off, num_bytes_copy);
+                    off += num_bytes_copy;
+                }
+            }
+        }
+        num_bytes_total += num_bytes_transferred;
+        is_short = (num_bytes_transferred != num_bytes);
+    }
+    if(is_write)
+    {
+        invalidate_views(pFile);
+    }
+    unlock();
+
+    return num_bytes_total;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 9,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_FILEIO_Init
+****************************************************************************//**
+*
+*  Initializes the vectored file I/O module.
+*
+*  Parameters
+*   pBuffer     Staging buffer used to gather small segments. Can be NULL
+*               in which case each segment is transferred separately.
+*               A size of one logical sector is a good choice.
+*   NumBytes    Size of pBuffer in bytes.
+*
+*  Return Value
+*   FS_FILEIO_RESULT_OK          Initialized successfully.
+*   FS_FILEIO_RESULT_BADPARAM    Invalid parameters or already initialized.
+*   FS_FILEIO_RESULT_ERROR       The OS resources could not be created.
+*
+*******************************************************************************/
+FS_FILEIO_Result_t FS_FILEIO_Init(void * pBuffer, U32 NumBytes)
+{
+    FS_FILEIO_Result_t result = FS_FILEIO_RESULT_BADPARAM;
+
+    if((!fileio_initialized) && ((pBuffer != NULL) || (NumBytes == 0U)))
+    {
+        fileio_buffer      = (U8 *)pBuffer;
+        fileio_buffer_size = (pBuffer != NULL) ? NumBytes : 0U;
+        result = FS_FILEIO_RESULT_OK;
+#if defined(COMPONENT_RTOS_AWARE)
+        if(CY_RSLT_SUCCESS != cy_rtos_init_mutex(&fileio_mutex))
+        {
+            result = FS_FILEIO_RESULT_ERROR;
+        }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        if(result == FS_FILEIO_RESULT_OK)
+        {
+            fileio_initialized = true;
+        }
+        else
+        {
+            fileio_buffer_size = 0U;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_FILEIO_DeInit
+****************************************************************************//**
+*
+*  Releases the resources of the vectored file I/O module. No transfer
+*  may be in progress when this function is called.
+*
+*  Return Value
+*   FS_FILEIO_RESULT_OK          Deinitialized successfully.
+*   FS_FILEIO_RESULT_BADPARAM    The module is not initialized.
+*
+*******************************************************************************/
+FS_FILEIO_Result_t FS_FILEIO_DeInit(void)
+{
+    FS_FILEIO_Result_t result = FS_FILEIO_RESULT_BADPARAM;
+
+    if(fileio_initialized)
+    {
+        fileio_initialized = false;
+        fileio_buffer      = NULL;
+        fileio_buffer_size = 0U;
+#if defined(COMPONENT_RTOS_AWARE)
+        (void) cy_rtos_deinit_mutex(&fileio_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        result = FS_FILEIO_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_FILEIO_ConfigViews
+****************************************************************************//**
+*
+*  Assigns the memory for the view buffers used by FS_ReadView().
+*
+*  Parameters
+*   pBuffer     Memory for the view buffers. Has to be aligned as the
+*               sector buffers of the file system. NULL disables the views.
+*   NumBytes    Size of pBuffer in bytes.
+*   ViewSize    Size of one view buffer in bytes. A multiple of
+*               FS_FILEIO_VIEW_ALIGN that is at least as large as the
+*               largest range read via FS_ReadView() plus
+*               FS_FILEIO_VIEW_ALIGN - 1 bytes.
+*
+*  Return Value
+*   FS_FILEIO_RESULT_OK          Configured successfully.
+*   FS_FILEIO_RESULT_BADPARAM    Invalid parameters or a view is still in use.
+*
+*  The number of view buffers is NumBytes / ViewSize, limited to
+*  FS_FILEIO_MAX_VIEWS.
+*
+*******************************************************************************/
+FS_FILEIO_Result_t FS_FILEIO_ConfigViews(void * pBuffer, U32 NumBytes, U32 ViewSize)
+{
+    FS_FILEIO_Result_t result = FS_FILEIO_RESULT_BADPARAM;
+
+    if((pBuffer == NULL) ||
+       ((ViewSize != 0U) && ((ViewSize % FS_FILEIO_VIEW_ALIGN) == 0U) && (NumBytes >= ViewSize)))
+    {
+        bool is_pinned = false;
+
+        lock();
+        for(U32 i = 0U; i < fileio_num_views; i++)
+        {
+            if(fileio_views[i].num_pins != 0U)
+            {
+                is_pinned = true;
+            }
+        }
+        if(!is_pinned)
+        {
+            U32 num_views = (pBuffer != NULL) ? (NumBytes / ViewSize) : 0U;
+
+            if(num_views > FS_FILEIO_MAX_VIEWS)
+            {
+                num_views = FS_FILEIO_MAX_VIEWS;
+            }
+            FS_MEMSET(fileio_views, 0, sizeof(fileio_views));
+            for(U32 i = 0U; i < num_views; i++)
+            {
+                fileio_views[i].data = (U8 *)pBuffer + (i * ViewSize);
+            }
+            fileio_num_views = num_views;
+            fileio_view_size = (pBuffer != NULL) ? ViewSize : 0U;
+            result = FS_FILEIO_RESULT_OK;
+        }
+        unlock();
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_ReadV
+*
+*  Function description
+*    Reads data from a file into several buffers.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pIov       [IN] List of buffers, filled in the order given.
+*    NumVecs    Number of entries in pIov.
+*
+*  Return value
+*    Number of bytes read. Less than the total size of the buffers if
+*    the end of the file was reached or an error occurred, in which
+*    case FS_FError() returns the reason.
+*
+*  Additional information
+*    The data is read from the current file position, which is advanced
+*    by the number of bytes read. The transfer is not interleaved with
+*    other transfers performed via the functions of this module after
+*    FS_FILEIO_Init() has been called.
+*/
+U32 FS_ReadV(FS_FILE * pFile, const FS_IOVEC * pIov, unsigned NumVecs)
+{
+    U32 r = 0U;
+
+    if(is_vec_valid(pFile, pIov, NumVecs))
+    {
+        r = transfer_vec(pFile, pIov, NumVecs, false);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_WriteV
+*
+*  Function description
+*    Writes the data of several buffers to a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pIov       [IN] List of buffers, written in the order given.
+*    NumVecs    Number of entries in pIov.
+*
+*  Return value
+*    Number of bytes written. Less than the total size of the buffers
+*    if an error occurred, in which case FS_FError() returns the reason.
+*
+*  Additional information
+*    The data is written at the current file position, which is advanced
+*    by the number of bytes written. The transfer is not interleaved with
+*    other transfers performed via the functions of this module after
+*    FS_FILEIO_Init() has been called, so that several tasks can append
+*    complete records to the same file.
+*/
+U32 FS_WriteV(FS_FILE * pFile, const FS_IOVEC * pIov, unsigned NumVecs)
+{
+    U32 r = 0U;
+
+    if(is_vec_valid(pFile, pIov, NumVecs))
+    {
+        r = transfer_vec(pFile, pIov, NumVecs, true);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_ReadAt
+*
+*  Function description
+*    Reads data from a given offset of a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    Offset     Byte offset from the beginning of the file.
+*    pData      [OUT] Read data.
+*    NumBytes   Number of bytes to be read.
+*
+*  Return value
+*    Number of bytes read. Less than NumBytes if the end of the file
+*    was reached or an error occurred, in which case FS_FError()
+*    returns the reason.
+*
+*  Additional information
+*    The file position is not changed. The operation is atomic with
+*    respect to the other functions of this module after FS_FILEIO_Init()
+*    has been called, so that several tasks can access the same file
+*    handle via FS_ReadAt(), FS_WriteAt(), FS_ReadV() and FS_WriteV()
+*    without an additional lock. A task that uses FS_Read(), FS_Write()
+*    or FS_FSeek() on the same file handle has to be synchronized by
+*    the application.
+*/
+U32 FS_ReadAt(FS_FILE * pFile, U32 Offset, void * pData, U32 NumBytes)
+{
+    U32 r = 0U;
+
+    if((pFile != NULL) && ((pData != NULL) || (NumBytes == 0U)))
+    {
+        r = transfer_at(pFile, Offset, (U8 *)pData, NumBytes, false);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_WriteAt
+*
+*  Function description
+*    Writes data at a given offset of a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    Offset     Byte offset from the beginning of the file.
+*    pData      [IN] Data to be written.
+*    NumBytes   Number of bytes to be written.
+*
+*  Return value
+*    Number of bytes written. Less than NumBytes if an error occurred,
+*    in which case FS_FError() returns the reason.
+*
+*  Additional information
+*    The file position is not changed. See FS_ReadAt() for the
+*    synchronization with other tasks. A file opened in append mode
+*    is written at its end regardless of Offset.
+*/
+U32 FS_WriteAt(FS_FILE * pFile, U32 Offset, const void * pData, U32 NumBytes)
+{
+    U32 r = 0U;
+
+    if((pFile != NULL) && ((pData != NULL) || (NumBytes == 0U)))
+    {
+        CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by FS_Write()');
+        r = transfer_at(pFile, Offset, (U8 *)pData, NumBytes, true);
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_ReadView
+*
+*  Function description
+*    Returns a read-only reference to a range of a file.
+*
+*  Parameters
+*    pFile          Handle to a file opened for reading.
+*    Offset         Byte offset of the range from the beginning of the file.
+*    NumBytes       Number of bytes in the range (at least 1).
+*    ppData         [OUT] Data of the range.
+*    pNumBytesView  [OUT] Number of bytes available at *ppData. Less than
+*                   NumBytes if the range extends beyond the end of the file.
+*
+*  Return value
+*    ==0    OK, the view has to be released via FS_ReleaseView().
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The data is not copied when the range is already held by a view
+*    buffer, also if the view buffer is used by other readers. Otherwise
+*    it is read into the least recently used view buffer that is not
+*    pinned, starting at a multiple of FS_FILEIO_VIEW_ALIGN bytes. A range
+*    that is not held by a single view buffer can be read via FS_ReadAt().
+*    The file position is not changed.
+*
+*    The data remains valid until the view is released. Modifications
+*    of the file via FS_WriteV() and FS_WriteAt() discard the view buffers
+*    of the file. So does any change of the file size, for example by
+*    FS_Write() at the end of the file or when the handle was closed and
+*    assigned to a file of a different size. Modifications via other
+*    functions that do not change the file size are not detected;
+*    FS_InvalidateViews() has to be called after such modifications and
+*    before the file is closed.
+*/
+int FS_ReadView(FS_FILE * pFile, U32 Offset, U32 NumBytes, const void ** ppData, U32 * pNumBytesView)
+{
+    int r = FS_ERRCODE_INVALID_PARA;
+
+    if((pFile != NULL) && (ppData != NULL) && (pNumBytesView != NULL) && (NumBytes != 0U) &&
+       (fileio_view_size != 0U) && (NumBytes <= (fileio_view_size - (Offset & (FS_FILEIO_VIEW_ALIGN - 1U)))))
+    {
+        fileio_view_t * view;
+        U32 file_size;
+        U32 num_bytes_file = 0U;
+
+        lock();
+        fileio_view_clock++;
+        /* A view that reaches the end of the file holds less than
+         * NumBytes so the range is limited to the file for the search.
+         */
+        file_size = FS_GetFileSize(pFile);
+        check_views(pFile, file_size);
+        if(Offset < file_size)
+        {
+            num_bytes_file = ((file_size - Offset) < NumBytes) ? (file_size - Offset) : NumBytes;
+        }
+        view = find_view(pFile, Offset, num_bytes_file);
+        if(view == NULL)
+        {
+            view = load_view(pFile, Offset, file_size);
+        }
+        if(view == NULL)
+        {
+            r = FS_FError(pFile);
+            if(r == FS_ERRCODE_OK)
+            {
+                r = FS_ERRCODE_BUFFER_NOT_AVAILABLE;    /* All the view buffers are pinned. */
+            }
+        }
+        else
+        {
+            U32 num_bytes_avail = 0U;
+
+            if((Offset - view->offset) < view->num_bytes)
+            {
+                num_bytes_avail = view->num_bytes - (Offset - view->offset);
+            }
+            view->num_pins++;
+            view->last_use = fileio_view_clock;
+            *ppData        = view->data + (Offset - view->offset);
+            *pNumBytesView = (NumBytes < num_bytes_avail) ? NumBytes : num_bytes_avail;
+            r = FS_ERRCODE_OK;
+        }
+        unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_ReleaseView
+*
+*  Function description
+*    Releases a view returned by FS_ReadView().
+*
+*  Parameters
+*    pData      Data pointer returned by FS_ReadView().
+*
+*  Return value
+*    ==0    OK, view released.
+*    !=0    Error code indicating the failure reason.
+*/
+int FS_ReleaseView(const void * pData)
+{
+    int r = FS_ERRCODE_INVALID_PARA;
+    const U8 * data = (const U8 *)pData;
+
+    lock();
+    for(U32 i = 0U; i < fileio_num_views; i++)
+    {
+        fileio_view_t * view = &fileio_views[i];
+
+        if((data >= view->data) && (data < (view->data + fileio_view_size)) && (view->num_pins != 0U))
+        {
+            view->num_pins--;
+            if((view->num_pins == 0U) && view->is_stale)
+            {
+                view->pFile = NULL;
+            }
+            r = FS_ERRCODE_OK;
+            break;
+        }
+    }
+    unlock();
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_InvalidateViews
+*
+*  Function description
+*    Discards the view buffers that hold data of a file.
+*
+*  Parameters
+*    pFile      Handle to an opened file or NULL for all the files.
+*
+*  Return value
+*    ==0    OK, view buffers discarded.
+*
+*  Additional information
+*    Has to be called before a file with views is closed and after
+*    it was modified by other functions than FS_WriteV() and FS_WriteAt().
+*    Views that are not released yet remain valid until they are released.
+*/
+int FS_InvalidateViews(FS_FILE * pFile)
+{
+    lock();
+    invalidate_views(pFile);
+    unlock();
+
+    return FS_ERRCODE_OK;
+}
+
+#if FS_FILEIO_SUPPORT_BIGFAT
+
+/*********************************************************************
+*
+*       FS_BIGFAT_ReadAt
+*
+*  Function description
+*    Reads data from a given offset of a file opened via FS_BIGFAT_Open().
+*
+*  Parameters
+*    pBigFile       Handle to an opened big file.
+*    Offset         Byte offset from the beginning of the file.
+*    pData          [OUT] Read data.
+*    NumBytes       Number of bytes to be read.
+*    pNumBytesRead  [OUT] Number of bytes read. Can be NULL.
+*
+*  Return value
+*    ==0    OK, data read.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The file position is not changed. See FS_ReadAt() for the
+*    synchronization with other tasks.
+*/
+int FS_BIGFAT_ReadAt(FS_BIGFAT_FILE * pBigFile, U64 Offset, void * pData, U32 NumBytes, U32 * pNumBytesRead)
+{
+    U32 num_bytes_read = 0U;
+    U64 pos;
+    int r = FS_ERRCODE_INVALID_PARA;
+
+    if((pBigFile != NULL) && ((pData != NULL) || (NumBytes == 0U)))
+    {
+        lock();
+        r = FS_BIGFAT_GetPos(pBigFile, &pos);
+        if(r == 0)
+        {
+            r = FS_BIGFAT_SetPos(pBigFile, Offset);
+            if(r == 0)
+            {
+                r = FS_BIGFAT_Read(pBigFile, pData, NumBytes, &num_bytes_read);
+                (void) FS_BIGFAT_SetPos(pBigFile, pos);
+            }
+        }
+        unlock();
+    }
+    if(pNumBytesRead != NULL)
+    {
+        *pNumBytesRead = num_bytes_read;
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_BIGFAT_WriteAt
+*
+*  Function description
+*    Writes data at a given offset of a file opened via FS_BIGFAT_Open().
+*
+*  Parameters
+*    pBigFile           Handle to an opened big file.
+*    Offset             Byte offset from the beginning of the file.
+*    pData              [IN] Data to be written.
+*    NumBytes           Number of bytes to be written.
+*    pNumBytesWritten   [OUT] Number of bytes written. Can be NULL.
+*
+*  Return value
+*    ==0    OK, data written.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The file position is not changed. See FS_ReadAt() for the
+*    synchronization with other tasks.
+*/
+int FS_BIGFAT_WriteAt(FS_BIGFAT_FILE * pBigFile, U64 Offset, const void * pData, U32 NumBytes, U32 * pNumBytesWritten)
+{
+    U32 num_bytes_written = 0U;
+    U64 pos;
+    int r = FS_ERRCODE_INVALID_PARA;
+
+    if((pBigFile != NULL) && ((pData != NULL) || (NumBytes == 0U)))
+    {
+        lock();
+        r = FS_BIGFAT_GetPos(pBigFile, &pos);
+        if(r == 0)
+        {
+            r = FS_BIGFAT_SetPos(pBigFile, Offset);
+            if(r == 0)
+            {
+                r = FS_BIGFAT_Write(pBigFile, pData, NumBytes, &num_bytes_written);
+                (void) FS_BIGFAT_SetPos(pBigFile, pos);
+            }
+        }
+        unlock();
+    }
+    if(pNumBytesWritten != NULL)
+    {
+        *pNumBytesWritten = num_bytes_written;
+    }
+
+    return r;
+}
+
+#endif // FS_FILEIO_SUPPORT_BIGFAT
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
@@ -0,0 +1,119 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_FILEIO.h
+Purpose     : Vectored, positional and zero-copy file I/O.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_FILEIO_H     // Avoid recursive and multiple inclusion
+#define FS_FILEIO_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_FILEIO_SUPPORT_BIGFAT
+#define FS_FILEIO_SUPPORT_BIGFAT        (0)     /* Enables the positional I/O functions for files opened via FS_BIGFAT_Open(). */
+#endif
+
+#ifndef FS_FILEIO_MAX_VIEWS
+#define FS_FILEIO_MAX_VIEWS             (4U)    /* Maximum number of view buffers. */
+#endif
+
+#ifndef FS_FILEIO_VIEW_ALIGN
+#define FS_FILEIO_VIEW_ALIGN            (512U)  /* The data of a view is read from a file offset that is a multiple of this value. Power of 2. */
+#endif
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+/* Describes one buffer of a vectored transfer. */
+typedef struct
+{
+    void * pData;       /* Data to be read or written. */
+    U32    NumBytes;    /* Number of bytes in pData. */
+} FS_IOVEC;
+
+typedef enum
+{
+    FS_FILEIO_RESULT_OK = 0U,
+    FS_FILEIO_RESULT_BADPARAM,
+    FS_FILEIO_RESULT_ERROR,
+} FS_FILEIO_Result_t;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_FILEIO_Result_t FS_FILEIO_Init   (void * pBuffer, U32 NumBytes);
+FS_FILEIO_Result_t FS_FILEIO_DeInit (void);
+U32                FS_ReadV         (FS_FILE * pFile, const FS_IOVEC * pIov, unsigned NumVecs);
+U32                FS_WriteV        (FS_FILE * pFile, const FS_IOVEC * pIov, unsigned NumVecs);
+FS_FILEIO_Result_t FS_FILEIO_ConfigViews(void * pBuffer, U32 NumBytes, U32 ViewSize);
+U32                FS_ReadAt        (FS_FILE * pFile, U32 Offset,       void * pData, U32 NumBytes);
+U32                FS_WriteAt       (FS_FILE * pFile, U32 Offset, const void * pData, U32 NumBytes);
+int                FS_ReadView      (FS_FILE * pFile, U32 Offset, U32 NumBytes, const void ** ppData, U32 * pNumBytesView);
+int                FS_ReleaseView   (const void * pData);
+int                FS_InvalidateViews(FS_FILE * pFile);
+#if FS_FILEIO_SUPPORT_BIGFAT
+int                FS_BIGFAT_ReadAt (FS_BIGFAT_FILE * pBigFile, U64 Offset,       void * pData, U32 NumBytes, U32 * pNumBytesRead);
+int                FS_BIGFAT_WriteAt(FS_BIGFAT_FILE * pBigFile, U64 Offset, const void * pData, U32 NumBytes, U32 * pNumBytesWritten);
+#endif // FS_FILEIO_SUPPORT_BIGFAT
+
+#endif  // FS_FILEIO_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,624 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_HINT.c
+Purpose     : Access pattern hints for files and tasks.
+              The logical drivers see only sector requests and cannot tell
+              a bulk transfer from the accesses of a metadata-heavy task.
+              An application declares how a file or all the files of a task
+              are going to be accessed. The hint is published for the calling
+              task while the file system operation is in progress so that
+              the FS_CACHE2Q and FS_PREFETCH drivers, which are called in
+              the context of the same task, can act on it.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_HINT.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+#define HINT_NONE                       (0xFFU)     /* No operation with a file hint in progress. */
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    FS_FILE * pFile;
+    uint8_t   hint;
+} hint_file_t;
+
+typedef struct
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_thread_t thread;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    uint8_t     hint_task;      /* Hint assigned via FS_SetTaskAccessHint(). */
+    uint8_t     hint_active;    /* Hint of the file accessed by the task or HINT_NONE. */
+    bool        is_used;
+} hint_task_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static bool              hint_initialized = false;
+static hint_file_t       hint_files[FS_HINT_MAX_FILES];
+static volatile uint32_t hint_num_tasks;    /* Number of used entries in hint_tasks. Checked without lock. */
+
+#if defined(COMPONENT_RTOS_AWARE)
+static cy_mutex_t        hint_mutex;
+static hint_task_t       hint_tasks[FS_HINT_MAX_TASKS];
+#else
+static hint_task_t       hint_tasks[1];
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       lock / unlock
+*/
+static void lock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_get_mutex(&hint_mutex, CY_RTOS_NEVER_TIMEOUT);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+static void unlock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_set_mutex(&hint_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+/*********************************************************************
+*
+*       get_task
+*
+*  Function description
+*    Returns the table entry of the calling task.
+*    The function has to be called with the module locked.
+*
+*  Parameters
+*    do_alloc   Assigns a free entry if the task has none.
+*
+*  Return value
+*    Table entry or NULL if the task has none.
+*/
+static hint_task_t * get_task(bool do_alloc)
+{
+    hint_task_t * task = NULL;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_thread_t   thread;
+    hint_task_t * task_free = NULL;
+
+    if(CY_RSLT_SUCCESS == cy_rtos_get_thread_handle(&thread))
+    {
+        for(uint32_t i = 0U; i < FS_HINT_MAX_TASKS; i++)
+        {
+            if(hint_tasks[i].is_used)
+            {
+                if(hint_tasks[i].thread == thread)
+                {
+                    task = &hint_tasks[i];
+                    break;
+                }
+            }
+            else if(task_free == NULL)
+            {
+                task_free = &hint_tasks[i];
+            }
+            else
+            {
+                /* Keep the first free entry. */
+            }
+        }
+        if((task == NULL) && do_alloc && (task_free != NULL))
+        {
+            task = task_free;
+            task->thread = thread;
+        }
+    }
+#else
+    if(hint_tasks[0].is_used || do_alloc)
+    {
+        task = &hint_tasks[0];
+    }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+    if((task != NULL) && (!task->is_used))
+    {
+        task->hint_task   = FS_ACCESS_HINT_NORMAL;
+        task->hint_active = HINT_NONE;
+        task->is_used     = true;
+        hint_num_tasks++;
+    }
+
+    return task;
+}
+
+/*********************************************************************
+*
+*       release_task
+*
+*  Function description
+*    Frees the table entry of a task without any hint.
+*    The function has to be called with the module locked.
+*/
+static void release_task(hint_task_t * task)
+{
+    if((task->hint_task == FS_ACCESS_HINT_NORMAL) && (task->hint_active == HINT_NONE))
+    {
+        task->is_used = false;
+        hint_num_tasks--;
+    }
+}
+
+/*********************************************************************
+*
+*       get_file_hint
+*/
+static uint8_t get_file_hint(const FS_FILE * pFile)
+{
+    uint8_t hint = FS_ACCESS_HINT_NORMAL;
+
+    lock();
+    for(uint32_t i = 0U; i < FS_HINT_MAX_FILES; i++)
+    {
+        if(hint_files[i].pFile == pFile)
+        {
+            hint = hint_files[i].hint;
+            break;
+        }
+    }
+    unlock();
+
+    return hint;
+}
+
+/*********************************************************************
+*
+*       load_allocation
+*
+*  Function description
+*    Reads the last byte of a file so that the file system follows
+*    the complete cluster chain, loading the allocation table sectors
+*    of the file into the caches. The file position is restored.
+*/
+static void load_allocation(FS_FILE * pFile)
+{
+    U32 file_size = FS_GetFileSize(pFile);
+    I32 file_pos  = FS_FTell(pFile);
+    U8  data;
+
+    if((file_size != 0U) && (file_size != 0xFFFFFFFFUL) && (file_pos >= 0) && (FS_FError(pFile) == FS_ERRCODE_OK))
+    {
+        if(FS_FSeek(pFile, (I32)(file_size - 1U), FS_SEEK_SET) == 0)
+        {
+            if(FS_Read(pFile, &data, 1U) != 1U)
+            {
+                FS_ClearErr(pFile);     /* For example opened for writing only. */
+            }
+        }
+        (void) FS_FSeek(pFile, file_pos, FS_SEEK_SET);
+    }
+}
+
+/*********************************************************************
+*
+*       transfer
+*
+*  Function description
+*    Reads or writes data with the hint of the file handle published
+*    for the calling task.
+*/
+static U32 transfer(FS_FILE * pFile, U8 * pData, U32 num_bytes, bool is_write)
+{
+    hint_task_t * task = NULL;
+    uint8_t hint = FS_ACCESS_HINT_NORMAL;
+    U32 num_bytes_transferred;
+
+    if(hint_initialized)
+    {
+        hint = get_file_hint(pFile);
+    }
+    if(hint != FS_ACCESS_HINT_NORMAL)
+    {
+        lock();
+        task = get_task(true);
+        if(task != NULL)
+        {
+            task->hint_active = hint;
+        }
+        unlock();
+    }
+
+    if(is_write)
+    {
+        num_bytes_transferred = FS_Write(pFile, pData, num_bytes);
+    }
+    else
+    {
+        num_bytes_transferred = FS_Read(pFile, pData, num_bytes);
+    }
+
+    if(task != NULL)
+    {
+        lock();
+        task->hint_active = HINT_NONE;
+        release_task(task);
+        unlock();
+    }
+
+    return num_bytes_transferred;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 6,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_HINT_Init
+****************************************************************************//**
+*
+*  Initializes the access hint module.
+*
+*  Return Value
+*   FS_HINT_RESULT_OK          Initialized successfully.
+*   FS_HINT_RESULT_BADPARAM    Already initialized.
+*   FS_HINT_RESULT_ERROR       The OS resources could not be created.
+*
+*******************************************************************************/
+FS_HINT_Result_t FS_HINT_Init(void)
+{
+    FS_HINT_Result_t result = FS_HINT_RESULT_BADPARAM;
+
+    if(!hint_initialized)
+    {
+        FS_MEMSET(hint_files, 0, sizeof(hint_files));
+        FS_MEMSET(hint_tasks, 0, sizeof(hint_tasks));
+        hint_num_tasks = 0U;
+        result = FS_HINT_RESULT_OK;
+#if defined(COMPONENT_RTOS_AWARE)
+        if(CY_RSLT_SUCCESS != cy_rtos_init_mutex(&hint_mutex))
+        {
+            result = FS_HINT_RESULT_ERROR;
+        }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        if(result == FS_HINT_RESULT_OK)
+        {
+            hint_initialized = true;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_HINT_DeInit
+****************************************************************************//**
+*
+*  Releases the resources of the access hint module. No file system
+*  operation may be in progress when this function is called.
+*
+*  Return Value
+*   FS_HINT_RESULT_OK          Deinitialized successfully.
+*   FS_HINT_RESULT_BADPARAM    The module is not initialized.
+*
+*******************************************************************************/
+FS_HINT_Result_t FS_HINT_DeInit(void)
+{
+    FS_HINT_Result_t result = FS_HINT_RESULT_BADPARAM;
+
+    if(hint_initialized)
+    {
+        hint_initialized = false;
+        hint_num_tasks   = 0U;
+#if defined(COMPONENT_RTOS_AWARE)
+        (void) cy_rtos_deinit_mutex(&hint_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        result = FS_HINT_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_SetFileAccessHint
+*
+*  Function description
+*    Declares how a file is going to be accessed.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    Hint       FS_ACCESS_HINT_NORMAL, FS_ACCESS_HINT_SEQUENTIAL,
+*               FS_ACCESS_HINT_RANDOM, FS_ACCESS_HINT_NOREUSE or
+*               FS_ACCESS_HINT_WILLNEED.
+*
+*  Return value
+*    ==0    OK, hint assigned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The hint is applied to the transfers performed via FS_HINT_Read()
+*    and FS_HINT_Write(). FS_ACCESS_HINT_WILLNEED is not stored; the
+*    allocation information of the file is loaded immediately so that
+*    a subsequent read does not have to wait for it. FS_ACCESS_HINT_NORMAL
+*    releases the table entry of the file handle, which has to be done
+*    before the file is closed.
+*
+*    The hints are evaluated by the FS_CACHE2Q and FS_PREFETCH drivers.
+*    They do not change the behavior of the sector cache assigned via
+*    FS_AssignCache().
+*/
+int FS_SetFileAccessHint(FS_FILE * pFile, U8 Hint)
+{
+    int r = FS_ERRCODE_OK;
+
+    if((pFile == NULL) || (Hint >= FS_ACCESS_HINT_NUM_HINTS))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if(!hint_initialized)
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else if(Hint == FS_ACCESS_HINT_WILLNEED)
+    {
+        load_allocation(pFile);
+    }
+    else
+    {
+        hint_file_t * file_free = NULL;
+        hint_file_t * file      = NULL;
+
+        lock();
+        for(uint32_t i = 0U; i < FS_HINT_MAX_FILES; i++)
+        {
+            if(hint_files[i].pFile == pFile)
+            {
+                file = &hint_files[i];
+                break;
+            }
+            if((hint_files[i].pFile == NULL) && (file_free == NULL))
+            {
+                file_free = &hint_files[i];
+            }
+        }
+        if(Hint == FS_ACCESS_HINT_NORMAL)
+        {
+            if(file != NULL)
+            {
+                file->pFile = NULL;
+            }
+        }
+        else
+        {
+            if(file == NULL)
+            {
+                file = file_free;
+            }
+            if(file == NULL)
+            {
+                r = FS_ERRCODE_TOO_MANY_FILES_OPEN;
+            }
+            else
+            {
+                file->pFile = pFile;
+                file->hint  = Hint;
+            }
+        }
+        unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_SetTaskAccessHint
+*
+*  Function description
+*    Declares how the files accessed by the calling task are going to be accessed.
+*
+*  Parameters
+*    Hint       FS_ACCESS_HINT_NORMAL, FS_ACCESS_HINT_SEQUENTIAL,
+*               FS_ACCESS_HINT_RANDOM or FS_ACCESS_HINT_NOREUSE.
+*
+*  Return value
+*    ==0    OK, hint assigned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The hint applies to all file system operations of the task, including
+*    the ones performed via FS_Read() and FS_Write(). The hint of a file
+*    handle used with FS_HINT_Read() or FS_HINT_Write() takes precedence.
+*    FS_ACCESS_HINT_NORMAL releases the table entry of the calling task.
+*/
+int FS_SetTaskAccessHint(U8 Hint)
+{
+    int r = FS_ERRCODE_OK;
+
+    if((Hint >= FS_ACCESS_HINT_NUM_HINTS) || (Hint == FS_ACCESS_HINT_WILLNEED))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if(!hint_initialized)
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else
+    {
+        hint_task_t * task;
+
+        lock();
+        task = get_task(Hint != FS_ACCESS_HINT_NORMAL);
+        if(task != NULL)
+        {
+            task->hint_task = Hint;
+            release_task(task);
+        }
+        else if(Hint != FS_ACCESS_HINT_NORMAL)
+        {
+            r = FS_ERRCODE_TOO_MANY_INSTANCES;
+        }
+        else
+        {
+            /* No entry to be released. */
+        }
+        unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_HINT_Read
+*
+*  Function description
+*    Reads data from a file applying the access hint of the file handle.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pData      [OUT] Read data.
+*    NumBytes   Number of bytes to be read.
+*
+*  Return value
+*    Number of bytes read, as returned by FS_Read().
+*/
+U32 FS_HINT_Read(FS_FILE * pFile, void * pData, U32 NumBytes)
+{
+    return transfer(pFile, (U8 *)pData, NumBytes, false);
+}
+
+/*********************************************************************
+*
+*       FS_HINT_Write
+*
+*  Function description
+*    Writes data to a file applying the access hint of the file handle.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pData      [IN] Data to be written.
+*    NumBytes   Number of bytes to be written.
+*
+*  Return value
+*    Number of bytes written, as returned by FS_Write().
+*/
+U32 FS_HINT_Write(FS_FILE * pFile, const void * pData, U32 NumBytes)
+{
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by FS_Write()');
+    return transfer(pFile, (U8 *)pData, NumBytes, true);
+}
+
+/*********************************************************************
+*
+*       FS_HINT_GetCurrent
+*
+*  Function description
+*    Returns the access hint of the file system operation performed
+*    by the calling task.
+*
+*  Return value
+*    FS_ACCESS_HINT_NORMAL if no hint applies, otherwise the hint
+*    of the file handle or of the task.
+*
+*  Additional information
+*    Called by the logical drivers for each sector request.
+*/
+U8 FS_HINT_GetCurrent(void)
+{
+    uint8_t hint = FS_ACCESS_HINT_NORMAL;
+
+    if(hint_initialized && (hint_num_tasks != 0U))
+    {
+        hint_task_t * task;
+
+        lock();
+        task = get_task(false);
+        if(task != NULL)
+        {
+            hint = (task->hint_active != HINT_NONE) ? task->hint_active : task->hint_task;
+        }
+        unlock();
+    }
+
+    return hint;
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
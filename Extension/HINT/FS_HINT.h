@@ -0,0 +1,115 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_HINT.h
+Purpose     : Access pattern hints for files and tasks.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_HINT_H     // Avoid recursive and multiple inclusion
+#define FS_HINT_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_HINT_MAX_TASKS
+#define FS_HINT_MAX_TASKS               (8U)    /* Maximum number of tasks with an access hint. */
+#endif
+
+#ifndef FS_HINT_MAX_FILES
+#define FS_HINT_MAX_FILES               (8U)    /* Maximum number of file handles with an access hint. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Expected access pattern. */
+#define FS_ACCESS_HINT_NORMAL           (0U)    /* No specific pattern. Default. */
+#define FS_ACCESS_HINT_SEQUENTIAL       (1U)    /* Read in ascending order. Read-ahead starts with the largest window. */
+#define FS_ACCESS_HINT_RANDOM           (2U)    /* Read in random order. No read-ahead. */
+#define FS_ACCESS_HINT_NOREUSE          (3U)    /* Accessed only once. File data is not cached. */
+#define FS_ACCESS_HINT_WILLNEED         (4U)    /* Will be read soon. Loads the allocation information (file handles only). */
+#define FS_ACCESS_HINT_NUM_HINTS        (5U)
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef enum
+{
+    FS_HINT_RESULT_OK = 0U,
+    FS_HINT_RESULT_BADPARAM,
+    FS_HINT_RESULT_ERROR,
+} FS_HINT_Result_t;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_HINT_Result_t FS_HINT_Init           (void);
+FS_HINT_Result_t FS_HINT_DeInit         (void);
+int              FS_SetFileAccessHint   (FS_FILE * pFile, U8 Hint);
+int              FS_SetTaskAccessHint   (U8 Hint);
+U32              FS_HINT_Read           (FS_FILE * pFile,       void * pData, U32 NumBytes);
+U32              FS_HINT_Write          (FS_FILE * pFile, const void * pData, U32 NumBytes);
+U8               FS_HINT_GetCurrent     (void);
+
+#endif  // FS_HINT_H
+
+/*************************** End of file ****************************/
@@ -0,0 +1,863 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_IOPRIO.c
+Purpose     : I/O priority classes for tasks and file handles sharing a volume.
+              With driver locking the task that acquires the volume lock
+              first is served first regardless of its priority, so that a
+              large transfer can block a latency-critical task for a long
+              time. The functions of this module split the transfers of the
+              lower priority classes into bounded slices and defer each
+              slice while requests of a higher priority class are pending.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+/*********************************************************************
+*
+*       #include Section
+*
+**********************************************************************
+*/
+#include "FS_OS.h"
+#include "FS_IOPRIO.h"
+#include "cy_utils.h"
+
+#if defined(COMPONENT_RTOS_AWARE)
+#include "cyabs_rtos.h"
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_IOPRIO_DEFAULT_SLICE_SIZE
+#define FS_IOPRIO_DEFAULT_SLICE_SIZE    (4096U)     /* in bytes. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* Event bit set while no request of the class is pending. */
+#define CLASS_IDLE_BIT(io_class)        (1UL << (io_class))
+#define ALL_CLASSES_IDLE                ((1UL << FS_IOPRIO_NUM_CLASSES) - 1UL)
+
+/*********************************************************************
+*
+*       Local data types
+*
+**********************************************************************
+*/
+#if defined(COMPONENT_RTOS_AWARE)
+typedef struct
+{
+    cy_thread_t thread;
+    uint8_t     io_class;
+    bool        is_used;
+} ioprio_task_t;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+typedef struct
+{
+    FS_FILE * pFile;
+    uint8_t   io_class;
+} ioprio_file_t;
+
+/*********************************************************************
+*
+*       Static data
+*
+**********************************************************************
+*/
+static bool                    ioprio_initialized = false;
+static uint32_t                ioprio_slice_size  = FS_IOPRIO_DEFAULT_SLICE_SIZE;
+static uint32_t                ioprio_max_defer_ms;
+static ioprio_file_t           ioprio_files[FS_IOPRIO_MAX_FILES];
+static FS_IOPRIO_STAT_COUNTERS ioprio_stat;
+
+#if defined(COMPONENT_RTOS_AWARE)
+static cy_mutex_t              ioprio_mutex;
+static cy_event_t              ioprio_event;
+static ioprio_task_t           ioprio_tasks[FS_IOPRIO_MAX_TASKS];
+static uint32_t                ioprio_num_pending[FS_IOPRIO_NUM_CLASSES];
+#else
+static uint8_t                 ioprio_task_class = FS_IOPRIO_CLASS_NORMAL;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+/*********************************************************************
+*
+*      Static code
+*
+**********************************************************************
+*/
+
+/*********************************************************************
+*
+*       lock / unlock
+*/
+static void lock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_get_mutex(&ioprio_mutex, CY_RTOS_NEVER_TIMEOUT);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+static void unlock(void)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    (void) cy_rtos_set_mutex(&ioprio_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+/*********************************************************************
+*
+*       get_task_class
+*
+*  Function description
+*    Returns the priority class assigned to the calling task.
+*    The function has to be called with the module locked.
+*/
+static uint8_t get_task_class(void)
+{
+    uint8_t io_class = FS_IOPRIO_CLASS_NORMAL;
+
+#if defined(COMPONENT_RTOS_AWARE)
+    cy_thread_t thread;
+
+    if(CY_RSLT_SUCCESS == cy_rtos_get_thread_handle(&thread))
+    {
+        for(uint32_t i = 0U; i < FS_IOPRIO_MAX_TASKS; i++)
+        {
+            if(ioprio_tasks[i].is_used && (ioprio_tasks[i].thread == thread))
+            {
+                io_class = ioprio_tasks[i].io_class;
+                break;
+            }
+        }
+    }
+#else
+    io_class = ioprio_task_class;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+    return io_class;
+}
+
+/*********************************************************************
+*
+*       get_class
+*
+*  Function description
+*    Returns the priority class of an operation on a file handle.
+*    The class of the file handle takes precedence over the class
+*    of the calling task. FS_IOPRIO_CLASS_NORMAL is returned if the
+*    module is not initialized.
+*/
+static uint8_t get_class(const FS_FILE * pFile)
+{
+    uint8_t io_class = FS_IOPRIO_CLASS_NORMAL;
+
+    if(ioprio_initialized)
+    {
+        io_class = FS_IOPRIO_CLASS_INHERIT;
+        lock();
+        if(pFile != NULL)
+        {
+            for(uint32_t i = 0U; i < FS_IOPRIO_MAX_FILES; i++)
+            {
+                if(ioprio_files[i].pFile == pFile)
+                {
+                    io_class = ioprio_files[i].io_class;
+                    break;
+                }
+            }
+        }
+        if(io_class == FS_IOPRIO_CLASS_INHERIT)
+        {
+            io_class = get_task_class();
+        }
+        unlock();
+    }
+
+    return io_class;
+}
+
+/*********************************************************************
+*
+*       gate_enter
+*
+*  Function description
+*    Marks a request of the specified class as pending and waits
+*    until no request of a higher priority class is pending.
+*/
+static void gate_enter(uint8_t io_class)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    if(ioprio_initialized)
+    {
+        uint32_t  wait_bits = CLASS_IDLE_BIT(io_class) - 1UL;
+        cy_time_t time_start;
+        cy_time_t time_end;
+
+        lock();
+        ioprio_num_pending[io_class]++;
+        if(ioprio_num_pending[io_class] == 1U)
+        {
+            (void) cy_rtos_clearbits_event(&ioprio_event, CLASS_IDLE_BIT(io_class), false);
+        }
+        unlock();
+
+        if(wait_bits != 0U)
+        {
+            uint32_t current_bits = 0U;
+
+            (void) cy_rtos_getbits_event(&ioprio_event, &current_bits);
+            if((current_bits & wait_bits) != wait_bits)
+            {
+                (void) cy_rtos_get_time(&time_start);
+                (void) cy_rtos_waitbits_event(&ioprio_event, &wait_bits, false, true,
+                                              (ioprio_max_defer_ms == 0U) ? CY_RTOS_NEVER_TIMEOUT : ioprio_max_defer_ms);
+                (void) cy_rtos_get_time(&time_end);
+
+                lock();
+                ioprio_stat.NumDeferred[io_class]++;
+                if((uint32_t)(time_end - time_start) > ioprio_stat.MaxWaitMs[io_class])
+                {
+                    ioprio_stat.MaxWaitMs[io_class] = (uint32_t)(time_end - time_start);
+                }
+                unlock();
+            }
+        }
+    }
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    if(ioprio_initialized)
+    {
+        lock();
+        ioprio_stat.NumSlices[io_class]++;
+        unlock();
+    }
+}
+
+/*********************************************************************
+*
+*       gate_leave
+*
+*  Function description
+*    Marks a request of the specified class as completed and releases
+*    the requests of lower priority classes if no other request of
+*    the same class is pending.
+*/
+static void gate_leave(uint8_t io_class)
+{
+#if defined(COMPONENT_RTOS_AWARE)
+    if(ioprio_initialized)
+    {
+        lock();
+        ioprio_num_pending[io_class]--;
+        if(ioprio_num_pending[io_class] == 0U)
+        {
+            (void) cy_rtos_setbits_event(&ioprio_event, CLASS_IDLE_BIT(io_class), false);
+        }
+        unlock();
+    }
+#else
+    FS_USE_PARA(io_class);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+}
+
+/*********************************************************************
+*
+*       get_slice_size
+*/
+static U32 get_slice_size(uint8_t io_class, U32 num_bytes)
+{
+    U32 num_bytes_slice = num_bytes;
+
+    if((io_class != FS_IOPRIO_CLASS_REALTIME) && (num_bytes_slice > ioprio_slice_size))
+    {
+        num_bytes_slice = ioprio_slice_size;
+    }
+
+    return num_bytes_slice;
+}
+
+/*********************************************************************
+*
+*       transfer
+*
+*  Function description
+*    Reads or writes data in slices using the priority class
+*    of the file handle.
+*/
+static U32 transfer(FS_FILE * pFile, U8 * pData, U32 num_bytes, bool is_write)
+{
+    uint8_t io_class = get_class(pFile);
+    U32     num_bytes_done = 0U;
+
+    while(num_bytes_done < num_bytes)
+    {
+        U32 num_bytes_slice = get_slice_size(io_class, num_bytes - num_bytes_done);
+        U32 num_bytes_transferred;
+
+        gate_enter(io_class);
+        if(is_write)
+        {
+            num_bytes_transferred = FS_Write(pFile, pData + num_bytes_done, num_bytes_slice);
+        }
+        else
+        {
+            num_bytes_transferred = FS_Read(pFile, pData + num_bytes_done, num_bytes_slice);
+        }
+        gate_leave(io_class);
+
+        num_bytes_done += num_bytes_transferred;
+        if(num_bytes_transferred != num_bytes_slice)
+        {
+            break;          /* End of file reached or error. */
+        }
+    }
+
+    return num_bytes_done;
+}
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Directive 4.6', 9,\
+'The third-party defines the function interface with basic numeral type')
+
+/*******************************************************************************
+* Function Name: FS_IOPRIO_Init
+****************************************************************************//**
+*
+*  Initializes the I/O priority scheduler.
+*
+*  Parameters
+*   UserConfig  Scheduler configuration. NULL selects the default slice size
+*               and no limit for the time a slice can be deferred.
+*
+*  Return Value
+*   FS_IOPRIO_RESULT_OK          Initialized successfully.
+*   FS_IOPRIO_RESULT_BADPARAM    Already initialized.
+*   FS_IOPRIO_RESULT_ERROR       The OS resources could not be created.
+*
+*******************************************************************************/
+FS_IOPRIO_Result_t FS_IOPRIO_Init(const FS_IOPRIO_Config_t * UserConfig)
+{
+    FS_IOPRIO_Result_t result = FS_IOPRIO_RESULT_BADPARAM;
+
+    if(!ioprio_initialized)
+    {
+        ioprio_slice_size   = FS_IOPRIO_DEFAULT_SLICE_SIZE;
+        ioprio_max_defer_ms = 0U;
+        if(UserConfig != NULL)
+        {
+            if(UserConfig->SliceSize != 0U)
+            {
+                ioprio_slice_size = UserConfig->SliceSize;
+            }
+            ioprio_max_defer_ms = UserConfig->MaxDeferMs;
+        }
+        FS_MEMSET(ioprio_files, 0, sizeof(ioprio_files));
+        FS_MEMSET(&ioprio_stat, 0, sizeof(ioprio_stat));
+        result = FS_IOPRIO_RESULT_OK;
+
+#if defined(COMPONENT_RTOS_AWARE)
+        FS_MEMSET(ioprio_tasks, 0, sizeof(ioprio_tasks));
+        FS_MEMSET(ioprio_num_pending, 0, sizeof(ioprio_num_pending));
+        if(CY_RSLT_SUCCESS != cy_rtos_init_mutex(&ioprio_mutex))
+        {
+            result = FS_IOPRIO_RESULT_ERROR;
+        }
+        else if(CY_RSLT_SUCCESS != cy_rtos_init_event(&ioprio_event))
+        {
+            (void) cy_rtos_deinit_mutex(&ioprio_mutex);
+            result = FS_IOPRIO_RESULT_ERROR;
+        }
+        else
+        {
+            (void) cy_rtos_setbits_event(&ioprio_event, ALL_CLASSES_IDLE, false);
+        }
+#else
+        ioprio_task_class = FS_IOPRIO_CLASS_NORMAL;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+
+        if(result == FS_IOPRIO_RESULT_OK)
+        {
+            ioprio_initialized = true;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+* Function Name: FS_IOPRIO_DeInit
+****************************************************************************//**
+*
+*  Releases the resources of the I/O priority scheduler. No transfer
+*  may be in progress when this function is called.
+*
+*  Return Value
+*   FS_IOPRIO_RESULT_OK          Deinitialized successfully.
+*   FS_IOPRIO_RESULT_BADPARAM    The scheduler is not initialized.
+*
+*******************************************************************************/
+FS_IOPRIO_Result_t FS_IOPRIO_DeInit(void)
+{
+    FS_IOPRIO_Result_t result = FS_IOPRIO_RESULT_BADPARAM;
+
+    if(ioprio_initialized)
+    {
+        ioprio_initialized = false;
+#if defined(COMPONENT_RTOS_AWARE)
+        (void) cy_rtos_deinit_event(&ioprio_event);
+        (void) cy_rtos_deinit_mutex(&ioprio_mutex);
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+        result = FS_IOPRIO_RESULT_OK;
+    }
+
+    return result;
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_SetTaskClass
+*
+*  Function description
+*    Assigns an I/O priority class to the calling task.
+*
+*  Parameters
+*    Class      FS_IOPRIO_CLASS_REALTIME, FS_IOPRIO_CLASS_NORMAL or
+*               FS_IOPRIO_CLASS_BULK.
+*
+*  Return value
+*    ==0    OK, class assigned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    Tasks without an assigned class use FS_IOPRIO_CLASS_NORMAL.
+*    Assigning FS_IOPRIO_CLASS_NORMAL releases the table entry
+*    of the calling task.
+*/
+int FS_IOPRIO_SetTaskClass(U8 Class)
+{
+    int r = FS_ERRCODE_OK;
+
+    if(Class >= FS_IOPRIO_NUM_CLASSES)
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if(!ioprio_initialized)
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else
+    {
+#if defined(COMPONENT_RTOS_AWARE)
+        cy_thread_t     thread;
+        ioprio_task_t * task_free = NULL;
+        ioprio_task_t * task      = NULL;
+
+        if(CY_RSLT_SUCCESS != cy_rtos_get_thread_handle(&thread))
+        {
+            r = FS_ERRCODE_INVALID_USAGE;
+        }
+        else
+        {
+            lock();
+            for(uint32_t i = 0U; i < FS_IOPRIO_MAX_TASKS; i++)
+            {
+                if(ioprio_tasks[i].is_used)
+                {
+                    if(ioprio_tasks[i].thread == thread)
+                    {
+                        task = &ioprio_tasks[i];
+                        break;
+                    }
+                }
+                else if(task_free == NULL)
+                {
+                    task_free = &ioprio_tasks[i];
+                }
+                else
+                {
+                    /* Keep the first free entry. */
+                }
+            }
+
+            if(task == NULL)
+            {
+                task = task_free;
+            }
+
+            if(Class == FS_IOPRIO_CLASS_NORMAL)
+            {
+                if((task != NULL) && (task != task_free))
+                {
+                    task->is_used = false;
+                }
+            }
+            else if(task == NULL)
+            {
+                r = FS_ERRCODE_TOO_MANY_INSTANCES;
+            }
+            else
+            {
+                task->thread   = thread;
+                task->io_class = Class;
+                task->is_used  = true;
+            }
+            unlock();
+        }
+#else
+        ioprio_task_class = Class;
+#endif /* #if defined(COMPONENT_RTOS_AWARE) */
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_SetFileClass
+*
+*  Function description
+*    Assigns an I/O priority class to a file handle.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    Class      FS_IOPRIO_CLASS_REALTIME, FS_IOPRIO_CLASS_NORMAL,
+*               FS_IOPRIO_CLASS_BULK or FS_IOPRIO_CLASS_INHERIT.
+*
+*  Return value
+*    ==0    OK, class assigned.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    The class of a file handle overrides the class of the task that
+*    performs the operation. FS_IOPRIO_CLASS_INHERIT removes the
+*    assignment and has to be used before the file handle is closed.
+*/
+int FS_IOPRIO_SetFileClass(FS_FILE * pFile, U8 Class)
+{
+    int r = FS_ERRCODE_OK;
+
+    if((pFile == NULL) || ((Class >= FS_IOPRIO_NUM_CLASSES) && (Class != FS_IOPRIO_CLASS_INHERIT)))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else if(!ioprio_initialized)
+    {
+        r = FS_ERRCODE_INVALID_USAGE;
+    }
+    else
+    {
+        ioprio_file_t * file_free = NULL;
+        ioprio_file_t * file      = NULL;
+
+        lock();
+        for(uint32_t i = 0U; i < FS_IOPRIO_MAX_FILES; i++)
+        {
+            if(ioprio_files[i].pFile == pFile)
+            {
+                file = &ioprio_files[i];
+                break;
+            }
+            if((ioprio_files[i].pFile == NULL) && (file_free == NULL))
+            {
+                file_free = &ioprio_files[i];
+            }
+        }
+
+        if(Class == FS_IOPRIO_CLASS_INHERIT)
+        {
+            if(file != NULL)
+            {
+                file->pFile = NULL;
+            }
+        }
+        else
+        {
+            if(file == NULL)
+            {
+                file = file_free;
+            }
+            if(file == NULL)
+            {
+                r = FS_ERRCODE_TOO_MANY_INSTANCES;
+            }
+            else
+            {
+                file->pFile    = pFile;
+                file->io_class = Class;
+            }
+        }
+        unlock();
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_Read
+*
+*  Function description
+*    Reads data from a file according to its I/O priority class.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pData      [OUT] Read data.
+*    NumBytes   Number of bytes to be read.
+*
+*  Return value
+*    Number of bytes read.
+*
+*  Additional information
+*    The function works like FS_Read(). Except for the real-time class,
+*    the data is read in slices of at most the configured slice size and
+*    each slice waits until no request of a higher priority class is pending.
+*/
+U32 FS_IOPRIO_Read(FS_FILE * pFile, void * pData, U32 NumBytes)
+{
+    return transfer(pFile, (U8 *)pData, NumBytes, false);
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_Write
+*
+*  Function description
+*    Writes data to a file according to its I/O priority class.
+*
+*  Parameters
+*    pFile      Handle to an opened file.
+*    pData      [IN] Data to be written.
+*    NumBytes   Number of bytes to be written.
+*
+*  Return value
+*    Number of bytes written.
+*
+*  Additional information
+*    The function works like FS_Write(). Refer to FS_IOPRIO_Read()
+*    for the scheduling rules.
+*/
+U32 FS_IOPRIO_Write(FS_FILE * pFile, const void * pData, U32 NumBytes)
+{
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.8','The data is only read by FS_Write()');
+    return transfer(pFile, (U8 *)pData, NumBytes, true);
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_CopyFile
+*
+*  Function description
+*    Copies a file using the I/O priority class of the calling task.
+*
+*  Parameters
+*    sFileNameSrc   Name of the source file (fully qualified).
+*    sFileNameDest  Name of the destination file (fully qualified).
+*    pBuffer        Buffer to be used for the copy operation.
+*    NumBytes       Size of the buffer in bytes.
+*
+*  Return value
+*    ==0    OK, file copied.
+*    !=0    Error code indicating the failure reason.
+*
+*  Additional information
+*    This function is a replacement of FS_CopyFileEx() for background
+*    transfers. The destination file is overwritten if it exists. The
+*    attributes and the modification time of the source file are copied.
+*    Typically the calling task is assigned to FS_IOPRIO_CLASS_BULK so
+*    that the copy operation gives way to the other tasks.
+*/
+int FS_IOPRIO_CopyFile(const char * sFileNameSrc, const char * sFileNameDest, void * pBuffer, U32 NumBytes)
+{
+    FS_FILE * pFileSrc  = NULL;
+    FS_FILE * pFileDest = NULL;
+    U32       time_stamp = 0U;
+    U8        attributes;
+    int       r;
+
+    if((sFileNameSrc == NULL) || (sFileNameDest == NULL) || (pBuffer == NULL) || (NumBytes == 0U))
+    {
+        r = FS_ERRCODE_INVALID_PARA;
+    }
+    else
+    {
+        r = FS_FOpenEx(sFileNameSrc, "rb", &pFileSrc);
+        if(r == FS_ERRCODE_OK)
+        {
+            r = FS_FOpenEx(sFileNameDest, "wb", &pFileDest);
+            if(r == FS_ERRCODE_OK)
+            {
+                for(;;)
+                {
+                    U32 num_bytes_read = FS_IOPRIO_Read(pFileSrc, pBuffer, NumBytes);
+
+                    if(num_bytes_read == 0U)
+                    {
+                        r = (int)FS_FError(pFileSrc);
+                        if(r == FS_ERRCODE_EOF)
+                        {
+                            r = FS_ERRCODE_OK;
+                        }
+                        break;
+                    }
+                    if(FS_IOPRIO_Write(pFileDest, pBuffer, num_bytes_read) != num_bytes_read)
+                    {
+                        r = (int)FS_FError(pFileDest);
+                        if(r == FS_ERRCODE_OK)
+                        {
+                            r = FS_ERRCODE_WRITE_FAILURE;
+                        }
+                        break;
+                    }
+                    if(num_bytes_read != NumBytes)
+                    {
+                        r = (int)FS_FError(pFileSrc);
+                        if(r == FS_ERRCODE_EOF)
+                        {
+                            r = FS_ERRCODE_OK;  /* End of source file reached. */
+                        }
+                        break;
+                    }
+                }
+
+                if(FS_FClose(pFileDest) != 0)
+                {
+                    if(r == FS_ERRCODE_OK)
+                    {
+                        r = FS_ERRCODE_WRITE_FAILURE;
+                    }
+                }
+            }
+            (void) FS_FClose(pFileSrc);
+        }
+
+        if(r == FS_ERRCODE_OK)
+        {
+            if(FS_GetFileTimeEx(sFileNameSrc, &time_stamp, FS_FILETIME_MODIFY) == FS_ERRCODE_OK)
+            {
+                (void) FS_SetFileTimeEx(sFileNameDest, time_stamp, FS_FILETIME_MODIFY);
+            }
+            attributes = FS_GetFileAttributes(sFileNameSrc);
+            if(attributes != 0xFFU)
+            {
+                (void) FS_SetFileAttributes(sFileNameDest, attributes);
+            }
+        }
+        else if(pFileDest != NULL)
+        {
+            (void) FS_Remove(sFileNameDest);
+        }
+        else
+        {
+            /* Destination file not created. */
+        }
+    }
+
+    return r;
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_GetStatCounters
+*
+*  Function description
+*    Returns the values of the statistical counters.
+*
+*  Parameters
+*    pStat      [OUT] Values of the statistical counters.
+*
+*  Additional information
+*    MaxWaitMs is updated only when the RTOS_AWARE component is enabled.
+*    The counters are updated only while the scheduler is initialized.
+*/
+void FS_IOPRIO_GetStatCounters(FS_IOPRIO_STAT_COUNTERS * pStat)
+{
+    if((pStat != NULL) && ioprio_initialized)
+    {
+        lock();
+        *pStat = ioprio_stat;
+        unlock();
+    }
+    else if(pStat != NULL)
+    {
+        *pStat = ioprio_stat;
+    }
+    else
+    {
+        /* Invalid parameter. */
+    }
+}
+
+/*********************************************************************
+*
+*       FS_IOPRIO_ResetStatCounters
+*
+*  Function description
+*    Sets the values of all the statistical counters to 0.
+*/
+void FS_IOPRIO_ResetStatCounters(void)
+{
+    if(ioprio_initialized)
+    {
+        lock();
+        FS_MEMSET(&ioprio_stat, 0, sizeof(ioprio_stat));
+        unlock();
+    }
+    else
+    {
+        FS_MEMSET(&ioprio_stat, 0, sizeof(ioprio_stat));
+    }
+}
+CY_MISRA_BLOCK_END('MISRA C-2012 Directive 4.6')
+
+/*************************** End of file ****************************/
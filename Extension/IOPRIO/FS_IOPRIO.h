@@ -0,0 +1,129 @@
+/*********************************************************************
+*                     SEGGER Microcontroller GmbH                    *
+*                        The Embedded Experts                        *
+**********************************************************************
+*                                                                    *
+*       (c) 2003 - 2023  SEGGER Microcontroller GmbH                 *
+*                                                                    *
+*       www.segger.com     Support: support_emfile@segger.com        *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile * File system for embedded applications               *
+*                                                                    *
+*                                                                    *
+*       Please note:                                                 *
+*                                                                    *
+*       Knowledge of this file may under no circumstances            *
+*       be used to write a similar product for in-house use.         *
+*                                                                    *
+*       Thank you for your fairness !                                *
+*                                                                    *
+**********************************************************************
+*                                                                    *
+*       emFile version: V5.22.0                                      *
+*                                                                    *
+**********************************************************************
+----------------------------------------------------------------------
+Licensing information
+Licensor:                 SEGGER Microcontroller Systems LLC
+Licensed to:              Cypress Semiconductor Corp, 198 Champion Ct., San Jose, CA 95134, USA
+Licensed SEGGER software: emFile
+License number:           FS-00227
+License model:            Cypress Services and License Agreement, signed November 17th/18th, 2010
+                          and Amendment Number One, signed December 28th, 2020 and February 10th, 2021
+                          and Amendment Number Three, signed May 2nd, 2022 and May 5th, 2022
+Licensed platform:        Any Cypress platform (Initial targets are: PSoC3, PSoC5, PSoC6)
+----------------------------------------------------------------------
+Support and Update Agreement (SUA)
+SUA period:               2010-12-01 - 2023-07-27
+Contact to extend SUA:    sales@segger.com
+----------------------------------------------------------------------
+File        : FS_IOPRIO.h
+Purpose     : I/O priority classes for tasks and file handles sharing a volume.
+-------------------------- END-OF-HEADER -----------------------------
+*/
+
+#ifndef FS_IOPRIO_H     // Avoid recursive and multiple inclusion
+#define FS_IOPRIO_H
+
+/*********************************************************************
+*
+*       Includes
+*
+**********************************************************************
+*/
+#include "FS.h"
+
+/*********************************************************************
+*
+*       Defines, configurable
+*
+**********************************************************************
+*/
+#ifndef FS_IOPRIO_MAX_TASKS
+#define FS_IOPRIO_MAX_TASKS             (8U)    /* Maximum number of tasks with an assigned priority class. */
+#endif
+
+#ifndef FS_IOPRIO_MAX_FILES
+#define FS_IOPRIO_MAX_FILES             (8U)    /* Maximum number of file handles with an assigned priority class. */
+#endif
+
+/*********************************************************************
+*
+*       Defines, non-configurable
+*
+**********************************************************************
+*/
+/* I/O priority classes. A lower value means a higher priority. */
+#define FS_IOPRIO_CLASS_REALTIME        (0U)    /* Never deferred. Transfers are not sliced. */
+#define FS_IOPRIO_CLASS_NORMAL          (1U)    /* Deferred while real-time requests are pending. Default class. */
+#define FS_IOPRIO_CLASS_BULK            (2U)    /* Deferred while requests of any other class are pending. */
+#define FS_IOPRIO_NUM_CLASSES           (3U)
+#define FS_IOPRIO_CLASS_INHERIT         (0xFFU) /* File handle uses the class of the calling task. */
+
+/*********************************************************************
+*
+*       Public types
+*
+**********************************************************************
+*/
+typedef struct
+{
+    uint32_t SliceSize;     /* Maximum number of bytes transferred with one file system call. 0 selects the default. */
+    uint32_t MaxDeferMs;    /* Maximum time a slice waits for higher priority requests. 0 means no limit. */
+} FS_IOPRIO_Config_t;
+
+typedef struct
+{
+    U32 NumSlices[FS_IOPRIO_NUM_CLASSES];       /* Number of file system calls performed. */
+    U32 NumDeferred[FS_IOPRIO_NUM_CLASSES];     /* Number of slices that had to wait for higher priority requests. */
+    U32 MaxWaitMs[FS_IOPRIO_NUM_CLASSES];       /* Longest time a slice has been deferred. */
+} FS_IOPRIO_STAT_COUNTERS;
+
+typedef enum
+{
+    FS_IOPRIO_RESULT_OK = 0U,
+    FS_IOPRIO_RESULT_BADPARAM,
+    FS_IOPRIO_RESULT_ERROR,
+} FS_IOPRIO_Result_t;
+
+/*********************************************************************
+*
+*       Public code
+*
+**********************************************************************
+*/
+FS_IOPRIO_Result_t FS_IOPRIO_Init          (const FS_IOPRIO_Config_t * UserConfig);
+FS_IOPRIO_Result_t FS_IOPRIO_DeInit        (void);
+int                FS_IOPRIO_SetTaskClass  (U8 Class);
+int                FS_IOPRIO_SetFileClass  (FS_FILE * pFile, U8 Class);
+U32                FS_IOPRIO_Read          (FS_FILE * pFile,       void * pData, U32 NumBytes);
+U32                FS_IOPRIO_Write         (FS_FILE * pFile, const void * pData, U32 NumBytes);
+int                FS_IOPRIO_CopyFile      (const char * sFileNameSrc, const char * sFileNameDest, void * pBuffer, U32 NumBytes);
+void               FS_IOPRIO_GetStatCounters(FS_IOPRIO_STAT_COUNTERS * pStat);
+void               FS_IOPRIO_ResetStatCounters(void);
+
+#endif  // FS_IOPRIO_H
+
+/*************************** End of file ****************************/